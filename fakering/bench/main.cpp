@@ -0,0 +1,912 @@
+/************************************************************************************
+ *   Copyright (C) 2018 by BlueSystems GmbH                                         *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                            *
+ *                                                                                  *
+ *   This library is free software; you can redistribute it and/or                  *
+ *   modify it under the terms of the GNU Lesser General Public                     *
+ *   License as published by the Free Software Foundation; either                   *
+ *   version 2.1 of the License, or (at your option) any later version.             *
+ *                                                                                  *
+ *   This library is distributed in the hope that it will be useful,                *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of                 *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU              *
+ *   Lesser General Public License for more details.                                *
+ *                                                                                  *
+ *   You should have received a copy of the GNU Lesser General Public               *
+ *   License along with this library; if not, write to the Free Software            *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA *
+ ***********************************************************************************/
+
+/*
+ * Microbenchmarks of the parsers, of the directory and of the models on
+ * synthetic datasets.
+ *
+ *    libringqt_bench [--json] [--output file] [--seed n] [--repeat n]
+ *                    [--scales 1000,10000] [--full] [--only group,...]
+ *
+ * The datasets are generated from a fixed seed, so two runs with the same
+ * arguments process the same data. Everything is written in the
+ * QStandardPaths test directory, which is wiped at startup, the user data
+ * is never touched.
+ *
+ * The groups are:
+ *
+ *  * uri:       URI parsing
+ *  * directory: IndividualDirectory::getNumber and the NumberCompletionModel
+ *  * vcard:     vCard parsing
+ *  * events:    EventModel inserts, PeersTimelineModel reorders, ICS save
+ *  * ics:       ICS load (cold, without a snapshot)
+ *  * text:      Text recording JSON load and save
+ */
+
+// Qt
+#include <QtCore/QCoreApplication>
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QDateTime>
+#include <QtCore/QDir>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QEventLoop>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QStandardPaths>
+
+// Std
+#include <algorithm>
+#include <cstdio>
+#include <functional>
+#include <random>
+
+// LibRingQt
+#include <session.h>
+#include <account.h>
+#include <accountmodel.h>
+#include <call.h>
+#include <callmodel.h>
+#include <contactmethod.h>
+#include <person.h>
+#include <uri.h>
+#include <individualdirectory.h>
+#include <numbercompletionmodel.h>
+#include <peerstimelinemodel.h>
+#include <libcard/calendar.h>
+#include <libcard/event.h>
+#include <libcard/private/event_p.h>
+#include <libcard/private/icsbuilder.h>
+#include <media/media.h>
+#include <media/mimemessage.h>
+#include <media/textrecording.h>
+#include <collections/localtextrecordingcollection.h>
+#include <picocms/collectionloader.h>
+
+// Ring
+#include <configurationmanager_interface.h>
+
+// FakeRing
+#include "daemon.h"
+
+using FakeRing::Daemon;
+
+static const QStringList groupNames {
+   QStringLiteral("uri"      ),
+   QStringLiteral("directory"),
+   QStringLiteral("vcard"    ),
+   QStringLiteral("events"   ),
+   QStringLiteral("ics"      ),
+   QStringLiteral("text"     ),
+};
+
+static const char* firstNames[] = {
+   "Alice", "Bob", "Carol", "Dave", "Eve", "Frank", "Grace", "Heidi", "Ivan",
+   "Judy", "Mallory", "Niaj", "Olivia", "Peggy", "Rupert", "Sybil", "Trent",
+   "Victor", "Walter", "Zoe",
+};
+
+static const char* lastNames[] = {
+   "Anderson", "Brown", "Clark", "Davis", "Evans", "Garcia", "Harris",
+   "Jackson", "Lopez", "Martin", "Nguyen", "Roberts", "Smith", "Taylor",
+   "Thomas", "Walker", "White", "Wilson", "Young", "Zhang",
+};
+
+template<typename T, size_t N>
+static const T& pick(std::mt19937& rng, const T (&array)[N])
+{
+   return array[rng() % N];
+}
+
+/// One measured benchmark at one scale
+struct Result {
+   QString             name;
+   int                 size    {0};
+   int                 items   {0};
+   std::vector<double> samples {};
+   QJsonObject         extra   {};
+};
+
+class Bench final
+{
+public:
+   quint32        m_Seed    {42};
+   int            m_Repeats {5};
+   QList<int>     m_lScales {};
+   QStringList    m_lGroups {};
+   QList<Result>  m_lResults{};
+
+   /// A generator specific to a group and a scale, independent of --only
+   std::mt19937 random(const QString& group, int size) const;
+
+   void record(const QString& name, int size, int items, const std::vector<double>& samples, const QJsonObject& extra = {});
+
+   /// Run `f` once to warm the caches, then `m_Repeats` times
+   std::vector<double> measure(const std::function<void()>& f) const;
+
+   /// Run `f` exactly once, for the benchmarks changing the state
+   static double measureOnce(const std::function<void()>& f);
+
+   // Generators
+   static QString hex(std::mt19937& rng, int len);
+   static QString uri(std::mt19937& rng, int i);
+   static QByteArray vCard(std::mt19937& rng, int i);
+   static QVector<ContactMethod*> peers(std::mt19937& rng, Account* a, int count);
+   static qint64 writeIcs(std::mt19937& rng, Account* a, int size, int peerCount);
+   static QStringList writeTextRecordings(std::mt19937& rng, Account* a, int size);
+
+   /// Create the calendar of `a` and wait until the CollectionLoader loaded it
+   static Calendar* calendar(Account* a);
+
+   // Benchmarks
+   void benchUri      (int size);
+   void benchDirectory(int size, Account* a);
+   void benchVCard    (int size);
+   void benchEvents   (int size, Account* a);
+   void benchIcsLoad  (int size, Account* a);
+   void benchText     (int size, Account* a);
+
+   QJsonObject toJson() const;
+   void print() const;
+};
+
+std::mt19937 Bench::random(const QString& group, int size) const
+{
+   std::seed_seq seq {
+      m_Seed, static_cast<quint32>(groupNames.indexOf(group)), static_cast<quint32>(size)
+   };
+
+   return std::mt19937(seq);
+}
+
+std::vector<double> Bench::measure(const std::function<void()>& f) const
+{
+   std::vector<double> ret;
+   QElapsedTimer t;
+
+   f();
+
+   for (int i = 0; i < m_Repeats; i++) {
+      t.start();
+      f();
+      ret.push_back(t.nsecsElapsed() / 1000000.0);
+   }
+
+   return ret;
+}
+
+double Bench::measureOnce(const std::function<void()>& f)
+{
+   QElapsedTimer t;
+   t.start();
+   f();
+   return t.nsecsElapsed() / 1000000.0;
+}
+
+Calendar* Bench::calendar(Account* a)
+{
+   auto cal = a->calendar();
+
+   const auto state = CollectionLoader::instance().state(cal);
+
+   if (state != CollectionLoader::State::PENDING && state != CollectionLoader::State::RUNNING)
+      return cal;
+
+   QEventLoop loop;
+
+   QObject::connect(&CollectionLoader::instance(), &CollectionLoader::collectionLoaded, &loop,
+      [&loop, cal](CollectionInterface* col) {
+         if (col == cal)
+            loop.quit();
+   });
+
+   loop.exec();
+
+   return cal;
+}
+
+void Bench::record(const QString& name, int size, int items, const std::vector<double>& samples, const QJsonObject& extra)
+{
+   m_lResults << Result {name, size, items, samples, extra};
+
+   // Leave the deferred work (saving, proxies) out of the next measurement
+   QCoreApplication::processEvents();
+
+   fprintf(stderr, "%-20s %9d done\n", qPrintable(name), size);
+}
+
+QString Bench::hex(std::mt19937& rng, int len)
+{
+   static const char digits[] = "0123456789abcdef";
+
+   QString ret;
+   ret.reserve(len);
+
+   for (int i = 0; i < len; i++)
+      ret += QLatin1Char(digits[rng() % 16]);
+
+   return ret;
+}
+
+/// The URI flavors found in the wild, the index keeps them unique
+QString Bench::uri(std::mt19937& rng, int i)
+{
+   switch (rng() % 5) {
+      case 0:
+         return QStringLiteral("ring:") + hex(rng, 40);
+      case 1:
+         return QStringLiteral("sip:user%1@sip%2.example.com:5060").arg(i).arg(rng() % 100);
+      case 2:
+         return QStringLiteral("<sips:%1@192.168.%2.%3:5061;transport=TLS>")
+            .arg(1000 + i).arg(rng() % 256).arg(rng() % 256);
+      case 3:
+         return QStringLiteral("+1 (%1) 555-%2").arg(200 + rng() % 800).arg(i, 7, 10, QLatin1Char('0'));
+      default:
+         return QStringLiteral("%1.%2%3@example.org")
+            .arg(QString(pick(rng, firstNames)).toLower())
+            .arg(QString(pick(rng, lastNames)).toLower())
+            .arg(i);
+   }
+}
+
+QByteArray Bench::vCard(std::mt19937& rng, int i)
+{
+   const QByteArray first = pick(rng, firstNames);
+   const QByteArray last  = pick(rng, lastNames );
+
+   QByteArray ret;
+   ret.reserve(512);
+
+   ret += "BEGIN:VCARD\r\n";
+   ret += "VERSION:3.0\r\n";
+   ret += "UID:bench-" + QByteArray::number(i) + "\r\n";
+   ret += "FN:" + first + ' ' + last + "\r\n";
+   ret += "N:" + last + ';' + first + ";;;\r\n";
+   ret += "ORG:Example " + QByteArray::number(rng() % 50) + "\r\n";
+   ret += "EMAIL;TYPE=INTERNET:" + first.toLower() + '.' + last.toLower()
+      + QByteArray::number(i) + "@example.com\r\n";
+
+   for (int j = 0, count = 1 + rng() % 3; j < count; j++) {
+      ret += (rng() % 2 ? "TEL;TYPE=cell:+1555" : "TEL;TYPE=work:+1444")
+         + QByteArray::number(i * 10 + j).rightJustified(7, '0') + "\r\n";
+   }
+
+   if (rng() % 2)
+      ret += "X-RINGACCOUNTID:" + hex(rng, 16).toLatin1() + "\r\n";
+
+   ret += "END:VCARD\r\n";
+
+   return ret;
+}
+
+QVector<ContactMethod*> Bench::peers(std::mt19937& rng, Account* a, int count)
+{
+   QVector<ContactMethod*> ret;
+   ret.reserve(count);
+
+   for (int i = 0; i < count; i++) {
+      ret << Session::instance()->individualDirectory()->getNumber(
+         URI(QStringLiteral("ring:") + hex(rng, 40)), a
+      );
+   }
+
+   return ret;
+}
+
+/**
+ * Write a calendar in the same format as ICSBuilder.
+ *
+ * It has to be done before the calendar is created, so the path has to be
+ * kept in sync with Calendar::path().
+ */
+qint64 Bench::writeIcs(std::mt19937& rng, Account* a, int size, int peerCount)
+{
+   const QString path = QStandardPaths::writableLocation(QStandardPaths::DataLocation)
+      + "/iCal/" + a->id() + ".ics";
+
+   QDir().mkpath(QFileInfo(path).absolutePath());
+
+   QFile file(path);
+
+   if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+      return 0;
+
+   QVector<QByteArray> attendees;
+   attendees.reserve(peerCount);
+
+   for (int i = 0; i < peerCount; i++)
+      attendees << "ATTENDEE:ring:" + hex(rng, 40).toLatin1() + '\n';
+
+   const QByteArray organizer = "ORGANIZER;CN=\"" + a->displayName().toUtf8()
+      + "\";X_RING_ACCOUNTID=" + a->id() + ':'
+      + a->contactMethod()->uri().format(
+         URI::Section::SCHEME | URI::Section::USER_INFO | URI::Section::HOSTNAME
+      ).toUtf8() + '\n';
+
+   const QByteArray category = Event::categoryName(Event::EventCategory::CALL);
+   const QByteArray status   = Event::statusName(Event::Status::FINAL);
+   const QByteArray type     = Event::typeName(Event::Type::VEVENT);
+
+   QByteArray buffer;
+   buffer.reserve(1024*1024);
+
+   buffer += "BEGIN:VCALENDAR\nVERSION:2.0\n";
+   buffer += "BEGIN:VTIMEZONE\nTZID:UTC\nEND:VTIMEZONE\n";
+
+   time_t t = 1500000000;
+
+   for (int i = 0; i < size; i++) {
+      t += 1 + rng() % 3600;
+      const QByteArray start = QByteArray::number(static_cast<qint64>(t));
+      const QByteArray end   = QByteArray::number(static_cast<qint64>(t + rng() % 600));
+
+      buffer += "BEGIN:" + type + '\n';
+      buffer += "UID:bench-ics-" + QByteArray::number(size) + '-' + QByteArray::number(i) + '\n';
+      buffer += "CATEGORIES:" + category + '\n';
+      buffer += "DTSTART;TZID=UTC:" + start + '\n';
+      buffer += "DTEND;TZID=UTC:" + end + '\n';
+      buffer += "DTSTAMP;TZID=UTC:" + start + '\n';
+      buffer += rng() % 2 ?
+         "X_RING_DIRECTION;VALUE=STRING:INCOMING\n" : "X_RING_DIRECTION;VALUE=STRING:OUTGOING\n";
+      buffer += "STATUS:" + status + '\n';
+      buffer += organizer;
+      buffer += attendees[rng() % peerCount];
+      buffer += "END:" + type + '\n';
+
+      if (buffer.size() > 1000*1000) {
+         file.write(buffer);
+         buffer.clear();
+      }
+   }
+
+   buffer += "END:VCALENDAR\n";
+   file.write(buffer);
+
+   return file.size();
+}
+
+/**
+ * Write one file per peer in the LocalTextRecordingCollection format.
+ *
+ * The groups have no eventUid, so the events are created when loading, like
+ * for the files written before the events existed.
+ */
+QStringList Bench::writeTextRecordings(std::mt19937& rng, Account* a, int size)
+{
+   static const QString mimeType = QStringLiteral("text/plain");
+
+   const int peerCount = std::max(10, size / 1000);
+   const auto cms      = peers(rng, a, peerCount);
+   const auto selfSha1 = QString(a->contactMethod()->sha1());
+
+   QStringList ret;
+   time_t t = 1500000000;
+   int id = 0;
+
+   for (int p = 0; p < peerCount; p++) {
+      const auto cm       = cms[p];
+      const auto peerSha1 = QString(cm->sha1());
+
+      // Spread the remainder over the first peers
+      const int count = size / peerCount + (p < size % peerCount ? 1 : 0);
+
+      QJsonArray groups;
+      QJsonArray messages;
+
+      for (int i = 0; i < count; i++) {
+         const bool incoming = rng() % 2;
+
+         QJsonObject payload;
+         payload[QStringLiteral("payload")   ] = QStringLiteral("Message %1 %2").arg(i).arg(hex(rng, 8 + rng() % 64));
+         payload[QStringLiteral("mimeType")  ] = mimeType;
+         payload[QStringLiteral("bookmarked")] = false;
+
+         QJsonObject m;
+         m[QStringLiteral("payloads")      ] = QJsonArray {payload};
+         m[QStringLiteral("timestamp")     ] = static_cast<int>(t += 1 + rng() % 600);
+         m[QStringLiteral("authorSha1")    ] = incoming ? peerSha1 : selfSha1;
+         m[QStringLiteral("direction")     ] = static_cast<int>(incoming ?
+            Media::Media::Direction::IN : Media::Media::Direction::OUT);
+         m[QStringLiteral("type")          ] = static_cast<int>(Media::MimeMessage::Type::CHAT);
+         m[QStringLiteral("isRead")        ] = true;
+         m[QStringLiteral("id")            ] = QString::number(++id);
+         m[QStringLiteral("deliveryStatus")] = static_cast<int>(incoming ?
+            Media::MimeMessage::State::READ : Media::MimeMessage::State::SENT);
+
+         messages.append(m);
+
+         // Split the conversation into groups, like the sessions would
+         if (messages.size() == 50 || i == count - 1) {
+            QJsonObject g;
+            g[QStringLiteral("id")           ] = groups.size();
+            g[QStringLiteral("nextGroupSha1")] = QString();
+            g[QStringLiteral("nextGroupId")  ] = 0;
+            g[QStringLiteral("type")         ] = static_cast<int>(Media::MimeMessage::Type::CHAT);
+            g[QStringLiteral("messages")     ] = messages;
+
+            groups.append(g);
+            messages = QJsonArray();
+         }
+      }
+
+      QJsonObject o;
+      o[QStringLiteral("sha1s") ] = QJsonArray {peerSha1};
+      o[QStringLiteral("groups")] = groups;
+      o[QStringLiteral("peers") ] = QJsonArray {cm->toJson()};
+
+      const QString path = LocalTextRecordingCollection::directoryPath() + peerSha1 + ".json";
+
+      QFile file(path);
+      if (file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+         file.write(QJsonDocument(o).toJson(QJsonDocument::Compact));
+         ret << path;
+      }
+   }
+
+   return ret;
+}
+
+void Bench::benchUri(int size)
+{
+   auto rng = random(QStringLiteral("uri"), size);
+
+   QStringList uris;
+   uris.reserve(size);
+
+   for (int i = 0; i < size; i++)
+      uris << uri(rng, i);
+
+   int checksum = 0;
+
+   const auto samples = measure([&uris, &checksum]() {
+      for (const auto& str : qAsConst(uris)) {
+         const URI u(str);
+         checksum += u.userinfo().size() + static_cast<int>(u.schemeType());
+      }
+   });
+
+   record(QStringLiteral("uri_parse"), size, size, samples, {
+      {QStringLiteral("checksum"), checksum},
+   });
+}
+
+/**
+ * The numbers are added to the directory and stay there, so each scale sees
+ * the numbers of the previous ones. The completion is measured on whatever
+ * the directory contains at that point.
+ */
+void Bench::benchDirectory(int size, Account* a)
+{
+   auto rng = random(QStringLiteral("directory"), size);
+   auto d   = Session::instance()->individualDirectory();
+
+   QVector<URI> uris;
+   uris.reserve(size);
+
+   // The index is offset by the scale to avoid hitting the previous numbers
+   for (int i = 0; i < size; i++)
+      uris << URI(uri(rng, size + i));
+
+   record(QStringLiteral("directory_insert"), size, size, {measureOnce([&uris, d, a]() {
+      for (const auto& u : qAsConst(uris))
+         d->getNumber(u, a);
+   })});
+
+   record(QStringLiteral("directory_lookup"), size, size, measure([&uris, d, a]() {
+      for (const auto& u : qAsConst(uris))
+         d->getNumber(u, a);
+   }));
+
+   // Prefix queries of various lengths taken from existing numbers
+   auto ncm = Session::instance()->numberCompletionModel();
+   ncm->setUseUnregisteredAccounts(true);
+
+   auto call = Session::instance()->callModel()->dialingCall({}, a);
+
+   if (!call) {
+      fprintf(stderr, "Could not create a dialing call, skipping the completion\n");
+      return;
+   }
+
+   static const int lengths[] = {1, 2, 3, 5, 8};
+   constexpr static const int queryCount = 200;
+
+   std::vector<double> samples;
+   int matches = 0;
+
+   for (int i = 0; i < queryCount; i++) {
+      const auto ui     = uris[rng() % size].userinfo();
+      const auto prefix = ui.left(pick(rng, lengths));
+
+      samples.push_back(measureOnce([call, ncm, &prefix, &matches]() {
+         call->setDialNumber(prefix);
+         matches += ncm->rowCount();
+      }));
+   }
+
+   call->setDialNumber(QString());
+
+   record(QStringLiteral("completion_query"), size, 1, samples, {
+      {QStringLiteral("directory_size"), d->rowCount()},
+      {QStringLiteral("mean_matches")  , matches / static_cast<double>(queryCount)},
+   });
+}
+
+void Bench::benchVCard(int size)
+{
+   auto rng = random(QStringLiteral("vcard"), size);
+
+   QList<QByteArray> cards;
+   cards.reserve(size);
+
+   qint64 bytes = 0;
+
+   for (int i = 0; i < size; i++) {
+      cards << vCard(rng, i);
+      bytes += cards.last().size();
+   }
+
+   const auto samples = measure([&cards]() {
+      for (const auto& c : qAsConst(cards))
+         delete new Person(c, Person::Encoding::vCard);
+   });
+
+   record(QStringLiteral("vcard_parse"), size, size, samples, {
+      {QStringLiteral("bytes"), bytes},
+   });
+}
+
+/**
+ * Insert `size` events in a new calendar, then move the peers around the
+ * timeline with newer events, then save the calendar.
+ */
+void Bench::benchEvents(int size, Account* a)
+{
+   auto rng = random(QStringLiteral("events"), size);
+
+   const int peerCount = std::max(10, size / 10);
+   const auto cms = peers(rng, a, peerCount);
+
+   auto cal = calendar(a);
+   auto tl  = Session::instance()->peersTimelineModel();
+
+   // The timeline is kept sorted only once it has been initialized
+   tl->rowCount();
+
+   time_t t = 1500000000;
+
+   const auto attributes = [&rng, &t, &cms, a, peerCount, size](int i) {
+      EventAttributes attrs;
+      t += 1 + rng() % 3600;
+
+      attrs.m_UID            = "bench-event-" + QByteArray::number(size) + '-' + QByteArray::number(i);
+      attrs.m_StartTimeStamp = t;
+      attrs.m_StopTimeStamp  = t + rng() % 600;
+      attrs.m_RevTimeStamp   = t;
+      attrs.m_pAccount       = a;
+      attrs.m_EventCategory  = Event::EventCategory::CALL;
+      attrs.m_Direction      = rng() % 2 ? Event::Direction::INCOMING : Event::Direction::OUTGOING;
+      attrs.m_Status         = Event::Status::FINAL;
+      attrs.m_Type           = Event::Type::VEVENT;
+      attrs.m_lAttendees     = {{cms[rng() % peerCount], QString()}};
+
+      return attrs;
+   };
+
+   QList<EventAttributes> inserts;
+   inserts.reserve(size);
+
+   for (int i = 0; i < size; i++)
+      inserts << attributes(i);
+
+   record(QStringLiteral("event_insert"), size, size, {measureOnce([cal, &inserts]() {
+      for (const auto& attrs : qAsConst(inserts))
+         cal->addEvent(attrs);
+   })}, {
+      {QStringLiteral("peers"), peerCount},
+   });
+
+   // Each new event makes its peer the most recent
+   const int reorderCount = std::min(size, 10000);
+
+   QList<EventAttributes> reorders;
+   reorders.reserve(reorderCount);
+
+   for (int i = 0; i < reorderCount; i++)
+      reorders << attributes(size + i);
+
+   int moves = 0;
+   const auto conn = QObject::connect(tl, &QAbstractItemModel::rowsMoved, [&moves]() {
+      moves++;
+   });
+
+   // Measured first, the order the arguments of record() are evaluated in
+   // is unspecified
+   const double reorderMs = measureOnce([cal, &reorders]() {
+      for (const auto& attrs : qAsConst(reorders))
+         cal->addEvent(attrs);
+   });
+
+   record(QStringLiteral("timeline_reorder"), size, reorderCount, {reorderMs}, {
+      {QStringLiteral("moves"), moves         },
+      {QStringLiteral("rows") , tl->rowCount()},
+   });
+
+   QObject::disconnect(conn);
+
+   const int events = cal->size();
+
+   const auto saveSamples = measure([cal]() {
+      ICSBuilder::rebuild(cal);
+   });
+
+   record(QStringLiteral("ics_save"), size, events, saveSamples, {
+      {QStringLiteral("bytes"), QFileInfo(cal->path()).size()},
+   });
+}
+
+void Bench::benchIcsLoad(int size, Account* a)
+{
+   auto rng = random(QStringLiteral("ics"), size);
+
+   const qint64 bytes = writeIcs(rng, a, size, std::max(10, size / 10));
+
+   // The account has no calendar yet, creating it loads the file
+   Calendar* cal = nullptr;
+
+   const double ms = measureOnce([a, &cal]() {
+      cal = calendar(a);
+   });
+
+   record(QStringLiteral("ics_load"), size, size, {ms}, {
+      {QStringLiteral("bytes") , bytes      },
+      {QStringLiteral("events"), cal->size()},
+   });
+}
+
+void Bench::benchText(int size, Account* a)
+{
+   auto rng = random(QStringLiteral("text"), size);
+
+   const auto paths   = writeTextRecordings(rng, a, size);
+   const auto backend = &LocalTextRecordingCollection::instance();
+
+   qint64 bytes = 0;
+
+   for (const auto& p : qAsConst(paths))
+      bytes += QFileInfo(p).size();
+
+   QList<Media::TextRecording*> recordings;
+
+   record(QStringLiteral("text_load"), size, size, {measureOnce([&paths, &recordings, backend]() {
+      for (const auto& p : qAsConst(paths)) {
+         if (auto r = Media::TextRecording::fromPath(p, {}, backend))
+            recordings << r;
+      }
+   })}, {
+      {QStringLiteral("bytes"), bytes       },
+      {QStringLiteral("files"), paths.size()},
+   });
+
+   record(QStringLiteral("text_save"), size, size, measure([&recordings]() {
+      for (auto r : qAsConst(recordings))
+         r->save();
+   }));
+}
+
+QJsonObject Bench::toJson() const
+{
+   QJsonArray results;
+
+   for (const auto& r : qAsConst(m_lResults)) {
+      auto sorted = r.samples;
+      std::sort(sorted.begin(), sorted.end());
+
+      const double median = sorted[sorted.size() / 2];
+
+      QJsonObject o = r.extra;
+      o[QStringLiteral("name")       ] = r.name;
+      o[QStringLiteral("size")       ] = r.size;
+      o[QStringLiteral("items")      ] = r.items;
+      o[QStringLiteral("samples")    ] = static_cast<int>(sorted.size());
+      o[QStringLiteral("median_ms")  ] = median;
+      o[QStringLiteral("min_ms")     ] = sorted.front();
+      o[QStringLiteral("max_ms")     ] = sorted.back();
+      o[QStringLiteral("ns_per_item")] = r.items ? median * 1000000.0 / r.items : 0;
+
+      results.append(o);
+   }
+
+   QJsonArray scales;
+   for (int s : qAsConst(m_lScales))
+      scales.append(s);
+
+   QJsonObject ret;
+   ret[QStringLiteral("tool")      ] = QStringLiteral("libringqt_bench");
+   ret[QStringLiteral("qt")        ] = QString(qVersion());
+   ret[QStringLiteral("seed")      ] = static_cast<qint64>(m_Seed);
+   ret[QStringLiteral("repeat")    ] = m_Repeats;
+   ret[QStringLiteral("scales")    ] = scales;
+   ret[QStringLiteral("groups")    ] = QJsonArray::fromStringList(m_lGroups);
+   ret[QStringLiteral("date")      ] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+   ret[QStringLiteral("results")   ] = results;
+
+   return ret;
+}
+
+void Bench::print() const
+{
+   const auto results = toJson()[QStringLiteral("results")].toArray();
+
+   printf("%-20s %9s %9s %12s %12s %12s\n", "benchmark", "size", "items", "median(ms)", "min(ms)", "ns/item");
+
+   for (const auto& v : qAsConst(results)) {
+      const auto r = v.toObject();
+      printf("%-20s %9d %9d %12.3f %12.3f %12.1f\n",
+         qPrintable(r[QStringLiteral("name")].toString()),
+         r[QStringLiteral("size")].toInt(),
+         r[QStringLiteral("items")].toInt(),
+         r[QStringLiteral("median_ms")].toDouble(),
+         r[QStringLiteral("min_ms")].toDouble(),
+         r[QStringLiteral("ns_per_item")].toDouble()
+      );
+   }
+}
+
+int main(int argc, char** argv)
+{
+   // Never touch the real history
+   QStandardPaths::setTestModeEnabled(true);
+
+   QCoreApplication app(argc, argv);
+   QCoreApplication::setApplicationName(QStringLiteral("libringqt_bench"));
+
+   QCommandLineParser parser;
+   parser.setApplicationDescription(QStringLiteral("Benchmark libringqt on synthetic datasets"));
+   parser.addHelpOption();
+
+   const QCommandLineOption jsonOption(QStringLiteral("json"), QStringLiteral("Print the results as JSON"));
+   const QCommandLineOption outputOption(QStringLiteral("output"),
+      QStringLiteral("Also write the JSON results to <file>"), QStringLiteral("file"));
+   const QCommandLineOption seedOption(QStringLiteral("seed"),
+      QStringLiteral("Seed of the dataset generators"), QStringLiteral("n"), QStringLiteral("42"));
+   const QCommandLineOption repeatOption(QStringLiteral("repeat"),
+      QStringLiteral("Measurements of the repeatable benchmarks"), QStringLiteral("n"), QStringLiteral("5"));
+   const QCommandLineOption scalesOption(QStringLiteral("scales"),
+      QStringLiteral("Comma separated dataset sizes"), QStringLiteral("sizes"), QStringLiteral("1000,10000,100000"));
+   const QCommandLineOption fullOption(QStringLiteral("full"), QStringLiteral("Also run with 1M items"));
+   const QCommandLineOption onlyOption(QStringLiteral("only"),
+      QStringLiteral("Comma separated groups (%1)").arg(groupNames.join(QStringLiteral(", "))),
+      QStringLiteral("groups"), groupNames.join(QLatin1Char(',')));
+
+   parser.addOptions({jsonOption, outputOption, seedOption, repeatOption, scalesOption, fullOption, onlyOption});
+   parser.process(app);
+
+   Bench b;
+   b.m_Seed    = parser.value(seedOption).toUInt();
+   b.m_Repeats = std::max(1, parser.value(repeatOption).toInt());
+   b.m_lGroups = parser.value(onlyOption).split(QLatin1Char(','), QString::SkipEmptyParts);
+
+   for (const auto& s : parser.value(scalesOption).split(QLatin1Char(','), QString::SkipEmptyParts)) {
+      bool ok = false;
+      const int size = s.toInt(&ok);
+
+      if ((!ok) || size <= 0) {
+         fprintf(stderr, "Invalid scale: %s\n", qPrintable(s));
+         return 1;
+      }
+
+      b.m_lScales << size;
+   }
+
+   if (parser.isSet(fullOption) && !b.m_lScales.contains(1000000))
+      b.m_lScales << 1000000;
+
+   for (const auto& g : qAsConst(b.m_lGroups)) {
+      if (!groupNames.contains(g)) {
+         fprintf(stderr, "Unknown group: %s\n", qPrintable(g));
+         return 1;
+      }
+   }
+
+   // Start from an empty history
+   QDir(QStandardPaths::writableLocation(QStandardPaths::DataLocation)).removeRecursively();
+   QDir().mkpath(QStandardPaths::writableLocation(QStandardPaths::DataLocation));
+
+   // Each scale gets its own accounts for the events, the ICS and the text
+   // recordings so the calendars are created empty (or from the ICS).
+   FakeRing::Script script;
+   script.parse(QStringLiteral("seed %1\naccounts %2 RING\n")
+      .arg(b.m_Seed).arg(b.m_lScales.size() * 3 + 1).toStdString());
+
+   Daemon::instance().load(script);
+
+   const auto ids = DRing::getAccountList();
+
+   auto s = Session::instance();
+
+   QVector<Account*> accounts;
+
+   QElapsedTimer timeout;
+   timeout.start();
+
+   for (const auto& id : ids) {
+      Account* a = nullptr;
+
+      while ((!(a = s->accountModel()->getById(QByteArray::fromStdString(id)))) && timeout.elapsed() < 5000)
+         QCoreApplication::processEvents(QEventLoop::AllEvents, 50);
+
+      if (!a) {
+         fprintf(stderr, "The accounts were not loaded\n");
+         return 1;
+      }
+
+      accounts << a;
+   }
+
+   const auto has = [&b](const char* g) {
+      return b.m_lGroups.contains(QLatin1String(g));
+   };
+
+   for (int i = 0; i < b.m_lScales.size(); i++) {
+      const int size = b.m_lScales[i];
+
+      if (has("uri"))
+         b.benchUri(size);
+
+      if (has("directory"))
+         b.benchDirectory(size, accounts[0]);
+
+      if (has("vcard"))
+         b.benchVCard(size);
+
+      if (has("events"))
+         b.benchEvents(size, accounts[1 + i*3]);
+
+      if (has("ics"))
+         b.benchIcsLoad(size, accounts[2 + i*3]);
+
+      if (has("text"))
+         b.benchText(size, accounts[3 + i*3]);
+   }
+
+   const auto json = QJsonDocument(b.toJson()).toJson();
+
+   if (parser.isSet(outputOption)) {
+      QFile file(parser.value(outputOption));
+
+      if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+         fprintf(stderr, "Could not write %s\n", qPrintable(file.fileName()));
+         return 1;
+      }
+
+      file.write(json);
+   }
+
+   if (parser.isSet(jsonOption))
+      printf("%s\n", json.constData());
+   else
+      b.print();
+
+   Daemon::instance().stop();
+
+   return 0;
+}
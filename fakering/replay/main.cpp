@@ -0,0 +1,276 @@
+/************************************************************************************
+ *   Copyright (C) 2018 by BlueSystems GmbH                                         *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                            *
+ *                                                                                  *
+ *   This library is free software; you can redistribute it and/or                  *
+ *   modify it under the terms of the GNU Lesser General Public                     *
+ *   License as published by the Free Software Foundation; either                   *
+ *   version 2.1 of the License, or (at your option) any later version.             *
+ *                                                                                  *
+ *   This library is distributed in the hope that it will be useful,                *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of                 *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU              *
+ *   Lesser General Public License for more details.                                *
+ *                                                                                  *
+ *   You should have received a copy of the GNU Lesser General Public               *
+ *   License along with this library; if not, write to the Free Software            *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA *
+ ***********************************************************************************/
+
+/*
+ * Replay a FakeRing script against the libringqt models and report how long
+ * the client took to process it.
+ *
+ *    ringqt_replay [--json] [--timeout ms] [script]
+ *
+ * Without a script, the built-in reconnection storm is used.
+ */
+
+// Qt
+#include <QtCore/QCoreApplication>
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QTimer>
+
+// Std
+#include <algorithm>
+#include <array>
+#include <cstdio>
+
+// LibRingQt
+#include <session.h>
+#include <accountmodel.h>
+#include <callmodel.h>
+#include <media/recordingmodel.h>
+
+// FakeRing
+#include "daemon.h"
+
+using FakeRing::Daemon;
+using FakeRing::EventKind;
+using Clock = Daemon::Clock;
+
+static const std::array<const char*, static_cast<int>(EventKind::COUNT__)> kindNames {{
+   "registration"    ,
+   "volatile_details",
+   "incoming_call"   ,
+   "call_state"      ,
+   "incoming_message",
+   "message_status"  ,
+   "presence"        ,
+   "video_frame"     ,
+}};
+
+/// Nearest rank percentile of a sorted list
+template<typename T>
+static T percentile(const std::vector<T>& sorted, double p)
+{
+   if (sorted.empty())
+      return {};
+
+   const size_t rank = std::min(sorted.size() - 1, static_cast<size_t>(p * sorted.size()));
+   return sorted[rank];
+}
+
+static double toMs(Clock::duration d)
+{
+   return std::chrono::duration<double, std::milli>(d).count();
+}
+
+int main(int argc, char** argv)
+{
+   QCoreApplication app(argc, argv);
+   QCoreApplication::setApplicationName(QStringLiteral("ringqt_replay"));
+
+   QCommandLineParser parser;
+   parser.setApplicationDescription(QStringLiteral("Replay a FakeRing script against libringqt"));
+   parser.addHelpOption();
+   parser.addPositionalArgument(QStringLiteral("script"), QStringLiteral("Script to replay"));
+
+   const QCommandLineOption jsonOption(QStringLiteral("json"), QStringLiteral("Print the results as JSON"));
+   const QCommandLineOption timeoutOption(QStringLiteral("timeout"),
+      QStringLiteral("Give up after <ms> milliseconds"), QStringLiteral("ms"), QStringLiteral("60000"));
+
+   parser.addOption(jsonOption);
+   parser.addOption(timeoutOption);
+   parser.process(app);
+
+   FakeRing::Script script = FakeRing::Script::reconnectStorm();
+
+   if (!parser.positionalArguments().isEmpty()) {
+      std::string error;
+      if (!script.load(parser.positionalArguments().first().toStdString(), &error)) {
+         fprintf(stderr, "%s\n", error.c_str());
+         return 1;
+      }
+   }
+
+   // The initial state has to exist before the client asks for it
+   Daemon::instance().load(script);
+
+   auto s = Session::instance();
+
+   std::array<std::vector<Clock::time_point>, static_cast<int>(EventKind::COUNT__)> received;
+
+   const auto receive = [&received](EventKind k) {
+      received[static_cast<int>(k)].push_back(Clock::now());
+   };
+
+   QObject::connect(s->callModel(), &CallModel::incomingCall, [receive]() {
+      receive(EventKind::INCOMING_CALL);
+   });
+
+   QObject::connect(s->recordingModel(), &Media::RecordingModel::mimeMessageInserted, [receive]() {
+      receive(EventKind::INCOMING_MESSAGE);
+   });
+
+   QObject::connect(s->accountModel(), &AccountModel::accountStateChanged, [receive]() {
+      receive(EventKind::REGISTRATION);
+   });
+
+   // Measure how long the event loop is blocked, this is what the user
+   // perceives as a frozen UI.
+   std::vector<double> stalls;
+   QElapsedTimer tickTimer;
+   QTimer ticker;
+   ticker.setTimerType(Qt::PreciseTimer);
+   ticker.setInterval(1);
+   QObject::connect(&ticker, &QTimer::timeout, [&stalls, &tickTimer]() {
+      stalls.push_back(std::max<qint64>(0, tickTimer.nsecsElapsed() - 1000000) / 1000000.0);
+      tickTimer.restart();
+   });
+
+   Clock::time_point start, end, played;
+   int quietTicks = 0;
+   size_t lastReceived = 0;
+   bool timedOut = false;
+
+   QTimer poller;
+   poller.setInterval(50);
+   QObject::connect(&poller, &QTimer::timeout, [&]() {
+      if (Daemon::instance().isPlaying())
+         return;
+
+      if (played == Clock::time_point())
+         played = Clock::now();
+
+      // Wait until nothing has been delivered for a while
+      size_t total = 0;
+      for (const auto& l : received)
+         total += l.size();
+
+      quietTicks = total == lastReceived ? quietTicks + 1 : 0;
+      lastReceived = total;
+
+      if (quietTicks >= 4)
+         app.quit();
+   });
+
+   QTimer::singleShot(parser.value(timeoutOption).toInt(), [&app, &timedOut]() {
+      timedOut = true;
+      app.quit();
+   });
+
+   // Let the startup settle before starting the clock
+   QTimer::singleShot(500, [&]() {
+      Daemon::instance().resetStatistics();
+      start = Clock::now();
+      tickTimer.start();
+      ticker.start();
+      poller.start();
+      Daemon::instance().play();
+   });
+
+   app.exec();
+
+   ticker.stop();
+   end = std::max(start, played);
+
+   for (const auto& l : received) {
+      if (!l.empty())
+         end = std::max(end, l.back());
+   }
+
+   // Report
+   QJsonObject report;
+   QJsonArray kinds;
+   int totalEmitted = 0;
+
+   for (int i = 0; i < static_cast<int>(EventKind::COUNT__); i++) {
+      const auto emitted = Daemon::instance().emitted(static_cast<EventKind>(i));
+      const auto& recv   = received[i];
+
+      totalEmitted += emitted.size();
+
+      if (emitted.empty() && recv.empty())
+         continue;
+
+      QJsonObject k;
+      k[QStringLiteral("kind")    ] = QString(kindNames[i]);
+      k[QStringLiteral("emitted") ] = static_cast<int>(emitted.size());
+      k[QStringLiteral("received")] = static_cast<int>(recv.size());
+
+      // Only the 1:1 events can be matched, the others are coalesced
+      if (emitted.size() == recv.size() && !recv.empty()) {
+         std::vector<double> latencies;
+         for (size_t j = 0; j < recv.size(); j++)
+            latencies.push_back(toMs(recv[j] - emitted[j]));
+
+         std::sort(latencies.begin(), latencies.end());
+
+         k[QStringLiteral("latency_p50_ms")] = percentile(latencies, 0.50);
+         k[QStringLiteral("latency_p95_ms")] = percentile(latencies, 0.95);
+         k[QStringLiteral("latency_p99_ms")] = percentile(latencies, 0.99);
+         k[QStringLiteral("latency_max_ms")] = latencies.back();
+      }
+
+      kinds.append(k);
+   }
+
+   std::sort(stalls.begin(), stalls.end());
+
+   const double duration = toMs(end - start);
+
+   report[QStringLiteral("events")         ] = kinds;
+   report[QStringLiteral("emitted")        ] = totalEmitted;
+   report[QStringLiteral("duration_ms")    ] = duration;
+   report[QStringLiteral("throughput_eps") ] = duration > 0 ? totalEmitted * 1000.0 / duration : 0;
+   report[QStringLiteral("stall_p99_ms")   ] = percentile(stalls, 0.99);
+   report[QStringLiteral("stall_max_ms")   ] = stalls.empty() ? 0 : stalls.back();
+   report[QStringLiteral("timed_out")      ] = timedOut;
+
+   if (parser.isSet(jsonOption)) {
+      printf("%s\n", QJsonDocument(report).toJson().constData());
+   }
+   else {
+      printf("%-18s %9s %9s %9s %9s %9s\n", "kind", "emitted", "received", "p50(ms)", "p99(ms)", "max(ms)");
+
+      for (const auto& v : qAsConst(kinds)) {
+         const auto k = v.toObject();
+         printf("%-18s %9d %9d %9.2f %9.2f %9.2f\n",
+            qPrintable(k[QStringLiteral("kind")].toString()),
+            k[QStringLiteral("emitted")].toInt(),
+            k[QStringLiteral("received")].toInt(),
+            k[QStringLiteral("latency_p50_ms")].toDouble(),
+            k[QStringLiteral("latency_p99_ms")].toDouble(),
+            k[QStringLiteral("latency_max_ms")].toDouble()
+         );
+      }
+
+      printf("\n%d events in %.1fms (%.0f events/s)\n", totalEmitted, duration,
+         report[QStringLiteral("throughput_eps")].toDouble());
+      printf("Event loop stall: p99 %.2fms, max %.2fms\n",
+         report[QStringLiteral("stall_p99_ms")].toDouble(),
+         report[QStringLiteral("stall_max_ms")].toDouble());
+
+      if (timedOut)
+         printf("Timed out before the client was done\n");
+   }
+
+   Daemon::instance().stop();
+
+   return timedOut ? 2 : 0;
+}
@@ -0,0 +1,398 @@
+/************************************************************************************
+ *   Copyright (C) 2018 by BlueSystems GmbH                                         *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                            *
+ *                                                                                  *
+ *   This library is free software; you can redistribute it and/or                  *
+ *   modify it under the terms of the GNU Lesser General Public                     *
+ *   License as published by the Free Software Foundation; either                   *
+ *   version 2.1 of the License, or (at your option) any later version.             *
+ *                                                                                  *
+ *   This library is distributed in the hope that it will be useful,                *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of                 *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU              *
+ *   Lesser General Public License for more details.                                *
+ *                                                                                  *
+ *   You should have received a copy of the GNU Lesser General Public               *
+ *   License along with this library; if not, write to the Free Software            *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA *
+ ***********************************************************************************/
+// Implementation of `callmanager_interface.h` on top of FakeRing::Daemon
+#include <callmanager_interface.h>
+#include <call_const.h>
+#include <media_const.h>
+
+#include "daemon.h"
+
+using FakeRing::Daemon;
+using Lock = std::lock_guard<std::recursive_mutex>;
+
+namespace {
+
+Daemon& fake()
+{
+   return Daemon::instance();
+}
+
+/// Apply a state change if the call exists
+bool changeState(const std::string& callID, const std::string& state)
+{
+   {
+      Lock l(fake().m_Mutex);
+
+      if (!fake().call(callID))
+         return false;
+   }
+
+   fake().post([callID, state]() {
+      fake().setCallState(callID, state);
+   });
+
+   return true;
+}
+
+/// Reschedule itself until stopSmartInfo() or another startSmartInfo()
+void smartInfoTick(int generation, uint32_t refreshTimeMs)
+{
+   std::string callId;
+
+   {
+      Lock l(fake().m_Mutex);
+
+      if (fake().m_SmartInfoGeneration != generation)
+         return;
+
+      if (!fake().m_hCalls.empty())
+         callId = fake().m_hCalls.begin()->first;
+   }
+
+   fake().emitSignal<DRing::CallSignal::SmartInfo>(std::map<std::string, std::string> {
+      { "callID"            , callId  },
+      { "local FPS"         , "30"    },
+      { "remote FPS"        , "30"    },
+      { "local width"       , "1280"  },
+      { "local height"      , "720"   },
+      { "remote width"      , "1280"  },
+      { "remote height"     , "720"   },
+      { "local audio codec" , "opus"  },
+      { "remote audio codec", "opus"  },
+      { "local video codec" , "H264"  },
+      { "remote video codec", "H264"  },
+   });
+
+   fake().post([generation, refreshTimeMs]() {
+      smartInfoTick(generation, refreshTimeMs);
+   }, refreshTimeMs);
+}
+
+} // anonymous namespace
+
+namespace DRing {
+
+std::string placeCall(const std::string& accountID, const std::string& to)
+{
+   return placeCall(accountID, to, {});
+}
+
+std::string placeCall(const std::string& accountID, const std::string& to, const std::map<std::string, std::string>& VolatileCallDetails)
+{
+   (void) VolatileCallDetails;
+   std::string callId;
+
+   {
+      Lock l(fake().m_Mutex);
+
+      if (!fake().account(accountID))
+         return {};
+
+      callId = fake().createCall(accountID, to, false).id;
+   }
+
+   // The peer always answers
+   fake().post([callId]() {
+      fake().setCallState(callId, Call::StateEvent::RINGING);
+   });
+   fake().post([callId]() {
+      fake().setCallState(callId, Call::StateEvent::CURRENT);
+   }, 100);
+
+   return callId;
+}
+
+bool refuse(const std::string& callID)
+{
+   return changeState(callID, Call::StateEvent::OVER);
+}
+
+bool accept(const std::string& callID)
+{
+   return changeState(callID, Call::StateEvent::CURRENT);
+}
+
+bool hangUp(const std::string& callID)
+{
+   {
+      Lock l(fake().m_Mutex);
+
+      if (!fake().call(callID))
+         return false;
+   }
+
+   fake().post([callID]() {
+      fake().setCallState(callID, Call::StateEvent::HUNGUP);
+      fake().setCallState(callID, Call::StateEvent::OVER  );
+   });
+
+   return true;
+}
+
+bool hold(const std::string& callID)
+{
+   return changeState(callID, Call::StateEvent::HOLD);
+}
+
+bool unhold(const std::string& callID)
+{
+   return changeState(callID, Call::StateEvent::CURRENT);
+}
+
+bool muteLocalMedia(const std::string& callid, const std::string& mediaType, bool mute)
+{
+   fake().post([callid, mediaType, mute]() {
+      if (mediaType == Media::Details::MEDIA_TYPE_VIDEO)
+         fake().emitSignal<CallSignal::VideoMuted>(callid, mute);
+      else
+         fake().emitSignal<CallSignal::AudioMuted>(callid, mute);
+   });
+
+   return true;
+}
+
+bool transfer(const std::string& callID, const std::string& to)
+{
+   (void) to;
+
+   if (!changeState(callID, Call::StateEvent::OVER))
+      return false;
+
+   fake().post([]() {
+      fake().emitSignal<CallSignal::TransferSucceeded>();
+   });
+
+   return true;
+}
+
+bool attendedTransfer(const std::string& transferID, const std::string& targetID)
+{
+   return transfer(transferID, targetID);
+}
+
+std::map<std::string, std::string> getCallDetails(const std::string& callID)
+{
+   Lock l(fake().m_Mutex);
+   auto c = fake().call(callID);
+
+   if (!c)
+      return {};
+
+   return {
+      { Call::Details::ACCOUNTID      , c->accountId                },
+      { Call::Details::PEER_NUMBER    , c->peer                     },
+      { Call::Details::DISPLAY_NAME   , std::string()               },
+      { Call::Details::CALL_STATE     , c->state                    },
+      { Call::Details::CALL_TYPE      , c->incoming ? "0" : "1"     },
+      { Call::Details::TIMESTAMP_START, std::to_string(c->start)    },
+      { Call::Details::VIDEO_SOURCE   , std::string()               },
+      { Call::Details::CONF_ID        , std::string()               },
+   };
+}
+
+std::vector<std::string> getCallList()
+{
+   Lock l(fake().m_Mutex);
+   std::vector<std::string> ret;
+
+   for (const auto& c : fake().m_hCalls)
+      ret.push_back(c.first);
+
+   return ret;
+}
+
+/*****************************************************************************
+ *                                                                           *
+ *                 Conferences (not supported by the fake daemon)            *
+ *                                                                           *
+ ****************************************************************************/
+
+bool joinParticipant(const std::string& sel_callID, const std::string& drag_callID)
+{
+   (void) sel_callID; (void) drag_callID;
+   return false;
+}
+
+void createConfFromParticipantList(const std::vector<std::string>& participants)
+{
+   (void) participants;
+}
+
+bool isConferenceParticipant(const std::string& callID)
+{
+   (void) callID;
+   return false;
+}
+
+bool addParticipant(const std::string& callID, const std::string& confID)
+{
+   (void) callID; (void) confID;
+   return false;
+}
+
+bool addMainParticipant(const std::string& confID)
+{
+   (void) confID;
+   return false;
+}
+
+bool detachParticipant(const std::string& callID)
+{
+   (void) callID;
+   return false;
+}
+
+bool joinConference(const std::string& sel_confID, const std::string& drag_confID)
+{
+   (void) sel_confID; (void) drag_confID;
+   return false;
+}
+
+bool hangUpConference(const std::string& confID)
+{
+   (void) confID;
+   return false;
+}
+
+bool holdConference(const std::string& confID)
+{
+   (void) confID;
+   return false;
+}
+
+bool unholdConference(const std::string& confID)
+{
+   (void) confID;
+   return false;
+}
+
+std::vector<std::string> getConferenceList()
+{
+   return {};
+}
+
+std::vector<std::string> getParticipantList(const std::string& confID)
+{
+   (void) confID;
+   return {};
+}
+
+std::vector<std::string> getDisplayNames(const std::string& confID)
+{
+   (void) confID;
+   return {};
+}
+
+std::string getConferenceId(const std::string& callID)
+{
+   (void) callID;
+   return {};
+}
+
+std::map<std::string, std::string> getConferenceDetails(const std::string& callID)
+{
+   (void) callID;
+   return {};
+}
+
+/*****************************************************************************
+ *                                                                           *
+ *                             Recording and misc                            *
+ *                                                                           *
+ ****************************************************************************/
+
+bool startRecordedFilePlayback(const std::string& filepath)
+{
+   (void) filepath;
+   return false;
+}
+
+void stopRecordedFilePlayback()
+{}
+
+bool toggleRecording(const std::string& callID)
+{
+   bool state;
+
+   {
+      Lock l(fake().m_Mutex);
+      auto c = fake().call(callID);
+
+      if (!c)
+         return false;
+
+      state = c->recording = !c->recording;
+   }
+
+   fake().post([callID, state]() {
+      fake().emitSignal<CallSignal::RecordingStateChanged>(callID, state);
+   });
+
+   return state;
+}
+
+void recordPlaybackSeek(double value)
+{
+   (void) value;
+}
+
+bool getIsRecording(const std::string& callID)
+{
+   Lock l(fake().m_Mutex);
+   auto c = fake().call(callID);
+
+   return c && c->recording;
+}
+
+void playDTMF(const std::string& key)
+{
+   (void) key;
+}
+
+void startTone(int32_t start, int32_t type)
+{
+   (void) start; (void) type;
+}
+
+void sendTextMessage(const std::string& callID, const std::map<std::string, std::string>& messages, const std::string& from, bool isMixed)
+{
+   (void) callID; (void) messages; (void) from; (void) isMixed;
+}
+
+void startSmartInfo(uint32_t refreshTimeMs)
+{
+   int generation;
+
+   {
+      Lock l(fake().m_Mutex);
+      generation = ++fake().m_SmartInfoGeneration;
+   }
+
+   fake().post([generation, refreshTimeMs]() {
+      smartInfoTick(generation, refreshTimeMs);
+   }, refreshTimeMs);
+}
+
+void stopSmartInfo()
+{
+   Lock l(fake().m_Mutex);
+   ++fake().m_SmartInfoGeneration;
+}
+
+} // namespace DRing
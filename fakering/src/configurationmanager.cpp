@@ -0,0 +1,963 @@
+/************************************************************************************
+ *   Copyright (C) 2018 by BlueSystems GmbH                                         *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                            *
+ *                                                                                  *
+ *   This library is free software; you can redistribute it and/or                  *
+ *   modify it under the terms of the GNU Lesser General Public                     *
+ *   License as published by the Free Software Foundation; either                   *
+ *   version 2.1 of the License, or (at your option) any later version.             *
+ *                                                                                  *
+ *   This library is distributed in the hope that it will be useful,                *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of                 *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU              *
+ *   Lesser General Public License for more details.                                *
+ *                                                                                  *
+ *   You should have received a copy of the GNU Lesser General Public               *
+ *   License along with this library; if not, write to the Free Software            *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA *
+ ***********************************************************************************/
+// Implementation of `configurationmanager_interface.h` and
+// `datatransfer_interface.h` on top of FakeRing::Daemon
+#include <configurationmanager_interface.h>
+#include <datatransfer_interface.h>
+#include <account_const.h>
+
+// Std
+#include <algorithm>
+
+#include "daemon.h"
+
+using FakeRing::Daemon;
+using Lock = std::lock_guard<std::recursive_mutex>;
+
+namespace {
+
+Daemon& fake()
+{
+   return Daemon::instance();
+}
+
+/// Copy a member of an account, or return a default value
+template<typename T, typename F>
+T fromAccount(const std::string& accountID, F f, T fallback = {})
+{
+   Lock l(fake().m_Mutex);
+
+   if (auto a = fake().account(accountID))
+      return f(*a);
+
+   return fallback;
+}
+
+std::map<uint64_t, DRing::DataTransferInfo> transfers;
+uint64_t transferCounter = 0;
+
+} // anonymous namespace
+
+namespace DRing {
+
+/*****************************************************************************
+ *                                                                           *
+ *                                  Accounts                                 *
+ *                                                                           *
+ ****************************************************************************/
+
+std::map<std::string, std::string> getAccountDetails(const std::string& accountID)
+{
+   return fromAccount<std::map<std::string, std::string>>(accountID, [](const Daemon::Account& a) {
+      return a.details;
+   });
+}
+
+std::map<std::string, std::string> getVolatileAccountDetails(const std::string& accountID)
+{
+   return fromAccount<std::map<std::string, std::string>>(accountID, [](const Daemon::Account& a) {
+      return a.volatileDetails;
+   });
+}
+
+void setAccountDetails(const std::string& accountID, const std::map<std::string, std::string>& details)
+{
+   {
+      Lock l(fake().m_Mutex);
+      auto a = fake().account(accountID);
+
+      if (!a)
+         return;
+
+      for (const auto& p : details)
+         a->details[p.first] = p.second;
+   }
+
+   fake().post([]() {
+      fake().emitSignal<ConfigurationSignal::AccountsChanged>();
+   });
+}
+
+std::map<std::string, std::string> getAccountTemplate(const std::string& accountType)
+{
+   return {
+      { Account::ConfProperties::TYPE   , accountType },
+      { Account::ConfProperties::ENABLED, "true"      },
+   };
+}
+
+std::string addAccount(const std::map<std::string, std::string>& details)
+{
+   std::string id;
+
+   {
+      Lock l(fake().m_Mutex);
+
+      const auto type = details.find(Account::ConfProperties::TYPE);
+      auto& a = fake().createAccount(
+         type == details.end() ? std::string(Account::ProtocolNames::RING) : type->second,
+         "New account"
+      );
+
+      for (const auto& p : details)
+         a.details[p.first] = p.second;
+
+      id = a.id;
+   }
+
+   fake().post([]() {
+      fake().emitSignal<ConfigurationSignal::AccountsChanged>();
+   });
+
+   return id;
+}
+
+void removeAccount(const std::string& accountID)
+{
+   {
+      Lock l(fake().m_Mutex);
+      auto& order = fake().m_lAccountOrder;
+
+      fake().m_hAccounts.erase(accountID);
+      order.erase(std::remove(order.begin(), order.end(), accountID), order.end());
+   }
+
+   fake().post([]() {
+      fake().emitSignal<ConfigurationSignal::AccountsChanged>();
+   });
+}
+
+std::vector<std::string> getAccountList()
+{
+   Lock l(fake().m_Mutex);
+   return fake().m_lAccountOrder;
+}
+
+void setAccountsOrder(const std::string& order)
+{
+   std::vector<std::string> ret;
+   std::string::size_type begin = 0, end;
+
+   Lock l(fake().m_Mutex);
+
+   while ((end = order.find('/', begin)) != std::string::npos) {
+      const auto id = order.substr(begin, end - begin);
+
+      if (fake().account(id))
+         ret.push_back(id);
+
+      begin = end + 1;
+   }
+
+   if (begin < order.size() && fake().account(order.substr(begin)))
+      ret.push_back(order.substr(begin));
+
+   // Keep the accounts missing from the new order
+   for (const auto& id : fake().m_lAccountOrder) {
+      if (std::find(ret.begin(), ret.end(), id) == ret.end())
+         ret.push_back(id);
+   }
+
+   fake().m_lAccountOrder = ret;
+}
+
+void sendRegister(const std::string& accountID, bool enable)
+{
+   {
+      Lock l(fake().m_Mutex);
+      auto a = fake().account(accountID);
+
+      if (!a)
+         return;
+
+      a->details[Account::ConfProperties::ENABLED] = enable ? "true" : "false";
+   }
+
+   fake().post([accountID, enable]() {
+      fake().setRegistrationState(accountID, Account::States::TRYING);
+      fake().setRegistrationState(accountID,
+         enable ? Account::States::REGISTERED : Account::States::UNREGISTERED
+      );
+   });
+}
+
+void registerAllAccounts()
+{
+   for (const auto& id : getAccountList())
+      sendRegister(id, true);
+}
+
+void connectivityChanged()
+{
+   // Like the real daemon, every account goes through a new registration
+   registerAllAccounts();
+}
+
+bool changeAccountPassword(const std::string& accountID, const std::string& password_old, const std::string& password_new)
+{
+   (void) password_old; (void) password_new;
+   return fromAccount<bool>(accountID, [](const Daemon::Account&) { return true; });
+}
+
+bool exportOnRing(const std::string& accountID, const std::string& password)
+{
+   (void) password;
+
+   fake().post([accountID]() {
+      fake().emitSignal<ConfigurationSignal::ExportOnRingEnded>(accountID, 0, std::string("fakepin"));
+   });
+
+   return true;
+}
+
+int exportAccounts(const std::vector<std::string>& accountIDs, const std::string& filepath, const std::string& password)
+{
+   (void) accountIDs; (void) filepath; (void) password;
+   return 0;
+}
+
+int importAccounts(const std::string& archivePath, const std::string& password)
+{
+   (void) archivePath; (void) password;
+   return 0;
+}
+
+std::map<std::string, std::string> getKnownRingDevices(const std::string& accountID)
+{
+   return fromAccount<std::map<std::string, std::string>>(accountID, [](const Daemon::Account& a) {
+      return std::map<std::string, std::string> {{ a.id, "Fake device" }};
+   });
+}
+
+bool revokeDevice(const std::string& accountID, const std::string& password, const std::string& deviceID)
+{
+   (void) accountID; (void) password; (void) deviceID;
+   return false;
+}
+
+bool lookupName(const std::string& account, const std::string& nameserver, const std::string& name)
+{
+   (void) nameserver;
+
+   fake().post([account, name]() {
+      // 2 is "not found"
+      fake().emitSignal<ConfigurationSignal::RegisteredNameFound>(account, 2, std::string(), name);
+   });
+
+   return true;
+}
+
+bool lookupAddress(const std::string& account, const std::string& nameserver, const std::string& address)
+{
+   (void) nameserver;
+
+   fake().post([account, address]() {
+      fake().emitSignal<ConfigurationSignal::RegisteredNameFound>(account, 2, address, std::string());
+   });
+
+   return true;
+}
+
+bool registerName(const std::string& account, const std::string& password, const std::string& name)
+{
+   (void) password;
+
+   fake().post([account, name]() {
+      fake().emitSignal<ConfigurationSignal::NameRegistrationEnded>(account, 0, name);
+   });
+
+   return true;
+}
+
+std::vector<std::map<std::string, std::string>> getCredentials(const std::string& accountID)
+{
+   return fromAccount<std::vector<std::map<std::string, std::string>>>(accountID, [](const Daemon::Account& a) {
+      return a.credentials;
+   });
+}
+
+void setCredentials(const std::string& accountID, const std::vector<std::map<std::string, std::string>>& details)
+{
+   Lock l(fake().m_Mutex);
+
+   if (auto a = fake().account(accountID))
+      a->credentials = details;
+}
+
+void enableProxyClient(const std::string& accountID, bool enable)
+{
+   (void) accountID; (void) enable;
+}
+
+void setPushNotificationToken(const std::string& pushDeviceToken)
+{
+   (void) pushDeviceToken;
+}
+
+void pushNotificationReceived(const std::string& from, const std::map<std::string, std::string>& data)
+{
+   (void) from; (void) data;
+}
+
+/*****************************************************************************
+ *                                                                           *
+ *                                  Contacts                                 *
+ *                                                                           *
+ ****************************************************************************/
+
+std::vector<std::map<std::string, std::string>> getContacts(const std::string& accountId)
+{
+   return fromAccount<std::vector<std::map<std::string, std::string>>>(accountId, [](const Daemon::Account& a) {
+      std::vector<std::map<std::string, std::string>> ret;
+      ret.reserve(a.contacts.size());
+
+      for (const auto& c : a.contacts) {
+         ret.push_back({
+            { "id"       , c.uri                    },
+            { "added"    , std::to_string(c.added)  },
+            { "confirmed", "true"                   },
+         });
+      }
+
+      return ret;
+   });
+}
+
+std::map<std::string, std::string> getContactDetails(const std::string& accountId, const std::string& uri)
+{
+   return fromAccount<std::map<std::string, std::string>>(accountId, [&uri](const Daemon::Account& a) {
+      for (const auto& c : a.contacts) {
+         if (c.uri == uri)
+            return std::map<std::string, std::string> {
+               { "id"       , c.uri                   },
+               { "added"    , std::to_string(c.added) },
+               { "confirmed", "true"                  },
+            };
+      }
+      return std::map<std::string, std::string>();
+   });
+}
+
+void addContact(const std::string& accountId, const std::string& uri)
+{
+   {
+      Lock l(fake().m_Mutex);
+      auto a = fake().account(accountId);
+
+      if (!a)
+         return;
+
+      a->contacts.push_back({uri, std::string(), false, time(nullptr)});
+   }
+
+   fake().post([accountId, uri]() {
+      fake().emitSignal<ConfigurationSignal::ContactAdded>(accountId, uri, true);
+   });
+}
+
+void removeContact(const std::string& accountId, const std::string& uri, bool ban)
+{
+   {
+      Lock l(fake().m_Mutex);
+      auto a = fake().account(accountId);
+
+      if (!a)
+         return;
+
+      a->contacts.erase(std::remove_if(a->contacts.begin(), a->contacts.end(),
+         [&uri](const Daemon::Contact& c) { return c.uri == uri; }
+      ), a->contacts.end());
+   }
+
+   fake().post([accountId, uri, ban]() {
+      fake().emitSignal<ConfigurationSignal::ContactRemoved>(accountId, uri, ban);
+   });
+}
+
+std::vector<std::map<std::string, std::string>> getTrustRequests(const std::string& accountId)
+{
+   return fromAccount<std::vector<std::map<std::string, std::string>>>(accountId, [](const Daemon::Account& a) {
+      return a.trustRequests;
+   });
+}
+
+bool acceptTrustRequest(const std::string& accountId, const std::string& from)
+{
+   bool found = false;
+
+   {
+      Lock l(fake().m_Mutex);
+      auto a = fake().account(accountId);
+
+      if (!a)
+         return false;
+
+      auto& requests = a->trustRequests;
+      const auto it = std::remove_if(requests.begin(), requests.end(),
+         [&from](const std::map<std::string, std::string>& r) { return r.at("from") == from; }
+      );
+
+      found = it != requests.end();
+      requests.erase(it, requests.end());
+   }
+
+   if (found)
+      addContact(accountId, from);
+
+   return found;
+}
+
+bool discardTrustRequest(const std::string& accountId, const std::string& from)
+{
+   Lock l(fake().m_Mutex);
+   auto a = fake().account(accountId);
+
+   if (!a)
+      return false;
+
+   auto& requests = a->trustRequests;
+   const auto it = std::remove_if(requests.begin(), requests.end(),
+      [&from](const std::map<std::string, std::string>& r) { return r.at("from") == from; }
+   );
+
+   const bool found = it != requests.end();
+   requests.erase(it, requests.end());
+
+   return found;
+}
+
+void sendTrustRequest(const std::string& accountId, const std::string& to, const std::vector<uint8_t>& payload)
+{
+   (void) payload;
+   addContact(accountId, to);
+}
+
+/*****************************************************************************
+ *                                                                           *
+ *                                  Messages                                 *
+ *                                                                           *
+ ****************************************************************************/
+
+uint64_t sendAccountTextMessage(const std::string& accountID, const std::string& to, const std::map<std::string, std::string>& payloads)
+{
+   (void) payloads;
+   uint64_t id;
+
+   {
+      Lock l(fake().m_Mutex);
+      id = ++fake().m_MessageCounter;
+      fake().m_hMessageStatus[id] = static_cast<int>(Account::MessageStates::SENDING);
+   }
+
+   fake().post([accountID, to, id]() {
+      {
+         Lock l(fake().m_Mutex);
+         fake().m_hMessageStatus[id] = static_cast<int>(Account::MessageStates::SENT);
+      }
+
+      fake().record(FakeRing::EventKind::MESSAGE_STATUS);
+      fake().emitSignal<ConfigurationSignal::AccountMessageStatusChanged>(
+         accountID, id, to, static_cast<int>(Account::MessageStates::SENT)
+      );
+   });
+
+   return id;
+}
+
+std::vector<Message> getLastMessages(const std::string& accountID, const uint64_t& base_timestamp)
+{
+   (void) accountID; (void) base_timestamp;
+   return {};
+}
+
+int getMessageStatus(uint64_t id)
+{
+   Lock l(fake().m_Mutex);
+   const auto it = fake().m_hMessageStatus.find(id);
+
+   return it == fake().m_hMessageStatus.end() ?
+      static_cast<int>(Account::MessageStates::UNKNOWN) : it->second;
+}
+
+/*****************************************************************************
+ *                                                                           *
+ *                                   Codecs                                  *
+ *                                                                           *
+ ****************************************************************************/
+
+// The same identifiers are used for all accounts
+static const std::vector<std::map<std::string, std::string>> codecs {
+   {
+      { Account::ConfProperties::CodecInfo::NAME       , "opus"  },
+      { Account::ConfProperties::CodecInfo::TYPE       , "AUDIO" },
+      { Account::ConfProperties::CodecInfo::SAMPLE_RATE, "48000" },
+   },
+   {
+      { Account::ConfProperties::CodecInfo::NAME       , "G722"  },
+      { Account::ConfProperties::CodecInfo::TYPE       , "AUDIO" },
+      { Account::ConfProperties::CodecInfo::SAMPLE_RATE, "16000" },
+   },
+   {
+      { Account::ConfProperties::CodecInfo::NAME       , "H264"  },
+      { Account::ConfProperties::CodecInfo::TYPE       , "VIDEO" },
+      { Account::ConfProperties::CodecInfo::BITRATE    , "800"   },
+   },
+};
+
+std::vector<unsigned> getCodecList()
+{
+   return {1, 2, 3};
+}
+
+std::map<std::string, std::string> getCodecDetails(const std::string& accountID, const unsigned& codecId)
+{
+   (void) accountID;
+
+   if (codecId < 1 || codecId > codecs.size())
+      return {};
+
+   return codecs[codecId - 1];
+}
+
+bool setCodecDetails(const std::string& accountID, const unsigned& codecId, const std::map<std::string, std::string>& details)
+{
+   (void) accountID; (void) details;
+   return codecId >= 1 && codecId <= codecs.size();
+}
+
+std::vector<unsigned> getActiveCodecList(const std::string& accountID)
+{
+   (void) accountID;
+   return getCodecList();
+}
+
+void setActiveCodecList(const std::string& accountID, const std::vector<unsigned>& list)
+{
+   (void) accountID; (void) list;
+}
+
+/*****************************************************************************
+ *                                                                           *
+ *                                   Audio                                   *
+ *                                                                           *
+ ****************************************************************************/
+
+std::vector<std::string> getAudioPluginList()
+{
+   return {"default"};
+}
+
+void setAudioPlugin(const std::string& audioPlugin)
+{
+   (void) audioPlugin;
+}
+
+std::vector<std::string> getAudioOutputDeviceList()
+{
+   return {"Fake output"};
+}
+
+void setAudioOutputDevice(int32_t index)
+{
+   (void) index;
+}
+
+void setAudioInputDevice(int32_t index)
+{
+   (void) index;
+}
+
+void setAudioRingtoneDevice(int32_t index)
+{
+   (void) index;
+}
+
+std::vector<std::string> getAudioInputDeviceList()
+{
+   return {"Fake input"};
+}
+
+std::vector<std::string> getCurrentAudioDevicesIndex()
+{
+   return {"0", "0", "0"};
+}
+
+int32_t getAudioInputDeviceIndex(const std::string& name)
+{
+   return name == "Fake input" ? 0 : -1;
+}
+
+int32_t getAudioOutputDeviceIndex(const std::string& name)
+{
+   return name == "Fake output" ? 0 : -1;
+}
+
+std::string getCurrentAudioOutputPlugin()
+{
+   return "default";
+}
+
+bool getNoiseSuppressState()
+{
+   Lock l(fake().m_Mutex);
+   return fake().m_NoiseSuppress;
+}
+
+void setNoiseSuppressState(bool state)
+{
+   Lock l(fake().m_Mutex);
+   fake().m_NoiseSuppress = state;
+}
+
+bool isAgcEnabled()
+{
+   Lock l(fake().m_Mutex);
+   return fake().m_Agc;
+}
+
+void setAgcState(bool enabled)
+{
+   Lock l(fake().m_Mutex);
+   fake().m_Agc = enabled;
+}
+
+void muteDtmf(bool mute)
+{
+   Lock l(fake().m_Mutex);
+   fake().m_DtmfMuted = mute;
+}
+
+bool isDtmfMuted()
+{
+   Lock l(fake().m_Mutex);
+   return fake().m_DtmfMuted;
+}
+
+bool isCaptureMuted()
+{
+   Lock l(fake().m_Mutex);
+   return fake().m_CaptureMuted;
+}
+
+void muteCapture(bool mute)
+{
+   Lock l(fake().m_Mutex);
+   fake().m_CaptureMuted = mute;
+}
+
+bool isPlaybackMuted()
+{
+   Lock l(fake().m_Mutex);
+   return fake().m_PlaybackMuted;
+}
+
+void mutePlayback(bool mute)
+{
+   Lock l(fake().m_Mutex);
+   fake().m_PlaybackMuted = mute;
+}
+
+std::string getAudioManager()
+{
+   return "fake";
+}
+
+bool setAudioManager(const std::string& api)
+{
+   return api == "fake";
+}
+
+void setVolume(const std::string& device, double value)
+{
+   fake().post([device, value]() {
+      fake().emitSignal<ConfigurationSignal::VolumeChanged>(device, value);
+   });
+}
+
+double getVolume(const std::string& device)
+{
+   (void) device;
+   return 1.0;
+}
+
+/*****************************************************************************
+ *                                                                           *
+ *                                  Settings                                 *
+ *                                                                           *
+ ****************************************************************************/
+
+std::string getRecordPath()
+{
+   Lock l(fake().m_Mutex);
+   return fake().m_RecordPath;
+}
+
+void setRecordPath(const std::string& recPath)
+{
+   Lock l(fake().m_Mutex);
+   fake().m_RecordPath = recPath;
+}
+
+bool getIsAlwaysRecording()
+{
+   Lock l(fake().m_Mutex);
+   return fake().m_AlwaysRecording;
+}
+
+void setIsAlwaysRecording(bool rec)
+{
+   Lock l(fake().m_Mutex);
+   fake().m_AlwaysRecording = rec;
+}
+
+void setHistoryLimit(int32_t days)
+{
+   Lock l(fake().m_Mutex);
+   fake().m_HistoryLimit = days;
+}
+
+int32_t getHistoryLimit()
+{
+   Lock l(fake().m_Mutex);
+   return fake().m_HistoryLimit;
+}
+
+std::map<std::string, std::string> getHookSettings()
+{
+   Lock l(fake().m_Mutex);
+   return fake().m_hHookSettings;
+}
+
+void setHookSettings(const std::map<std::string, std::string>& settings)
+{
+   Lock l(fake().m_Mutex);
+   fake().m_hHookSettings = settings;
+}
+
+std::map<std::string, std::string> getShortcuts()
+{
+   Lock l(fake().m_Mutex);
+   return fake().m_hShortcuts;
+}
+
+void setShortcuts(const std::map<std::string, std::string>& shortcutsMap)
+{
+   Lock l(fake().m_Mutex);
+   fake().m_hShortcuts = shortcutsMap;
+}
+
+/*****************************************************************************
+ *                                                                           *
+ *                                  Network                                  *
+ *                                                                           *
+ ****************************************************************************/
+
+std::string getAddrFromInterfaceName(const std::string& interface)
+{
+   return interface == "lo" ? "127.0.0.1" : std::string();
+}
+
+std::vector<std::string> getAllIpInterface()
+{
+   return {"127.0.0.1"};
+}
+
+std::vector<std::string> getAllIpInterfaceByName()
+{
+   return {"lo"};
+}
+
+/*****************************************************************************
+ *                                                                           *
+ *                                Certificates                               *
+ *                                                                           *
+ ****************************************************************************/
+
+std::map<std::string, std::string> getTlsDefaultSettings()
+{
+   return {};
+}
+
+std::vector<std::string> getSupportedTlsMethod()
+{
+   return {"Default"};
+}
+
+std::vector<std::string> getSupportedCiphers(const std::string& accountID)
+{
+   (void) accountID;
+   return {};
+}
+
+std::map<std::string, std::string> validateCertificate(const std::string& accountId, const std::string& certificate)
+{
+   (void) accountId; (void) certificate;
+   return {};
+}
+
+std::map<std::string, std::string> validateCertificatePath(const std::string& accountId,
+   const std::string& certificatePath, const std::string& privateKey, const std::string& privateKeyPassword,
+   const std::string& caList)
+{
+   (void) accountId; (void) certificatePath; (void) privateKey; (void) privateKeyPassword; (void) caList;
+   return {};
+}
+
+std::map<std::string, std::string> getCertificateDetails(const std::string& certificate)
+{
+   (void) certificate;
+   return {};
+}
+
+std::map<std::string, std::string> getCertificateDetailsPath(const std::string& certificatePath,
+   const std::string& privateKey, const std::string& privateKeyPassword)
+{
+   (void) certificatePath; (void) privateKey; (void) privateKeyPassword;
+   return {};
+}
+
+std::vector<std::string> getPinnedCertificates()
+{
+   return {};
+}
+
+std::vector<std::string> pinCertificate(const std::vector<uint8_t>& certificate, bool local)
+{
+   (void) certificate; (void) local;
+   return {};
+}
+
+bool unpinCertificate(const std::string& certId)
+{
+   (void) certId;
+   return false;
+}
+
+void pinCertificatePath(const std::string& path)
+{
+   (void) path;
+}
+
+unsigned unpinCertificatePath(const std::string& path)
+{
+   (void) path;
+   return 0;
+}
+
+bool pinRemoteCertificate(const std::string& accountId, const std::string& certId)
+{
+   (void) accountId; (void) certId;
+   return false;
+}
+
+bool setCertificateStatus(const std::string& account, const std::string& certId, const std::string& status)
+{
+   fake().post([account, certId, status]() {
+      fake().emitSignal<ConfigurationSignal::CertificateStateChanged>(account, certId, status);
+   });
+
+   return true;
+}
+
+std::vector<std::string> getCertificatesByStatus(const std::string& account, const std::string& status)
+{
+   (void) account; (void) status;
+   return {};
+}
+
+/*****************************************************************************
+ *                                                                           *
+ *                               Data transfer                               *
+ *                                                                           *
+ ****************************************************************************/
+
+std::vector<DataTransferId> dataTransferList() noexcept
+{
+   Lock l(fake().m_Mutex);
+   std::vector<DataTransferId> ret;
+
+   for (const auto& t : transfers)
+      ret.push_back(t.first);
+
+   return ret;
+}
+
+DataTransferError sendFile(const DataTransferInfo& info, DataTransferId& id) noexcept
+{
+   {
+      Lock l(fake().m_Mutex);
+      id = ++transferCounter;
+      transfers[id] = info;
+      transfers[id].lastEvent = DataTransferEventCode::created;
+   }
+
+   fake().post([id]() {
+      fake().emitSignal<DataTransferSignal::DataTransferEvent>(
+         id, static_cast<uint32_t>(DataTransferEventCode::created)
+      );
+   });
+
+   return DataTransferError::success;
+}
+
+DataTransferError acceptFileTransfer(const DataTransferId& id, const std::string& file_path, int64_t offset) noexcept
+{
+   (void) offset;
+   Lock l(fake().m_Mutex);
+   const auto it = transfers.find(id);
+
+   if (it == transfers.end())
+      return DataTransferError::invalid_argument;
+
+   it->second.path = file_path;
+   return DataTransferError::success;
+}
+
+DataTransferError cancelDataTransfer(const DataTransferId& id) noexcept
+{
+   Lock l(fake().m_Mutex);
+   return transfers.erase(id) ? DataTransferError::success : DataTransferError::invalid_argument;
+}
+
+DataTransferError dataTransferInfo(const DataTransferId& id, DataTransferInfo& info) noexcept
+{
+   Lock l(fake().m_Mutex);
+   const auto it = transfers.find(id);
+
+   if (it == transfers.end())
+      return DataTransferError::invalid_argument;
+
+   info = it->second;
+   return DataTransferError::success;
+}
+
+DataTransferError dataTransferBytesProgress(const DataTransferId& id, int64_t& total, int64_t& progress) noexcept
+{
+   Lock l(fake().m_Mutex);
+   const auto it = transfers.find(id);
+
+   if (it == transfers.end())
+      return DataTransferError::invalid_argument;
+
+   total    = it->second.totalSize;
+   progress = it->second.bytesProgress;
+   return DataTransferError::success;
+}
+
+} // namespace DRing
@@ -0,0 +1,649 @@
+/************************************************************************************
+ *   Copyright (C) 2018 by BlueSystems GmbH                                         *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                            *
+ *                                                                                  *
+ *   This library is free software; you can redistribute it and/or                  *
+ *   modify it under the terms of the GNU Lesser General Public                     *
+ *   License as published by the Free Software Foundation; either                   *
+ *   version 2.1 of the License, or (at your option) any later version.             *
+ *                                                                                  *
+ *   This library is distributed in the hope that it will be useful,                *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of                 *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU              *
+ *   Lesser General Public License for more details.                                *
+ *                                                                                  *
+ *   You should have received a copy of the GNU Lesser General Public               *
+ *   License along with this library; if not, write to the Free Software            *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA *
+ ***********************************************************************************/
+#include "daemon.h"
+
+// Std
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// Ring
+#include <account_const.h>
+#include <call_const.h>
+#include <callmanager_interface.h>
+#include <configurationmanager_interface.h>
+#include <presencemanager_interface.h>
+
+namespace FakeRing {
+
+Daemon::Daemon() : m_Random(0)
+{}
+
+Daemon::~Daemon()
+{
+   stop();
+}
+
+Daemon& Daemon::instance()
+{
+   static auto instance = new Daemon();
+   return *instance;
+}
+
+void Daemon::init(int flags)
+{
+   m_Flags = flags;
+}
+
+bool Daemon::start()
+{
+   if (m_Running.exchange(true))
+      return true;
+
+   m_LoopThread = std::thread(&Daemon::loop, this);
+
+   // The script can be provided by the environment to run unmodified clients
+   if (const char* path = std::getenv("FAKERING_SCRIPT")) {
+      Script s;
+      std::string error;
+
+      if (!s.load(path, &error)) {
+         fprintf(stderr, "fakering: %s\n", error.c_str());
+         return false;
+      }
+
+      load(s);
+
+      if (std::getenv("FAKERING_AUTOPLAY"))
+         post([this]() { play(); }, 1000);
+   }
+
+   return true;
+}
+
+void Daemon::stop()
+{
+   waitForFinished();
+
+   {
+      std::lock_guard<std::mutex> l(m_VideoMutex);
+      for (auto& p : m_hProducers)
+         p.second->running = false;
+   }
+
+   for (auto& p : m_hProducers) {
+      if (p.second->thread.joinable())
+         p.second->thread.join();
+   }
+   m_hProducers.clear();
+
+   if (m_Running.exchange(false)) {
+      m_LoopCondition.notify_all();
+      if (m_LoopThread.joinable())
+         m_LoopThread.join();
+   }
+}
+
+void Daemon::setHandlers(const std::map<std::string, std::shared_ptr<DRing::CallbackWrapperBase>>& handlers)
+{
+   std::lock_guard<std::mutex> l(m_HandlersMutex);
+
+   for (const auto& h : handlers)
+      m_hHandlers[h.first] = h.second;
+}
+
+void Daemon::clearHandlers()
+{
+   std::lock_guard<std::mutex> l(m_HandlersMutex);
+   m_hHandlers.clear();
+}
+
+/*****************************************************************************
+ *                                                                           *
+ *                                 Main loop                                 *
+ *                                                                           *
+ ****************************************************************************/
+
+void Daemon::post(std::function<void()> f, int delayMs)
+{
+   {
+      std::lock_guard<std::mutex> l(m_LoopMutex);
+      m_lTasks.push_back({
+         Clock::now() + std::chrono::milliseconds(delayMs), m_TaskCounter++, std::move(f)
+      });
+   }
+
+   m_LoopCondition.notify_one();
+}
+
+void Daemon::loop()
+{
+   std::unique_lock<std::mutex> l(m_LoopMutex);
+
+   while (m_Running) {
+      if (m_lTasks.empty()) {
+         m_LoopCondition.wait(l);
+         continue;
+      }
+
+      // Earliest first, then in the posting order
+      const auto next = std::min_element(m_lTasks.begin(), m_lTasks.end(),
+         [](const Task& a, const Task& b) {
+            return a.when < b.when || (a.when == b.when && a.order < b.order);
+      });
+
+      if (next->when > Clock::now()) {
+         m_LoopCondition.wait_until(l, next->when);
+         continue;
+      }
+
+      auto f = std::move(next->f);
+      m_lTasks.erase(next);
+
+      l.unlock();
+      f();
+      l.lock();
+   }
+}
+
+/*****************************************************************************
+ *                                                                           *
+ *                                   State                                   *
+ *                                                                           *
+ ****************************************************************************/
+
+std::string Daemon::newId(int hexDigits)
+{
+   static const char digits[] = "0123456789abcdef";
+   std::string ret(hexDigits, '0');
+
+   for (int i = 0; i < hexDigits; i++)
+      ret[i] = digits[m_Random() % 16];
+
+   return ret;
+}
+
+Daemon::Account* Daemon::account(const std::string& id)
+{
+   const auto it = m_hAccounts.find(id);
+   return it == m_hAccounts.end() ? nullptr : &it->second;
+}
+
+Daemon::Call* Daemon::call(const std::string& id)
+{
+   const auto it = m_hCalls.find(id);
+   return it == m_hCalls.end() ? nullptr : &it->second;
+}
+
+Daemon::Account& Daemon::createAccount(const std::string& type, const std::string& alias)
+{
+   using namespace DRing::Account;
+
+   const bool isRing = type != ProtocolNames::SIP;
+
+   Account a;
+   a.id = newId(16);
+
+   a.details = {
+      { ConfProperties::TYPE                 , isRing ? ProtocolNames::RING : ProtocolNames::SIP },
+      { ConfProperties::ALIAS                , alias                                             },
+      { ConfProperties::ENABLED              , "true"                                            },
+      { ConfProperties::USERNAME             , isRing ? "ring:" + newId(40) : "user" + a.id      },
+      { ConfProperties::HOSTNAME             , isRing ? "bootstrap.ring.cx" : "sip.example.com"  },
+      { ConfProperties::Registration::STATUS , States::REGISTERED                                },
+   };
+
+   a.volatileDetails = {
+      { VolatileProperties::Registration::STATUS, States::REGISTERED },
+      { VolatileProperties::Transport::STATE_CODE, "0"               },
+      { VolatileProperties::Transport::STATE_DESC, "OK"              },
+   };
+
+   m_lAccountOrder.push_back(a.id);
+   return m_hAccounts[a.id] = a;
+}
+
+Daemon::Call& Daemon::createCall(const std::string& accountId, const std::string& peer, bool incoming)
+{
+   Call c;
+   c.id        = newId(20);
+   c.accountId = accountId;
+   c.peer      = peer;
+   c.incoming  = incoming;
+   c.start     = time(nullptr);
+   c.state     = incoming ? DRing::Call::StateEvent::INCOMING : DRing::Call::StateEvent::CONNECTING;
+
+   return m_hCalls[c.id] = c;
+}
+
+void Daemon::setRegistrationState(const std::string& accountId, const std::string& state, int code)
+{
+   using namespace DRing::Account;
+
+   std::map<std::string, std::string> details;
+
+   {
+      std::lock_guard<std::recursive_mutex> l(m_Mutex);
+      auto a = account(accountId);
+
+      if (!a)
+         return;
+
+      a->details        [ ConfProperties::Registration::STATUS     ] = state;
+      a->volatileDetails[ VolatileProperties::Registration::STATUS ] = state;
+      details = a->volatileDetails;
+   }
+
+   record(EventKind::REGISTRATION);
+   emitSignal<DRing::ConfigurationSignal::RegistrationStateChanged>(accountId, state, code, std::string());
+
+   record(EventKind::VOLATILE_DETAILS);
+   emitSignal<DRing::ConfigurationSignal::VolatileDetailsChanged>(accountId, details);
+}
+
+void Daemon::setCallState(const std::string& callId, const std::string& state, int code)
+{
+   {
+      std::lock_guard<std::recursive_mutex> l(m_Mutex);
+      auto c = call(callId);
+
+      if (!c)
+         return;
+
+      if (state == DRing::Call::StateEvent::OVER)
+         m_hCalls.erase(callId);
+      else
+         c->state = state;
+   }
+
+   record(EventKind::CALL_STATE);
+   emitSignal<DRing::CallSignal::StateChange>(callId, state, code);
+}
+
+/*****************************************************************************
+ *                                                                           *
+ *                                   Script                                  *
+ *                                                                           *
+ ****************************************************************************/
+
+bool Daemon::load(const Script& script)
+{
+   if (m_Playing)
+      return false;
+
+   std::lock_guard<std::recursive_mutex> l(m_Mutex);
+
+   m_Script = script;
+
+   for (const auto& c : script.setup())
+      execute(c);
+
+   return true;
+}
+
+void Daemon::play()
+{
+   if (m_Playing.exchange(true))
+      return;
+
+   if (m_PlayerThread.joinable())
+      m_PlayerThread.join();
+
+   m_PlayerThread = std::thread([this]() {
+      m_Rate      = 0;
+      m_NextEvent = Clock::now();
+
+      for (const auto& c : m_Script.events())
+         execute(c);
+
+      m_Playing = false;
+   });
+}
+
+bool Daemon::isPlaying() const
+{
+   return m_Playing;
+}
+
+bool Daemon::waitForFinished(int timeoutMs)
+{
+   const auto deadline = Clock::now() + std::chrono::milliseconds(timeoutMs);
+
+   while (m_Playing) {
+      if (timeoutMs >= 0 && Clock::now() > deadline)
+         return false;
+
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+   }
+
+   if (m_PlayerThread.joinable())
+      m_PlayerThread.join();
+
+   return true;
+}
+
+void Daemon::throttle()
+{
+   if (m_Rate <= 0)
+      return;
+
+   m_NextEvent += std::chrono::microseconds(1000000 / m_Rate);
+   std::this_thread::sleep_until(m_NextEvent);
+}
+
+void Daemon::execute(const Script::Command& c)
+{
+   // Pick a random account and one of its contacts
+   const auto pick = [this](std::string& accountId, std::string& uri) -> bool {
+      std::lock_guard<std::recursive_mutex> l(m_Mutex);
+
+      if (m_lAccountOrder.empty())
+         return false;
+
+      accountId = m_lAccountOrder[m_Random() % m_lAccountOrder.size()];
+      auto& contacts = m_hAccounts[accountId].contacts;
+      uri = contacts.empty() ? newId(40) : contacts[m_Random() % contacts.size()].uri;
+
+      return true;
+   };
+
+   switch(c.type) {
+      case Script::Command::Type::SEED:
+         m_Random.seed(c.arg(0));
+         break;
+      case Script::Command::Type::ACCOUNTS: {
+         const std::string type = c.text.empty() ? DRing::Account::ProtocolNames::RING : c.text;
+         const int count = c.arg(0);
+
+         for (int i = 0; i < count; i++)
+            createAccount(type, "Fake account " + std::to_string(m_lAccountOrder.size() + 1));
+      }
+         break;
+      case Script::Command::Type::CONTACTS:
+         for (auto& a : m_hAccounts) {
+            for (int i = 0; i < c.arg(0); i++) {
+               a.second.contacts.push_back({
+                  newId(40), "Contact " + std::to_string(a.second.contacts.size() + 1), false, time(nullptr)
+               });
+            }
+         }
+         break;
+      case Script::Command::Type::RATE:
+         m_Rate      = c.arg(0);
+         m_NextEvent = Clock::now();
+         break;
+      case Script::Command::Type::WAIT:
+         std::this_thread::sleep_for(std::chrono::milliseconds(c.arg(0)));
+         m_NextEvent = Clock::now();
+         break;
+      case Script::Command::Type::REGISTRATION: {
+         std::vector<std::string> accounts;
+         {
+            std::lock_guard<std::recursive_mutex> l(m_Mutex);
+            accounts = m_lAccountOrder;
+         }
+
+         for (int i = 0; i < c.arg(0); i++) {
+            for (const auto& id : accounts) {
+               setRegistrationState(id, DRing::Account::States::TRYING);
+               throttle();
+            }
+            for (const auto& id : accounts) {
+               setRegistrationState(id, DRing::Account::States::REGISTERED);
+               throttle();
+            }
+         }
+      }
+         break;
+      case Script::Command::Type::CALLS: {
+         const int duration = c.arg(1);
+
+         for (int i = 0; i < c.arg(0); i++) {
+            std::string accountId, uri, callId;
+
+            if (!pick(accountId, uri))
+               return;
+
+            {
+               std::lock_guard<std::recursive_mutex> l(m_Mutex);
+               callId = createCall(accountId, uri, true).id;
+            }
+
+            record(EventKind::INCOMING_CALL);
+            emitSignal<DRing::CallSignal::IncomingCall>(accountId, callId, uri);
+            emitSignal<DRing::CallSignal::StateChange>(callId, std::string(DRing::Call::StateEvent::INCOMING), 0);
+
+            post([this, callId]() {
+               setCallState(callId, DRing::Call::StateEvent::HUNGUP);
+               setCallState(callId, DRing::Call::StateEvent::OVER  );
+            }, duration);
+
+            throttle();
+         }
+      }
+         break;
+      case Script::Command::Type::MESSAGES:
+         for (int i = 0; i < c.arg(0); i++) {
+            std::string accountId, uri;
+
+            if (!pick(accountId, uri))
+               return;
+
+            const std::map<std::string, std::string> payloads {
+               { "text/plain", "Message " + std::to_string(i) }
+            };
+
+            record(EventKind::INCOMING_MESSAGE);
+            emitSignal<DRing::ConfigurationSignal::IncomingAccountMessage>(accountId, uri, payloads);
+
+            throttle();
+         }
+         break;
+      case Script::Command::Type::STATUSES: {
+         // Each message goes through the usual transitions, so only one third
+         // of the events are for distinct messages.
+         static const std::array<int, 3> transitions {{
+            static_cast<int>(DRing::Account::MessageStates::SENDING),
+            static_cast<int>(DRing::Account::MessageStates::SENT   ),
+            static_cast<int>(DRing::Account::MessageStates::READ   ),
+         }};
+
+         std::string accountId, uri;
+         uint64_t id = 0;
+
+         for (int i = 0; i < c.arg(0); i++) {
+            if (i % 3 == 0) {
+               if (!pick(accountId, uri))
+                  return;
+
+               std::lock_guard<std::recursive_mutex> l(m_Mutex);
+               id = ++m_MessageCounter;
+            }
+
+            {
+               std::lock_guard<std::recursive_mutex> l(m_Mutex);
+               m_hMessageStatus[id] = transitions[i % 3];
+            }
+
+            record(EventKind::MESSAGE_STATUS);
+            emitSignal<DRing::ConfigurationSignal::AccountMessageStatusChanged>(
+               accountId, id, uri, transitions[i % 3]
+            );
+
+            throttle();
+         }
+      }
+         break;
+      case Script::Command::Type::PRESENCE:
+         for (int i = 0; i < c.arg(0); i++) {
+            std::string accountId, uri;
+            bool online = false;
+
+            if (!pick(accountId, uri))
+               return;
+
+            {
+               std::lock_guard<std::recursive_mutex> l(m_Mutex);
+               for (auto& contact : m_hAccounts[accountId].contacts) {
+                  if (contact.uri == uri) {
+                     online = contact.online = !contact.online;
+                     break;
+                  }
+               }
+            }
+
+            record(EventKind::PRESENCE);
+            emitSignal<DRing::PresenceSignal::NewBuddyNotification>(accountId, uri, online, std::string());
+
+            throttle();
+         }
+         break;
+      case Script::Command::Type::VIDEO:
+         startVideo("fakevideo" + std::to_string(c.line), c.arg(0), c.arg(1), c.arg(2), c.arg(3));
+         break;
+   }
+}
+
+/*****************************************************************************
+ *                                                                           *
+ *                                   Video                                   *
+ *                                                                           *
+ ****************************************************************************/
+
+void Daemon::setSink(const std::string& id, const DRing::SinkTarget& target)
+{
+   std::lock_guard<std::mutex> l(m_VideoMutex);
+
+   if (target.pull)
+      m_hSinks[id] = target;
+   else
+      m_hSinks.erase(id);
+}
+
+void Daemon::startVideo(const std::string& id, int width, int height, int fps, int durationMs)
+{
+   stopVideo(id);
+
+   auto producer = new VideoProducer();
+   producer->running = true;
+
+   {
+      std::lock_guard<std::mutex> l(m_VideoMutex);
+      m_hProducers[id].reset(producer);
+   }
+
+   emitSignal<DRing::VideoSignal::DecodingStarted>(id, std::string(), width, height, false);
+
+   producer->thread = std::thread([this, id, producer, width, height, fps, durationMs]() {
+      const auto interval = std::chrono::microseconds(1000000 / std::max(fps, 1));
+      const auto end      = Clock::now() + std::chrono::milliseconds(durationMs);
+      const size_t bytes  = static_cast<size_t>(width) * height * 4;
+      auto next           = Clock::now();
+      uint8_t frame       = 0;
+
+      while (producer->running && (durationMs <= 0 || Clock::now() < end)) {
+         DRing::SinkTarget sink;
+
+         {
+            std::lock_guard<std::mutex> l(m_VideoMutex);
+            const auto it = m_hSinks.find(id);
+            if (it != m_hSinks.end())
+               sink = it->second;
+         }
+
+         // The client registers the sink after receiving DecodingStarted
+         if (sink.pull && sink.push) {
+            if (auto buffer = sink.pull(bytes)) {
+               std::memset(buffer->ptr, frame++, buffer->ptrSize);
+               record(EventKind::VIDEO_FRAME);
+               sink.push(std::move(buffer));
+            }
+         }
+
+         next += interval;
+         std::this_thread::sleep_until(next);
+      }
+
+      producer->running = false;
+      emitSignal<DRing::VideoSignal::DecodingStopped>(id, std::string(), false);
+   });
+}
+
+void Daemon::stopVideo(const std::string& id)
+{
+   std::unique_ptr<VideoProducer> producer;
+
+   {
+      std::lock_guard<std::mutex> l(m_VideoMutex);
+      const auto it = m_hProducers.find(id);
+
+      if (it == m_hProducers.end())
+         return;
+
+      producer = std::move(it->second);
+      m_hProducers.erase(it);
+   }
+
+   producer->running = false;
+
+   if (producer->thread.joinable())
+      producer->thread.join();
+}
+
+bool Daemon::isVideoRunning(const std::string& id) const
+{
+   std::lock_guard<std::mutex> l(m_VideoMutex);
+   const auto it = m_hProducers.find(id);
+
+   return it != m_hProducers.end() && it->second->running;
+}
+
+/*****************************************************************************
+ *                                                                           *
+ *                                Statistics                                 *
+ *                                                                           *
+ ****************************************************************************/
+
+void Daemon::record(EventKind kind, int count)
+{
+   const auto now = Clock::now();
+
+   std::lock_guard<std::mutex> l(m_StatsMutex);
+   auto& list = m_lEmitted[static_cast<int>(kind)];
+
+   for (int i = 0; i < count; i++)
+      list.push_back(now);
+}
+
+std::vector<Daemon::Clock::time_point> Daemon::emitted(EventKind kind) const
+{
+   std::lock_guard<std::mutex> l(m_StatsMutex);
+   return m_lEmitted[static_cast<int>(kind)];
+}
+
+void Daemon::resetStatistics()
+{
+   std::lock_guard<std::mutex> l(m_StatsMutex);
+
+   for (auto& list : m_lEmitted)
+      list.clear();
+}
+
+} // namespace FakeRing
@@ -0,0 +1,240 @@
+/************************************************************************************
+ *   Copyright (C) 2018 by BlueSystems GmbH                                         *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                            *
+ *                                                                                  *
+ *   This library is free software; you can redistribute it and/or                  *
+ *   modify it under the terms of the GNU Lesser General Public                     *
+ *   License as published by the Free Software Foundation; either                   *
+ *   version 2.1 of the License, or (at your option) any later version.             *
+ *                                                                                  *
+ *   This library is distributed in the hope that it will be useful,                *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of                 *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU              *
+ *   Lesser General Public License for more details.                                *
+ *                                                                                  *
+ *   You should have received a copy of the GNU Lesser General Public               *
+ *   License along with this library; if not, write to the Free Software            *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA *
+ ***********************************************************************************/
+#pragma once
+
+// Std
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Ring
+#include <dring.h>
+#include <videomanager_interface.h>
+
+#include "script.h"
+
+namespace FakeRing {
+
+/**
+ * Kind of events emitted by the daemon, used to match what was emitted with
+ * what the client received when measuring the latency.
+ */
+enum class EventKind {
+   REGISTRATION     ,
+   VOLATILE_DETAILS ,
+   INCOMING_CALL    ,
+   CALL_STATE       ,
+   INCOMING_MESSAGE ,
+   MESSAGE_STATUS   ,
+   PRESENCE         ,
+   VIDEO_FRAME      ,
+   COUNT__
+};
+
+/**
+ * In-process stand-in for libring.
+ *
+ * It implements the subset of the `DRing::` API used by the `qtwrapper/`
+ * (see the `dring_*.cpp` files) on top of an in-memory state. That state is
+ * populated from a Script and the script events are replayed in a dedicated
+ * thread, like the real daemon would, so the client code paths are the same
+ * as in production.
+ *
+ * Asynchronous reactions to client requests (a call being answered, a
+ * message being sent) are executed in a second "main loop" thread.
+ */
+class Daemon final
+{
+public:
+   using Clock = std::chrono::steady_clock;
+
+   struct Contact {
+      std::string uri        ;
+      std::string displayName;
+      bool        online {false};
+      time_t      added  {0};
+   };
+
+   struct Account {
+      std::string                        id             ;
+      std::map<std::string, std::string> details        ;
+      std::map<std::string, std::string> volatileDetails;
+      std::vector<Contact>               contacts       ;
+      std::vector<std::map<std::string, std::string>> credentials;
+      std::vector<std::map<std::string, std::string>> trustRequests;
+   };
+
+   struct Call {
+      std::string id       ;
+      std::string accountId;
+      std::string peer     ;
+      std::string state    ;
+      bool        incoming {true};
+      bool        recording{false};
+      time_t      start    {0};
+   };
+
+   static Daemon& instance();
+
+   // Lifecycle (DRing::init/start/fini)
+   void init(int flags);
+   bool start();
+   void stop();
+
+   // Signal handlers (DRing::registerSignalHandlers)
+   void setHandlers(const std::map<std::string, std::shared_ptr<DRing::CallbackWrapperBase>>& handlers);
+   void clearHandlers();
+
+   template<typename Ts, typename... Args>
+   void emitSignal(Args&&... args);
+
+   // Script
+   bool load(const Script& script);
+   void play();
+   bool isPlaying() const;
+   bool waitForFinished(int timeoutMs = -1);
+
+   // Statistics
+   void record(EventKind kind, int count = 1);
+   std::vector<Clock::time_point> emitted(EventKind kind) const;
+   void resetStatistics();
+
+   // Main loop
+   void post(std::function<void()> f, int delayMs = 0);
+
+   // Video
+   void setSink(const std::string& id, const DRing::SinkTarget& target);
+   void startVideo(const std::string& id, int width, int height, int fps, int durationMs);
+   void stopVideo(const std::string& id);
+   bool isVideoRunning(const std::string& id) const;
+
+   // Helpers used by the API implementation, m_Mutex must be held
+   Account* account(const std::string& id);
+   Call*    call   (const std::string& id);
+   Account& createAccount(const std::string& type, const std::string& alias);
+   Call&    createCall(const std::string& accountId, const std::string& peer, bool incoming);
+   std::string newId(int hexDigits);
+
+   // Notify the client, m_Mutex must NOT be held
+   void setRegistrationState(const std::string& accountId, const std::string& state, int code = 0);
+   void setCallState(const std::string& callId, const std::string& state, int code = 0);
+
+   /// Protect the in-memory state
+   mutable std::recursive_mutex m_Mutex;
+
+   std::vector<std::string>          m_lAccountOrder;
+   std::map<std::string, Account>    m_hAccounts    ;
+   std::map<std::string, Call>       m_hCalls       ;
+   std::map<uint64_t, int>           m_hMessageStatus;
+   std::map<std::string, std::string> m_hHookSettings;
+   std::map<std::string, std::string> m_hShortcuts   ;
+   std::map<std::string, std::map<std::string, std::string>> m_hVideoSettings;
+   std::string                       m_DefaultVideoDevice {"fakecam"};
+   std::string                       m_RecordPath;
+   int                               m_HistoryLimit {30};
+   bool                              m_AlwaysRecording {false};
+   bool                              m_NoiseSuppress   {false};
+   bool                              m_Agc             {false};
+   bool                              m_CaptureMuted    {false};
+   bool                              m_PlaybackMuted   {false};
+   bool                              m_DtmfMuted       {false};
+   bool                              m_DecodingAccelerated {false};
+   uint64_t                          m_MessageCounter  {0};
+   int                               m_SmartInfoGeneration {0};
+
+private:
+   explicit Daemon();
+   ~Daemon();
+
+   void loop();
+   void execute(const Script::Command& c);
+   void throttle();
+
+   // Signal handlers
+   mutable std::mutex m_HandlersMutex;
+   std::map<std::string, std::shared_ptr<DRing::CallbackWrapperBase>> m_hHandlers;
+
+   // Main loop
+   struct Task {
+      Clock::time_point     when;
+      uint64_t              order;
+      std::function<void()> f;
+   };
+   std::mutex              m_LoopMutex;
+   std::condition_variable m_LoopCondition;
+   std::vector<Task>       m_lTasks;
+   uint64_t                m_TaskCounter {0};
+   std::thread             m_LoopThread;
+   std::atomic<bool>       m_Running {false};
+
+   // Script
+   Script            m_Script;
+   std::thread       m_PlayerThread;
+   std::atomic<bool> m_Playing {false};
+   std::mt19937_64   m_Random;
+   int               m_Rate {0};
+   Clock::time_point m_NextEvent;
+
+   // Video
+   struct VideoProducer {
+      std::thread       thread;
+      std::atomic<bool> running {false};
+   };
+   mutable std::mutex m_VideoMutex;
+   std::map<std::string, DRing::SinkTarget> m_hSinks;
+   std::map<std::string, std::unique_ptr<VideoProducer>> m_hProducers;
+
+   // Statistics
+   mutable std::mutex m_StatsMutex;
+   std::array<std::vector<Clock::time_point>, static_cast<int>(EventKind::COUNT__)> m_lEmitted;
+
+   int m_Flags {0};
+};
+
+template<typename Ts, typename... Args>
+void Daemon::emitSignal(Args&&... args)
+{
+   std::shared_ptr<DRing::CallbackWrapperBase> wrapper;
+
+   {
+      std::lock_guard<std::mutex> l(m_HandlersMutex);
+      const auto it = m_hHandlers.find(Ts::name);
+
+      if (it == m_hHandlers.end())
+         return;
+
+      wrapper = it->second;
+   }
+
+   const DRing::CallbackWrapper<typename Ts::cb_type> cb(wrapper);
+
+   if (cb)
+      (*cb)(std::forward<Args>(args)...);
+}
+
+} // namespace FakeRing
@@ -0,0 +1,54 @@
+/************************************************************************************
+ *   Copyright (C) 2018 by BlueSystems GmbH                                         *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                            *
+ *                                                                                  *
+ *   This library is free software; you can redistribute it and/or                  *
+ *   modify it under the terms of the GNU Lesser General Public                     *
+ *   License as published by the Free Software Foundation; either                   *
+ *   version 2.1 of the License, or (at your option) any later version.             *
+ *                                                                                  *
+ *   This library is distributed in the hope that it will be useful,                *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of                 *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU              *
+ *   Lesser General Public License for more details.                                *
+ *                                                                                  *
+ *   You should have received a copy of the GNU Lesser General Public               *
+ *   License along with this library; if not, write to the Free Software            *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA *
+ ***********************************************************************************/
+// Implementation of the `dring.h` lifecycle API on top of FakeRing::Daemon
+#include <dring.h>
+
+#include "daemon.h"
+
+namespace DRing {
+
+bool init(enum InitFlag flags) noexcept
+{
+   FakeRing::Daemon::instance().init(flags);
+   return true;
+}
+
+bool start(const std::string& config_file) noexcept
+{
+   (void) config_file;
+   return FakeRing::Daemon::instance().start();
+}
+
+void fini() noexcept
+{
+   FakeRing::Daemon::instance().stop();
+   FakeRing::Daemon::instance().clearHandlers();
+}
+
+void registerSignalHandlers(const std::map<std::string, std::shared_ptr<CallbackWrapperBase>>& handlers)
+{
+   FakeRing::Daemon::instance().setHandlers(handlers);
+}
+
+void unregisterSignalHandlers()
+{
+   FakeRing::Daemon::instance().clearHandlers();
+}
+
+} // namespace DRing
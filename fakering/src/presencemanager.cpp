@@ -0,0 +1,101 @@
+/************************************************************************************
+ *   Copyright (C) 2018 by BlueSystems GmbH                                         *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                            *
+ *                                                                                  *
+ *   This library is free software; you can redistribute it and/or                  *
+ *   modify it under the terms of the GNU Lesser General Public                     *
+ *   License as published by the Free Software Foundation; either                   *
+ *   version 2.1 of the License, or (at your option) any later version.             *
+ *                                                                                  *
+ *   This library is distributed in the hope that it will be useful,                *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of                 *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU              *
+ *   Lesser General Public License for more details.                                *
+ *                                                                                  *
+ *   You should have received a copy of the GNU Lesser General Public               *
+ *   License along with this library; if not, write to the Free Software            *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA *
+ ***********************************************************************************/
+// Implementation of `presencemanager_interface.h` on top of FakeRing::Daemon
+#include <presencemanager_interface.h>
+#include <presence_const.h>
+
+#include "daemon.h"
+
+using FakeRing::Daemon;
+using Lock = std::lock_guard<std::recursive_mutex>;
+
+namespace {
+
+Daemon& fake()
+{
+   return Daemon::instance();
+}
+
+} // anonymous namespace
+
+namespace DRing {
+
+void publish(const std::string& accountID, bool status, const std::string& note)
+{
+   (void) accountID; (void) status; (void) note;
+}
+
+void answerServerRequest(const std::string& uri, bool flag)
+{
+   (void) uri; (void) flag;
+}
+
+void subscribeBuddy(const std::string& accountID, const std::string& uri, bool flag)
+{
+   bool online = false;
+
+   {
+      Lock l(fake().m_Mutex);
+      auto a = fake().account(accountID);
+
+      if (!a)
+         return;
+
+      for (const auto& c : a->contacts) {
+         if (c.uri == uri) {
+            online = c.online;
+            break;
+         }
+      }
+   }
+
+   fake().post([accountID, uri, flag, online]() {
+      fake().emitSignal<PresenceSignal::SubscriptionStateChanged>(accountID, uri, flag);
+
+      if (flag) {
+         fake().record(FakeRing::EventKind::PRESENCE);
+         fake().emitSignal<PresenceSignal::NewBuddyNotification>(accountID, uri, online, std::string());
+      }
+   });
+}
+
+std::vector<std::map<std::string, std::string>> getSubscriptions(const std::string& accountID)
+{
+   Lock l(fake().m_Mutex);
+   std::vector<std::map<std::string, std::string>> ret;
+
+   if (auto a = fake().account(accountID)) {
+      for (const auto& c : a->contacts) {
+         ret.push_back({
+            { Presence::BUDDY_KEY , c.uri                                       },
+            { Presence::STATUS_KEY, c.online ? Presence::ONLINE_KEY : Presence::OFFLINE_KEY },
+         });
+      }
+   }
+
+   return ret;
+}
+
+void setSubscriptions(const std::string& accountID, const std::vector<std::string>& uris)
+{
+   for (const auto& uri : uris)
+      subscribeBuddy(accountID, uri, true);
+}
+
+} // namespace DRing
@@ -0,0 +1,194 @@
+/************************************************************************************
+ *   Copyright (C) 2018 by BlueSystems GmbH                                         *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                            *
+ *                                                                                  *
+ *   This library is free software; you can redistribute it and/or                  *
+ *   modify it under the terms of the GNU Lesser General Public                     *
+ *   License as published by the Free Software Foundation; either                   *
+ *   version 2.1 of the License, or (at your option) any later version.             *
+ *                                                                                  *
+ *   This library is distributed in the hope that it will be useful,                *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of                 *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU              *
+ *   Lesser General Public License for more details.                                *
+ *                                                                                  *
+ *   You should have received a copy of the GNU Lesser General Public               *
+ *   License along with this library; if not, write to the Free Software            *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA *
+ ***********************************************************************************/
+#include "script.h"
+
+// Std
+#include <fstream>
+#include <sstream>
+#include <map>
+
+namespace FakeRing {
+
+static const std::map<std::string, std::pair<Script::Command::Type, int>> commands = {
+   //  Name               Type                                   Minimum arguments
+   { "seed"         , { Script::Command::Type::SEED         , 1 }},
+   { "accounts"     , { Script::Command::Type::ACCOUNTS     , 1 }},
+   { "contacts"     , { Script::Command::Type::CONTACTS     , 1 }},
+   { "rate"         , { Script::Command::Type::RATE         , 1 }},
+   { "wait"         , { Script::Command::Type::WAIT         , 1 }},
+   { "registration" , { Script::Command::Type::REGISTRATION , 1 }},
+   { "calls"        , { Script::Command::Type::CALLS        , 1 }},
+   { "messages"     , { Script::Command::Type::MESSAGES     , 1 }},
+   { "statuses"     , { Script::Command::Type::STATUSES     , 1 }},
+   { "presence"     , { Script::Command::Type::PRESENCE     , 1 }},
+   { "video"        , { Script::Command::Type::VIDEO        , 4 }},
+};
+
+int Script::Command::arg(int idx, int fallback) const
+{
+   return idx < static_cast<int>(args.size()) ? args[idx] : fallback;
+}
+
+bool Script::Command::isSetup() const
+{
+   return type == Type::SEED || type == Type::ACCOUNTS || type == Type::CONTACTS;
+}
+
+bool Script::parse(const std::string& content, std::string* error)
+{
+   std::istringstream stream(content);
+   std::string line;
+   int lineNumber = 0;
+
+   m_lCommands.clear();
+
+   while (std::getline(stream, line)) {
+      lineNumber++;
+
+      const auto comment = line.find('#');
+      if (comment != std::string::npos)
+         line.resize(comment);
+
+      std::istringstream tokens(line);
+      std::string name;
+
+      if (!(tokens >> name))
+         continue;
+
+      const auto it = commands.find(name);
+
+      if (it == commands.end()) {
+         if (error)
+            *error = "Unknown command '" + name + "' on line " + std::to_string(lineNumber);
+         return false;
+      }
+
+      Command c {it->second.first, {}, {}, lineNumber};
+
+      std::string token;
+      while (tokens >> token) {
+         try {
+            c.args.push_back(std::stoi(token));
+         }
+         catch (const std::exception&) {
+            // The account type is the only non numeric argument
+            c.text = token;
+         }
+      }
+
+      if (static_cast<int>(c.args.size()) < it->second.second) {
+         if (error)
+            *error = "Missing arguments for '" + name + "' on line " + std::to_string(lineNumber);
+         return false;
+      }
+
+      m_lCommands.push_back(c);
+   }
+
+   return true;
+}
+
+bool Script::load(const std::string& path, std::string* error)
+{
+   std::ifstream file(path);
+
+   if (!file.is_open()) {
+      if (error)
+         *error = "Cannot open " + path;
+      return false;
+   }
+
+   std::stringstream content;
+   content << file.rdbuf();
+
+   return parse(content.str(), error);
+}
+
+Script Script::reconnectStorm()
+{
+   Script s;
+   s.parse(
+      "seed 1\n"
+      "accounts 5 RING\n"
+      "contacts 200\n"
+      "rate 0\n"
+      "registration 20\n"
+      "presence 5000\n"
+      "messages 500\n"
+      "statuses 500\n"
+      "calls 20 0\n"
+   );
+   return s;
+}
+
+std::vector<Script::Command> Script::setup() const
+{
+   std::vector<Command> ret;
+
+   for (const auto& c : m_lCommands) {
+      if (c.isSetup())
+         ret.push_back(c);
+   }
+
+   return ret;
+}
+
+std::vector<Script::Command> Script::events() const
+{
+   std::vector<Command> ret;
+
+   for (const auto& c : m_lCommands) {
+      if (!c.isSetup())
+         ret.push_back(c);
+   }
+
+   return ret;
+}
+
+int Script::eventCount() const
+{
+   int accounts = 0, count = 0;
+
+   for (const auto& c : m_lCommands) {
+      switch(c.type) {
+         case Command::Type::ACCOUNTS:
+            accounts += c.arg(0);
+            break;
+         case Command::Type::REGISTRATION:
+            count += c.arg(0) * accounts * 2;
+            break;
+         case Command::Type::CALLS:
+         case Command::Type::MESSAGES:
+         case Command::Type::STATUSES:
+         case Command::Type::PRESENCE:
+            count += c.arg(0);
+            break;
+         case Command::Type::SEED:
+         case Command::Type::CONTACTS:
+         case Command::Type::RATE:
+         case Command::Type::WAIT:
+         case Command::Type::VIDEO:
+            break;
+      }
+   }
+
+   return count;
+}
+
+} // namespace FakeRing
@@ -0,0 +1,95 @@
+/************************************************************************************
+ *   Copyright (C) 2018 by BlueSystems GmbH                                         *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                            *
+ *                                                                                  *
+ *   This library is free software; you can redistribute it and/or                  *
+ *   modify it under the terms of the GNU Lesser General Public                     *
+ *   License as published by the Free Software Foundation; either                   *
+ *   version 2.1 of the License, or (at your option) any later version.             *
+ *                                                                                  *
+ *   This library is distributed in the hope that it will be useful,                *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of                 *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU              *
+ *   Lesser General Public License for more details.                                *
+ *                                                                                  *
+ *   You should have received a copy of the GNU Lesser General Public               *
+ *   License along with this library; if not, write to the Free Software            *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA *
+ ***********************************************************************************/
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace FakeRing {
+
+/**
+ * A line based description of the daemon state and of the events to replay.
+ *
+ * The setup commands are applied when the daemon starts, before the client
+ * queries the initial state. The other ones are replayed, in order, by
+ * Daemon::play().
+ *
+ * @code
+ * # Comments start with '#'
+ * seed 42                      # Seed of the pseudo random generator
+ * accounts 5 RING              # Create 5 accounts (RING or SIP)
+ * contacts 200                 # Add 200 contacts to each account
+ *
+ * rate 2000                    # Events per second (0 = as fast as possible)
+ * registration 10              # 10 TRYING -> REGISTERED rounds per account
+ * calls 50 0                   # 50 incoming calls, hung up after 0ms
+ * messages 1000                # 1000 incoming text messages
+ * statuses 1000                # 1000 outgoing message status changes
+ * presence 5000                # 5000 contact presence changes
+ * video 1280 720 30 2000       # Send frames for 2 seconds (30 FPS)
+ * wait 500                     # Sleep 500ms
+ * @endcode
+ */
+class Script final
+{
+public:
+   struct Command {
+      enum class Type {
+         SEED        ,
+         ACCOUNTS    ,
+         CONTACTS    ,
+         RATE        ,
+         WAIT        ,
+         REGISTRATION,
+         CALLS       ,
+         MESSAGES    ,
+         STATUSES    ,
+         PRESENCE    ,
+         VIDEO       ,
+      };
+
+      Type             type;
+      std::vector<int> args;
+      std::string      text;
+      int              line {0};
+
+      int arg(int idx, int fallback = 0) const;
+      bool isSetup() const;
+   };
+
+   /// Parse a script, return false and set `error` if it is invalid
+   bool parse(const std::string& content, std::string* error = nullptr);
+
+   /// Parse a script file
+   bool load(const std::string& path, std::string* error = nullptr);
+
+   /// Built-in script modelled after a reconnection storm
+   static Script reconnectStorm();
+
+   std::vector<Command> setup () const;
+   std::vector<Command> events() const;
+
+   /// Number of events the script will emit (for the statistics)
+   int eventCount() const;
+
+private:
+   std::vector<Command> m_lCommands;
+};
+
+} // namespace FakeRing
@@ -0,0 +1,143 @@
+/************************************************************************************
+ *   Copyright (C) 2018 by BlueSystems GmbH                                         *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                            *
+ *                                                                                  *
+ *   This library is free software; you can redistribute it and/or                  *
+ *   modify it under the terms of the GNU Lesser General Public                     *
+ *   License as published by the Free Software Foundation; either                   *
+ *   version 2.1 of the License, or (at your option) any later version.             *
+ *                                                                                  *
+ *   This library is distributed in the hope that it will be useful,                *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of                 *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU              *
+ *   Lesser General Public License for more details.                                *
+ *                                                                                  *
+ *   You should have received a copy of the GNU Lesser General Public               *
+ *   License along with this library; if not, write to the Free Software            *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA *
+ ***********************************************************************************/
+// Implementation of `videomanager_interface.h` on top of FakeRing::Daemon
+#include <videomanager_interface.h>
+
+#include "daemon.h"
+
+using FakeRing::Daemon;
+using Lock = std::lock_guard<std::recursive_mutex>;
+
+namespace {
+
+Daemon& fake()
+{
+   return Daemon::instance();
+}
+
+/// The renderer identifier used by the client for the camera preview
+constexpr static const char previewId[] = "local";
+
+} // anonymous namespace
+
+namespace DRing {
+
+void registerSinkTarget(const std::string& sinkId, const SinkTarget& target)
+{
+   fake().setSink(sinkId, target);
+}
+
+std::vector<std::string> getDeviceList()
+{
+   return {"fakecam"};
+}
+
+VideoCapabilities getCapabilities(const std::string& name)
+{
+   if (name != "fakecam")
+      return {};
+
+   return {
+      { "default", {
+         { "1280x720", {"30", "15"} },
+         { "640x480" , {"30", "15"} },
+      }},
+   };
+}
+
+std::map<std::string, std::string> getSettings(const std::string& name)
+{
+   Lock l(fake().m_Mutex);
+   const auto it = fake().m_hVideoSettings.find(name);
+
+   if (it != fake().m_hVideoSettings.end())
+      return it->second;
+
+   return {
+      { "name"   , name       },
+      { "channel", "default"  },
+      { "size"   , "1280x720" },
+      { "rate"   , "30"       },
+   };
+}
+
+void applySettings(const std::string& name, const std::map<std::string, std::string>& settings)
+{
+   Lock l(fake().m_Mutex);
+   fake().m_hVideoSettings[name] = settings;
+}
+
+void setDefaultDevice(const std::string& name)
+{
+   Lock l(fake().m_Mutex);
+   fake().m_DefaultVideoDevice = name;
+}
+
+std::string getDefaultDevice()
+{
+   Lock l(fake().m_Mutex);
+   return fake().m_DefaultVideoDevice;
+}
+
+void startCamera()
+{
+   // Runs until stopCamera()
+   fake().startVideo(previewId, 1280, 720, 30, 0);
+}
+
+void stopCamera()
+{
+   fake().stopVideo(previewId);
+}
+
+bool hasCameraStarted()
+{
+   return fake().isVideoRunning(previewId);
+}
+
+bool switchInput(const std::string& resource)
+{
+   (void) resource;
+   return true;
+}
+
+std::string startLocalRecorder(const bool& audioOnly, const std::string& filepath)
+{
+   (void) audioOnly;
+   return filepath;
+}
+
+void stopLocalRecorder(const std::string& filepath)
+{
+   (void) filepath;
+}
+
+bool getDecodingAccelerated()
+{
+   Lock l(fake().m_Mutex);
+   return fake().m_DecodingAccelerated;
+}
+
+void setDecodingAccelerated(bool state)
+{
+   Lock l(fake().m_Mutex);
+   fake().m_DecodingAccelerated = state;
+}
+
+} // namespace DRing
@@ -37,8 +37,14 @@ public:
     QPersistentModelIndex m_LastKnownIndex;
     QString m_SearchString;
 
+    /// The messages matching m_SearchString, oldest first
+    QList<QPersistentModelIndex> m_lResults;
+    int m_ResultPosition {-1};
+
     // Helpers
     void findNewest();
+    void updateResults();
+    void proposeResult(int direction);
 
     TimelineIterator* q_ptr;
 
@@ -77,10 +83,12 @@ void TimelineIterator::setCurrentIndividual(Individual* i)
     }
 
     d_ptr->m_pCurrentIndividual = i;
+    d_ptr->m_lResults.clear();
 
     if (i) {
         d_ptr->m_pTimeline = i->timelineModel();
         d_ptr->findNewest();
+        d_ptr->updateResults();
 
         connect(d_ptr->m_pTimeline.data(), &QAbstractItemModel::rowsInserted,
             d_ptr, &TimelineIteratorPrivate::slotInserted);
@@ -132,7 +140,11 @@ QString TimelineIterator::searchString() const
 
 void TimelineIterator::setSearchString(const QString& s)
 {
+    if (s == d_ptr->m_SearchString)
+        return;
+
     d_ptr->m_SearchString = s;
+    d_ptr->updateResults();
     emit changed();
 }
 
@@ -150,8 +162,7 @@ int TimelineIterator::bookmarkCount() const
 
 int TimelineIterator::searchResultCount() const
 {
-//     return d_ptr->m_pCurrentIndividual ? d_ptr->m_pCurrentIndividual-> : 0;
-    return 0;
+    return d_ptr->m_lResults.size();
 }
 
 void TimelineIterator::proposePreviousUnread() const
@@ -176,12 +187,12 @@ void TimelineIterator::proposeNextBookmark() const
 
 void TimelineIterator::proposePreviousResult() const
 {
-
+    d_ptr->proposeResult(-1);
 }
 
 void TimelineIterator::proposeNextResult() const
 {
-
+    d_ptr->proposeResult(1);
 }
 
 void TimelineIterator::proposeNewest() const
@@ -231,6 +242,42 @@ void TimelineIteratorPrivate::findNewest()
     m_LastKnownIndex = parent;
 }
 
+void TimelineIteratorPrivate::updateResults()
+{
+    m_lResults.clear();
+    m_ResultPosition = -1;
+
+    auto tl = qobject_cast<IndividualTimelineModel*>(m_pTimeline.data());
+
+    if ((!tl) || m_SearchString.isEmpty())
+        return;
+
+    const auto results = tl->searchMessages(m_SearchString);
+
+    for (const auto& idx : results)
+        m_lResults << idx;
+}
+
+/// Move to the next (1) or previous (-1) result, the first one is the newest
+void TimelineIteratorPrivate::proposeResult(int direction)
+{
+    if (m_lResults.isEmpty())
+        return;
+
+    const int size = m_lResults.size();
+
+    if (m_ResultPosition == -1)
+        m_ResultPosition = size - 1;
+    else
+        m_ResultPosition = (m_ResultPosition + direction + size) % size;
+
+    // It may have been removed since the search
+    const QModelIndex idx = m_lResults[m_ResultPosition];
+
+    if (idx.isValid())
+        emit q_ptr->proposeIndex(idx);
+}
+
 QModelIndex TimelineIterator::newestIndex() const
 {
     return d_ptr->m_LastKnownIndex;
@@ -45,7 +45,10 @@
 #include "private/certificatemodel_p.h"
 #include "private/account_p.h"
 #include "private/accountmodel_p.h"
+#include "private/daemonrequest_p.h"
+#include "private/daemonhydrator_p.h"
 #include "private/contactmethod_p.h"
+#include "private/presencesubscriptions_p.h"
 #include "credentialmodel.h"
 #include "ciphermodel.h"
 #include "session.h"
@@ -145,7 +148,10 @@ Account* AccountPrivate::buildExistingAccountFromId(const QByteArray& _accountId
 
    //Load the pending trust requests
    if (a->protocol() == Account::Protocol::RING) {
-      const VectorMapStringString& pending_tr {ConfigurationManager::instance().getTrustRequests(a->id())};
+      VectorMapStringString pending_tr;
+      if (!DaemonHydrator::instance().takeTrustRequests(a->id(), pending_tr))
+         pending_tr = ConfigurationManager::instance().getTrustRequests(a->id());
+
       for (const auto& tr_info : pending_tr) {
          auto payload = tr_info[DRing::Account::TrustRequest::PAYLOAD].toUtf8();
          auto ringID = tr_info[DRing::Account::TrustRequest::FROM];
@@ -167,8 +173,9 @@ Account* AccountPrivate::buildExistingAccountFromId(const QByteArray& _accountId
    if (a->protocol() == Account::Protocol::RING) {
 
       // Load the contacts associated from the daemon and create the cms.
-      const QVector<QMap<QString, QString>> account_contacts = ConfigurationManager::instance()
-         .getContacts(a->id().data());
+      VectorMapStringString account_contacts;
+      if (!DaemonHydrator::instance().takeContacts(a->id(), account_contacts))
+         account_contacts = ConfigurationManager::instance().getContacts(a->id().data());
 
       for (const auto& contact_info : qAsConst(account_contacts)) {
          auto cm = Session::instance()->individualDirectory()->getNumber(contact_info[QStringLiteral("id")], a);
@@ -179,10 +186,15 @@ Account* AccountPrivate::buildExistingAccountFromId(const QByteArray& _accountId
    }
 
    //Load the tracked buddies
-   const VectorMapStringString subscriptions = PresenceManager::instance().getSubscriptions(a->id());
+   VectorMapStringString subscriptions;
+   if (!DaemonHydrator::instance().takeSubscriptions(a->id(), subscriptions))
+      subscriptions = PresenceManager::instance().getSubscriptions(a->id());
+
    foreach(auto subscription, subscriptions){
        ContactMethod* tracked_buddy = Session::instance()->individualDirectory()->getNumber(subscription[DRing::Presence::BUDDY_KEY], a);
        bool tracked_buddy_present = subscription[DRing::Presence::STATUS_KEY].compare(DRing::Presence::ONLINE_KEY) == 0;
+       // The daemon already has it, don't subscribe a second time
+       PresenceSubscriptions::instance().setActive(tracked_buddy);
        tracked_buddy->setTracked(true);
        tracked_buddy->d_ptr->setPresent(tracked_buddy_present);
    }
@@ -231,6 +243,8 @@ Account* AccountPrivate::buildNewAccountFromAlias(Account::Protocol proto, const
       a->d_ptr->m_hAccountDetails[iter.key()] = iter.value();
    }
 
+   a->d_ptr->m_Properties.load(a->d_ptr->m_hAccountDetails);
+
    if (proto == Account::Protocol::RING)
    {
        /* Set LRC-provided bootstrap servers */
@@ -287,15 +301,15 @@ void AccountPrivate::slotUpdateCertificate()
    if (cert) {
       switch (cert->type()) {
          case Certificate::Type::AUTHORITY:
-            if (accountDetail(DRing::Account::ConfProperties::TLS::CA_LIST_FILE) != cert->path())
+            if (properties().toString(AccountProperties::Key::TLS_CA_LIST_FILE) != cert->path())
                setAccountProperty(DRing::Account::ConfProperties::TLS::CA_LIST_FILE, cert->path());
             break;
          case Certificate::Type::USER:
-            if (accountDetail(DRing::Account::ConfProperties::TLS::CERTIFICATE_FILE) != cert->path())
+            if (properties().toString(AccountProperties::Key::TLS_CERTIFICATE_FILE) != cert->path())
                setAccountProperty(DRing::Account::ConfProperties::TLS::CERTIFICATE_FILE, cert->path());
             break;
          case Certificate::Type::PRIVATE_KEY:
-            if (accountDetail(DRing::Account::ConfProperties::TLS::PRIVATE_KEY_FILE) != cert->path())
+            if (properties().toString(AccountProperties::Key::TLS_PRIVATE_KEY_FILE) != cert->path())
                setAccountProperty(DRing::Account::ConfProperties::TLS::PRIVATE_KEY_FILE, cert->path());
             break;
          case Certificate::Type::NONE:
@@ -337,13 +351,13 @@ const QByteArray Account::id() const
 ///Get the device ID
 QString Account::deviceId() const
 {
-    return d_ptr->accountDetail(DRing::Account::ConfProperties::RING_DEVICE_ID);
+    return d_ptr->properties().toString(AccountProperties::Key::RING_DEVICE_ID);
 }
 
 ///Get current state
 const QString Account::toHumanStateName() const
 {
-   const QString s = d_ptr->m_hAccountDetails[DRing::Account::ConfProperties::Registration::STATUS];
+   const QString& s = d_ptr->properties().toString(AccountProperties::Key::REGISTRATION_STATUS);
 
                                                  //: Account state
    static const QString ready                  = tr("Ready"                    );
@@ -439,7 +453,7 @@ QString AccountPrivate::accountDetail(const QString& param) const
 ///Get the alias
 const QString Account::alias() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::ALIAS);
+   return d_ptr->properties().toString(AccountProperties::Key::ALIAS);
 }
 
 ///Return the model index of this item
@@ -577,7 +591,7 @@ RingDeviceModel* Account::ringDeviceModel() const
         d_ptr->m_pRingDeviceModel = new RingDeviceModel(
             const_cast<Account*>(this),
             d_ptr->accountDetail(DRing::Account::ConfProperties::RING_DEVICE_ID  ),
-            d_ptr->accountDetail(DRing::Account::ConfProperties::RING_DEVICE_NAME)
+            d_ptr->properties().toString(AccountProperties::Key::RING_DEVICE_NAME)
         );
 
     return d_ptr->m_pRingDeviceModel;
@@ -587,7 +601,7 @@ Calendar* Account::calendar() const
 {
     if (!d_ptr->m_pCalendar) {
         d_ptr->m_pCalendar = Session::instance()->eventModel()->addCollection<Calendar, Account*>(
-            const_cast<Account*>(this), LoadOptions::FORCE_ENABLED
+            const_cast<Account*>(this), LoadOptions::FORCE_ENABLED | LoadOptions::ASYNC
         );
     }
 
@@ -731,7 +745,7 @@ QString Account::hostname() const
 ///Return if the account is enabled
 bool Account::isEnabled() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::ENABLED) IS_TRUE;
+   return d_ptr->properties().toBool(AccountProperties::Key::ENABLED);
 }
 
 ///Return if the account should auto answer
@@ -743,15 +757,14 @@ Account::AutoAnswerStatus Account::autoAnswerStatus() const
 //Return if the accounts needs to migrate
 bool Account::needsMigration() const
 {
-    const MapStringString details = ConfigurationManager::instance().getVolatileAccountDetails(id());
-    const QString status = details[DRing::Account::VolatileProperties::Registration::STATUS];
+    const QString status = d_ptr->volatileDetails()[DRing::Account::VolatileProperties::Registration::STATUS];
     return status == DRing::Account::States::ERROR_NEED_MIGRATION;
 }
 
 ///Return the account user name
 QString Account::username() const
 {
-   auto ret = d_ptr->accountDetail(DRing::Account::ConfProperties::USERNAME);
+   auto ret = d_ptr->properties().toString(AccountProperties::Key::USERNAME);
 
    // The username (ringId) can take a while to be available, keep trying
    if (ret.isEmpty() && protocol() == Account::Protocol::RING && editState() == Account::EditState::READY) {
@@ -759,6 +772,7 @@ QString Account::username() const
        const QMap<QString,QString> aDetails = configurationManager.getAccountDetails(id());
        ret = aDetails[DRing::Account::ConfProperties::USERNAME];
        d_ptr->m_hAccountDetails[DRing::Account::ConfProperties::USERNAME] = ret;
+       d_ptr->m_Properties.set(AccountProperties::Key::USERNAME, ret, false);
    }
 
    return ret;
@@ -767,27 +781,25 @@ QString Account::username() const
 //Return the account registered name
 QString Account::registeredName() const
 {
-    const MapStringString details = ConfigurationManager::instance().getVolatileAccountDetails(id());
-    const QString registeredName = details[DRing::Account::VolatileProperties::REGISTERED_NAME];
-    return registeredName;
+    return d_ptr->volatileDetails()[DRing::Account::VolatileProperties::REGISTERED_NAME];
 }
 
 ///Return the account mailbox address
 QString Account::mailbox() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::MAILBOX);
+   return d_ptr->properties().toString(AccountProperties::Key::MAILBOX);
 }
 
 ///Return the account mailbox address
 QString Account::proxy() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::ROUTE);
+   return d_ptr->properties().toString(AccountProperties::Key::ROUTE);
 }
 
 ///Return the name service URL
 QString Account::nameServiceURL() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::RingNS::URI);
+   return d_ptr->properties().toString(AccountProperties::Key::RINGNS_URI);
 }
 
 QString Account::password() const
@@ -809,68 +821,68 @@ QString Account::password() const
 ///Return the account security fallback
 bool Account::isSrtpRtpFallback() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::SRTP::RTP_FALLBACK) IS_TRUE;
+   return d_ptr->properties().toBool(AccountProperties::Key::SRTP_RTP_FALLBACK);
 }
 
 //Return if SRTP is enabled or not
 bool Account::isSrtpEnabled() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::SRTP::ENABLED) IS_TRUE;
+   return d_ptr->properties().toBool(AccountProperties::Key::SRTP_ENABLED);
 }
 
 ///Return if the account is using a STUN server
 bool Account::isSipStunEnabled() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::STUN::ENABLED) IS_TRUE;
+   return d_ptr->properties().toBool(AccountProperties::Key::STUN_ENABLED);
 }
 
 ///Return the account STUN server
 QString Account::sipStunServer() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::STUN::SERVER);
+   return d_ptr->properties().toString(AccountProperties::Key::STUN_SERVER);
 }
 
 ///Return when the account expire (require renewal)
 int Account::registrationExpire() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::Registration::EXPIRE).toInt();
+   return d_ptr->properties().toInt(AccountProperties::Key::REGISTRATION_EXPIRE);
 }
 
 ///Return if the published address is the same as the local one
 bool Account::isPublishedSameAsLocal() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::PUBLISHED_SAMEAS_LOCAL) IS_TRUE;
+   return d_ptr->properties().toBool(AccountProperties::Key::PUBLISHED_SAMEAS_LOCAL);
 }
 
 ///Return the account published address
 QString Account::publishedAddress() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::PUBLISHED_ADDRESS);
+   return d_ptr->properties().toString(AccountProperties::Key::PUBLISHED_ADDRESS);
 }
 
 ///Return the account published port
 int Account::publishedPort() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::PUBLISHED_PORT).toUInt();
+   return d_ptr->properties().toUInt(AccountProperties::Key::PUBLISHED_PORT);
 }
 
 ///Return the account tls password
 QString Account::tlsPassword() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::TLS::PASSWORD);
+   return d_ptr->properties().toString(AccountProperties::Key::TLS_PASSWORD);
 }
 
 ///Return the account TLS port
 int Account::bootstrapPort() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::DHT::PORT).toInt();
+   return d_ptr->properties().toInt(AccountProperties::Key::DHT_PORT);
 }
 
 ///Return the account TLS certificate authority list file
 Certificate* Account::tlsCaListCertificate() const
 {
    if (!d_ptr->m_pCaCert) {
-      const QString& path = d_ptr->accountDetail(DRing::Account::ConfProperties::TLS::CA_LIST_FILE);
+      const QString& path = d_ptr->properties().toString(AccountProperties::Key::TLS_CA_LIST_FILE);
       if (path.isEmpty())
          return nullptr;
       d_ptr->m_pCaCert = CertificateModel::instance().getCertificateFromPath(path,Certificate::Type::AUTHORITY);
@@ -883,7 +895,7 @@ Certificate* Account::tlsCaListCertificate() const
 Certificate* Account::tlsCertificate() const
 {
    if (!d_ptr->m_pTlsCert) {
-      const QString& path = d_ptr->accountDetail(DRing::Account::ConfProperties::TLS::CERTIFICATE_FILE);
+      const QString& path = d_ptr->properties().toString(AccountProperties::Key::TLS_CERTIFICATE_FILE);
       if (path.isEmpty())
          return nullptr;
       d_ptr->m_pTlsCert = CertificateModel::instance().getCertificateFromPath(path,Certificate::Type::USER);
@@ -901,49 +913,49 @@ QString Account::tlsPrivateKey() const
 ///Return the account TLS server name
 QString Account::tlsServerName() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::TLS::SERVER_NAME);
+   return d_ptr->properties().toString(AccountProperties::Key::TLS_SERVER_NAME);
 }
 
 ///Return the account negotiation timeout in seconds
 int Account::tlsNegotiationTimeoutSec() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::TLS::NEGOTIATION_TIMEOUT_SEC).toInt();
+   return d_ptr->properties().toInt(AccountProperties::Key::TLS_NEGOTIATION_TIMEOUT_SEC);
 }
 
 ///Return the account TLS verify server
 bool Account::isTlsVerifyServer() const
 {
-   return (d_ptr->accountDetail(DRing::Account::ConfProperties::TLS::VERIFY_SERVER) IS_TRUE);
+   return (d_ptr->properties().toBool(AccountProperties::Key::TLS_VERIFY_SERVER));
 }
 
 ///Return the account TLS verify client
 bool Account::isTlsVerifyClient() const
 {
-   return (d_ptr->accountDetail(DRing::Account::ConfProperties::TLS::VERIFY_CLIENT) IS_TRUE);
+   return (d_ptr->properties().toBool(AccountProperties::Key::TLS_VERIFY_CLIENT));
 }
 
 ///Return if it is required for the peer to have a certificate
 bool Account::isTlsRequireClientCertificate() const
 {
-   return (d_ptr->accountDetail(DRing::Account::ConfProperties::TLS::REQUIRE_CLIENT_CERTIFICATE) IS_TRUE);
+   return (d_ptr->properties().toBool(AccountProperties::Key::TLS_REQUIRE_CLIENT_CERTIFICATE));
 }
 
 ///Return the account TLS security is enabled
 bool Account::isTlsEnabled() const
 {
-   return protocol() == Account::Protocol::RING || (d_ptr->accountDetail(DRing::Account::ConfProperties::TLS::ENABLED) IS_TRUE);
+   return protocol() == Account::Protocol::RING || (d_ptr->properties().toBool(AccountProperties::Key::TLS_ENABLED));
 }
 
 ///Return if the ringtone are enabled
 bool Account::isRingtoneEnabled() const
 {
-   return (d_ptr->accountDetail(DRing::Account::ConfProperties::Ringtone::ENABLED) IS_TRUE);
+   return (d_ptr->properties().toBool(AccountProperties::Key::RINGTONE_ENABLED));
 }
 
 ///Return the account ringtone path
 QString Account::ringtonePath() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::Ringtone::PATH);
+   return d_ptr->properties().toString(AccountProperties::Key::RINGTONE_PATH);
 }
 
 ///Return the last error message received
@@ -977,11 +989,11 @@ int Account::localPort() const
    switch (protocol()) {
       case Account::Protocol::SIP:
          if (isTlsEnabled())
-            return d_ptr->accountDetail(DRing::Account::ConfProperties::TLS::LISTENER_PORT).toInt();
+            return d_ptr->properties().toInt(AccountProperties::Key::TLS_LISTENER_PORT);
          else
-            return d_ptr->accountDetail(DRing::Account::ConfProperties::LOCAL_PORT).toInt();
+            return d_ptr->properties().toInt(AccountProperties::Key::LOCAL_PORT);
       case Account::Protocol::RING:
-         return d_ptr->accountDetail(DRing::Account::ConfProperties::TLS::LISTENER_PORT).toInt();
+         return d_ptr->properties().toInt(AccountProperties::Key::TLS_LISTENER_PORT);
       case Account::Protocol::COUNT__:
          break;
    };
@@ -1011,7 +1023,7 @@ Account::Protocol Account::protocol() const
 {
    // Changing an account protocol is not supported
    if (d_ptr->m_Protocol == Account::Protocol::COUNT__) {
-      const QString str = d_ptr->accountDetail(DRing::Account::ConfProperties::TYPE);
+      const QString str = d_ptr->properties().toString(AccountProperties::Key::TYPE);
 
       if (str.isEmpty() || str == DRing::Account::ProtocolNames::SIP)
          d_ptr->m_Protocol = Account::Protocol::SIP;
@@ -1060,7 +1072,7 @@ ContactMethod* Account::contactMethod() const
 ///Return the DTMF type
 DtmfType Account::DTMFType() const
 {
-   QString type = d_ptr->accountDetail(DRing::Account::ConfProperties::DTMF_TYPE);
+   QString type = d_ptr->properties().toString(AccountProperties::Key::DTMF_TYPE);
    return (type == QLatin1String("overrtp") || type.isEmpty())? DtmfType::OverRtp:DtmfType::OverSip;
 }
 
@@ -1076,12 +1088,12 @@ QString Account::presenceMessage() const
 
 bool Account::supportPresencePublish() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::Presence::SUPPORT_PUBLISH) IS_TRUE;
+   return d_ptr->properties().toBool(AccountProperties::Key::PRESENCE_SUPPORT_PUBLISH);
 }
 
 bool Account::supportPresenceSubscribe() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::Presence::SUPPORT_SUBSCRIBE) IS_TRUE;
+   return d_ptr->properties().toBool(AccountProperties::Key::PRESENCE_SUPPORT_SUBSCRIBE);
 }
 
 bool Account::canCall() const
@@ -1097,47 +1109,47 @@ bool Account::canVideoCall() const
 
 bool Account::presenceEnabled() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::Presence::ENABLED) IS_TRUE;
+   return d_ptr->properties().toBool(AccountProperties::Key::PRESENCE_ENABLED);
 }
 
 bool Account::isVideoEnabled() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::Video::ENABLED) IS_TRUE;
+   return d_ptr->properties().toBool(AccountProperties::Key::VIDEO_ENABLED);
 }
 
 int Account::videoPortMax() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::Video::PORT_MAX).toInt();
+   return d_ptr->properties().toInt(AccountProperties::Key::VIDEO_PORT_MAX);
 }
 
 int Account::videoPortMin() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::Video::PORT_MIN).toInt();
+   return d_ptr->properties().toInt(AccountProperties::Key::VIDEO_PORT_MIN);
 }
 
 int Account::audioPortMin() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::Audio::PORT_MIN).toInt();
+   return d_ptr->properties().toInt(AccountProperties::Key::AUDIO_PORT_MIN);
 }
 
 int Account::audioPortMax() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::Audio::PORT_MAX).toInt();
+   return d_ptr->properties().toInt(AccountProperties::Key::AUDIO_PORT_MAX);
 }
 
 bool Account::isUpnpEnabled() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::UPNP_ENABLED) IS_TRUE;
+   return d_ptr->properties().toBool(AccountProperties::Key::UPNP_ENABLED);
 }
 
 bool Account::hasCustomUserAgent() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::HAS_CUSTOM_USER_AGENT) IS_TRUE;
+   return d_ptr->properties().toBool(AccountProperties::Key::HAS_CUSTOM_USER_AGENT);
 }
 
 QString Account::userAgent() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::USER_AGENT);
+   return d_ptr->properties().toString(AccountProperties::Key::USER_AGENT);
 }
 
 bool Account::useDefaultPort() const
@@ -1147,27 +1159,27 @@ bool Account::useDefaultPort() const
 
 bool Account::isTurnEnabled() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::TURN::ENABLED) IS_TRUE;
+   return d_ptr->properties().toBool(AccountProperties::Key::TURN_ENABLED);
 }
 
 QString Account::turnServer() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::TURN::SERVER);
+   return d_ptr->properties().toString(AccountProperties::Key::TURN_SERVER);
 }
 
 QString Account::turnServerUsername() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::TURN::SERVER_UNAME);
+   return d_ptr->properties().toString(AccountProperties::Key::TURN_SERVER_UNAME);
 }
 
 QString Account::turnServerPassword() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::TURN::SERVER_PWD);
+   return d_ptr->properties().toString(AccountProperties::Key::TURN_SERVER_PWD);
 }
 
 QString Account::turnServerRealm() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::TURN::SERVER_REALM);
+   return d_ptr->properties().toString(AccountProperties::Key::TURN_SERVER_REALM);
 }
 
 bool Account::hasProxy() const
@@ -1177,22 +1189,22 @@ bool Account::hasProxy() const
 
 QString Account::displayName() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::DISPLAYNAME);
+   return d_ptr->properties().toString(AccountProperties::Key::DISPLAYNAME);
 }
 
 QString Account::archivePassword() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::ARCHIVE_PASSWORD);
+   return d_ptr->properties().toString(AccountProperties::Key::ARCHIVE_PASSWORD);
 }
 
 QString Account::archivePin() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::ARCHIVE_PIN);
+   return d_ptr->properties().toString(AccountProperties::Key::ARCHIVE_PIN);
 }
 
 bool Account::allowIncomingFromUnknown() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::DHT::PUBLIC_IN_CALLS) IS_TRUE;
+   return d_ptr->properties().toBool(AccountProperties::Key::DHT_PUBLIC_IN_CALLS);
 }
 
 bool Account::allowIncomingFromHistory() const
@@ -1200,7 +1212,7 @@ bool Account::allowIncomingFromHistory() const
    if (protocol() != Account::Protocol::RING)
       return false;
 
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::ALLOW_CERT_FROM_HISTORY) IS_TRUE;
+   return d_ptr->properties().toBool(AccountProperties::Key::ALLOW_CERT_FROM_HISTORY);
 }
 
 bool Account::allowIncomingFromContact() const
@@ -1208,12 +1220,12 @@ bool Account::allowIncomingFromContact() const
    if (protocol() != Account::Protocol::RING)
       return false;
 
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::ALLOW_CERT_FROM_CONTACT) IS_TRUE;
+   return d_ptr->properties().toBool(AccountProperties::Key::ALLOW_CERT_FROM_CONTACT);
 }
 
 int Account::activeCallLimit() const
 {
-   return d_ptr->accountDetail(DRing::Account::ConfProperties::ACTIVE_CALL_LIMIT).toInt();
+   return d_ptr->properties().toInt(AccountProperties::Key::ACTIVE_CALL_LIMIT);
 }
 
 bool Account::hasActiveCallLimit() const
@@ -1547,6 +1559,7 @@ void AccountPrivate::setAccountProperties(const QHash<QString,QString>& m)
 {
    m_hAccountDetails.clear();
    m_hAccountDetails = m;
+   m_Properties.load(m);
    m_HostName = m[DRing::Account::ConfProperties::HOSTNAME];
 }
 
@@ -1559,6 +1572,7 @@ bool AccountPrivate::setAccountProperty(const QString& param, const QString& val
    //TODO make this more generic for volatile properties
    if (param == DRing::Account::ConfProperties::Registration::STATUS) {
       m_hAccountDetails[param] = val;
+      m_Properties.set(AccountProperties::Key::REGISTRATION_STATUS, val, false);
       if (accChanged) {
          emit q_ptr->changed(q_ptr);
          emit q_ptr->propertyChanged(q_ptr,param,val,buf);
@@ -1567,6 +1581,7 @@ bool AccountPrivate::setAccountProperty(const QString& param, const QString& val
    else if (accChanged) {
 
       m_hAccountDetails[param] = val;
+      m_Properties.set(param, val);
       emit q_ptr->changed(q_ptr);
       emit q_ptr->propertyChanged(q_ptr,param,val,buf);
 
@@ -2544,35 +2559,53 @@ QString AccountPrivate::buildUri()
     return currentUri;
 }
 
-/**Update the account
- * @return if the state changed
- */
-bool AccountPrivate::updateState()
+///Refresh the registration state without waiting for the daemon
+void AccountPrivate::updateState()
 {
    if(! q_ptr->isNew()) {
-      ConfigurationManagerInterface& configurationManager = ConfigurationManager::instance();
-      const MapStringString details        = configurationManager.getVolatileAccountDetails(q_ptr->id());
-      const QString         status         = details[DRing::Account::VolatileProperties::Registration::STATUS];
-      const Account::RegistrationState cst = q_ptr->registrationState();
-      const Account::RegistrationState st  = Account::fromDaemonName(status);
-
-      setAccountProperty(DRing::Account::ConfProperties::Registration::STATUS, status); //Update -internal- object state
-      m_RegistrationState = st;
-
-      if (st != cst) {
-         emit q_ptr->stateChanged(q_ptr->registrationState());
-         emit q_ptr->canVideoCallChanged(q_ptr->canVideoCall());
-         emit q_ptr->canCallChanged(q_ptr->canCall());
-      }
-
-      return st == cst;
+      DaemonRequest::instance().getVolatileAccountDetails(q_ptr->id(), q_ptr, [this](const MapStringString& details) {
+         updateState(details);
+      });
    }
    else if (m_RegistrationState == Account::RegistrationState::READY
      && q_ptr->protocol() == Account::Protocol::RING && q_ptr->username().isEmpty()) {
       q_ptr << Account::EditAction::RELOAD;
    }
+}
 
-   return true;
+/**Update the account from its volatile details
+ * @return if the state changed
+ */
+bool AccountPrivate::updateState(const MapStringString& volatileDetails)
+{
+   m_hVolatileDetails = volatileDetails;
+
+   const QString                    status = volatileDetails[DRing::Account::VolatileProperties::Registration::STATUS];
+   const Account::RegistrationState cst    = q_ptr->registrationState();
+   const Account::RegistrationState st     = Account::fromDaemonName(status);
+
+   setAccountProperty(DRing::Account::ConfProperties::Registration::STATUS, status); //Update -internal- object state
+   m_RegistrationState = st;
+
+   if (st != cst) {
+      emit q_ptr->stateChanged(q_ptr->registrationState());
+      emit q_ptr->canVideoCallChanged(q_ptr->canVideoCall());
+      emit q_ptr->canCallChanged(q_ptr->canCall());
+   }
+
+   return st != cst;
+}
+
+/**
+ * The volatile details are kept up to date by the daemon signals, only the
+ * first access blocks.
+ */
+const MapStringString& AccountPrivate::volatileDetails()
+{
+   if (m_hVolatileDetails.isEmpty() && !q_ptr->isNew())
+      m_hVolatileDetails = ConfigurationManager::instance().getVolatileAccountDetails(q_ptr->id());
+
+   return m_hVolatileDetails;
 }
 
 ///Save the current account to the daemon
@@ -2581,7 +2614,7 @@ void AccountPrivate::save()
    ConfigurationManagerInterface& configurationManager = ConfigurationManager::instance();
 
    // Sync the device name
-   if (q_ptr->ringDevice() && q_ptr->ringDevice()->name() != accountDetail(DRing::Account::ConfProperties::RING_DEVICE_NAME))
+   if (q_ptr->ringDevice() && q_ptr->ringDevice()->name() != properties().toString(AccountProperties::Key::RING_DEVICE_NAME))
       setAccountProperty(
          DRing::Account::ConfProperties::RING_DEVICE_NAME,
          q_ptr->ringDevice()->name()
@@ -2605,7 +2638,7 @@ void AccountPrivate::save()
 
       setId(currentId.toLatin1());
    } //New account
-   else { //Existing account
+   else if (m_Properties.isDirty()) { //Existing account
       MapStringString tmp;
       QMutableHashIterator<QString,QString> iter(m_hAccountDetails);
 
@@ -2614,6 +2647,7 @@ void AccountPrivate::save()
          tmp[iter.key()] = iter.value();
       }
       configurationManager.setAccountDetails(q_ptr->id(), tmp);
+      m_Properties.clearDirty();
       if (m_RemoteEnabledState != q_ptr->isEnabled()) {
          m_RemoteEnabledState = q_ptr->isEnabled();
          emit q_ptr->enabled(m_RemoteEnabledState);
@@ -2653,8 +2687,9 @@ void AccountPrivate::reload()
       if (m_hAccountDetails.size())
          qDebug() << "Reloading" << q_ptr->id() << q_ptr->alias();
 
-      ConfigurationManagerInterface& configurationManager = ConfigurationManager::instance();
-      QMap<QString,QString> aDetails = configurationManager.getAccountDetails(q_ptr->id());
+      QMap<QString,QString> aDetails;
+      if (!DaemonHydrator::instance().takeAccountDetails(q_ptr->id(), aDetails))
+         aDetails = ConfigurationManager::instance().getAccountDetails(q_ptr->id());
 
       if (!aDetails.count()) {
          qDebug() << "Account not found";
@@ -2668,6 +2703,8 @@ void AccountPrivate::reload()
             m_hAccountDetails[iter.key()] = iter.value();
          }
 
+         m_Properties.load(m_hAccountDetails);
+
          //Manually re-set elements that need extra business logic or caching
          q_ptr->setHostname(m_hAccountDetails[DRing::Account::ConfProperties::HOSTNAME]);
 
@@ -2726,9 +2763,19 @@ void AccountPrivate::reload()
       emit q_ptr->changed(q_ptr);
 
       //The registration state is cached, update that cache
-      updateState();
+      MapStringString volatileDetails;
+      if (DaemonHydrator::instance().takeVolatileAccountDetails(q_ptr->id(), volatileDetails)) {
+         updateState(volatileDetails);
+         emit ConfigurationManager::instance().volatileAccountDetailsChanged(q_ptr->id(), volatileDetails);
+      }
+      else {
+         updateState();
 
-      emit configurationManager.volatileAccountDetailsChanged(q_ptr->id(),configurationManager.getVolatileAccountDetails(q_ptr->id()));
+         //This is merged with the request sent by updateState()
+         DaemonRequest::instance().getVolatileAccountDetails(q_ptr->id(), q_ptr, [this](const MapStringString& details) {
+            emit ConfigurationManager::instance().volatileAccountDetailsChanged(q_ptr->id(), details);
+         });
+      }
 
       m_ReloadLock.unlock();
    }
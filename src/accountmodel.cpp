@@ -56,6 +56,8 @@
 #include "private/vcardutils.h"
 #include "individualdirectory.h"
 #include "bannedcontactmodel.h"
+#include "private/daemonrequest_p.h"
+#include "private/daemonhydrator_p.h"
 
 QHash<QByteArray,AccountPlaceHolder*> AccountModelPrivate::m_hsPlaceHolder;
 
@@ -73,19 +75,23 @@ AccountModel::AccountModel()
 void AccountModelPrivate::init()
 {
     InstanceManager::instance(); // Make sure the daemon is running before calling updateAccounts()
+
+    // Send the requests of all accounts at once rather than one by one
+    DaemonHydrator::instance().fetchAccounts();
     q_ptr->updateAccounts();
+    DaemonHydrator::instance().clear();
 
     CallManagerInterface& callManager = CallManager::instance();
     ConfigurationManagerInterface& configurationManager = ConfigurationManager::instance();
 
-    connect(&configurationManager, &ConfigurationManagerInterface::registrationStateChanged,this ,
-            &AccountModelPrivate::slotDaemonAccountChanged, Qt::QueuedConnection);
+    connect(&DaemonSignalBridge::instance(), &DaemonSignalBridge::registrationStatesChanged, this,
+            &AccountModelPrivate::slotRegistrationStatesChanged);
     connect(&configurationManager, SIGNAL(accountsChanged())                               ,q_ptr,
             SLOT(updateAccounts()), Qt::QueuedConnection);
     connect(&callManager         , SIGNAL(voiceMailNotify(QString,int))                    ,this ,
             SLOT(slotVoiceMailNotify(QString,int))  );
-    connect(&configurationManager, SIGNAL(volatileAccountDetailsChanged(QString,MapStringString)),this,
-            SLOT(slotVolatileAccountDetailsChange(QString,MapStringString)), Qt::QueuedConnection);
+    connect(&DaemonSignalBridge::instance(), &DaemonSignalBridge::volatileDetailsChanged, this,
+            &AccountModelPrivate::slotVolatileDetailsChanged);
     connect(&configurationManager, SIGNAL(mediaParametersChanged(QString))                 ,this ,
             SLOT(slotMediaParametersChanged(QString)), Qt::QueuedConnection);
     connect(&configurationManager, &ConfigurationManagerInterface::knownDevicesChanged, this,
@@ -384,28 +390,29 @@ void AccountModelPrivate::slotDaemonAccountChanged(const QString& account, const
       }
    }
    else {
-      const bool isRegistered = a->registrationState() == Account::RegistrationState::READY;
-      a->d_ptr->updateState();
-      const QModelIndex idx = a->index();
-      emit q_ptr->dataChanged(idx, idx);
-      const bool regStateChanged = isRegistered != (a->registrationState() == Account::RegistrationState::READY);
-
-      //Handle some important events directly
-      if (regStateChanged && (code == 502 || code == 503)) {
-         emit q_ptr->badGateway();
-      }
-      else if (regStateChanged)
-         emit q_ptr->registrationChanged(a,a->registrationState() == Account::RegistrationState::READY);
-
       //Send the messages to AccountStatusModel for processing
       a->statusModel()->addSipRegistrationEvent(status,code);
 
       //Make sure volatile details get reloaded
       //TODO eventually remove this call and trust the signal
-      slotVolatileAccountDetailsChange(account,configurationManager.getVolatileAccountDetails(account));
+      DaemonRequest::instance().invalidate(account);
+      DaemonRequest::instance().getVolatileAccountDetails(account, a, [this, a, account, code](const MapStringString& details) {
+         const bool isRegistered = a->registrationState() == Account::RegistrationState::READY;
+         slotVolatileAccountDetailsChange(account, details);
+         const QModelIndex idx = a->index();
+         emit q_ptr->dataChanged(idx, idx);
+         const bool regStateChanged = isRegistered != (a->registrationState() == Account::RegistrationState::READY);
+
+         //Handle some important events directly
+         if (regStateChanged && (code == 502 || code == 503)) {
+            emit q_ptr->badGateway();
+         }
+         else if (regStateChanged)
+            emit q_ptr->registrationChanged(a,a->registrationState() == Account::RegistrationState::READY);
 
-      emit q_ptr->accountStateChanged(a,a->registrationState());
-      emit q_ptr->hasAvailableAccountsChanged();
+         emit q_ptr->accountStateChanged(a,a->registrationState());
+         emit q_ptr->hasAvailableAccountsChanged();
+      });
    }
 
 }
@@ -449,8 +456,33 @@ void AccountModelPrivate::slotAccountPresenceEnabledChanged(bool state)
    emit q_ptr->presenceEnabledChanged(q_ptr->isPresenceEnabled());
 }
 
+///Coalesced registration state changes, in the order the daemon sent them
+void AccountModelPrivate::slotRegistrationStatesChanged(const QVector<DaemonSignalBridge::RegistrationEvent>& events)
+{
+   for (const auto& e : qAsConst(events))
+      slotDaemonAccountChanged(e.accountId, e.state, e.code, e.detail);
+}
+
+///Coalesced runtime details, the availability is only recomputed once
+void AccountModelPrivate::slotVolatileDetailsChanged(const QVector<DaemonSignalBridge::VolatileDetailsEvent>& events)
+{
+   bool changed = false;
+
+   for (const auto& e : qAsConst(events))
+      changed |= applyVolatileDetails(e.accountId, e.details);
+
+   if (changed)
+      slotAvailabilityStatusChanged();
+}
+
 ///Emitted when some runtime details changes
 void AccountModelPrivate::slotVolatileAccountDetailsChange(const QString& accountId, const MapStringString& details)
+{
+   if (applyVolatileDetails(accountId, details))
+      slotAvailabilityStatusChanged();
+}
+
+bool AccountModelPrivate::applyVolatileDetails(const QString& accountId, const MapStringString& details)
 {
    if (auto a = q_ptr->getById(accountId.toLatin1())) {
       const int     transportCode = details[DRing::Account::VolatileProperties::Transport::STATE_CODE].toInt();
@@ -462,14 +494,24 @@ void AccountModelPrivate::slotVolatileAccountDetailsChange(const QString& accoun
       a->d_ptr->setLastTransportCode(transportCode);
       a->d_ptr->setLastTransportMessage(transportDesc);
 
-      const Account::RegistrationState state = Account::fromDaemonName(
-          a->d_ptr->accountDetail(DRing::Account::ConfProperties::Registration::STATUS)
-      );
+      // Those are the details the daemon would return, don't fetch them again
+      if (!a->isNew()) {
+         a->d_ptr->updateState(details);
+         return true;
+      }
+
+      // New accounts have no status yet, they are unregistered
+      const auto& props = a->d_ptr->properties();
+      const Account::RegistrationState state = props.isSet(AccountProperties::Key::REGISTRATION_STATUS) ?
+          Account::fromDaemonName(props.toString(AccountProperties::Key::REGISTRATION_STATUS)) :
+          Account::RegistrationState::UNREGISTERED;
 
       a->d_ptr->setRegistrationState(state);
 
-      slotAvailabilityStatusChanged();
+      return true;
    }
+
+   return false;
 }
 
 ///Known Ring devices have changed
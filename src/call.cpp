@@ -27,7 +27,6 @@
 
 //Qt
 #include <QtCore/QFile>
-#include <QtCore/QTimer>
 #include <QtCore/QDateTime>
 
 //DRing
@@ -49,6 +48,7 @@
 #include "private/videorenderermanager.h"
 #include "collections/localrecordingcollection.h"
 #include "useractionmodel.h"
+#include "callqualitymodel.h"
 #include "callmodel.h"
 #include "certificate.h"
 #include "collections/numbercategory.h"
@@ -88,6 +88,8 @@
 
 #include "private/call_p.h"
 #include "private/textrecording_p.h"
+#include "private/daemonrequest_p.h"
+#include "private/callheartbeat_p.h"
 
 const TypedStateMachine< TypedStateMachine< Call::State , Call::Action> , Call::State> CallPrivate::actionPerformedStateMap =
 {{
@@ -340,8 +342,7 @@ Call::Call(const QString& confId, const QString& account)
 ///Destructor
 Call::~Call()
 {
-   if (d_ptr->m_pTimer)
-      delete d_ptr->m_pTimer;
+   CallHeartbeat::instance().remove(this);
 
    this->disconnect();
 
@@ -412,10 +413,17 @@ MapStringString CallPrivate::getCallDetailsCommon(const QString& callId)
 
    MapStringString details = callManager.getCallDetails(callId);
 
+   formatCallDetails(details);
+
+   return details;
+}
+
+void CallPrivate::formatCallDetails(MapStringString& details)
+{
    const QString account = details[ DRing::Call::Details::ACCOUNTID ];
 
    if (account.isEmpty())
-      return details;
+      return;
 
    Account* acc = Session::instance()->accountModel()->getById(account.toLatin1());
 
@@ -431,15 +439,32 @@ MapStringString CallPrivate::getCallDetailsCommon(const QString& callId)
          URI::Section::USER_INFO |
          URI::Section::HOSTNAME
       );
+}
 
-   return details;
+///Apply the details which can change during the call lifetime
+void CallPrivate::updateCallDetails(const MapStringString& details)
+{
+   updateOutgoingMedia(details);
+
+   if (!details[DRing::Call::Details::DISPLAY_NAME].isEmpty()
+       and ( details[DRing::Call::Details::DISPLAY_NAME] != m_PeerName) )
+      q_ptr->setPeerName(details[DRing::Call::Details::DISPLAY_NAME]);
+
+   //Load the certificate if it's now available
+   if (!q_ptr->certificate() && !details[DRing::TlsTransport::TLS_PEER_CERT].isEmpty()) {
+      m_pCertificate = CertificateModel::instance().getCertificateFromId(details[DRing::TlsTransport::TLS_PEER_CERT], q_ptr->account());
+   }
 }
 
 ///Build a call from a dbus event
 Call* CallPrivate::buildCall(const QString& callId, Call::Direction callDirection, Call::State startState)
 {
-    const auto& details = getCallDetailsCommon(callId);
+    return buildCall(callId, callDirection, startState, getCallDetailsCommon(callId), CallManager::instance().getIsRecording(callId));
+}
 
+///Build a call from details fetched in advance
+Call* CallPrivate::buildCall(const QString& callId, Call::Direction callDirection, Call::State startState, const MapStringString& details, bool isRecording)
+{
     auto peerNumber      = details[ DRing::Call::Details::PEER_NUMBER ];
     const auto& peerName = details[ DRing::Call::Details::DISPLAY_NAME];
     const auto& account  = details[ DRing::Call::Details::ACCOUNTID   ];
@@ -473,7 +498,7 @@ Call* CallPrivate::buildCall(const QString& callId, Call::Direction callDirectio
     call->d_ptr->m_pParentCall  = nullptr;
 
     //Set the recording state
-    if (CallManager::instance().getIsRecording(callId)) {
+    if (isRecording) {
         call->d_ptr->m_mIsRecording[ Media::Media::Type::AUDIO ].setAt( Media::Media::Direction::IN  , true);
         call->d_ptr->m_mIsRecording[ Media::Media::Type::AUDIO ].setAt( Media::Media::Direction::OUT , true);
         call->d_ptr->m_mIsRecording[ Media::Media::Type::VIDEO ].setAt( Media::Media::Direction::IN  , true);
@@ -503,11 +528,16 @@ Call* CallPrivate::buildCall(const QString& callId, Call::Direction callDirectio
 ///Build a call from its ID
 Call* CallPrivate::buildExistingCall(const QString& callId)
 {
-    const auto& details = getCallDetailsCommon(callId);
+    return buildExistingCall(callId, getCallDetailsCommon(callId), CallManager::instance().getIsRecording(callId));
+}
+
+///Build a call from formatted details fetched in advance
+Call* CallPrivate::buildExistingCall(const QString& callId, const MapStringString& details, bool isRecording)
+{
     const auto daemon_state = details[DRing::Call::Details::CALL_STATE];
     const auto daemon_type = details[DRing::Call::Details::CALL_TYPE];
     const auto direction = daemon_type == CallPrivate::CallDirection::OUTGOING ? Call::Direction::OUTGOING : Call::Direction::INCOMING;
-    return buildCall(callId, direction, startStateFromDaemonCallState(daemon_state, daemon_type));
+    return buildCall(callId, direction, startStateFromDaemonCallState(daemon_state, daemon_type), details, isRecording);
 }
 
 ///Build a call from a dbus event
@@ -1411,17 +1441,13 @@ Call::State CallPrivate::stateChanged(const QString& newStateName)
          return m_CurrentState;
       }
 
-      MapStringString details = getCallDetailsCommon(m_DringId);
-      updateOutgoingMedia(details);
-
-      if (!details[DRing::Call::Details::DISPLAY_NAME].isEmpty()
-          and ( details[DRing::Call::Details::DISPLAY_NAME] != m_PeerName) )
-         q_ptr->setPeerName(details[DRing::Call::Details::DISPLAY_NAME]);
-
-      //Load the certificate if it's now available
-      if (!q_ptr->certificate() && !details[DRing::TlsTransport::TLS_PEER_CERT].isEmpty()) {
-         m_pCertificate = CertificateModel::instance().getCertificateFromId(details[DRing::TlsTransport::TLS_PEER_CERT], q_ptr->account());
-      }
+      //None of the transitions depend on those details, don't block on them
+      DaemonRequest::instance().invalidate(m_DringId);
+      DaemonRequest::instance().getCallDetails(m_DringId, q_ptr, [this](const MapStringString& d) {
+         MapStringString details = d;
+         formatCallDetails(details);
+         updateCallDetails(details);
+      });
 
       try {
          (this->*(stateChangedFunctionMap[previousState][dcs]))();
@@ -1766,8 +1792,7 @@ void CallPrivate::hangUp()
       qDebug() << "Error: Invalid call, the daemon may have crashed";
       changeCurrentState(Call::State::OVER);
    }
-   if (m_pTimer)
-      m_pTimer->stop();
+   CallHeartbeat::instance().remove(q_ptr);
 }
 
 ///Remove the call without contacting the daemon
@@ -2322,6 +2347,12 @@ void Call::reset()
  ****************************************************************************/
 
 void CallPrivate::updated()
+{
+    emit q_ptr->changed();
+}
+
+///Called by the heartbeat once per second while the call is in progress
+void CallPrivate::tick()
 {
     // If there is a video renderer, detect if no frame has been acquired for
     // more than 5 seconds.
@@ -2362,7 +2393,8 @@ void CallPrivate::updated()
             m_UnholdCounter++;
     }
 
-    emit q_ptr->changed();
+    // The models are notified in batch by the heartbeat
+    emit q_ptr->lengthChanged();
 }
 
 UserActionModel* Call::userActionModel() const
@@ -2372,29 +2404,29 @@ UserActionModel* Call::userActionModel() const
    return d_ptr->m_pUserActionModel;
 }
 
-///Check if creating a timer is necessary
+///Get the media quality time series, they are filled by the RTCP reports
+CallQualityModel* Call::qualityModel() const
+{
+   if (!d_ptr->m_pQualityModel)
+      d_ptr->m_pQualityModel = new CallQualityModel(const_cast<Call*>(this));
+   return d_ptr->m_pQualityModel;
+}
+
+///Check if the call needs to be updated every second
 void CallPrivate::initTimer()
 {
+   CallHeartbeat& heartbeat = CallHeartbeat::instance();
+
    if (q_ptr->lifeCycleState() == Call::LifeCycleState::PROGRESS
        || q_ptr->lifeCycleState() == Call::LifeCycleState::INITIALIZATION) {
-      if (!m_pTimer) {
-         m_pTimer = new QTimer(this);
-         m_pTimer->setInterval(1000);
-         connect(m_pTimer,SIGNAL(timeout()),this,SLOT(updated()));
-         connect(m_pTimer, &QTimer::timeout, this, [this]() {
-            emit q_ptr->lengthChanged();
-         });
-      }
-      if (!m_pTimer->isActive()) {
-         m_pTimer->start();
+      if (!heartbeat.contains(q_ptr)) {
+         heartbeat.add(q_ptr);
          emit q_ptr->lengthChanged();
       }
    }
-   else if (m_pTimer && q_ptr->lifeCycleState() != Call::LifeCycleState::PROGRESS) {
-      m_pTimer->stop();
+   else if (heartbeat.contains(q_ptr) && q_ptr->lifeCycleState() != Call::LifeCycleState::PROGRESS) {
+      heartbeat.remove(q_ptr);
       emit q_ptr->lengthChanged();
-      delete m_pTimer;
-      m_pTimer = nullptr;
    }
 }
 
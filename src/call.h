@@ -33,6 +33,7 @@ class QTimer;
 #include "itemdataroles.h"
 class Account               ;
 class UserActionModel       ;
+class CallQualityModel      ;
 class ContactMethod         ;
 class TemporaryContactMethod;
 class CollectionInterface   ;
@@ -88,6 +89,7 @@ public:
    friend class CallModel            ;
    friend class CallHistoryModel;
    friend class CallModelPrivate     ;
+   friend class CallHeartbeat        ;
    friend class IMConversationManager;
    friend class VideoRendererManager;
    friend class VideoRendererManagerPrivate;
@@ -302,6 +304,7 @@ public:
    Q_PROPERTY( QString            length             READ length            NOTIFY lengthChanged    )
    Q_PROPERTY( bool               recordingAV        READ isAVRecording     NOTIFY recordingChanged )
    Q_PROPERTY( UserActionModel*   userActionModel    READ userActionModel   CONSTANT                )
+   Q_PROPERTY( CallQualityModel*  qualityModel       READ qualityModel      CONSTANT                )
    Q_PROPERTY( QString            toHumanStateName   READ toHumanStateName  NOTIFY stateChanged     )
    Q_PROPERTY( bool               missed             READ isMissed          NOTIFY changed          )
    Q_PROPERTY( Direction          direction          READ direction         CONSTANT                )
@@ -344,6 +347,7 @@ public:
    const QString            formattedName    () const;
    QString                  length           () const;
    UserActionModel*         userActionModel  () const;
+   CallQualityModel*        qualityModel     () const;
    QString                  toHumanStateName () const;
    bool                     isMissed         () const;
    Call::Direction          direction        () const;
@@ -72,6 +72,9 @@ private:
 
 public Q_SLOTS:
    void add(Call* call);
+   void add(const QList<Call*>& calls);
+   HistoryNode* createNode(Call* call, HistoryNode* tl);
+   void watch(HistoryNode* item);
    void reloadCategories();
    void slotChanged(const QModelIndex& idx);
 };
@@ -86,6 +89,10 @@ struct HistoryNode final
    ~HistoryNode() {
       foreach (HistoryNode* n, m_lChildren)
          delete n;
+
+      // The call outlives the node when the categories are reloaded
+      for (const auto& c : qAsConst(m_lConnections))
+         QObject::disconnect(c);
    }
 
    //Attributes
@@ -96,6 +103,7 @@ struct HistoryNode final
    QString      m_Name                ;
    int          m_AbsIdx  { 0         };
    QVector<HistoryNode*> m_lChildren  ;
+   QVector<QMetaObject::Connection> m_lConnections;
 };
 
 CallMap CallHistoryModelPrivate::m_sHistoryCalls;
@@ -243,38 +251,62 @@ const CallMap CallHistoryModel::getHistoryCalls() const
 }
 
 ///Add to history
-void CallHistoryModelPrivate::add(Call* call)
+HistoryNode* CallHistoryModelPrivate::createNode(Call* call, HistoryNode* tl)
 {
-   if (!call || call->lifeCycleState() != Call::LifeCycleState::FINISHED || !call->startTimeStamp()) {
-      return;
-   }
+   HistoryNode* item = new HistoryNode();
 
-   emit q_ptr->newHistoryCall(call);
+   item->m_Type = HistoryNode::Type::CALL;
+   item->m_pCall = call;
+   item->m_pParent = tl;
 
-   HistoryNode* tl = getCategory(call);
+   watch(item);
 
-   const auto parentIdx = q_ptr->index(tl->m_Index, 0);
+   item->m_Index = tl->m_lChildren.size();
+   tl->m_lChildren << item;
 
-   q_ptr->beginInsertRows(parentIdx,tl->m_lChildren.size(),tl->m_lChildren.size());
+   //Try to prevent startTimeStamp() collisions, it technically doesn't work as time_t are signed
+   //we don't care
+   m_sHistoryCalls[(call->startTimeStamp() << 10)+qrand()%1024] = call;
 
-   HistoryNode* item = new HistoryNode();
+   return item;
+}
 
-   item->m_Type = HistoryNode::Type::CALL;
-   item->m_pCall = call;
-   item->m_pParent = tl;
+///Update the node when its call changes
+void CallHistoryModelPrivate::watch(HistoryNode* item)
+{
+   // The heartbeat only emits lengthChanged, don't refresh the other roles
+   static const QVector<int> lengthRoles {
+      static_cast<int>(Call::Role::Length),
+      static_cast<int>(Ring::Role::Length),
+   };
 
-   connect(call, &Call::changed, call, [this, item]() {
+   item->m_lConnections << connect(item->m_pCall, &Call::changed, this, [this, item]() {
       const QModelIndex idx = q_ptr->createIndex(item->m_Index, 0, item);
       emit q_ptr->dataChanged(idx, idx);
    });
 
+   item->m_lConnections << connect(item->m_pCall, &Call::lengthChanged, this, [this, item]() {
+      const QModelIndex idx = q_ptr->createIndex(item->m_Index, 0, item);
+      emit q_ptr->dataChanged(idx, idx, lengthRoles);
+   });
+}
+
+void CallHistoryModelPrivate::add(Call* call)
+{
+   if (!call || call->lifeCycleState() != Call::LifeCycleState::FINISHED || !call->startTimeStamp()) {
+      return;
+   }
+
+   emit q_ptr->newHistoryCall(call);
+
+   HistoryNode* tl = getCategory(call);
+
+   const auto parentIdx = q_ptr->index(tl->m_Index, 0);
+
    const int size = tl->m_lChildren.size();
-   item->m_Index = size;
-   tl->m_lChildren << item;
 
-   //Try to prevent startTimeStamp() collisions, it technically doesn't work as time_t are signed
-   //we don't care
-   m_sHistoryCalls[(call->startTimeStamp() << 10)+qrand()%1024] = call;
+   q_ptr->beginInsertRows(parentIdx,size,size);
+   HistoryNode* item = createNode(call, tl);
    q_ptr->endInsertRows();
 
    emit q_ptr->historyChanged();
@@ -287,6 +319,53 @@ void CallHistoryModelPrivate::add(Call* call)
    }
 }
 
+///Add many calls with a single insertion range per category
+void CallHistoryModelPrivate::add(const QList<Call*>& calls)
+{
+   QVector<HistoryNode*> categories;
+   QHash<HistoryNode*, QVector<Call*>> byCategory;
+
+   for (Call* call : qAsConst(calls)) {
+      if (!call || call->lifeCycleState() != Call::LifeCycleState::FINISHED || !call->startTimeStamp())
+         continue;
+
+      emit q_ptr->newHistoryCall(call);
+
+      // This can insert new categories, so the indices are computed later
+      HistoryNode* tl = getCategory(call);
+
+      auto& children = byCategory[tl];
+
+      if (children.isEmpty())
+         categories << tl;
+
+      children << call;
+   }
+
+   if (categories.isEmpty())
+      return;
+
+   for (HistoryNode* tl : qAsConst(categories)) {
+      const auto& children  = byCategory[tl];
+      const auto  parentIdx = q_ptr->index(tl->m_Index, 0);
+      const int   size      = tl->m_lChildren.size();
+
+      q_ptr->beginInsertRows(parentIdx, size, size + children.size() - 1);
+
+      for (Call* call : qAsConst(children))
+         createNode(call, tl);
+
+      q_ptr->endInsertRows();
+
+      //When the categories goes from 0 items to many, its conceptual state change
+      //therefore the clients may want to act on this, notify them
+      if (!size)
+         emit q_ptr->dataChanged(parentIdx, parentIdx);
+   }
+
+   emit q_ptr->historyChanged();
+}
+
 ///Set if the history has a limit
 void CallHistoryModel::setHistoryLimited(bool isLimited)
 {
@@ -352,12 +431,8 @@ void CallHistoryModelPrivate::reloadCategories()
          item->m_pCall = call;
          item->m_Index = category->m_lChildren.size();
 
-         connect(call, &Call::changed, call, [this, item]() {
-            const QModelIndex idx = q_ptr->createIndex(item->m_Index, 0, item);
-            emit q_ptr->dataChanged(idx, idx);
-         });
-
          item->m_pParent = category;
+         watch(item);
          q_ptr->beginInsertRows(q_ptr->index(category->m_Index,0), item->m_Index, item->m_Index); {
             category->m_lChildren << item;
          } q_ptr->endInsertRows();
@@ -594,6 +669,12 @@ bool CallHistoryModel::addItemCallback(const Call* item)
    return true;
 }
 
+bool CallHistoryModel::addItemsCallback(const QList<Call*>& items)
+{
+   d_ptr->add(items);
+   return true;
+}
+
 bool CallHistoryModel::removeItemCallback(const Call* item)
 {
    emit const_cast<Call*>(item)->changed();
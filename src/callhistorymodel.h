@@ -115,6 +115,7 @@ private:
    //Backend interface
    virtual void collectionAddedCallback(CollectionInterface* collection) override;
    virtual bool addItemCallback(const Call* item) override;
+   virtual bool addItemsCallback(const QList<Call*>& items) override;
    virtual bool removeItemCallback(const Call* item) override;
 
 Q_SIGNALS:
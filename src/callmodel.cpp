@@ -25,6 +25,7 @@
 #include <QtCore/QCoreApplication>
 #include <QtCore/QMimeData>
 #include <QtCore/QItemSelectionModel>
+#include <QtCore/QSet>
 
 //Ring library
 #include "call.h"
@@ -63,6 +64,9 @@
 
 //Private
 #include "private/call_p.h"
+#include "private/daemonhydrator_p.h"
+#include "private/callheartbeat_p.h"
+#include "private/callqualitymodel_p.h"
 
 //Define
 ///InternalStruct: internal representation of a call
@@ -126,6 +130,7 @@ private Q_SLOTS:
     void slotVideoMutex         ( const QString& callId    , bool state             );
     void slotPeerHold           ( const QString& callId    , bool state             );
     void slotRtcpReportReceived ( const QString& callId    , const MapStringInt& m  );
+    void slotHeartbeat          ( const QVector<Call*>& calls                       );
 };
 
 
@@ -179,21 +184,28 @@ void CallModelPrivate::init()
     /*                                                                                                                           */
 
     connect(Session::instance()->historyModel(),SIGNAL(newHistoryCall(Call*)),this,SLOT(slotAddPrivateCall(Call*)));
+    connect(&CallHeartbeat::instance(), &CallHeartbeat::ticked, this, &CallModelPrivate::slotHeartbeat);
 
     // Delay adding the calls so the session has time to be initialized. Not
     // doing so will cause signals to be emitted before they are connected and
     // Session::instance()->callModel() called recursively.
     QTimer::singleShot(0, [this]() {
-        CallManagerInterface& callManager = CallManager::instance();
-
-        const QStringList callList = getCallList();
-        for (const QString& callId : qAsConst(callList)) {
-            Call* tmpCall = CallPrivate::buildExistingCall(callId);
+        // Send the requests of all calls at once rather than one by one
+        QVector<DaemonHydrator::CallData> callList;
+        QStringList confList;
+        DaemonHydrator::instance().fetchCalls();
+        DaemonHydrator::instance().takeCalls(callList, confList);
+
+        for (auto& c : callList) {
+            //LibRingClient doesn't [need to] handle INACTIVE calls
+            if (c.m_Details[DRing::Call::Details::CALL_STATE] == DRing::Call::StateEvent::INACTIVE)
+                continue;
+
+            CallPrivate::formatCallDetails(c.m_Details);
+            Call* tmpCall = CallPrivate::buildExistingCall(c.m_Id, c.m_Details, c.m_IsRecording);
             addCall2(tmpCall);
         }
 
-        const QStringList confList = callManager.getConferenceList();
-
         for (const QString& confId : qAsConst(confList)) {
             Call* conf = addConference(confId);
             emit q_ptr->conferenceCreated(conf);
@@ -1735,6 +1747,41 @@ void CallModelPrivate::slotCallChanged()
     emit q_ptr->dataChanged(idx,idx);
 }
 
+/**
+ * Only the lengths changed. Send one range per level of the tree for all
+ * the calls rather than one signal per call.
+ */
+void CallModelPrivate::slotHeartbeat(const QVector<Call*>& calls)
+{
+    static const QVector<int> roles {
+        static_cast<int>(Call::Role::Length),
+        static_cast<int>(Ring::Role::Length),
+    };
+
+    const QSet<Call*> ticked = calls.toList().toSet();
+
+    const auto notify = [this, &ticked](const QList<InternalStruct*>& rows, const QModelIndex& parent) {
+        int first(-1), last(-1);
+
+        for (int i = 0; i < rows.size(); i++) {
+            if (ticked.contains(rows[i]->call_real)) {
+                first = first == -1 ? i : first;
+                last  = i;
+            }
+        }
+
+        if (first != -1)
+            emit q_ptr->dataChanged(q_ptr->index(first, 0, parent), q_ptr->index(last, 0, parent), roles);
+    };
+
+    notify(m_lInternalModel, {});
+
+    for (int i = 0; i < m_lInternalModel.size(); i++) {
+        if (!m_lInternalModel[i]->m_lChildren.isEmpty())
+            notify(m_lInternalModel[i]->m_lChildren, q_ptr->index(i, 0));
+    }
+}
+
 ///Add call slot
 void CallModelPrivate::slotAddPrivateCall(Call* call)
 {
@@ -1826,8 +1873,8 @@ void CallModelPrivate::slotPeerHold( const QString& callId, bool state)
 
 void CallModelPrivate::slotRtcpReportReceived(const QString& callId, const MapStringInt& m)
 {
-    Q_UNUSED(callId)
-    Q_UNUSED(m)
+    if (auto call = q_ptr->getCall(callId))
+        CallQualityModelPrivate::addRtcpReport(call, m);
 }
 
 void CallModelPrivate::slotSelectionChanged(const QModelIndex& idx)
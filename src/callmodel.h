@@ -55,6 +55,8 @@ Q_OBJECT
    friend class CallPrivate;
    //The renderer use DringId as identifiers and have to be matched to calls
    friend class VideoRendererManagerPrivate;
+   //SmartInfo samples are identified by the DringId
+   friend class CallQualityModelPrivate;
 
    friend class Session; // Factory
 public:
@@ -0,0 +1,450 @@
+/************************************************************************************
+ *   Copyright (C) 2018 by BlueSystems GmbH                                         *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                            *
+ *                                                                                  *
+ *   This library is free software; you can redistribute it and/or                  *
+ *   modify it under the terms of the GNU Lesser General Public                     *
+ *   License as published by the Free Software Foundation; either                   *
+ *   version 2.1 of the License, or (at your option) any later version.             *
+ *                                                                                  *
+ *   This library is distributed in the hope that it will be useful,                *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of                 *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU              *
+ *   Lesser General Public License for more details.                                *
+ *                                                                                  *
+ *   You should have received a copy of the GNU Lesser General Public               *
+ *   License along with this library; if not, write to the Free Software            *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA *
+ ***********************************************************************************/
+#include "callqualitymodel.h"
+
+// Std
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// Qt
+#include <QtCore/QDateTime>
+
+// Ring
+#include <call.h>
+#include <session.h>
+#include <callmodel.h>
+#include "private/callqualitymodel_p.h"
+#include "private/smartInfoHub_p.h"
+
+void QualitySeries::Bucket::merge(const Bucket& other)
+{
+    if (!other.m_Count)
+        return;
+
+    if (!m_Count) {
+        *this = other;
+        return;
+    }
+
+    const qint64 start = std::min(m_Time, other.m_Time);
+    const qint64 stop  = std::max(end() , other.end() );
+
+    m_Time      = start;
+    m_Duration  = static_cast<quint32>(stop - start);
+    m_Count    += other.m_Count;
+    m_Min       = std::min(m_Min, other.m_Min);
+    m_Max       = std::max(m_Max, other.m_Max);
+    m_Sum      += other.m_Sum;
+}
+
+void QualitySeries::Level::push(const Bucket& b)
+{
+    m_lBuckets[m_Head] = b;
+    m_Head = (m_Head + 1) % CAPACITY;
+    m_Size = std::min(m_Size + 1, CAPACITY);
+}
+
+const QualitySeries::Bucket& QualitySeries::Level::at(int i) const
+{
+    return m_lBuckets[(m_Head - m_Size + i + CAPACITY) % CAPACITY];
+}
+
+void QualitySeries::push(int level, const Bucket& b)
+{
+    Level& l = m_lLevels[level];
+
+    l.push(b);
+
+    if (level + 1 == LEVELS)
+        return;
+
+    l.m_Pending.merge(b);
+
+    if (++l.m_PendingSize == FACTOR) {
+        const Bucket merged = l.m_Pending;
+        l.m_Pending     = {};
+        l.m_PendingSize = 0;
+        push(level + 1, merged);
+    }
+}
+
+void QualitySeries::add(float value, qint64 time)
+{
+    Bucket b;
+    b.m_Time  = time;
+    b.m_Count = 1;
+    b.m_Min   = value;
+    b.m_Max   = value;
+    b.m_Sum   = value;
+
+    m_Last = value;
+
+    push(0, b);
+}
+
+QVector<QualitySeries::Bucket> QualitySeries::buckets(qint64 since) const
+{
+    QVector<Bucket> ret;
+
+    for (int l = LEVELS - 1; l >= 0; l--) {
+        const Level& level = m_lLevels[l];
+
+        // The coarse levels are only used for what the finer ones evicted
+        const qint64 boundary = (l && m_lLevels[l-1].m_Size) ?
+            m_lLevels[l-1].at(0).m_Time : std::numeric_limits<qint64>::max();
+
+        for (int i = 0; i < level.m_Size; i++) {
+            const Bucket& b = level.at(i);
+
+            if (b.end() >= boundary)
+                break;
+
+            if (b.end() >= since)
+                ret << b;
+        }
+    }
+
+    return ret;
+}
+
+CallQualityModelPrivate::~CallQualityModelPrivate()
+{
+    for (auto s : m_lSeries)
+        delete s;
+}
+
+CallQualityModel::CallQualityModel(Call* parent) : QAbstractListModel(parent),
+    d_ptr(new CallQualityModelPrivate(this))
+{
+    d_ptr->m_pCall = parent;
+}
+
+CallQualityModel::~CallQualityModel()
+{
+    delete d_ptr;
+}
+
+void CallQualityModelPrivate::add(CallQualityModel::Metric m, float value, qint64 time)
+{
+    auto& s = m_lSeries[static_cast<int>(m)];
+
+    // Audio only calls never allocate the video series
+    if (!s)
+        s = new QualitySeries();
+
+    s->add(value, time);
+}
+
+void CallQualityModelPrivate::commit()
+{
+    emit q_ptr->dataChanged(
+        q_ptr->index(0, 0),
+        q_ptr->index(static_cast<int>(CallQualityModel::Metric::COUNT__) - 1, 0)
+    );
+
+    emit q_ptr->samplesAdded();
+}
+
+void CallQualityModelPrivate::addRtcpReport(Call* c, const MapStringInt& report)
+{
+    // The report content changed between daemon versions, accept both names
+    static const QHash<QString, CallQualityModel::Metric> keys {
+        { QStringLiteral("PL"        ), CallQualityModel::Metric::PACKET_LOSS     },
+        { QStringLiteral("packetLoss"), CallQualityModel::Metric::PACKET_LOSS     },
+        { QStringLiteral("jitter"    ), CallQualityModel::Metric::JITTER          },
+        { QStringLiteral("Jitter"    ), CallQualityModel::Metric::JITTER          },
+        { QStringLiteral("RTT"       ), CallQualityModel::Metric::ROUND_TRIP_TIME },
+        { QStringLiteral("rtt"       ), CallQualityModel::Metric::ROUND_TRIP_TIME },
+        { QStringLiteral("bitrate"   ), CallQualityModel::Metric::BITRATE         },
+        { QStringLiteral("Bitrate"   ), CallQualityModel::Metric::BITRATE         },
+    };
+
+    if ((!c) || report.isEmpty())
+        return;
+
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    auto d = c->qualityModel()->d_ptr;
+    bool changed = false;
+
+    for (auto i = report.constBegin(); i != report.constEnd(); ++i) {
+        const auto k = keys.constFind(i.key());
+
+        if (k == keys.constEnd())
+            continue;
+
+        d->add(*k, i.value(), now);
+        changed = true;
+    }
+
+    if (changed)
+        d->commit();
+}
+
+void CallQualityModelPrivate::addSmartInfo(const MapStringString& info)
+{
+    static const QPair<QString, CallQualityModel::Metric> keys[] = {
+        { LOCAL_FPS    , CallQualityModel::Metric::LOCAL_FPS         },
+        { REMOTE_FPS   , CallQualityModel::Metric::REMOTE_FPS        },
+        { LOCAL_HEIGHT , CallQualityModel::Metric::LOCAL_RESOLUTION  },
+        { REMOTE_HEIGHT, CallQualityModel::Metric::REMOTE_RESOLUTION },
+    };
+
+    const QString callId = info[CALL_ID];
+
+    if (callId.isEmpty())
+        return;
+
+    auto c = Session::instance()->callModel()->getCall(callId);
+
+    if (!c)
+        return;
+
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    auto d = c->qualityModel()->d_ptr;
+    bool changed = false;
+
+    for (const auto& k : keys) {
+        const auto v = info.constFind(k.first);
+
+        if (v == info.constEnd() || v->isEmpty())
+            continue;
+
+        bool ok = false;
+        const float value = v->toFloat(&ok);
+
+        if (!ok)
+            continue;
+
+        d->add(k.second, value, now);
+        changed = true;
+    }
+
+    if (changed)
+        d->commit();
+}
+
+QVariant CallQualityModel::data( const QModelIndex& index, int role ) const
+{
+    if (!index.isValid())
+        return {};
+
+    const auto m = static_cast<Metric>(index.row());
+
+    switch(role) {
+        case Qt::DisplayRole:
+            switch(m) {
+                case Metric::JITTER:
+                    return tr("Jitter");
+                case Metric::PACKET_LOSS:
+                    return tr("Packet loss");
+                case Metric::ROUND_TRIP_TIME:
+                    return tr("Round trip time");
+                case Metric::BITRATE:
+                    return tr("Bitrate");
+                case Metric::LOCAL_FPS:
+                    return tr("Outgoing frame rate");
+                case Metric::REMOTE_FPS:
+                    return tr("Incoming frame rate");
+                case Metric::LOCAL_RESOLUTION:
+                    return tr("Outgoing resolution");
+                case Metric::REMOTE_RESOLUTION:
+                    return tr("Incoming resolution");
+                case Metric::COUNT__:
+                    break;
+            }
+            break;
+        case static_cast<int>(Role::Unit):
+            switch(m) {
+                case Metric::JITTER:
+                case Metric::ROUND_TRIP_TIME:
+                    return QStringLiteral("ms");
+                case Metric::PACKET_LOSS:
+                    return QStringLiteral("%");
+                case Metric::BITRATE:
+                    return QStringLiteral("kbit/s");
+                case Metric::LOCAL_FPS:
+                case Metric::REMOTE_FPS:
+                    return QStringLiteral("fps");
+                case Metric::LOCAL_RESOLUTION:
+                case Metric::REMOTE_RESOLUTION:
+                    return QStringLiteral("p");
+                case Metric::COUNT__:
+                    break;
+            }
+            break;
+        case static_cast<int>(Role::Metric):
+            return QVariant::fromValue(m);
+        case static_cast<int>(Role::HasSamples):
+            return d_ptr->m_lSeries[index.row()] != nullptr;
+        case static_cast<int>(Role::Current):
+            return statistics(m).current;
+        case static_cast<int>(Role::Minimum):
+            return statistics(m).minimum;
+        case static_cast<int>(Role::Average):
+            return statistics(m).average;
+        case static_cast<int>(Role::Percentile95):
+            return statistics(m).p95;
+        case static_cast<int>(Role::Maximum):
+            return statistics(m).maximum;
+        case static_cast<int>(Role::SampleCount):
+            return statistics(m).count;
+        case static_cast<int>(Role::History): {
+            QVariantList ret;
+            const auto points = history(m);
+            ret.reserve(points.size());
+
+            for (const auto& p : points)
+                ret << p;
+
+            return ret;
+        }
+    }
+
+    return {};
+}
+
+int CallQualityModel::rowCount( const QModelIndex& parent ) const
+{
+    return parent.isValid() ? 0 : static_cast<int>(Metric::COUNT__);
+}
+
+QHash<int,QByteArray> CallQualityModel::roleNames() const
+{
+    static QHash<int, QByteArray> roles = QAbstractItemModel::roleNames();
+    static bool initRoles = false;
+    if (!initRoles) {
+        initRoles = true;
+        roles.insert(static_cast<int>(Role::Metric      ) , QByteArray("metric"      ));
+        roles.insert(static_cast<int>(Role::Unit        ) , QByteArray("unit"        ));
+        roles.insert(static_cast<int>(Role::HasSamples  ) , QByteArray("hasSamples"  ));
+        roles.insert(static_cast<int>(Role::Current     ) , QByteArray("current"     ));
+        roles.insert(static_cast<int>(Role::Minimum     ) , QByteArray("minimum"     ));
+        roles.insert(static_cast<int>(Role::Average     ) , QByteArray("average"     ));
+        roles.insert(static_cast<int>(Role::Percentile95) , QByteArray("percentile95"));
+        roles.insert(static_cast<int>(Role::Maximum     ) , QByteArray("maximum"     ));
+        roles.insert(static_cast<int>(Role::SampleCount ) , QByteArray("sampleCount" ));
+        roles.insert(static_cast<int>(Role::History     ) , QByteArray("history"     ));
+    }
+    return roles;
+}
+
+int CallQualityModel::window() const
+{
+    return d_ptr->m_Window;
+}
+
+Call* CallQualityModel::call() const
+{
+    return d_ptr->m_pCall;
+}
+
+void CallQualityModel::setWindow(int seconds)
+{
+    if (seconds <= 0 || seconds == d_ptr->m_Window)
+        return;
+
+    d_ptr->m_Window = seconds;
+
+    emit windowChanged(seconds);
+    emit dataChanged(index(0, 0), index(rowCount() - 1, 0));
+}
+
+CallQualityModel::Statistics CallQualityModel::statistics(Metric m, int seconds) const
+{
+    Statistics ret;
+
+    const auto s = d_ptr->m_lSeries[static_cast<int>(m)];
+
+    if (!s)
+        return ret;
+
+    if (seconds < 0)
+        seconds = d_ptr->m_Window;
+
+    ret.current = s->last();
+
+    const auto buckets = s->buckets(
+        QDateTime::currentMSecsSinceEpoch() - static_cast<qint64>(seconds) * 1000
+    );
+
+    if (buckets.isEmpty())
+        return ret;
+
+    // The downsampled buckets only know their average, so the percentile is
+    // weighted by the number of samples each of them represents.
+    QVector<QPair<float, quint32>> values;
+    values.reserve(buckets.size());
+
+    double  sum   = 0;
+    quint32 count = 0;
+
+    ret.minimum = std::numeric_limits<float>::max   ();
+    ret.maximum = std::numeric_limits<float>::lowest();
+
+    for (const auto& b : qAsConst(buckets)) {
+        sum   += b.m_Sum;
+        count += b.m_Count;
+        ret.minimum = std::min(ret.minimum, b.m_Min);
+        ret.maximum = std::max(ret.maximum, b.m_Max);
+        values << qMakePair(b.average(), b.m_Count);
+    }
+
+    std::sort(values.begin(), values.end());
+
+    const quint32 rank = static_cast<quint32>(std::ceil(0.95 * count));
+    quint32 seen = 0;
+
+    for (const auto& v : qAsConst(values)) {
+        seen += v.second;
+        if (seen >= rank) {
+            ret.p95 = v.first;
+            break;
+        }
+    }
+
+    ret.average = sum / count;
+    ret.count   = static_cast<int>(count);
+
+    return ret;
+}
+
+QVector<QPointF> CallQualityModel::history(Metric m, int seconds) const
+{
+    QVector<QPointF> ret;
+
+    const auto s = d_ptr->m_lSeries[static_cast<int>(m)];
+
+    if (!s)
+        return ret;
+
+    if (seconds < 0)
+        seconds = d_ptr->m_Window;
+
+    const auto buckets = s->buckets(
+        QDateTime::currentMSecsSinceEpoch() - static_cast<qint64>(seconds) * 1000
+    );
+
+    ret.reserve(buckets.size());
+
+    for (const auto& b : buckets)
+        ret << QPointF(b.m_Time + b.m_Duration/2, b.average());
+
+    return ret;
+}
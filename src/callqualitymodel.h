@@ -0,0 +1,127 @@
+/************************************************************************************
+ *   Copyright (C) 2018 by BlueSystems GmbH                                         *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                            *
+ *                                                                                  *
+ *   This library is free software; you can redistribute it and/or                  *
+ *   modify it under the terms of the GNU Lesser General Public                     *
+ *   License as published by the Free Software Foundation; either                   *
+ *   version 2.1 of the License, or (at your option) any later version.             *
+ *                                                                                  *
+ *   This library is distributed in the hope that it will be useful,                *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of                 *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU              *
+ *   Lesser General Public License for more details.                                *
+ *                                                                                  *
+ *   You should have received a copy of the GNU Lesser General Public               *
+ *   License along with this library; if not, write to the Free Software            *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA *
+ ***********************************************************************************/
+#pragma once
+
+#include <QtCore/QAbstractListModel>
+#include <QtCore/QVector>
+#include <QtCore/QPointF>
+
+#include <typedefs.h>
+#include <itemdataroles.h>
+
+class Call;
+class CallQualityModelPrivate;
+
+/**
+ * Time series of the media quality metrics of a call.
+ *
+ * The daemon periodically sends RTCP reports and "SmartInfo" samples. Rather
+ * than only keeping the last value, they are accumulated in fixed size ring
+ * buffers. Older samples are merged into coarser buckets so a long call uses
+ * the same amount of memory as a short one.
+ *
+ * There is one row per metric. The aggregated roles (minimum, average, 95th
+ * percentile and maximum) are computed over the last `window` seconds.
+ *
+ * Use Call::qualityModel() to get an instance.
+ */
+class LIB_EXPORT CallQualityModel final : public QAbstractListModel
+{
+    Q_OBJECT
+    friend class Call;
+    friend class CallQualityModelPrivate;
+public:
+    Q_PROPERTY(int window READ window WRITE setWindow NOTIFY windowChanged)
+
+    enum class Metric {
+        JITTER           , /*!< Receiver jitter in milliseconds              */
+        PACKET_LOSS      , /*!< Fraction of the packets lost, in percent      */
+        ROUND_TRIP_TIME  , /*!< RTCP round trip time in milliseconds          */
+        BITRATE          , /*!< Received bitrate in kbit/s                    */
+        LOCAL_FPS        , /*!< Frames per seconds of the outgoing video      */
+        REMOTE_FPS       , /*!< Frames per seconds of the incoming video      */
+        LOCAL_RESOLUTION , /*!< Height (in lines) of the outgoing video       */
+        REMOTE_RESOLUTION, /*!< Height (in lines) of the incoming video       */
+        COUNT__
+    };
+    Q_ENUM(Metric)
+
+    enum class Role {
+        Metric       = static_cast<int>(Ring::Role::UserRole) + 100,
+        Unit         ,
+        HasSamples   ,
+        Current      ,
+        Minimum      ,
+        Average      ,
+        Percentile95 ,
+        Maximum      ,
+        SampleCount  ,
+        History      , /*!< QVariantList of QPointF (msecs since epoch, value) */
+    };
+
+    /// The aggregated value of a metric over a window
+    struct Statistics {
+        float current {0};
+        float minimum {0};
+        float average {0};
+        float p95     {0};
+        float maximum {0};
+        int   count   {0};
+    };
+
+    virtual ~CallQualityModel();
+
+    // Model
+    virtual QVariant data    ( const QModelIndex& index, int role = Qt::DisplayRole ) const override;
+    virtual int      rowCount( const QModelIndex& parent = {}                       ) const override;
+    virtual QHash<int,QByteArray> roleNames() const override;
+
+    // Getters
+    int window() const;
+    Call* call() const;
+
+    /**
+     * Aggregate the samples of the last `seconds` seconds. If `seconds` is
+     * negative, the window property is used.
+     */
+    Statistics statistics(Metric m, int seconds = -1) const;
+
+    /**
+     * The (possibly downsampled) averages for the last `seconds` seconds,
+     * oldest first. The x axis is in milliseconds since epoch.
+     */
+    QVector<QPointF> history(Metric m, int seconds = -1) const;
+
+    // Setters
+    void setWindow(int seconds);
+
+Q_SIGNALS:
+    void windowChanged(int seconds);
+
+    /// Emitted (once per report) when new samples have been added
+    void samplesAdded();
+
+private:
+    explicit CallQualityModel(Call* parent);
+
+    CallQualityModelPrivate* d_ptr;
+    Q_DECLARE_PRIVATE(CallQualityModel)
+};
+
+Q_DECLARE_METATYPE(CallQualityModel*)
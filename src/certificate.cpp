@@ -34,6 +34,8 @@
 #include "libcard/matrixutils.h"
 #include "private/certificatemodel_p.h"
 #include "private/certificate_p.h"
+#include "private/daemonrequest_p.h"
+#include "private/certificatecache_p.h"
 #include <account.h>
 #include <chainoftrustmodel.h>
 #include "contactmethod.h"
@@ -203,13 +205,28 @@ ChecksCache::ChecksCache(const MapStringString& checks)
    m_NotActivated                        = CertificatePrivate::toBool(checks[DRing::Certificate::ChecksNames::NOT_ACTIVATED                    ]);
 }
 
+/**
+ * Password protected keys are never written to the disk cache, the results
+ * would leak if the key is valid.
+ */
+bool CertificatePrivate::isCacheable() const
+{
+   return m_LoadingType == LoadingType::FROM_PATH && m_PrivateKeyPassword.isEmpty();
+}
+
 void CertificatePrivate::loadDetails(bool reload)
 {
    if (!m_pDetailsCache || reload) {
       MapStringString d;
       switch(m_LoadingType) {
          case LoadingType::FROM_PATH:
+            if ((!reload) && isCacheable() && CertificateCache::instance().details(m_Path, m_PrivateKey, d))
+               break;
+
             d = ConfigurationManager::instance().getCertificateDetailsPath(m_Path, m_PrivateKey, m_PrivateKeyPassword);
+
+            if (isCacheable())
+               CertificateCache::instance().insertDetails(m_Path, m_PrivateKey, d);
             break;
          case LoadingType::FROM_ID:
             d = ConfigurationManager::instance().getCertificateDetails(m_Id);
@@ -225,7 +242,13 @@ void CertificatePrivate::loadChecks(bool reload)
       MapStringString checks;
       switch(m_LoadingType) {
          case LoadingType::FROM_PATH:
+            if ((!reload) && isCacheable() && CertificateCache::instance().checks(m_Path, m_PrivateKey, checks))
+               break;
+
             checks = ConfigurationManager::instance().validateCertificatePath(QString(),m_Path,m_PrivateKey, m_PrivateKeyPassword, {});
+
+            if (isCacheable())
+               CertificateCache::instance().insertChecks(m_Path, m_PrivateKey, checks);
             break;
          case LoadingType::FROM_ID:
             checks = ConfigurationManager::instance().validateCertificate(QString(),m_Id);
@@ -238,6 +261,82 @@ void CertificatePrivate::loadChecks(bool reload)
    }
 }
 
+/**
+ * Fetch the details without blocking. If they arrive before the first
+ * access, loadDetails() won't have to wait for the daemon.
+ */
+void CertificatePrivate::requestDetails()
+{
+   if (m_pDetailsCache)
+      return;
+
+   const auto apply = [this](const MapStringString& d) {
+      //They may have been loaded synchronously in the meantime
+      if (m_pDetailsCache)
+         return;
+
+      m_pDetailsCache = new DetailsCache(d);
+
+      if (isCacheable())
+         CertificateCache::instance().insertDetails(m_Path, m_PrivateKey, d);
+
+      emit q_ptr->changed();
+   };
+
+   MapStringString cached;
+
+   if (isCacheable() && CertificateCache::instance().details(m_Path, m_PrivateKey, cached)) {
+      m_pDetailsCache = new DetailsCache(cached);
+      return;
+   }
+
+   switch(m_LoadingType) {
+      case LoadingType::FROM_PATH:
+         DaemonRequest::instance().getCertificateDetailsPath(m_Path, m_PrivateKey, m_PrivateKeyPassword, q_ptr, apply);
+         break;
+      case LoadingType::FROM_ID:
+         DaemonRequest::instance().getCertificateDetails(m_Id, q_ptr, apply);
+         break;
+   }
+}
+
+///Same as requestDetails() for the checks
+void CertificatePrivate::requestChecks()
+{
+   if (m_pCheckCache)
+      return;
+
+   const auto apply = [this](const MapStringString& checks) {
+      if (m_pCheckCache)
+         return;
+
+      m_pCheckCache = new ChecksCache(checks);
+
+      if (isCacheable())
+         CertificateCache::instance().insertChecks(m_Path, m_PrivateKey, checks);
+
+      CertificateModel::instance().d_ptr->regenChecks(q_ptr);
+      emit q_ptr->changed();
+   };
+
+   MapStringString cached;
+
+   if (isCacheable() && CertificateCache::instance().checks(m_Path, m_PrivateKey, cached)) {
+      m_pCheckCache = new ChecksCache(cached);
+      CertificateModel::instance().d_ptr->regenChecks(q_ptr);
+      return;
+   }
+
+   switch(m_LoadingType) {
+      case LoadingType::FROM_PATH:
+         DaemonRequest::instance().validateCertificatePath(QString(), m_Path, m_PrivateKey, m_PrivateKeyPassword, q_ptr, apply);
+         break;
+      case LoadingType::FROM_ID:
+         DaemonRequest::instance().validateCertificate(QString(), m_Id, q_ptr, apply);
+         break;
+   }
+}
+
 Certificate::Certificate(const QString& path, Type type, const QString& privateKey) : ItemBase(&CertificateModel::instance()),d_ptr(new CertificatePrivate(this,LoadingType::FROM_PATH))
 {
    Q_UNUSED(privateKey)
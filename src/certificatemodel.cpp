@@ -42,6 +42,7 @@
 #include "collections/daemoncertificatecollection.h"
 #include "libcard/matrixutils.h"
 #include "private/certificatemodel_p.h"
+#include "private/certificate_p.h"
 #include "accountmodel.h"
 
 /*
@@ -171,7 +172,7 @@ CertificateNode::~CertificateNode()
 CertificateModelPrivate::CertificateModelPrivate(CertificateModel* parent) : QObject(parent), q_ptr(parent),
  m_pDefaultCategory(nullptr), m_CertLoader(), m_GroupCounter(-1)
 {
-    connect(&ConfigurationManager::instance(), &ConfigurationManagerInterface::certificateStateChanged, this, &CertificateModelPrivate::slotCertificateStateChanged);
+    connect(&DaemonSignalBridge::instance(), &DaemonSignalBridge::certificateStatesChanged, this, &CertificateModelPrivate::slotCertificateStatesChanged);
 }
 
 CertificateModel::CertificateModel(QObject* parent) : QAbstractItemModel(parent), CollectionManagerInterface<Certificate>(this),
@@ -687,6 +688,14 @@ Certificate* CertificateModel::getCertificateFromId(const QString& id, Account*
    if (!cert) {
       cert = new Certificate(id);
 
+      //Most of them are discovered during a call state change, don't block
+      //the first access on two daemon round-trips. The collections can also
+      //be loaded from a thread, they keep the synchronous path.
+      if (QThread::currentThread() == thread()) {
+         cert->d_ptr->requestDetails();
+         cert->d_ptr->requestChecks();
+      }
+
       { // mutex
       QMutexLocker(&d_ptr->m_CertInsertion);
       d_ptr->m_hCertificates[id.toLatin1()] = cert;
@@ -1023,6 +1032,12 @@ void CertificateModelPrivate::slotCertificateStateChanged(const QString& account
     }
 }
 
+void CertificateModelPrivate::slotCertificateStatesChanged(const QVector<DaemonSignalBridge::CertificateStateEvent>& events)
+{
+    for (const auto& e : qAsConst(events))
+        slotCertificateStateChanged(e.accountId, e.certId, e.state);
+}
+
 void CertificateModel::collectionAddedCallback(CollectionInterface* collection)
 {
    Q_UNUSED(collection)
@@ -51,7 +51,7 @@ CipherModelPrivate::CipherModelPrivate(Account* parent) : m_pAccount(parent),m_U
 {
    m_lChecked = new bool[m_slSupportedCiphers.size()]{};
 
-   foreach(const QString& cipher, parent->d_ptr->accountDetail(DRing::Account::ConfProperties::TLS::CIPHERS).split(' ')) {
+   foreach(const QString& cipher, parent->d_ptr->properties().toString(AccountProperties::Key::TLS_CIPHERS).split(' ')) {
       if (!cipher.trimmed().isEmpty()) {
          m_lChecked[m_shMapping[cipher]] = true;
          m_UseDefault = false;
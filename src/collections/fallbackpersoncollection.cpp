@@ -33,13 +33,14 @@
 #include "private/vcardutils.h"
 #include "contactmethod.h"
 #include "picocms/collectioneditor.h"
+#include "picocms/collectionloader.h"
 #include "globalinstances.h"
 #include "individual.h"
 #include "session.h"
 #include "interfaces/pixmapmanipulatori.h"
 #include "interfaces/actionextenderi.h"
 #include "interfaces/itemmodelstateserializeri.h"
-#include "private/threadworker.h"
+#include "private/vcardscanner_p.h"
 
 class FallbackPersonBackendEditor final : public CollectionEditor<Person>
 {
@@ -51,9 +52,13 @@ public:
    virtual bool addNew     ( Person*       item ) override;
    virtual bool addExisting( const Person* item ) override;
 
+   Person* itemForPath(const QString& path) const;
+   void    drop       (Person* item             );
+
    QVector<Person*>             m_lItems;
    QString                      m_Path  ;
    QHash<const Person*,QString> m_hPaths;
+   VCardScanner*                m_pScanner {nullptr};
 
 private:
    virtual QVector<Person*> items() const override;
@@ -68,11 +73,15 @@ public:
    QString                      m_Path        ;
    QString                      m_Name        ;
    bool                         m_Async {true};
+   VCardScanner*                m_pScanner {nullptr};
 
    FallbackPersonCollection* q_ptr;
 
 public Q_SLOTS:
    void loadAsync();
+   void slotFileAdded   (const QString& path, Person* p                );
+   void slotFileModified(const QString& path, const QByteArray& content);
+   void slotFileRemoved (const QString& path                           );
 };
 
 FallbackPersonCollectionPrivate::FallbackPersonCollectionPrivate(FallbackPersonCollection* parent, CollectionMediator<Person>* mediator, const QString& path) : q_ptr(parent), m_pMediator(mediator), m_Path(path)
@@ -91,6 +100,13 @@ FallbackPersonCollectionPrivate::FallbackPersonCollectionPrivate(FallbackPersonC
       m_Name[0] = m_Name[0].toUpper();
    else
       m_Name = QLatin1String("vCard");
+
+   m_pScanner = new VCardScanner(m_Path, this);
+   static_cast<FallbackPersonBackendEditor*>(q_ptr->editor<Person>())->m_pScanner = m_pScanner;
+
+   connect(m_pScanner, &VCardScanner::added   , this, &FallbackPersonCollectionPrivate::slotFileAdded   );
+   connect(m_pScanner, &VCardScanner::modified, this, &FallbackPersonCollectionPrivate::slotFileModified);
+   connect(m_pScanner, &VCardScanner::removed , this, &FallbackPersonCollectionPrivate::slotFileRemoved );
 }
 
 FallbackPersonCollection::FallbackPersonCollection(CollectionMediator<Person>* mediator, const QString& path, bool async, FallbackPersonCollection* parent) :
@@ -126,7 +142,8 @@ bool FallbackPersonBackendEditor::save(const Person* item)
       const_cast<Person*>(item)->setUid(hash.result().toHex());
    }
 
-   const QString path = m_Path+'/'+item->uid()+".vcf";
+   // Use the same form as the scanner to look it up later
+   const QString path = QDir(m_Path).absoluteFilePath(item->uid()+".vcf");
 
    QFile file(path);
 
@@ -135,8 +152,17 @@ bool FallbackPersonBackendEditor::save(const Person* item)
       return false;
    }
 
-   file.write(item->toVCard({}));
+   const QByteArray content = item->toVCard({});
+
+   file.write(content);
    file.close();
+
+   m_hPaths[item] = path;
+
+   // Don't reload it on the next scan
+   if (m_pScanner)
+      m_pScanner->commit(path, content);
+
    return true;
 }
 
@@ -153,6 +179,11 @@ bool FallbackPersonBackendEditor::remove(const Person* item)
    bool ret = QFile::remove(path);
 
    if (ret) {
+      if (m_pScanner)
+         m_pScanner->forget(path);
+
+      m_lItems.removeAll(const_cast<Person*>(item));
+      m_hPaths.remove(item);
       ret &= mediator()->removeItem(item);
    }
    else
@@ -191,6 +222,24 @@ QVector<Person*> FallbackPersonBackendEditor::items() const
    return m_lItems;
 }
 
+Person* FallbackPersonBackendEditor::itemForPath(const QString& path) const
+{
+   for (auto i = m_hPaths.constBegin(); i != m_hPaths.constEnd(); ++i) {
+      if (i.value() == path)
+         return const_cast<Person*>(i.key());
+   }
+
+   return nullptr;
+}
+
+///Forget an item whose file was deleted by someone else
+void FallbackPersonBackendEditor::drop(Person* item)
+{
+   m_lItems.removeAll(item);
+   m_hPaths.remove(item);
+   mediator()->removeItem(item);
+}
+
 QString FallbackPersonCollection::name () const
 {
    return d_ptr->m_Name;
@@ -218,7 +267,14 @@ bool FallbackPersonCollection::isEnabled() const
 
 bool FallbackPersonCollection::load()
 {
-   auto l = [this]() {
+   if (d_ptr->m_Async) {
+      // The files are parsed on a shared pool and added as they come. The
+      // first scan starts from the manifest saved by the last session, so
+      // only the files modified since then are parsed again
+      d_ptr->m_pScanner->scan();
+      d_ptr->m_pScanner->setWatched(true);
+   }
+   else {
       bool ok;
       Q_UNUSED(ok)
       const QList< Person* > ret =  VCardUtils::loadDir(QUrl(d_ptr->m_Path),ok,static_cast<FallbackPersonBackendEditor*>(editor<Person>())->m_hPaths);
@@ -226,12 +282,7 @@ bool FallbackPersonCollection::load()
          p->setCollection(this);
          editor<Person>()->addExisting(p);
       }
-   };
-
-   if (d_ptr->m_Async)
-      new ThreadWorker(l);
-   else
-      l();
+   }
 
    //Add all sub directories as new backends
    QTimer::singleShot(0,d_ptr,SLOT(loadAsync()));
@@ -241,7 +292,13 @@ bool FallbackPersonCollection::load()
 
 bool FallbackPersonCollection::reload()
 {
-   return false;
+   if (!d_ptr->m_Async)
+      return false;
+
+   // Only the files which changed since the last scan are parsed
+   d_ptr->m_pScanner->scan();
+
+   return true;
 }
 
 FlagPack<CollectionInterface::SupportedFeatures> FallbackPersonCollection::supportedFeatures() const
@@ -281,11 +338,37 @@ void FallbackPersonCollectionPrivate::loadAsync()
    for (const QString& dir : d.entryList(QDir::AllDirs)) {
       if (dir != QString('.') && dir != QLatin1String("..")) {
          CollectionInterface* col = Session::instance()->personDirectory()->addCollection<FallbackPersonCollection,QString,FallbackPersonCollection*>(m_Path+'/'+dir,q_ptr);
+         // Each directory is scanned by its own loader job
          if (col->isEnabled()) {
-            col->load();
+            CollectionLoader::instance().schedule(col);
          }
       }
    }
 }
 
+void FallbackPersonCollectionPrivate::slotFileAdded(const QString& path, Person* p)
+{
+   auto e = static_cast<FallbackPersonBackendEditor*>(q_ptr->editor<Person>());
+
+   p->setCollection(q_ptr);
+   e->m_hPaths[p] = path;
+   e->addExisting(p);
+}
+
+void FallbackPersonCollectionPrivate::slotFileModified(const QString& path, const QByteArray& content)
+{
+   auto e = static_cast<FallbackPersonBackendEditor*>(q_ptr->editor<Person>());
+
+   if (Person* p = e->itemForPath(path))
+      p->updateFromVCard(content);
+}
+
+void FallbackPersonCollectionPrivate::slotFileRemoved(const QString& path)
+{
+   auto e = static_cast<FallbackPersonBackendEditor*>(q_ptr->editor<Person>());
+
+   if (Person* p = e->itemForPath(path))
+      e->drop(p);
+}
+
 #include "fallbackpersoncollection.moc"
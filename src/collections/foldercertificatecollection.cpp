@@ -34,6 +34,7 @@
 
 //Dring
 #include "dbus/configurationmanager.h"
+#include "private/certificatecache_p.h"
 
 class FallbackLocalCertificateEditor final : public CollectionEditor<Certificate>
 {
@@ -349,17 +350,23 @@ void BackgroundLoader::run()
       m_pCurrentFolder = m_lFolderQueue.takeFirst();
 
       QMutexLocker(&this->m_LoaderMutex);
-      for(const QByteArray& id : m_pCurrentFolder->listId()) {
+      const QList<QByteArray> ids = m_pCurrentFolder->listId();
+
+      ConfigurationManagerInterface& configurationManager = ConfigurationManager::instance();
+      //qDebug() << "\n\nPINING PATH TODO remove extra /" << m_pCurrentFolder->path();
+      configurationManager.pinCertificatePath(m_pCurrentFolder->path().path()+'/');
+
+      // Validate while still in the background (and once pinned), when they
+      // are added the model gets the results from the cache
+      CertificateCache::instance().prefetch(ids);
+
+      for(const QByteArray& id : ids) {
          Certificate* cert = CertificateModel::instance().getCertificateFromPath(id);
          m_pCurrentFolder->editor<Certificate>()->addExisting(cert);
 
          if (m_pCurrentFolder->d_ptr->m_Flags & FolderCertificateCollection::Options::ROOT)
             cert->addOrigin(Certificate::OriginHint::ROOT_AUTORITY);
       }
-
-      ConfigurationManagerInterface& configurationManager = ConfigurationManager::instance();
-      //qDebug() << "\n\nPINING PATH TODO remove extra /" << m_pCurrentFolder->path();
-      configurationManager.pinCertificatePath(m_pCurrentFolder->path().path()+'/');
    }
    FolderCertificateCollectionPrivate::m_spLoader = nullptr;
    QThread::exit(0);
@@ -49,6 +49,7 @@ public:
    virtual bool edit       ( Call*       item ) override;
    virtual bool addNew     ( Call*       item ) override;
    virtual bool addExisting( const Call* item ) override;
+   virtual bool batchAddExisting( const QList<Call*> items ) override;
 
    //Attributes
    QVector<Call*> m_lItems;
@@ -194,6 +195,16 @@ bool LocalHistoryEditor::addExisting(const Call* item)
    return true;
 }
 
+bool LocalHistoryEditor::batchAddExisting(const QList<Call*> items)
+{
+   m_lItems.reserve(m_lItems.size() + items.size());
+
+   for (auto item : qAsConst(items))
+      m_lItems << item;
+
+   return mediator()->addItems(items);
+}
+
 QVector<Call*> LocalHistoryEditor::items() const
 {
    return m_lItems;
@@ -241,6 +252,8 @@ bool LocalHistoryCollection::load()
 
       time_t now = time(0); // get time now
 
+      QList<Call*> calls;
+
       for (const QStringRef& line : qAsConst(lines)) {
          //The item is complete
          if ((line.isEmpty() || !line.size()) && hc.size()) {
@@ -251,7 +264,7 @@ bool LocalHistoryCollection::load()
 
             if (!isLimited || ( (now - pastCall->startTimeStamp()) < dayLimit) ) {
                pastCall->setCollection(this);
-               editor<Call>()->addExisting(pastCall);
+               calls << pastCall;
             }
 
             hc.clear();
@@ -264,6 +277,8 @@ bool LocalHistoryCollection::load()
          }
       }
 
+      editor<Call>()->batchAddExisting(calls);
+
       for (auto cb :  static_cast<LocalHistoryEditor*>(editor<Call>())->m_lCallbacks) {
           cb(this);
       }
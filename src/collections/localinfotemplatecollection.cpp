@@ -34,7 +34,7 @@
 #include "individual.h"
 #include "session.h"
 #include "infotemplatemanager.h"
-#include "private/threadworker.h"
+#include "private/taskpool_p.h"
 
 class LocalInfoTemplateCollectionEditor final : public CollectionEditor<InfoTemplate>
 {
@@ -175,7 +175,7 @@ bool LocalInfoTemplateCollection::isEnabled() const
 
 bool LocalInfoTemplateCollection::load()
 {
-    new ThreadWorker([this]() {
+    TaskPool::instance().run(TaskPool::Lane::BACKGROUND, [this]() {
         QDir dir(LocalInfoTemplateCollectionEditor::m_Path);
 
         if (!dir.exists())
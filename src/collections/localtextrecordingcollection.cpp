@@ -25,6 +25,9 @@
 #include <QtCore/QJsonDocument>
 #include <QtCore/QJsonObject>
 #include <QtCore/QJsonArray>
+#include <QtCore/QVector>
+#include <QtCore/QPair>
+#include <QtCore/QDebug>
 
 //Ring
 #include <globalinstances.h>
@@ -36,6 +39,8 @@
 #include <private/textrecording_p.h>
 #include <private/contactmethod_p.h>
 #include <media/media.h>
+#include <picocms/collectionloader.h>
+#include <private/tracer_p.h>
 
 /*
  * This collection store and load the instant messaging conversations. Lets call
@@ -60,6 +65,7 @@ public:
     virtual bool edit       ( Media::Recording*       item ) override;
     virtual bool addNew     ( Media::Recording*       item ) override;
     virtual bool addExisting( const Media::Recording* item ) override;
+    virtual bool batchAddExisting( const QList<Media::Recording*> items ) override;
     QString fetch(const QByteArray& sha1);
     static QString path(const QByteArray& sha1);
 
@@ -230,6 +236,17 @@ bool LocalTextRecordingEditor::addExisting(const Media::Recording* item)
     return false;
 }
 
+bool LocalTextRecordingEditor::batchAddExisting(const QList<Media::Recording*> items)
+{
+    m_lNumbers.reserve(m_lNumbers.size() + items.size());
+
+    for (auto item : qAsConst(items))
+        m_lNumbers << item;
+
+    mediator()->addItems(items);
+    return false;
+}
+
 QString LocalTextRecordingCollection::pathForCm(ContactMethod* cm)
 {
     return LocalTextRecordingEditor::path(cm->sha1());
@@ -278,6 +295,7 @@ bool LocalTextRecordingCollection::isEnabled() const
 
 bool LocalTextRecordingCollection::load()
 {
+    RING_TRACE_SPAN("collection", "LocalTextRecordingCollection::load");
 
     // load all text recordings so we can recover CMs that are not in the call history
     QDir dir(QStandardPaths::writableLocation(QStandardPaths::DataLocation) + "/text/");
@@ -292,30 +310,63 @@ bool LocalTextRecordingCollection::load()
         QDir::Files | QDir::NoSymLinks | QDir::Readable, QDir::Time
     );
 
+    // Read and decode the files here, load() can run in a CollectionLoader
+    // worker thread
+    QVector< QPair<QString, QJsonObject> > documents;
+    documents.reserve(list.size());
+
     for (const auto& fileInfo : qAsConst(list)) {
-        if (auto r = Media::TextRecording::fromPath(fileInfo.absoluteFilePath(), {}, this)) {
+        QFile file(fileInfo.absoluteFilePath());
 
-            // get CMs from recording
-            const auto peers = r->peers();
+        if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+            qWarning() << "Could not open text recording json file";
+            continue;
+        }
 
-            for (auto cm : qAsConst(peers)) {
-                // since we load the recordings in order from newest to oldest, if there is
-                // more than one found associated with a CM, we take the newest one
-                if (!cm->d_ptr->m_pTextRecording) {
-                    cm->d_ptr->setTextRecording(r);
-                }
-                else{
-                    // Useful, but too noisy, it will happen as contacts are added
-                    //qWarning() << "CM already has text recording" << cm;
-                    cm->d_ptr->addAlternativeTextRecording(r);
-                }
-            }
+        QJsonParseError err;
+        const QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &err);
 
-            editor<Media::Recording>()->addExisting(r);
+        if (err.error != QJsonParseError::ParseError::NoError) {
+            qWarning() << "Error Decoding Text Message History Json" << err.errorString();
+            continue;
         }
+
+        documents << qMakePair(fileInfo.absoluteFilePath(), doc.object());
     }
 
-    return true;
+    // The recordings resolve and modify the ContactMethods, create them in
+    // the main thread
+    return CollectionLoader::runInMainThread([this, documents]() {
+        QList<Media::Recording*> recordings;
+        recordings.reserve(documents.size());
+
+        for (const auto& d : qAsConst(documents)) {
+            if (auto r = Media::TextRecording::fromJson({d.second}, d.first, nullptr, this)) {
+
+                // get CMs from recording
+                const auto peers = r->peers();
+
+                for (auto cm : qAsConst(peers)) {
+                    // since we load the recordings in order from newest to oldest, if there is
+                    // more than one found associated with a CM, we take the newest one
+                    if (!cm->d_ptr->m_pTextRecording) {
+                        cm->d_ptr->setTextRecording(r);
+                    }
+                    else{
+                        // Useful, but too noisy, it will happen as contacts are added
+                        //qWarning() << "CM already has text recording" << cm;
+                        cm->d_ptr->addAlternativeTextRecording(r);
+                    }
+                }
+
+                recordings << r;
+            }
+        }
+
+        editor<Media::Recording>()->batchAddExisting(recordings);
+
+        return true;
+    });
 }
 
 bool LocalTextRecordingCollection::reload()
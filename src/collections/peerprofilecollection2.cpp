@@ -111,9 +111,11 @@ void PeerProfileCollection2Private::quickMerge(Person* source, Person* target) c
         }
     }
 
-    if (target->photo().isNull() && !source->photo().isNull()) {
+    // Don't force the photos to be decoded
+    if ((!target->d_ptr->hasPhoto()) && source->d_ptr->hasPhoto()) {
         changed = true;
-        target->setPhoto(source->photo());
+        target->d_ptr->copyPhoto(source->d_ptr);
+        target->d_ptr->photoChanged();
     }
 
     QSet<QString> dedup;
@@ -35,7 +35,6 @@
 #include "call.h"
 #include "private/notificationstatemodel_p.h"
 #include "availableaccountmodel.h"
-#include "dbus/presencemanager.h"
 #include "numbercategorymodel.h"
 #include "bookmarkmodel.h"
 #include "private/numbercategorymodel_p.h"
@@ -58,6 +57,7 @@
 //Private
 #include "private/individualdirectory_p.h"
 #include "private/textrecording_p.h"
+#include "private/presencesubscriptions_p.h"
 
 class UsageStatisticsPrivate
 {
@@ -476,6 +476,7 @@ bool ContactMethodPrivate::setType(ContactMethod::Type t)
 
       if (q_ptr->account()->supportPresenceSubscribe()) {
          m_Tracked = true; //The daemon will init the tracker itself
+         PresenceSubscriptions::instance().setActive(q_ptr);
          trackedChanged(true);
       }
       m_Type = t;
@@ -499,12 +500,7 @@ void ContactMethod::setTracked(bool track)
       //You can't subscribe without account
       if (track && !d_ptr->m_pAccount) return;
       d_ptr->m_Tracked = track;
-      PresenceManager::instance().subscribeBuddy(d_ptr->m_pAccount->id(),
-                                                 uri().format(URI::Section::CHEVRONS |
-                                                              URI::Section::SCHEME |
-                                                              URI::Section::USER_INFO |
-                                                              URI::Section::HOSTNAME),
-                                                 track);
+      PresenceSubscriptions::instance().setTracked(this, track);
       d_ptr->changed();
       d_ptr->trackedChanged(track);
    }
@@ -888,7 +884,7 @@ QVariant ContactMethod::roleData(int role) const
       case static_cast<int>(Role::TotalCallCount):
           return callCount();
       case static_cast<int>(Role::TotalEventCount):
-          return Session::instance()->eventModel()->d_ptr->events(this).size();
+          return Session::instance()->eventModel()->d_ptr->eventCount(this);
       case static_cast<int>(Role::TotalMessageCount):
           if (auto rec = textRecording())
             cat = rec->sentCount() + rec->receivedCount();
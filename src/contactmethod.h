@@ -410,6 +410,8 @@ Q_SIGNALS:
    void accountChanged(Account* account);
    /// When an event is attached to a ContactMethod
    void eventAdded(QSharedPointer<Event> e);
+   /// When many events are attached at once (such as when a calendar is loaded)
+   void eventsAdded(const QList<QSharedPointer<Event>>& events);
    /// When an event is detached from a ContactMethod
    void eventDetached(QSharedPointer<Event> e);
    /// When the status of the ContactRequest changes.
@@ -37,6 +37,7 @@
 #include "persondirectory.h"
 #include "individual.h"
 #include "private/sortproxies.h"
+#include "private/tracer_p.h"
 
 class ContactTreeNode;
 
@@ -308,6 +309,8 @@ ContactTreeNode* ContactModelPrivate::getContactTopLevelItem(const QString& cate
 
 void ContactModelPrivate::reloadCategories()
 {
+   RING_TRACE_SPAN("model", "ContactModel::reset");
+
    //TODO This could be optimized
    q_ptr->beginResetModel();
    m_hCategories.clear();
@@ -483,9 +483,9 @@ void CredentialModelPrivate::reload()
 
       //TURN
       const auto idx = q_ptr->addCredentials(Credential::Type::TURN);
-      const QString usern = m_pAccount->d_ptr->accountDetail(DRing::Account::ConfProperties::TURN::SERVER_UNAME);
+      const QString usern = m_pAccount->d_ptr->properties().toString(AccountProperties::Key::TURN_SERVER_UNAME);
       const QString passw = m_pAccount->d_ptr->accountDetail(DRing::Account::ConfProperties::TURN::SERVER_PWD  );
-      const QString realm = m_pAccount->d_ptr->accountDetail(DRing::Account::ConfProperties::TURN::SERVER_REALM);
+      const QString realm = m_pAccount->d_ptr->properties().toString(AccountProperties::Key::TURN_SERVER_REALM);
 
       if (!(usern.isEmpty() && passw.isEmpty() && realm.isEmpty())) {
          q_ptr->setData(idx, usern, CredentialModel::Role::NAME    );
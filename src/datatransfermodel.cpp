@@ -0,0 +1,677 @@
+/************************************************************************************
+ *   Copyright (C) 2018 by BlueSystems GmbH                                         *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                            *
+ *                                                                                  *
+ *   This library is free software; you can redistribute it and/or                  *
+ *   modify it under the terms of the GNU Lesser General Public                     *
+ *   License as published by the Free Software Foundation; either                   *
+ *   version 2.1 of the License, or (at your option) any later version.             *
+ *                                                                                  *
+ *   This library is distributed in the hope that it will be useful,                *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of                 *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU              *
+ *   Lesser General Public License for more details.                                *
+ *                                                                                  *
+ *   You should have received a copy of the GNU Lesser General Public               *
+ *   License along with this library; if not, write to the Free Software            *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA *
+ ***********************************************************************************/
+#include "datatransfermodel.h"
+
+// Qt
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDebug>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QHash>
+#include <QtCore/QTimer>
+#include <QtCore/QVector>
+#ifndef ENABLE_LIBWRAP
+ #include <QtDBus/QDBusPendingCallWatcher>
+#endif
+
+// Std
+#include <algorithm>
+#include <functional>
+
+// Ring
+#include "dbus/configurationmanager.h"
+
+struct DataTransfer
+{
+    quint64                   m_Id         {0};
+    DataTransferInfo          m_Info       { };
+    DataTransferModel::Status m_Status     {DataTransferModel::Status::INVALID};
+    qint64                    m_Total      {0};
+    qint64                    m_Progress   {0};
+    qint64                    m_LastSample {0};
+    double                    m_Rate       {0};
+    bool                      m_HasRate    {false};
+};
+
+class DataTransferModelPrivate final : public QObject
+{
+    Q_OBJECT
+public:
+    explicit DataTransferModelPrivate(DataTransferModel* q) : QObject(q), q_ptr(q) {}
+
+    /// The weight of the last sample in the smoothed rate
+    static constexpr const double SMOOTHING = 0.3;
+
+    /// The progress below which the interval gets longer (less than a pixel)
+    static constexpr const double SLOW_STEP = 0.001;
+
+    /// The progress above which the interval gets shorter
+    static constexpr const double FAST_STEP = 0.01;
+
+    /// Not a daemon error code, the IPC call itself failed
+    static constexpr const uint IPC_ERROR = 0xffffffff;
+
+    /// The last event is not known yet, use the one from the info
+    static constexpr const int UNKNOWN_EVENT = -1;
+
+    struct Sample {
+        quint64 m_Id      ;
+        qint64  m_Total   ;
+        qint64  m_Progress;
+    };
+
+    QVector<DataTransfer*>         m_lRows      ;
+    QHash<quint64, DataTransfer*>  m_hById      ;
+    QHash<quint64, int>            m_hFetching  ;
+    QVector<Sample>                m_lSamples   ;
+    QTimer                         m_Timer      ;
+    QElapsedTimer                  m_Clock      ;
+    int                            m_Interval   {250 };
+    int                            m_ActiveCount{0   };
+    int                            m_Replies    {0   };
+    bool                           m_IsVisible  {true};
+
+    DataTransferModel* q_ptr;
+
+    // Helpers
+    static bool isActive(DataTransferModel::Status s);
+    void fetch(quint64 id, int event);
+    DataTransfer* insert(quint64 id, const DataTransferInfo& info);
+    void remove(quint64 id);
+    void setStatus(DataTransfer* t, DataTransferModel::Status s);
+    void adapt(double step);
+    void reschedule();
+    void applySamples();
+
+    // Daemon, the callbacks are called in the main thread
+    void fetchInfo(quint64 id, const std::function<void(uint, const DataTransferInfo&)>& f);
+    void fetchProgress(quint64 id, const std::function<void(uint, qint64, qint64)>& f);
+#ifndef ENABLE_LIBWRAP
+    void watch(const QDBusPendingCall& call, const std::function<void(uint)>& f);
+#endif
+
+public Q_SLOTS:
+    void slotTransferEvent(quint64 id, uint code);
+    void slotSample();
+};
+
+DataTransferModel::DataTransferModel() : QAbstractListModel(QCoreApplication::instance()),
+d_ptr(new DataTransferModelPrivate(this))
+{
+    d_ptr->m_Clock.start();
+
+    connect(&d_ptr->m_Timer, &QTimer::timeout, d_ptr, &DataTransferModelPrivate::slotSample);
+
+    // The signature differs between the D-Bus and libwrap interfaces
+    connect(&ConfigurationManager::instance(), &ConfigurationManagerInterface::dataTransferEvent,
+        d_ptr, [this](qulonglong id, uint code) { d_ptr->slotTransferEvent(id, code); });
+
+    // Pick up the transfers started before this model existed
+#ifdef ENABLE_LIBWRAP
+    const VectorULongLong ids = ConfigurationManager::instance().dataTransferList();
+
+    for (const auto id : qAsConst(ids))
+        d_ptr->fetch(id, DataTransferModelPrivate::UNKNOWN_EVENT);
+#else
+    auto watcher = new QDBusPendingCallWatcher(ConfigurationManager::instance().dataTransferList(), d_ptr);
+
+    connect(watcher, &QDBusPendingCallWatcher::finished, d_ptr, [this](QDBusPendingCallWatcher* w) {
+        const QDBusPendingReply<VectorULongLong> reply(*w);
+        w->deleteLater();
+
+        if (reply.isError()) {
+            qWarning() << "Failed to list the transfers" << reply.error().message();
+            return;
+        }
+
+        const VectorULongLong ids = reply.value();
+
+        for (const auto id : qAsConst(ids))
+            d_ptr->fetch(id, DataTransferModelPrivate::UNKNOWN_EVENT);
+    });
+#endif
+}
+
+DataTransferModel::~DataTransferModel()
+{
+    qDeleteAll(d_ptr->m_lRows);
+    delete d_ptr;
+}
+
+void DataTransferModelPrivate::fetchInfo(quint64 id, const std::function<void(uint, const DataTransferInfo&)>& f)
+{
+#ifdef ENABLE_LIBWRAP
+    // In process, it doesn't block on anything
+    DataTransferInfo info {};
+    const uint err = ConfigurationManager::instance().dataTransferInfo(id, info);
+
+    f(err, info);
+#else
+    auto watcher = new QDBusPendingCallWatcher(ConfigurationManager::instance().dataTransferInfo(id), this);
+
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, [f](QDBusPendingCallWatcher* w) {
+        const QDBusPendingReply<uint, DataTransferInfo> reply(*w);
+        w->deleteLater();
+
+        if (reply.isError())
+            f(IPC_ERROR, {});
+        else
+            f(reply.argumentAt<0>(), reply.argumentAt<1>());
+    });
+#endif
+}
+
+void DataTransferModelPrivate::fetchProgress(quint64 id, const std::function<void(uint, qint64, qint64)>& f)
+{
+#ifdef ENABLE_LIBWRAP
+    int64_t t(0), p(0);
+    const uint err = ConfigurationManager::instance().dataTransferBytesProgress(id, t, p);
+
+    f(err, t, p);
+#else
+    auto watcher = new QDBusPendingCallWatcher(ConfigurationManager::instance().dataTransferBytesProgress(id), this);
+
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, [f](QDBusPendingCallWatcher* w) {
+        const QDBusPendingReply<uint, qlonglong, qlonglong> reply(*w);
+        w->deleteLater();
+
+        if (reply.isError())
+            f(IPC_ERROR, 0, 0);
+        else
+            f(reply.argumentAt<0>(), reply.argumentAt<1>(), reply.argumentAt<2>());
+    });
+#endif
+}
+
+#ifndef ENABLE_LIBWRAP
+void DataTransferModelPrivate::watch(const QDBusPendingCall& call, const std::function<void(uint)>& f)
+{
+    auto watcher = new QDBusPendingCallWatcher(call, this);
+
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, [f](QDBusPendingCallWatcher* w) {
+        const QDBusPendingReply<uint> reply(*w);
+        w->deleteLater();
+
+        f(reply.isError() ? IPC_ERROR : reply.argumentAt<0>());
+    });
+}
+#endif
+
+QHash<int,QByteArray> DataTransferModel::roleNames() const
+{
+    static QHash<int, QByteArray> roles = QAbstractItemModel::roleNames();
+    static bool initRoles = false;
+    if (!initRoles) {
+        initRoles = true;
+        roles.insert(static_cast<int>(Role::Id         ) , QByteArray("id"         ));
+        roles.insert(static_cast<int>(Role::AccountId  ) , QByteArray("accountId"  ));
+        roles.insert(static_cast<int>(Role::Peer       ) , QByteArray("peer"       ));
+        roles.insert(static_cast<int>(Role::DisplayName) , QByteArray("displayName"));
+        roles.insert(static_cast<int>(Role::Path       ) , QByteArray("path"       ));
+        roles.insert(static_cast<int>(Role::MimeType   ) , QByteArray("mimeType"   ));
+        roles.insert(static_cast<int>(Role::IsOutgoing ) , QByteArray("isOutgoing" ));
+        roles.insert(static_cast<int>(Role::Status     ) , QByteArray("status"     ));
+        roles.insert(static_cast<int>(Role::IsActive   ) , QByteArray("isActive"   ));
+        roles.insert(static_cast<int>(Role::TotalSize  ) , QByteArray("totalSize"  ));
+        roles.insert(static_cast<int>(Role::Progress   ) , QByteArray("progress"   ));
+        roles.insert(static_cast<int>(Role::Ratio      ) , QByteArray("ratio"      ));
+        roles.insert(static_cast<int>(Role::Rate       ) , QByteArray("rate"       ));
+        roles.insert(static_cast<int>(Role::Eta        ) , QByteArray("eta"        ));
+    }
+    return roles;
+}
+
+QVariant DataTransferModel::data(const QModelIndex& index, int role) const
+{
+    if ((!index.isValid()) || index.row() >= d_ptr->m_lRows.size())
+        return {};
+
+    const DataTransfer* t = d_ptr->m_lRows[index.row()];
+
+    switch(role) {
+        case Qt::DisplayRole:
+            return t->m_Info.displayName.isEmpty() ? t->m_Info.path : t->m_Info.displayName;
+        case static_cast<int>(Role::Id):
+            return t->m_Id;
+        case static_cast<int>(Role::AccountId):
+            return t->m_Info.accountId;
+        case static_cast<int>(Role::Peer):
+            return t->m_Info.peer;
+        case static_cast<int>(Role::DisplayName):
+            return t->m_Info.displayName;
+        case static_cast<int>(Role::Path):
+            return t->m_Info.path;
+        case static_cast<int>(Role::MimeType):
+            return t->m_Info.mimetype;
+        case static_cast<int>(Role::IsOutgoing):
+            // The first flag is the direction, set for incoming transfers
+            return !(t->m_Info.flags & 0x1);
+        case static_cast<int>(Role::Status):
+            return QVariant::fromValue(t->m_Status);
+        case static_cast<int>(Role::IsActive):
+            return DataTransferModelPrivate::isActive(t->m_Status);
+        case static_cast<int>(Role::TotalSize):
+            return t->m_Total;
+        case static_cast<int>(Role::Progress):
+            return t->m_Progress;
+        case static_cast<int>(Role::Ratio):
+            return t->m_Total > 0 ? static_cast<double>(t->m_Progress) / t->m_Total : 0.0;
+        case static_cast<int>(Role::Rate):
+            return t->m_Rate;
+        case static_cast<int>(Role::Eta):
+            if (t->m_Status != Status::ONGOING || t->m_Rate < 1 || t->m_Total <= 0)
+                return -1;
+
+            return static_cast<qint64>((t->m_Total - t->m_Progress) / t->m_Rate);
+    }
+
+    return {};
+}
+
+int DataTransferModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : d_ptr->m_lRows.size();
+}
+
+bool DataTransferModel::isVisible() const
+{
+    return d_ptr->m_IsVisible;
+}
+
+int DataTransferModel::activeCount() const
+{
+    return d_ptr->m_ActiveCount;
+}
+
+int DataTransferModel::interval() const
+{
+    return d_ptr->m_Timer.isActive() ? d_ptr->m_Timer.interval() : 0;
+}
+
+QModelIndex DataTransferModel::indexForId(quint64 id) const
+{
+    if (auto t = d_ptr->m_hById.value(id))
+        return index(d_ptr->m_lRows.indexOf(t), 0);
+
+    return {};
+}
+
+void DataTransferModel::setVisible(bool visible)
+{
+    if (d_ptr->m_IsVisible == visible)
+        return;
+
+    d_ptr->m_IsVisible = visible;
+    d_ptr->reschedule();
+
+    // Don't show values from seconds ago when it becomes visible again
+    if (visible && d_ptr->m_Timer.isActive())
+        d_ptr->slotSample();
+
+    emit visibleChanged(visible);
+}
+
+void DataTransferModel::sendFile(const QString& accountId, const QString& peer, const QString& path, const QString& displayName)
+{
+    DataTransferInfo info {};
+    info.accountId   = accountId;
+    info.peer        = peer;
+    info.path        = path;
+    info.displayName = displayName;
+
+    const auto sent = [this, path](uint err, quint64 id) {
+        if (err) {
+            qWarning() << "Sending" << path << "failed with error" << err;
+            emit fileSent(path, 0);
+            return;
+        }
+
+        // The "created" event usually arrives later, but the caller may
+        // want the row right away
+        d_ptr->fetch(id, DataTransferModelPrivate::UNKNOWN_EVENT);
+
+        emit fileSent(path, id);
+    };
+
+#ifdef ENABLE_LIBWRAP
+    uint64_t id = 0;
+    const uint err = ConfigurationManager::instance().sendFile(info, id);
+
+    sent(err, id);
+#else
+    auto watcher = new QDBusPendingCallWatcher(ConfigurationManager::instance().sendFile(info), d_ptr);
+
+    connect(watcher, &QDBusPendingCallWatcher::finished, d_ptr, [sent](QDBusPendingCallWatcher* w) {
+        const QDBusPendingReply<uint, qulonglong> reply(*w);
+        w->deleteLater();
+
+        if (reply.isError())
+            sent(DataTransferModelPrivate::IPC_ERROR, 0);
+        else
+            sent(reply.argumentAt<0>(), reply.argumentAt<1>());
+    });
+#endif
+}
+
+void DataTransferModel::accept(quint64 id, const QString& path)
+{
+    const auto accepted = [this, id](uint err) {
+        if (err)
+            qWarning() << "Accepting the transfer" << id << "failed with error" << err;
+
+        emit transferAccepted(id, !err);
+    };
+
+#ifdef ENABLE_LIBWRAP
+    accepted(ConfigurationManager::instance().acceptFileTransfer(id, path, 0));
+#else
+    d_ptr->watch(ConfigurationManager::instance().acceptFileTransfer(id, path, 0), accepted);
+#endif
+}
+
+void DataTransferModel::cancel(quint64 id)
+{
+    const auto cancelled = [this, id](uint err) {
+        if (err)
+            qWarning() << "Cancelling the transfer" << id << "failed with error" << err;
+
+        emit transferCancelled(id, !err);
+    };
+
+#ifdef ENABLE_LIBWRAP
+    cancelled(ConfigurationManager::instance().cancelDataTransfer(id));
+#else
+    d_ptr->watch(ConfigurationManager::instance().cancelDataTransfer(id), cancelled);
+#endif
+}
+
+bool DataTransferModelPrivate::isActive(DataTransferModel::Status s)
+{
+    switch(s) {
+        case DataTransferModel::Status::CREATED:
+        case DataTransferModel::Status::WAIT_PEER_ACCEPTANCE:
+        case DataTransferModel::Status::WAIT_HOST_ACCEPTANCE:
+        case DataTransferModel::Status::ONGOING:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * Ask the daemon about `id`, then add its row with `event` as status.
+ *
+ * The events received in the meantime replace `event`, only the last one
+ * matters.
+ */
+void DataTransferModelPrivate::fetch(quint64 id, int event)
+{
+    if (m_hById.contains(id))
+        return;
+
+    const bool isFetching = m_hFetching.contains(id);
+
+    if (event != UNKNOWN_EVENT || !isFetching)
+        m_hFetching[id] = event;
+
+    if (isFetching)
+        return;
+
+    fetchInfo(id, [this, id](uint err, const DataTransferInfo& info) {
+        const int event = m_hFetching.take(id);
+
+        if (err) {
+            qWarning() << "Failed to get the information about the transfer" << id;
+            return;
+        }
+
+        if (m_hById.contains(id))
+            return;
+
+        auto t = insert(id, info);
+
+        const auto s = static_cast<DataTransferModel::Status>(event == UNKNOWN_EVENT ? info.lastEvent : event);
+
+        if (s == t->m_Status)
+            QTimer::singleShot(DataTransferModel::ENDED_DELAY, this, [this, id]() { remove(id); });
+        else
+            setStatus(t, s);
+
+        reschedule();
+    });
+}
+
+DataTransfer* DataTransferModelPrivate::insert(quint64 id, const DataTransferInfo& info)
+{
+    auto t = new DataTransfer;
+    t->m_Id       = id;
+    t->m_Info     = info;
+    t->m_Total    = info.totalSize;
+    t->m_Progress = info.bytesProgress;
+
+    q_ptr->beginInsertRows({}, m_lRows.size(), m_lRows.size());
+    m_lRows << t;
+    m_hById[id] = t;
+    q_ptr->endInsertRows();
+
+    return t;
+}
+
+/// Drop a transfer which ended a while ago
+void DataTransferModelPrivate::remove(quint64 id)
+{
+    DataTransfer* t = m_hById.value(id);
+
+    // It was restarted in the meantime
+    if ((!t) || isActive(t->m_Status))
+        return;
+
+    const int row = m_lRows.indexOf(t);
+
+    q_ptr->beginRemoveRows({}, row, row);
+    m_lRows.remove(row);
+    m_hById.remove(id);
+    q_ptr->endRemoveRows();
+
+    delete t;
+}
+
+void DataTransferModelPrivate::setStatus(DataTransfer* t, DataTransferModel::Status s)
+{
+    if (s > DataTransferModel::Status::TIMEOUT_EXPIRED)
+        s = DataTransferModel::Status::INVALID;
+
+    const auto old = t->m_Status;
+
+    if (old == s)
+        return;
+
+    t->m_Status = s;
+
+    // Start a fresh rate estimation
+    if (s == DataTransferModel::Status::ONGOING) {
+        t->m_LastSample = m_Clock.elapsed();
+        t->m_Rate       = 0;
+        t->m_HasRate    = false;
+    }
+    else if (s == DataTransferModel::Status::FINISHED)
+        t->m_Progress = t->m_Total;
+
+    if (s != DataTransferModel::Status::ONGOING)
+        t->m_Rate = 0;
+
+    const QModelIndex idx = q_ptr->index(m_lRows.indexOf(t), 0);
+    emit q_ptr->dataChanged(idx, idx);
+
+    if (isActive(old) && !isActive(s))
+        emit q_ptr->transferEnded(t->m_Id, s);
+
+    // Keep the row long enough for the result to be seen
+    if (!isActive(s)) {
+        const quint64 id = t->m_Id;
+        QTimer::singleShot(DataTransferModel::ENDED_DELAY, this, [this, id]() { remove(id); });
+    }
+
+    int count = 0;
+
+    for (const auto other : qAsConst(m_lRows))
+        count += isActive(other->m_Status) ? 1 : 0;
+
+    if (count != m_ActiveCount) {
+        m_ActiveCount = count;
+        emit q_ptr->activeCountChanged(count);
+    }
+}
+
+void DataTransferModelPrivate::slotTransferEvent(quint64 id, uint code)
+{
+    DataTransfer* t = m_hById.value(id);
+
+    if (!t) {
+        fetch(id, code);
+        return;
+    }
+
+    setStatus(t, static_cast<DataTransferModel::Status>(code));
+
+    reschedule();
+}
+
+/// Start, stop or change the timer interval
+void DataTransferModelPrivate::reschedule()
+{
+    const bool hasOngoing = std::any_of(m_lRows.constBegin(), m_lRows.constEnd(), [](const DataTransfer* t) {
+        return t->m_Status == DataTransferModel::Status::ONGOING;
+    });
+
+    if (!hasOngoing) {
+        m_Timer.stop();
+        return;
+    }
+
+    m_Timer.setInterval(m_IsVisible ? m_Interval : qMax(m_Interval, DataTransferModel::HIDDEN_INTERVAL));
+
+    if (!m_Timer.isActive())
+        m_Timer.start();
+}
+
+/**
+ * `step` is the largest fraction of a file transferred since the last tick.
+ */
+void DataTransferModelPrivate::adapt(double step)
+{
+    if (step < SLOW_STEP)
+        m_Interval *= 2;
+    else if (step > FAST_STEP)
+        m_Interval /= 2;
+
+    m_Interval = qBound(DataTransferModel::MIN_INTERVAL, m_Interval, DataTransferModel::MAX_INTERVAL);
+}
+
+/**
+ * Ask the progress of all ongoing transfers at once. The rows are updated
+ * when the last reply arrives.
+ */
+void DataTransferModelPrivate::slotSample()
+{
+    // The daemon is slower than the timer, don't pile up the requests
+    if (m_Replies)
+        return;
+
+    QVector<quint64> ids;
+
+    for (const auto t : qAsConst(m_lRows)) {
+        if (t->m_Status == DataTransferModel::Status::ONGOING)
+            ids << t->m_Id;
+    }
+
+    if (ids.isEmpty()) {
+        reschedule();
+        return;
+    }
+
+    m_Replies = ids.size();
+    m_lSamples.clear();
+
+    for (const auto id : qAsConst(ids)) {
+        fetchProgress(id, [this, id](uint err, qint64 total, qint64 progress) {
+            if (!err)
+                m_lSamples << Sample {id, total, progress};
+
+            if (!--m_Replies)
+                applySamples();
+        });
+    }
+}
+
+void DataTransferModelPrivate::applySamples()
+{
+    const qint64 now = m_Clock.elapsed();
+
+    int    first = -1;
+    int    last  = -1;
+    double step  =  0;
+
+    for (const auto& sample : qAsConst(m_lSamples)) {
+        DataTransfer* t = m_hById.value(sample.m_Id);
+
+        // It ended while the request was in flight
+        if ((!t) || t->m_Status != DataTransferModel::Status::ONGOING)
+            continue;
+
+        const qint64 elapsed = now - t->m_LastSample;
+
+        if (elapsed > 0) {
+            const double instant = (sample.m_Progress - t->m_Progress) * 1000.0 / elapsed;
+
+            t->m_Rate    = t->m_HasRate ? t->m_Rate + SMOOTHING * (instant - t->m_Rate) : instant;
+            t->m_HasRate = true;
+        }
+
+        if (sample.m_Total > 0)
+            step = qMax(step, static_cast<double>(sample.m_Progress - t->m_Progress) / sample.m_Total);
+
+        t->m_Total      = sample.m_Total;
+        t->m_Progress   = sample.m_Progress;
+        t->m_LastSample = now;
+
+        const int row = m_lRows.indexOf(t);
+
+        first = first == -1 ? row : qMin(first, row);
+        last  = qMax(last, row);
+    }
+
+    m_lSamples.clear();
+
+    // A single notification for all the rows in between, views repaint
+    // them at once anyway
+    if (first != -1) {
+        emit q_ptr->dataChanged(q_ptr->index(first, 0), q_ptr->index(last, 0), {
+            static_cast<int>(DataTransferModel::Role::TotalSize),
+            static_cast<int>(DataTransferModel::Role::Progress ),
+            static_cast<int>(DataTransferModel::Role::Ratio    ),
+            static_cast<int>(DataTransferModel::Role::Rate     ),
+            static_cast<int>(DataTransferModel::Role::Eta      ),
+        });
+    }
+
+    adapt(step);
+    reschedule();
+}
+
+#include <datatransfermodel.moc>
@@ -0,0 +1,147 @@
+/************************************************************************************
+ *   Copyright (C) 2018 by BlueSystems GmbH                                         *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                            *
+ *                                                                                  *
+ *   This library is free software; you can redistribute it and/or                  *
+ *   modify it under the terms of the GNU Lesser General Public                     *
+ *   License as published by the Free Software Foundation; either                   *
+ *   version 2.1 of the License, or (at your option) any later version.             *
+ *                                                                                  *
+ *   This library is distributed in the hope that it will be useful,                *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of                 *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU              *
+ *   Lesser General Public License for more details.                                *
+ *                                                                                  *
+ *   You should have received a copy of the GNU Lesser General Public               *
+ *   License along with this library; if not, write to the Free Software            *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA *
+ ***********************************************************************************/
+#pragma once
+
+#include <QtCore/QAbstractListModel>
+
+#include <typedefs.h>
+#include <itemdataroles.h>
+
+class DataTransferModelPrivate;
+
+/**
+ * The file transfers known by the daemon.
+ *
+ * The daemon only notifies the state changes, the progress has to be
+ * polled. Rather than one timer per transfer, all active transfers are
+ * sampled by a single timer and the changed rows are reported with one
+ * ranged dataChanged() per tick.
+ *
+ * The sampling interval adapts. It gets shorter when the transfers progress
+ * by more than a percent per tick and longer when the progress would not
+ * even move a progress bar by a pixel. It is also much longer while the
+ * model is not displayed (see the `visible` property).
+ *
+ * The rate is smoothed with an exponential moving average and the ETA is
+ * computed from it.
+ *
+ * With D-Bus, the daemon is never waited for. The progress of all active
+ * transfers is requested at once and applied when the last reply arrives.
+ * The mutators return right away and report the daemon reply with a signal.
+ *
+ * The transfers which ended are removed after ENDED_DELAY.
+ */
+class LIB_EXPORT DataTransferModel final : public QAbstractListModel
+{
+    Q_OBJECT
+public:
+    Q_PROPERTY(bool visible READ isVisible WRITE setVisible NOTIFY visibleChanged)
+    Q_PROPERTY(int activeCount READ activeCount NOTIFY activeCountChanged)
+
+    /// The sampling interval bounds, in milliseconds
+    static constexpr const int MIN_INTERVAL    = 100 ;
+    static constexpr const int MAX_INTERVAL    = 2000;
+    static constexpr const int HIDDEN_INTERVAL = 5000;
+
+    /// How long the ended transfers are kept, in milliseconds
+    static constexpr const int ENDED_DELAY = 30000;
+
+    /// Mirror the daemon DataTransferEventCode
+    enum class Status {
+        INVALID             ,
+        CREATED             ,
+        UNSUPPORTED         ,
+        WAIT_PEER_ACCEPTANCE,
+        WAIT_HOST_ACCEPTANCE,
+        ONGOING             ,
+        FINISHED            ,
+        CLOSED_BY_HOST      ,
+        CLOSED_BY_PEER      ,
+        INVALID_PATHNAME    ,
+        UNJOINABLE_PEER     ,
+        TIMEOUT_EXPIRED     ,
+    };
+    Q_ENUM(Status)
+
+    enum class Role {
+        Id           = static_cast<int>(Ring::Role::UserRole) + 100,
+        AccountId    ,
+        Peer         ,
+        DisplayName  ,
+        Path         ,
+        MimeType     ,
+        IsOutgoing   ,
+        Status       ,
+        IsActive     ,
+        TotalSize    , /*!< In bytes                                      */
+        Progress     , /*!< In bytes                                      */
+        Ratio        , /*!< From 0 to 1                                   */
+        Rate         , /*!< Smoothed, in bytes per second                 */
+        Eta          , /*!< In seconds, -1 when unknown                   */
+    };
+
+    Q_INVOKABLE explicit DataTransferModel();
+    virtual ~DataTransferModel();
+
+    // Model
+    virtual QVariant data    ( const QModelIndex& index, int role = Qt::DisplayRole ) const override;
+    virtual int      rowCount( const QModelIndex& parent = {}                       ) const override;
+    virtual QHash<int,QByteArray> roleNames() const override;
+
+    // Getters
+    bool isVisible() const;
+    int activeCount() const;
+
+    /// The current sampling interval in milliseconds, 0 when idle
+    int interval() const;
+
+    QModelIndex indexForId(quint64 id) const;
+
+    // Setters
+    void setVisible(bool visible);
+
+    // Mutators
+    /// The transfer id is reported by fileSent() once the daemon replied
+    Q_INVOKABLE void sendFile(const QString& accountId, const QString& peer,
+                              const QString& path, const QString& displayName = {});
+    /// The result is reported by transferAccepted()
+    Q_INVOKABLE void accept(quint64 id, const QString& path);
+    /// The result is reported by transferCancelled()
+    Q_INVOKABLE void cancel(quint64 id);
+
+Q_SIGNALS:
+    void visibleChanged(bool visible);
+    void activeCountChanged(int count);
+
+    /// A transfer reached FINISHED or one of the error states
+    void transferEnded(quint64 id, DataTransferModel::Status status);
+
+    /// The reply to sendFile(), `id` is 0 if it failed
+    void fileSent(const QString& path, quint64 id);
+
+    /// The replies to accept() and cancel()
+    void transferAccepted(quint64 id, bool success);
+    void transferCancelled(quint64 id, bool success);
+
+private:
+    DataTransferModelPrivate* d_ptr;
+    Q_DECLARE_PRIVATE(DataTransferModel)
+};
+
+Q_DECLARE_METATYPE(DataTransferModel*)
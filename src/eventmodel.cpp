@@ -18,6 +18,9 @@
  ***********************************************************************************/
 #include "eventmodel.h"
 
+// Qt
+#include <QtCore/QMetaMethod>
+
 //Ring
 #include "account.h"
 #include "individual.h"
@@ -25,6 +28,7 @@
 #include "libcard/event.h"
 #include "libcard/private/event_p.h"
 #include "libcard/private/eventmodel_p.h"
+#include "libcard/private/eventstore.h"
 
 #include <stdio.h>
 
@@ -33,9 +37,12 @@
  *
  * At this point everything is semi-unordered. The linked list is used to
  * generate aggregates and can be sorted properly if the need arise.
+ *
+ * The nodes refer to the EventStore rows, the Event objects are only created
+ * when needed.
  */
 struct EventModelNode {
-    Event*          m_pEvent                   {nullptr};
+    EventStore::Row m_Row                      {0};
     EventModelNode* m_pNextByContactMethod     {nullptr};
     EventModelNode* m_pPreviousByContactMethod {nullptr};
     EventModelNode* m_pNextByIndividual        {nullptr};
@@ -57,21 +64,23 @@ struct EventModelNode {
 
 struct ContactMethodEvents
 {
-    Event* m_pNewest       {nullptr}; /*!< Highest stopTimeStamp () */
-    Event* m_pOldest       {nullptr}; /*!< Lowest  startTimeStamp() */
-    Event* m_pUnsortedTail {nullptr}; /*!< Lastest addition         */
-    Event* m_pUnsortedHead {nullptr}; /*!< The first addition       */
+    EventModelNode* m_pNewest       {nullptr}; /*!< Highest stopTimeStamp () */
+    EventModelNode* m_pOldest       {nullptr}; /*!< Lowest  startTimeStamp() */
+    EventModelNode* m_pUnsortedTail {nullptr}; /*!< Lastest addition         */
+    EventModelNode* m_pUnsortedHead {nullptr}; /*!< The first addition       */
 
     //FIXME this sucks and forces to track all events all the time.
     // Given events are synchronized across devices, they are expected in semi
     // random order and keeping a sorted vector for every CM becomes very
     // CPU/memcpy intensive.
     // I have no time left until release to finish the lazy sorting system.
-    QVector< QSharedPointer<Event> > m_lEvents;
+    QVector<EventModelNode*> m_lEvents;
 };
 
+// The sorting is done in the main thread, there is no need to lock the store
 inline static int cmp(EventModelNode *a, EventModelNode *b) {
-    return a->m_pEvent->startTimeStamp() - b->m_pEvent->startTimeStamp();
+    const auto& store = EventStore::instance();
+    return store.unlockedStartTimeStamp(a->m_Row) - store.unlockedStartTimeStamp(b->m_Row);
 }
 
 /**
@@ -230,11 +239,14 @@ EventModel::~EventModel()
     while (d_ptr->m_lEvent.size()) {
         EventModelNode* n = d_ptr->m_lEvent.takeLast();
 
-        n->m_pEvent->setParent(nullptr);
+        // The rows without objects are freed along with the store
+        if (auto e = EventStore::instance().object(n->m_Row)) {
+            e->setParent(nullptr);
 
-        // If m_pStrongRef is the last reference, the destructor is called.
-        // Otherwise it will assert if any class attempts to get new references
-        n->m_pEvent->d_ptr->m_pStrongRef = nullptr;
+            // If m_pStrongRef is the last reference, the destructor is called.
+            // Otherwise it will assert if any class attempts to get new references
+            e->d_ptr->m_pStrongRef = nullptr;
+        }
     }
 
     delete d_ptr;
@@ -273,7 +285,11 @@ QVariant EventModel::data( const QModelIndex& index, int role ) const
 
     const EventModelNode* info = d_ptr->m_lEvent[index.row()];
 
-    return info->m_pEvent->roleData(role);
+    // Only the displayed events get an object
+    if (auto e = EventStore::instance().event(info->m_Row))
+        return e->roleData(role);
+
+    return {};
 }
 
 int EventModel::rowCount( const QModelIndex& parent ) const
@@ -288,76 +304,212 @@ QItemSelectionModel* EventModel::defaultSelectionModel() const
     return nullptr;
 }
 
-bool EventModel::addItemCallback(const Event* item)
+/// Check if the event can be added
+bool EventModelPrivate::track(EventStore::Row row)
 {
-    if (Q_UNLIKELY(d_ptr->m_hUids.contains(item->uid()))) {
-        qWarning() << "An event with the same name was created twice, this is a bug" << item->uid();
-    }
-
     // If this happens, the index will be corrupted
-    if (Q_UNLIKELY(item->d_ptr->m_pTracker)) {
+    if (Q_UNLIKELY(row < (uint) m_lNodes.size() && m_lNodes[row])) {
         qWarning() << "addItemCallback called twice for the same event";
         Q_ASSERT(false);
+        return false;
     }
 
-    d_ptr->m_hUids[item->uid()] = const_cast<Event*>(item);
-    connect(item, &QObject::destroyed, d_ptr, &EventModelPrivate::slotFixCache);
+    return true;
+}
 
-    beginInsertRows({} ,d_ptr->m_lEvent.size(),d_ptr->m_lEvent.size());
+/// Append the node, the caller is responsible for the begin/endInsertRows
+EventModelNode* EventModelPrivate::append(EventStore::Row row)
+{
+    auto& store = EventStore::instance();
 
     auto n = new EventModelNode();
-    n->m_pEvent = const_cast<Event*>(item);
+    n->m_Row = row;
 
     // Check if the event is a direct sibling
-    if (!d_ptr->m_lEvent.isEmpty()) {
-        const auto prev = d_ptr->m_lEvent.constLast()->m_pEvent;
-        item->d_ptr->m_IsGroupHead = !prev->isSibling(item->d_ptr->m_pStrongRef);
+    if (!m_lEvent.isEmpty())
+        store.setGroupHead(row, !store.isSibling(m_lEvent.constLast()->m_Row, row));
+
+    m_lEvent << n;
+
+    if (row >= (uint) m_lNodes.size())
+        m_lNodes.resize(row + 1);
+
+    m_lNodes[row] = n;
+
+    return n;
+}
+
+/// Update the ContactMethod and handle sorting (if any)
+void EventModelPrivate::attach(ContactMethod* cm, EventModelNode* n)
+{
+    const auto& store = EventStore::instance();
+
+    if (!cm->d_ptr->m_pEvents)
+        cm->d_ptr->m_pEvents = new ContactMethodEvents;
+
+    auto events = cm->d_ptr->m_pEvents;
+
+    const time_t start = store.unlockedStartTimeStamp(n->m_Row);
+    const time_t stop  = store.unlockedStopTimeStamp (n->m_Row);
+
+    if ((!events->m_pOldest) || store.unlockedStartTimeStamp(events->m_pOldest->m_Row) > start) {
+        events->m_pOldest = n;
     }
 
-    d_ptr->m_lEvent << n;
+    // Update the unsorted Event_by_CM linked list
+    if (auto tail = events->m_pUnsortedTail) {
+        Q_ASSERT(!tail->m_pNextByContactMethod);
 
-    item->d_ptr->m_pTracker = n;
+        tail->m_pNextByContactMethod  = n;
+        n->m_pPreviousByContactMethod = tail;
+    }
+
+    events->m_pUnsortedTail = n;
+
+    if ((!events->m_pNewest) || store.unlockedStopTimeStamp(events->m_pNewest->m_Row) <= stop) {
+        events->m_pNewest = n;
+    }
+
+    //FIXME someday, do better than that
+    events->m_lEvents << n;
+    cm->d_ptr->setLastUsed(stop);
+    cm->d_ptr->addTimeRange(start, stop, store.eventCategory(n->m_Row));
+}
 
+bool EventModel::addItemCallback(const Event* item)
+{
+    const auto row = item->d_ptr->m_Row;
+
+    if (!d_ptr->track(row))
+        return false;
+
+    beginInsertRows({} ,d_ptr->m_lEvent.size(),d_ptr->m_lEvent.size());
+    auto n = d_ptr->append(row);
     endInsertRows();
 
-    // Update the ContactMethod and handle sorting (if any)
-    for (auto pair : qAsConst(item->d_ptr->m_lAttendees)) {
+    const auto attendees = item->attendees();
+
+    for (auto pair : attendees) {
         auto cm = pair.first; //TODO C++17
 
-        if (!cm->d_ptr->m_pEvents)
-            cm->d_ptr->m_pEvents = new ContactMethodEvents;
+        d_ptr->attach(cm, n);
 
-        if ((!cm->d_ptr->m_pEvents->m_pOldest) || cm->d_ptr->m_pEvents->m_pOldest->startTimeStamp() > item->startTimeStamp()) {
-            cm->d_ptr->m_pEvents->m_pOldest = const_cast<Event*>(item);
-        }
+        auto ref = const_cast<Event*>(item)->ref();
 
-        // Update the unsorted Event_by_CM linked list
-        if (cm->d_ptr->m_pEvents->m_pUnsortedTail) {
-            Q_ASSERT(cm->d_ptr->m_pEvents->m_pUnsortedTail->d_ptr->m_pTracker);
+        emit cm->eventAdded(ref);
+        emit cm->individual()->eventAdded(ref);
+        emit cm->individual()->textMessageCountChanged();
+    }
 
-            auto tail = cm->d_ptr->m_pEvents->m_pUnsortedTail->d_ptr->m_pTracker;
+    return true;
+}
 
-            Q_ASSERT(!tail->m_pNextByContactMethod);
+bool EventModel::addItemsCallback(const QList<Event*>& items)
+{
+    QVector<EventStore::Row> rows;
+    rows.reserve(items.size());
 
-            tail->m_pNextByContactMethod  = n;
-            n->m_pPreviousByContactMethod = tail;
-        }
+    for (const Event* item : qAsConst(items))
+        rows << item->d_ptr->m_Row;
 
-        cm->d_ptr->m_pEvents->m_pUnsortedTail = const_cast<Event*>(item);
+    return d_ptr->insertRows(rows);
+}
 
-        if ((!cm->d_ptr->m_pEvents->m_pNewest) || cm->d_ptr->m_pEvents->m_pNewest->stopTimeStamp() <= item->stopTimeStamp()) {
-            cm->d_ptr->m_pEvents->m_pNewest = const_cast<Event*>(item);
+/**
+ * Rather than notifying each ContactMethod and Individual once per event,
+ * they get a single `eventsAdded` with all the events attached to them.
+ *
+ * Most of them have nothing connected while the calendars are loading, so
+ * the events are only turned into objects for those who do.
+ */
+bool EventModelPrivate::insertRows(const QVector<EventStore::Row>& rows)
+{
+    auto& store = EventStore::instance();
+
+    QVector<EventStore::Row> accepted;
+    accepted.reserve(rows.size());
+
+    for (const auto row : qAsConst(rows)) {
+        if (track(row))
+            accepted << row;
+    }
+
+    if (accepted.isEmpty())
+        return false;
+
+    QVector<EventModelNode*> nodes;
+    nodes.reserve(accepted.size());
+
+    const int first = m_lEvent.size();
+    q_ptr->beginInsertRows({}, first, first + accepted.size() - 1);
+    m_lEvent.reserve(first + accepted.size());
+
+    for (const auto row : qAsConst(accepted))
+        nodes << append(row);
+
+    q_ptr->endInsertRows();
+
+    static const QMetaMethod cmSignal  = QMetaMethod::fromSignal(&ContactMethod::eventsAdded);
+    static const QMetaMethod indSignal = QMetaMethod::fromSignal(&Individual::eventsAdded);
+
+    // Keep the insertion order so the receivers see the events in the same
+    // order they would have with addItemCallback()
+    QVector<ContactMethod*> cms;
+    QVector<Individual*> inds;
+    QHash<ContactMethod*, QVector<EventStore::Row>> byCm;
+    QHash<Individual*, QVector<EventStore::Row>> byInd;
+
+    for (int i = 0; i < accepted.size(); i++) {
+        const auto row   = accepted[i];
+        const int  count = store.attendeeCount(row);
+
+        for (int j = 0; j < count; j++) {
+            auto cm  = store.attendee(row, j);
+            auto ind = cm->individual();
+
+            attach(cm, nodes[i]);
+
+            if (cm->isSignalConnected(cmSignal)) {
+                auto& cmEvents = byCm[cm];
+                if (cmEvents.isEmpty())
+                    cms << cm;
+                cmEvents << row;
+            }
+
+            // Many of the attendees can be part of the same individual
+            auto indEvents = byInd.find(ind);
+            if (indEvents == byInd.end()) {
+                inds << ind;
+                indEvents = byInd.insert(ind, {});
+            }
+
+            if (ind->isSignalConnected(indSignal)) {
+                if (indEvents->isEmpty() || indEvents->constLast() != row)
+                    (*indEvents) << row;
+            }
         }
+    }
 
-        //FIXME someday, do better than that
-        cm->d_ptr->m_pEvents->m_lEvents << item->d_ptr->m_pStrongRef;
-        cm->d_ptr->setLastUsed(item->stopTimeStamp());
-        cm->d_ptr->addTimeRange(item->startTimeStamp(), item->stopTimeStamp(), item->eventCategory());
+    const auto toEvents = [&store](const QVector<EventStore::Row>& eventRows) {
+        QList<QSharedPointer<Event>> ret;
+        ret.reserve(eventRows.size());
 
-        auto ref = const_cast<Event*>(item)->ref();
+        for (const auto row : qAsConst(eventRows))
+            ret << store.event(row);
 
-        emit cm->eventAdded(ref);
-        emit cm->individual()->eventAdded(ref);
+        return ret;
+    };
+
+    for (auto cm : qAsConst(cms))
+        emit cm->eventsAdded(toEvents(byCm[cm]));
+
+    for (auto ind : qAsConst(inds)) {
+        const auto& indRows = byInd[ind];
+
+        if (!indRows.isEmpty())
+            emit ind->eventsAdded(toEvents(indRows));
+
+        emit ind->textMessageCountChanged();
     }
 
     return true;
@@ -365,7 +517,9 @@ bool EventModel::addItemCallback(const Event* item)
 
 bool EventModel::removeItemCallback(const Event* item)
 {
-    for (auto pair : qAsConst(item->d_ptr->m_lAttendees)) {
+    const auto attendees = item->attendees();
+
+    for (auto pair : attendees) {
         auto cm = pair.first; //TODO C++17
         auto ref = const_cast<Event*>(item)->ref();
         emit cm->eventDetached(ref);
@@ -380,14 +534,16 @@ QSharedPointer<Event> EventModel::getById(const QByteArray& eventId, bool placeh
     if (eventId.isEmpty())
         return nullptr;
 
-    if (auto e = d_ptr->m_hUids.value(eventId))
-        return e->d_ptr->m_pStrongRef;
+    auto& store = EventStore::instance();
+
+    EventStore::Row row;
 
-    if (placeholder && !eventId.isEmpty()) {
+    if (store.find(eventId, &row))
+        return store.event(row);
+
+    if (placeholder) {
         auto e = new Event({}, Event::SyncState::PLACEHOLDER);
-        connect(e, &QObject::destroyed, d_ptr, &EventModelPrivate::slotFixCache);
-        e->d_ptr->m_UID = eventId;
-        d_ptr->m_hUids[eventId] = e;
+        store.setUid(e->d_ptr->m_Row, eventId);
         return e->d_ptr->m_pStrongRef;
     }
 
@@ -424,9 +580,8 @@ void EventModelPrivate::sort(ContactMethod* cm)
         return;
 
     Q_ASSERT(cm->d_ptr->m_pEvents->m_pUnsortedTail);
-    Q_ASSERT(cm->d_ptr->m_pEvents->m_pUnsortedHead->d_ptr->m_pTracker);
 
-    listsort(cm->d_ptr->m_pEvents->m_pUnsortedHead->d_ptr->m_pTracker, false, false);
+    listsort(cm->d_ptr->m_pEvents->m_pUnsortedHead, false, false);
 
 //     SortMode
 }
@@ -441,7 +596,7 @@ void EventModelPrivate::sort(Individual* ind)
 //         &EventModelNode::m_pPreviousByIndividual,
 //         EventModelNode::SortMode::IND
 //     >
-//     (cm->d_ptr->m_pEvents->m_pUnsortedHead->d_ptr->m_pTracker, false, false);
+//     (cm->d_ptr->m_pEvents->m_pUnsortedHead, false, false);
 }
 
 /**
@@ -469,44 +624,32 @@ void EventModelPrivate::mergeEvents(ContactMethod* dest, ContactMethod* src)
     else if (!dest->d_ptr->m_pEvents)
         dest->d_ptr->m_pEvents = new ContactMethodEvents;
 
-    // If that happens, there is a race condition when inserting events
-    // This is not the right place to fix it, it's already too late
-    Q_ASSERT(src->d_ptr->m_pEvents->m_pUnsortedHead->d_ptr->m_pTracker);
+    const auto& store = EventStore::instance();
 
     // Unsorted merge (append)
-    for (auto e = src->d_ptr->m_pEvents->m_pUnsortedHead->d_ptr->m_pTracker; e; e = e->m_pNextByContactMethod) {
-        dest->d_ptr->m_pEvents->m_pUnsortedTail->d_ptr->m_pTracker->m_pNextByContactMethod = e;
+    for (auto e = src->d_ptr->m_pEvents->m_pUnsortedHead; e; e = e->m_pNextByContactMethod) {
+        dest->d_ptr->m_pEvents->m_pUnsortedTail->m_pNextByContactMethod = e;
 
-        e->m_pPreviousByContactMethod = dest->d_ptr->m_pEvents->m_pUnsortedTail->d_ptr->m_pTracker;
+        e->m_pPreviousByContactMethod = dest->d_ptr->m_pEvents->m_pUnsortedTail;
 
-        dest->d_ptr->m_pEvents->m_pUnsortedTail = e->m_pEvent;
+        dest->d_ptr->m_pEvents->m_pUnsortedTail = e;
     }
 
     if (src->d_ptr->m_pEvents->m_pNewest && (
       (!dest->d_ptr->m_pEvents->m_pNewest) ||
-      src->d_ptr->m_pEvents->m_pNewest->stopTimeStamp() >
-      dest->d_ptr->m_pEvents->m_pNewest->stopTimeStamp()
+      store.unlockedStopTimeStamp(src->d_ptr->m_pEvents->m_pNewest->m_Row) >
+      store.unlockedStopTimeStamp(dest->d_ptr->m_pEvents->m_pNewest->m_Row)
     ))
         dest->d_ptr->m_pEvents->m_pNewest = src->d_ptr->m_pEvents->m_pNewest;
 
     if (src->d_ptr->m_pEvents->m_pOldest && (
       (!dest->d_ptr->m_pEvents->m_pOldest) ||
-      src->d_ptr->m_pEvents->m_pOldest->startTimeStamp() <
-      dest->d_ptr->m_pEvents->m_pOldest->startTimeStamp()
+      store.unlockedStartTimeStamp(src->d_ptr->m_pEvents->m_pOldest->m_Row) <
+      store.unlockedStartTimeStamp(dest->d_ptr->m_pEvents->m_pOldest->m_Row)
     ))
         dest->d_ptr->m_pEvents->m_pOldest = src->d_ptr->m_pEvents->m_pOldest;
 }
 
-void EventModelPrivate::slotFixCache()
-{
-    auto e = qobject_cast<Event*>(sender());
-
-    if (!e)
-        return;
-
-    m_hUids.remove(e->uid());
-}
-
 QSharedPointer<Event> EventModel::nextEvent(const QSharedPointer<Event>& e, ContactMethod* cm) const
 {
     Q_UNUSED(e)
@@ -543,7 +686,7 @@ QSharedPointer<Event> EventModel::oldest(const ContactMethod* cm) const
     if (!cm->d_ptr->m_pEvents->m_pOldest)
         return nullptr;
 
-    return cm->d_ptr->m_pEvents->m_pOldest->d_ptr->m_pStrongRef;
+    return EventStore::instance().event(cm->d_ptr->m_pEvents->m_pOldest->m_Row);
 }
 
 QSharedPointer<Event> EventModel::newest(const ContactMethod* cm) const
@@ -554,13 +697,28 @@ QSharedPointer<Event> EventModel::newest(const ContactMethod* cm) const
     if (!cm->d_ptr->m_pEvents->m_pNewest)
         return nullptr;
 
-    return cm->d_ptr->m_pEvents->m_pNewest->d_ptr->m_pStrongRef;
+    return EventStore::instance().event(cm->d_ptr->m_pEvents->m_pNewest->m_Row);
 }
 
-const QVector< QSharedPointer<Event> >& EventModelPrivate::events(const ContactMethod* cm) const
+/// This creates the Event objects, use eventCount() to only count them
+QVector< QSharedPointer<Event> > EventModelPrivate::events(const ContactMethod* cm) const
 {
+    QVector< QSharedPointer<Event> > ret;
+
     if (!cm->d_ptr->m_pEvents)
-        cm->d_ptr->m_pEvents = new ContactMethodEvents;
+        return ret;
 
-    return cm->d_ptr->m_pEvents->m_lEvents;
+    auto& store = EventStore::instance();
+
+    ret.reserve(cm->d_ptr->m_pEvents->m_lEvents.size());
+
+    for (const auto n : qAsConst(cm->d_ptr->m_pEvents->m_lEvents))
+        ret << store.event(n->m_Row);
+
+    return ret;
+}
+
+int EventModelPrivate::eventCount(const ContactMethod* cm) const
+{
+    return cm->d_ptr->m_pEvents ? cm->d_ptr->m_pEvents->m_lEvents.size() : 0;
 }
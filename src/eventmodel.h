@@ -49,6 +49,7 @@ class LIB_EXPORT EventModel : public QAbstractListModel, public CollectionManage
    friend class ContactMethod; // calls into the private API when deduplicating itself
    friend class EventAggregate; // use the private getters to get references on the event list
    friend class Session; // factory
+   friend class CalendarPrivate; // insert the loaded rows without creating the events
 public:
 
     virtual ~EventModel();
@@ -82,6 +83,7 @@ private:
 
     //Collection interface
     virtual bool addItemCallback   (const Event* item) override;
+    virtual bool addItemsCallback  (const QList<Event*>& items) override;
     virtual bool removeItemCallback(const Event* item) override;
 
 };
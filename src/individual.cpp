@@ -128,6 +128,12 @@ Individual::Individual(Person* parent) :
     // Row inserted/deleted can be implemented later //FIXME
     d_ptr->m_cBeginCB = connect(this, &Individual::phoneNumbersAboutToChange, this, [this](){beginResetModel();});
     d_ptr->m_cEndCB   = connect(this, &Individual::phoneNumbersChanged      , this, [this](){endResetModel  ();});
+
+    // Forwarded so the Person observers don't have to create the Individual
+    connect(this, &Individual::phoneNumbersChanged, this, [this]() {
+        if (d_ptr->m_pPerson)
+            d_ptr->m_pPerson->d_ptr->phoneNumbersChanged();
+    });
     d_ptr->m_lParents << this;
     moveToThread(QCoreApplication::instance()->thread());
     setObjectName(parent->formattedName());
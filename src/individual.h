@@ -43,6 +43,7 @@ class LIB_EXPORT Individual final : public QAbstractListModel
 {
     Q_OBJECT
 
+    friend class EventModelPrivate; // only create the events when eventsAdded is connected
 public:
     Q_PROPERTY(bool editRow READ hasEditRow WRITE setEditRow NOTIFY hasEditRowChanged)
     Q_PROPERTY(QSharedPointer<QAbstractItemModel> timelineModel READ timelineModel)
@@ -61,7 +62,7 @@ public:
     Q_PROPERTY(QString formattedLastUsedTime READ formattedLastUsedTime NOTIFY lastUsedTimeChanged)
     Q_PROPERTY(int callCount READ callCount NOTIFY callAdded)
     Q_PROPERTY(int totalSpentTime READ totalSpentTime NOTIFY callAdded)
-    Q_PROPERTY(int textMessageCount READ textMessageCount NOTIFY eventAdded)
+    Q_PROPERTY(int textMessageCount READ textMessageCount NOTIFY textMessageCountChanged)
     Q_PROPERTY(int unreadTextMessageCount READ unreadTextMessageCount NOTIFY unreadCountChanged)
     Q_PROPERTY(int lastUsedTime READ lastUsedTime NOTIFY lastUsedTimeChanged)
     Q_PROPERTY(bool isSelf READ isSelf NOTIFY isSelfChanged)
@@ -251,8 +252,12 @@ Q_SIGNALS:
 
     /// When an event is attached to a ContactMethod
     void eventAdded(QSharedPointer<Event>& e);
+    /// When many events are attached at once (such as when a calendar is loaded)
+    void eventsAdded(const QList<QSharedPointer<Event>>& events);
     /// When an event is detached from a ContactMethod
     void eventDetached(QSharedPointer<Event>& e);
+    /// After one or many events were added
+    void textMessageCountChanged();
 
     /// When any ContactMethod changes
     void changed();
@@ -72,8 +72,8 @@ IndividualDirectory::IndividualDirectory(QObject* parent) :
    QAbstractTableModel(parent?parent:QCoreApplication::instance()), d_ptr(new IndividualDirectoryPrivate(this))
 {
    setObjectName(QStringLiteral("IndividualDirectory"));
-   connect(&PresenceManager::instance(),SIGNAL(newBuddyNotification(QString,QString,bool,QString)),d_ptr.data(),
-           SLOT(slotNewBuddySubscription(QString,QString,bool,QString)));
+   connect(&DaemonSignalBridge::instance(), &DaemonSignalBridge::presencesChanged, d_ptr.data(),
+           &IndividualDirectoryPrivate::slotPresencesChanged);
 
    QTimer::singleShot(0, [this]() {
       connect(Session::instance()->accountModel(), &AccountModel::accountStateChanged,
@@ -1110,11 +1110,23 @@ void IndividualDirectoryPrivate::slotContactChanged(Person* newContact, Person*
 void IndividualDirectoryPrivate::slotNewBuddySubscription(const QString& accountId, const QString& uri, bool status, const QString& message)
 {
    ContactMethod* number = q_ptr->getNumber(uri,Session::instance()->accountModel()->getById(accountId.toLatin1()));
+
+   // The daemon re-sends the same state on reconnection, skip the no-op
+   if (number->d_ptr->m_Present == status && number->presenceMessage() == message)
+      return;
+
    number->d_ptr->setPresent(status);
    number->setPresenceMessage(message);
    emit number->changed();
 }
 
+///Coalesced presence notifications, only the latest one for each URI is kept
+void IndividualDirectoryPrivate::slotPresencesChanged(const QVector<DaemonSignalBridge::PresenceEvent>& events)
+{
+   for (const auto& e : qAsConst(events))
+      slotNewBuddySubscription(e.accountId, e.uri, e.status, e.message);
+}
+
 ///Make sure the indexes are still valid for those names
 void IndividualDirectoryPrivate::indexNumber(ContactMethod* number, const QStringList &names)
 {
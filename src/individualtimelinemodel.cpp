@@ -40,6 +40,8 @@
 #include "libcard/matrixutils.h"
 #include <media/avrecording.h>
 #include "private/lensmanager_p.h"
+#include "private/messagesearchindex_p.h"
+#include "private/tracer_p.h"
 
 struct TimeCategoryData
 {
@@ -117,6 +119,15 @@ public:
     QHash<Serializable::Group*, IndividualTimelineNode*> m_hTextGroups;
     QSet<Media::TextRecording*> m_hTrackedTRs;
     QSet<ContactMethod*> m_hTrackedCMs;
+    QHash<const Media::MimeMessage*, IndividualTimelineNode*> m_hMessageNodes;
+
+    // When a batch of events is added, the contiguous appends to the same list
+    // are queued and inserted as a single range
+    bool m_IsBatching {false};
+    std::vector<IndividualTimelineNode*>* m_pPendingIn {nullptr};
+    std::vector<IndividualTimelineNode*>  m_lPending;
+    QModelIndex m_PendingParent;
+    QSet<IndividualTimelineNode*> m_lChangedNodes;
 
     // Constants
     static const Matrix1D<IndividualTimelineModel::NodeType ,QString> peerTimelineNodeName;
@@ -127,6 +138,8 @@ public:
     IndividualTimelineNode* getGroup(TextMessageNode* message);
     void insert(IndividualTimelineNode* n, time_t t, std::vector<IndividualTimelineNode*>& in, const QModelIndex& parent = {});
     void incrementCounter(IndividualTimelineNode* n);
+    void flushPending();
+    void nodeChanged(IndividualTimelineNode* n);
     void init();
     void disconnectOldCms();
     void updateContentType(IndividualTimelineNode* n);
@@ -135,6 +148,7 @@ public:
 public Q_SLOTS:
     void slotMessageAdded(TextMessageNode* message);
     void slotEventAdded(QSharedPointer<Event>& call);
+    void slotEventsAdded(const QList<QSharedPointer<Event>>& events);
     void slotReload();
     void slotClear(IndividualTimelineNode* root = nullptr);
     void slotContactChanged(ContactMethod* cm, Person* newContact, Person* oldContact);
@@ -179,6 +193,9 @@ void IndividualTimelineModelPrivate::init()
     connect(m_pIndividual, &Individual::eventAdded,
         this, &IndividualTimelineModelPrivate::slotEventAdded);
 
+    connect(m_pIndividual, &Individual::eventsAdded,
+        this, &IndividualTimelineModelPrivate::slotEventsAdded);
+
     connect(m_pIndividual, &Individual::relatedContactMethodsAdded,
         this, &IndividualTimelineModelPrivate::slotPhoneNumberChanged);
 
@@ -527,9 +544,26 @@ void IndividualTimelineModelPrivate::insert(IndividualTimelineNode* n, time_t t,
 {
     updateContentType(n);
 
+    if (m_IsBatching && m_pPendingIn == &in && m_lPending.back()->m_StartTime < t) {
+        n->m_Index = in.size() + m_lPending.size();
+        m_lPending.push_back(n);
+        return;
+    }
+
+    // Anything else has to see the model in its final state
+    flushPending();
+
     // Many, if not most, elements are already sorted, speedup this case
     if (in.size() > 0 && in[in.size()-1]->m_StartTime < t) {
         n->m_Index = in.size();
+
+        if (m_IsBatching) {
+            m_pPendingIn    = &in;
+            m_PendingParent = parent;
+            m_lPending.push_back(n);
+            return;
+        }
+
         q_ptr->beginInsertRows(parent, n->m_Index, n->m_Index);
         in.push_back(n);
         q_ptr->endInsertRows();
@@ -555,6 +589,35 @@ void IndividualTimelineModelPrivate::insert(IndividualTimelineNode* n, time_t t,
     incrementCounter(n);
 }
 
+/// Insert the queued appends with a single beginInsertRows()
+void IndividualTimelineModelPrivate::flushPending()
+{
+    if (m_lPending.empty())
+        return;
+
+    const int first = m_pPendingIn->size();
+
+    q_ptr->beginInsertRows(m_PendingParent, first, first + m_lPending.size() - 1);
+    m_pPendingIn->insert(m_pPendingIn->end(), m_lPending.begin(), m_lPending.end());
+    q_ptr->endInsertRows();
+
+    m_lPending.clear();
+    m_pPendingIn    = nullptr;
+    m_PendingParent = {};
+}
+
+/// Emit dataChanged() now or, when batching, once at the end
+void IndividualTimelineModelPrivate::nodeChanged(IndividualTimelineNode* n)
+{
+    if (m_IsBatching) {
+        m_lChangedNodes.insert(n);
+        return;
+    }
+
+    const auto idx = q_ptr->createIndex(n->m_Index, 0, n);
+    emit q_ptr->dataChanged(idx, idx);
+}
+
 /// Return or create a time category
 IndividualTimelineNode* IndividualTimelineModelPrivate::getCategory(time_t t)
 {
@@ -640,6 +703,8 @@ void IndividualTimelineModelPrivate::slotMessageAdded(TextMessageNode* message)
     ret->m_pParent   = group;
     ret->m_Type      = messageType;
 
+    m_hMessageNodes[message->m_pMessage] = ret;
+
     insert(ret, ret->m_StartTime, group->m_lChildren, q_ptr->createIndex(group->m_Index, 0, group));
 
     // Update the group timelapse
@@ -649,6 +714,24 @@ void IndividualTimelineModelPrivate::slotMessageAdded(TextMessageNode* message)
     emit q_ptr->dataChanged(idx, idx);
 }
 
+void IndividualTimelineModelPrivate::slotEventsAdded(const QList<QSharedPointer<Event>>& events)
+{
+    m_IsBatching = true;
+
+    for (auto e : qAsConst(events))
+        slotEventAdded(e);
+
+    flushPending();
+
+    m_IsBatching = false;
+
+    const auto changed = m_lChangedNodes;
+    m_lChangedNodes.clear();
+
+    for (auto n : changed)
+        nodeChanged(n);
+}
+
 void IndividualTimelineModelPrivate::slotEventAdded(QSharedPointer<Event>& event)
 {
     if (event->eventCategory() != Event::EventCategory::CALL)
@@ -720,18 +803,10 @@ void IndividualTimelineModelPrivate::slotEventAdded(QSharedPointer<Event>& event
 
     m_pCurrentCallGroup->m_EndTime = ret->m_EndTime;
 
-    const auto idx = q_ptr->createIndex(
-        m_pCurrentCallGroup->m_pParent->m_Index, 0, m_pCurrentCallGroup->m_pParent
-    );
+    nodeChanged(m_pCurrentCallGroup->m_pParent);
 
     // For the CallCount
-    const auto gidx = q_ptr->createIndex(
-        m_pCurrentCallGroup->m_Index, 0, m_pCurrentCallGroup
-    );
-
-    emit q_ptr->dataChanged(idx, idx);
-
-    emit q_ptr->dataChanged(gidx, gidx);
+    nodeChanged(m_pCurrentCallGroup);
 }
 
 /// To use with extreme restrict, this isn't really intended to be used directly
@@ -807,6 +882,8 @@ void IndividualTimelineModelPrivate::slotIndividualDestroyed()
 
 void IndividualTimelineModelPrivate::slotReload()
 {
+    RING_TRACE_SPAN("model", "IndividualTimelineModel::reset");
+
     // Eventually, this could be optimized to detect if `reset` is more efficient
     // than individual `move` operation and pick the "right" mode. For now,
     // `reset` creates more readable code, so that will be it.
@@ -849,6 +926,7 @@ void IndividualTimelineModelPrivate::slotClear(IndividualTimelineNode* root)
         m_hTextGroups.clear();
         m_hTrackedCMs.clear();
         m_hTrackedTRs.clear();
+        m_hMessageNodes.clear();
         m_pCurrentCallGroup = nullptr;
         m_pCurrentTextGroup = nullptr;
         m_TotalEntries = 0;
@@ -863,6 +941,9 @@ void IndividualTimelineModelPrivate::disconnectOldCms()
     disconnect(m_pIndividual, &Individual::eventAdded,
         this, &IndividualTimelineModelPrivate::slotEventAdded);
 
+    disconnect(m_pIndividual, &Individual::eventsAdded,
+        this, &IndividualTimelineModelPrivate::slotEventsAdded);
+
     disconnect(m_pIndividual, &Individual::relatedContactMethodsAdded,
         this, &IndividualTimelineModelPrivate::slotPhoneNumberChanged);
 
@@ -958,6 +1039,21 @@ bool IndividualTimelineModel::isLensAvailable(LensType t) const
     return d_ptr->m_LensManager.m_ContentTypes & t;
 }
 
+QModelIndexList IndividualTimelineModel::searchMessages(const QString& query) const
+{
+    QModelIndexList ret;
+
+    // The index is global, only keep the messages from this timeline
+    const auto messages = MessageSearchIndex::instance().search(query);
+
+    for (auto m : qAsConst(messages)) {
+        if (auto n = d_ptr->m_hMessageNodes.value(m))
+            ret << createIndex(n->m_Index, 0, n);
+    }
+
+    return ret;
+}
+
 void IndividualTimelineModelPrivate::updateContentType(IndividualTimelineNode* n)
 {
     //TODO there's media in the other too, such as recordings
@@ -124,6 +124,13 @@ public:
      */
     static void setMaximiumLensSize(int size);
 
+    /**
+     * The text messages matching a search query, oldest first.
+     *
+     * @see MessageSearchIndex for the query syntax
+     */
+    QModelIndexList searchMessages(const QString& query) const;
+
 Q_SIGNALS:
     void availableLensesChanged();
 
@@ -92,6 +92,18 @@ public:
      * Return the icons associated with the action and its state
      */
     virtual QVariant userActionIcon(const UserActionElement& state) const = 0;
+
+    /**
+     * The photos are kept encoded until they are first displayed. If
+     * personPhoto() can be called from a worker thread (for example because
+     * it returns a QImage), return true and they will be decoded in the
+     * background. Otherwise the decoding is done in the main thread, as
+     * QPixmap requires.
+     *
+     * The contactPhoto() implementations should use ThumbnailCache rather
+     * than scaling the same photo every time.
+     */
+    virtual bool isPhotoDecodingThreadSafe() const { return false; }
 };
 
 } // namespace Interfaces
@@ -196,7 +196,7 @@ void KeyExchangeModelPrivate::slotCurrentIndexChanged(const QModelIndex& idx, co
 ///Return the key exchange mechanism
 KeyExchangeModel::Type KeyExchangeModelPrivate::keyExchange() const
 {
-   return KeyExchangeModelPrivate::fromDaemonName(m_pAccount->d_ptr->accountDetail(DRing::Account::ConfProperties::SRTP::KEY_EXCHANGE));
+   return KeyExchangeModelPrivate::fromDaemonName(m_pAccount->d_ptr->properties().toString(AccountProperties::Key::SRTP_KEY_EXCHANGE));
 }
 
 ///Set the Tls method
@@ -18,11 +18,15 @@
  ***********************************************************************************/
 #include "calendar.h"
 
+// Std
+#include <algorithm>
+
 // Qt
 #include <QtCore/QStandardPaths>
 #include <QtCore/QDir>
 #include <QtCore/QTimer>
 #include <QtCore/QMutex>
+#include <QtCore/QCoreApplication>
 
 // Ring
 #include "event.h"
@@ -33,12 +37,17 @@
 #include <persondirectory.h>
 #include <eventmodel.h>
 #include <individualdirectory.h>
+#include <picocms/collectionloader.h>
 #include <collections/localrecordingcollection.h>
 #include <media/avrecording.h>
 #include "../private/call_p.h"
 #include "libcard/private/event_p.h"
+#include "libcard/private/eventmodel_p.h"
+#include "libcard/private/eventstore.h"
+#include "libcard/private/calendarsnapshot.h"
 #include "libcard/private/icsbuilder.h"
 #include "libcard/private/icsloader.h"
+#include "private/tracer_p.h"
 
 class CalendarEditor final : public CollectionEditor<Event>
 {
@@ -49,9 +58,10 @@ public:
    virtual bool edit       ( Event*       item ) override;
    virtual bool addNew     ( Event*       item ) override;
    virtual bool addExisting( const Event* item ) override;
+   virtual bool batchAddExisting( const QList<Event*> items ) override;
 
    //Attributes
-   QVector<Event*> m_lItems;
+   QVector<EventStore::Row> m_lItems;
 
    Calendar* m_pCal {nullptr};
    CalendarPrivate* d_ptr {nullptr};
@@ -85,12 +95,15 @@ public:
     } m_GCHeuristics;
 
     // Helpers
-    Event* getEvent(const EventPrivate& data, Event::SyncState st);
-    Event* updateEvent(Event* e, const EventPrivate& data);
+    Event* getEvent(const EventAttributes& data, Event::SyncState st);
+    void updateEvent(EventStore::Row row, const EventAttributes& data);
+    bool finishLoading(const QList<EventAttributes>& attributes);
+    void resolve(EventAttributes& attrs) const;
 
 public Q_SLOTS:
     void slotEventStateChanged(Event::SyncState state, Event::SyncState old);
     void slotSaveOnDisk();
+    void slotSaveSnapshot();
 };
 
 Calendar::Calendar(CollectionMediator<Event>* mediator, Account* a) : QObject(nullptr), CollectionInterface(new CalendarEditor(mediator)),
@@ -101,6 +114,9 @@ d_ptr(new CalendarPrivate)
     d_ptr->m_pEditor  = static_cast<CalendarEditor*>(editor<Event>());
     d_ptr->m_pEditor->m_pCal = this;
     d_ptr->m_pEditor->d_ptr = d_ptr;
+
+    connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit,
+        d_ptr, &CalendarPrivate::slotSaveSnapshot);
 }
 
 Calendar::~Calendar()
@@ -110,17 +126,31 @@ Calendar::~Calendar()
 
 bool Calendar::load()
 {
+    RING_TRACE_SPAN_ARG("calendar", "load", account()->id());
+
+    // Do not add the events yet, batch those insertion once the newest event
+    // is known to avoid triggering thousand of peers timeline updates.
+    QList<EventAttributes> attributes;
+
+    // The snapshot has the same events and attendees
+    if (CalendarSnapshot::read(this, [&attributes](const EventAttributes& attrs) {
+        attributes << attrs;
+    }))
+        return d_ptr->finishLoading(attributes);
+
+    RING_TRACE_SPAN("calendar", "parseIcs");
+
     ICSLoader l;
     auto calendarAdapter = std::shared_ptr<VObjectAdapter<Calendar>>(
         new VObjectAdapter<Calendar>
     );
 
-    auto eventAdapter = std::shared_ptr<VObjectAdapter<EventPrivate>>(
-        new  VObjectAdapter<EventPrivate>
+    auto eventAdapter = std::shared_ptr<VObjectAdapter<EventAttributes>>(
+        new  VObjectAdapter<EventAttributes>
     );
 
     // It was very unreadable without it
-#define ARGS (EventPrivate* self, const std::basic_string<char>& value, const AbstractVObjectAdaptor::Parameters& params)
+#define ARGS (EventAttributes* self, const std::basic_string<char>& value, const AbstractVObjectAdaptor::Parameters& params)
 
     eventAdapter->addPropertyHandler("DTSTART", []ARGS {
         Q_UNUSED(params)
@@ -137,11 +167,10 @@ bool Calendar::load()
         self->m_RevTimeStamp = QString(value.data()).toInt();
     });
 
-    eventAdapter->addPropertyHandler("ATTENDEE", [this]ARGS {
-        const QByteArray val = QByteArray::fromRawData(value.data(), value.size());
-
-        Account* a = nullptr;
-        Person*  p = nullptr;
+    // Only keep the values, this may run in a worker thread
+    eventAdapter->addPropertyHandler("ATTENDEE", []ARGS {
+        EventAttendeeRef ref;
+        ref.m_Uri = QString::fromUtf8(value.data(), value.size());
 
         for (auto param : params) {
             const QByteArray pKey = QByteArray::fromRawData(param.first.data (), param.first.size ());
@@ -156,16 +185,17 @@ bool Calendar::load()
             }
             else if (pKey == "UID") {
                 pVal.detach();
-                p = Session::instance()->personDirectory()->getPlaceHolder(pVal);
+                ref.m_PersonUid = pVal;
+            }
+            else if (pKey == "X_RING_ACCOUNTID") {
+                pVal.detach();
+                ref.m_AccountId = pVal;
             }
-            else if (pKey == "X_RING_ACCOUNTID")
-                a = Session::instance()->accountModel()->getById(pVal);
         }
 
-        self->m_lAttendees << QPair<ContactMethod*, QString> {
-            Session::instance()->individualDirectory()->getNumber(val, p, a ? a : account()),
-            self->m_CN
-        };
+        ref.m_Name = self->m_CN;
+
+        self->m_lAttendeeRefs << ref;
     });
 
     eventAdapter->addPropertyHandler("CATEGORIES", []ARGS {
@@ -196,17 +226,9 @@ bool Calendar::load()
     // Import the autio recordings
     eventAdapter->addPropertyHandler("ATTACH", []ARGS {
         if (self->m_EventCategory == Event::EventCategory::CALL) {
-            Media::AVRecording* rec = nullptr;
             for (auto param : params) {
-                if (param.first == "FMTTYPE" && param.second == "audio/x-wav") {
-                    rec = LocalRecordingCollection::instance().addFromPath(
-                        value.data()
-                    );
-
-                    self->m_lAttachedFiles << rec;
-
-                    Q_ASSERT(rec->type() == Media::Attachment::BuiltInTypes::AUDIO_RECORDING);
-                }
+                if (param.first == "FMTTYPE" && param.second == "audio/x-wav")
+                    self->m_lRecordingPaths << QString::fromUtf8(value.data());
             }
         }
     });
@@ -219,27 +241,23 @@ bool Calendar::load()
 
     // No need to allocate anything for each events, it will happen anyway
     // in Event:: constructor
-    EventPrivate e;
+    EventAttributes e;
 
-    eventAdapter->setObjectFactory([&e](const std::basic_string<char>& object_type) -> EventPrivate* {
+    eventAdapter->setObjectFactory([&e](const std::basic_string<char>& object_type) -> EventAttributes* {
         e = {};
         e.m_Type = Event::typeFromName(object_type.data());
         return &e;
     });
 
-    // Do not add the events yet, batch those insertion once the newest event
-    // is known to avoid triggering thousand of peers timeline updates.
-    QList<Event*> events;
-
-    calendarAdapter->setFallbackObjectHandler<EventPrivate>(
-        [this, &events](
+    calendarAdapter->setFallbackObjectHandler<EventAttributes>(
+        [&attributes](
            Calendar* self,
-           EventPrivate* child,
+           EventAttributes* child,
            const std::basic_string<char>& name
         ) {
             Q_UNUSED(self)
             Q_UNUSED(name)
-            events << d_ptr->getEvent(*child, Event::SyncState::SAVED);
+            attributes << *child;
     });
 
     l.registerVObjectAdaptor("VCALENDAR", calendarAdapter);
@@ -252,23 +270,96 @@ bool Calendar::load()
 
 #undef ARGS
 
-    //TODO add batching to the collection system
+    if (!d_ptr->finishLoading(attributes))
+        return false;
 
-    // Read backward to improve the odds of the newest being added first
-    while (!events.isEmpty()) {
-        auto e = events.takeLast();
-        if (!e->collection()) {
-            if (e->syncState() == Event::SyncState::NEW)
-                editor<Event>()->addNew(e);
-            else
-                editor<Event>()->addExisting(e);
-        }
+    // Skip the parsing next time, it reads the events from the main thread
+    QTimer::singleShot(0, d_ptr, SLOT(slotSaveSnapshot()));
+
+    return true;
+}
+
+/**
+ * Create the attendees and recordings the loaders only read, in the main
+ * thread.
+ */
+void CalendarPrivate::resolve(EventAttributes& attrs) const
+{
+    auto pd = Session::instance()->personDirectory();
+    auto id = Session::instance()->individualDirectory();
+    auto am = Session::instance()->accountModel();
+
+    for (const auto& ref : qAsConst(attrs.m_lAttendeeRefs)) {
+        Person*  p = ref.m_PersonUid.isEmpty() ? nullptr : pd->getPlaceHolder(ref.m_PersonUid);
+        Account* a = ref.m_AccountId.isEmpty() ? nullptr : am->getById(ref.m_AccountId);
+
+        attrs.m_lAttendees << QPair<ContactMethod*, QString> {
+            id->getNumber(ref.m_Uri, p, a ? a : m_pAccount), ref.m_Name
+        };
     }
 
-    d_ptr->m_IsLoaded = true;
-    emit loadingFinished();
+    for (const auto& path : qAsConst(attrs.m_lRecordingPaths)) {
+        auto rec = LocalRecordingCollection::instance().addFromPath(path);
 
-    return true;
+        Q_ASSERT(rec->type() == Media::Attachment::BuiltInTypes::AUDIO_RECORDING);
+
+        attrs.m_lAttachedFiles << rec;
+    }
+
+    attrs.m_lAttendeeRefs.clear();
+    attrs.m_lRecordingPaths.clear();
+}
+
+/**
+ * Add the events to the store and the model.
+ *
+ * load() can run in the CollectionLoader threads, but the attendees, the
+ * recordings, the EventStore and the models are only created or modified in
+ * the main thread.
+ *
+ * The Event objects are not created here. The EventStore creates them when
+ * something asks for them.
+ */
+bool CalendarPrivate::finishLoading(const QList<EventAttributes>& attributes)
+{
+    return CollectionLoader::runInMainThread([this, attributes]() {
+        RING_TRACE_SPAN("calendar", "addEvents");
+
+        auto& store = EventStore::instance();
+
+        QVector<EventStore::Row> rows;
+        rows.reserve(attributes.size());
+
+        for (auto attrs : qAsConst(attributes)) {
+            resolve(attrs);
+
+            EventStore::Row row;
+
+            // A previous revision or a placeholder
+            if (store.find(attrs.m_UID, &row)) {
+                updateEvent(row, attrs);
+                continue;
+            }
+
+            row = store.append(attrs);
+            store.setAccount   (row, m_pAccount);
+            store.setCollection(row, q_ptr    );
+            rows << row;
+        }
+
+        // Read backward to improve the odds of the newest being added first
+        std::reverse(rows.begin(), rows.end());
+
+        m_pEditor->m_lItems << rows;
+
+        // Like the CollectionMediator, but without creating the events
+        Session::instance()->eventModel()->d_ptr->insertRows(rows);
+
+        m_IsLoaded = true;
+        emit q_ptr->loadingFinished();
+
+        return true;
+    });
 }
 
 bool Calendar::reload()
@@ -353,7 +444,7 @@ bool CalendarEditor::remove( const Event* item )
 
     time_t curTime;
     ::time(&curTime);
-    const_cast<Event*>(item)->d_ptr->m_RevTimeStamp = curTime;
+    EventStore::instance().setRevTimeStamp(item->d_ptr->m_Row, curTime);
 
     {
         QMutexLocker l(&d_ptr->m_Mutex);
@@ -382,14 +473,38 @@ bool CalendarEditor::addExisting( const Event* item )
 {
     Q_ASSERT(!item->collection());
     const_cast<Event*>(item)->setCollection(m_pCal);
-    m_lItems << const_cast<Event*>(item);
+    EventStore::instance().setCollection(item->d_ptr->m_Row, m_pCal);
+    m_lItems << item->d_ptr->m_Row;
     mediator()->addItem(item);
     return true;
 }
 
+bool CalendarEditor::batchAddExisting( const QList<Event*> items )
+{
+    m_lItems.reserve(m_lItems.size() + items.size());
+
+    for (auto item : qAsConst(items)) {
+        Q_ASSERT(!item->collection());
+        item->setCollection(m_pCal);
+        EventStore::instance().setCollection(item->d_ptr->m_Row, m_pCal);
+        m_lItems << item->d_ptr->m_Row;
+    }
+
+    return mediator()->addItems(items);
+}
+
+/// This creates all the Event objects, avoid it
 QVector<Event*> CalendarEditor::items() const
 {
-    return m_lItems;
+    auto& store = EventStore::instance();
+
+    QVector<Event*> ret;
+    ret.reserve(m_lItems.size());
+
+    for (const auto row : qAsConst(m_lItems))
+        ret << store.event(row).data();
+
+    return ret;
 }
 
 bool Calendar::isEnabled() const
@@ -412,7 +527,17 @@ QSharedPointer<Event> Calendar::eventAt(int position) const
     if (position < 0 || position >= d_ptr->m_pEditor->m_lItems.size())
         return nullptr;
 
-    return d_ptr->m_pEditor->m_lItems[position]->d_ptr->m_pStrongRef;
+    return EventStore::instance().event(d_ptr->m_pEditor->m_lItems[position]);
+}
+
+int Calendar::size() const
+{
+    return d_ptr->m_pEditor->m_lItems.size();
+}
+
+const QVector<quint32>& Calendar::rows() const
+{
+    return d_ptr->m_pEditor->m_lItems;
 }
 
 Account* Calendar::account() const
@@ -446,7 +571,12 @@ QSharedPointer<Event> Calendar::addEvent(Call* c)
         return e;
     }
 
-    EventPrivate b;
+    // If this event is newly imported, then "now" is the last time it was
+    // modified
+    time_t curTime;
+    ::time(&curTime);
+
+    EventAttributes b;
     b.m_StartTimeStamp  = c->startTimeStamp();
     b.m_StopTimeStamp   = c->stopTimeStamp ();
     b.m_Status          = Event::Status::FINAL;
@@ -456,21 +586,16 @@ QSharedPointer<Event> Calendar::addEvent(Call* c)
     b.m_Direction       = c->direction() == Call::Direction::OUTGOING ?
         Event::Direction::OUTGOING : Event::Direction::INCOMING;
 
-    auto e = new Event(b, Event::SyncState::NEW);
-
-    // If this event is newly imported, then "now" is the last time it was
-    // modified
-    time_t curTime;
-    ::time(&curTime);
-
-    e->d_ptr->m_pAccount     = account();
-    e->d_ptr->m_RevTimeStamp = curTime;
-    e->d_ptr->m_CN           = c->peerName();
+    b.m_pAccount        = account();
+    b.m_RevTimeStamp    = curTime;
+    b.m_CN              = c->peerName();
 
-    e->d_ptr->m_lAttendees << QPair<ContactMethod*, QString> {
+    b.m_lAttendees << QPair<ContactMethod*, QString> {
         c->peerContactMethod(), c->peerName()
     };
 
+    auto e = new Event(b, Event::SyncState::NEW);
+
     // Add the audio recordings
     if (c->hasRecording(Media::Media::Type::AUDIO, Media::Media::Direction::IN)) {
         const auto rec = static_cast<Media::AVRecording*> (
@@ -492,53 +617,58 @@ QSharedPointer<Event> Calendar::addEvent(Call* c)
  * If the revision timestamp is greater than the older one, squash the new
  * values on top of the old ones.
  */
-Event* CalendarPrivate::updateEvent(Event* e, const EventPrivate& data)
+void CalendarPrivate::updateEvent(EventStore::Row row, const EventAttributes& data)
 {
     Q_ASSERT(!data.m_UID.isEmpty());
 
+    auto& store = EventStore::instance();
+
     // Turn the placeholder into the "real" event
-    if (e->syncState() == Event::SyncState::PLACEHOLDER) {
+    auto e = store.object(row);
+    if (e && e->syncState() == Event::SyncState::PLACEHOLDER) {
         e->rebuild(data, Event::SyncState::SAVED);
-        e->d_ptr->m_pAccount = m_pAccount;
+        store.setAccount   (row, m_pAccount);
+        store.setCollection(row, q_ptr    );
         e->setCollection(q_ptr);
-        return e;
+        return;
     }
 
-    if (e->revTimeStamp() < data.m_RevTimeStamp) {
-        qWarning() << "Attempting to update an event from the future, ignoring" << e;
-        return e;
+    if (store.revTimeStamp(row) < data.m_RevTimeStamp) {
+        qWarning() << "Attempting to update an event from the future, ignoring" << data.m_UID;
+        return;
     }
 
-    if (data.m_StopTimeStamp > e->stopTimeStamp()) {
+    if (data.m_StopTimeStamp > store.stopTimeStamp(row)) {
         m_GCHeuristics.m_Unsorted++;
-        e->d_ptr->m_StopTimeStamp = data.m_StopTimeStamp;
+        store.setStopTimeStamp(row, data.m_StopTimeStamp);
     }
 
     // Note that this never triggers a GC pass. Since updateEvent is called
     // during load time, it is improbable it will hit the threshold as the
     // previous time it was saved, the GC would have been executed automatically
     m_GCHeuristics.m_Duplicates++;
-
-    return e;
 }
 
 /// Ensure no duplicates are created by accident
-Event* CalendarPrivate::getEvent(const EventPrivate& data, Event::SyncState st)
+Event* CalendarPrivate::getEvent(const EventAttributes& data, Event::SyncState st)
 {
-    if (data.m_UID.size())
+    auto& store = EventStore::instance();
 
-    if (auto ret = data.m_UID.isEmpty() ? nullptr : Session::instance()->eventModel()->getById(data.m_UID)) {
-        return updateEvent(ret.data(), data);
+    EventStore::Row row;
+
+    if (store.find(data.m_UID, &row)) {
+        updateEvent(row, data);
+        return store.event(row).data();
     }
 
     auto e = new Event(data, st);
 
-    e->d_ptr->m_pAccount = m_pAccount;
+    store.setAccount(e->d_ptr->m_Row, m_pAccount);
 
     return e;
 }
 
-QSharedPointer<Event> Calendar::addEvent(const EventPrivate& data)
+QSharedPointer<Event> Calendar::addEvent(const EventAttributes& data)
 {
     auto e = d_ptr->getEvent(data, Event::SyncState::NEW)->d_ptr->m_pStrongRef;
 
@@ -622,6 +752,20 @@ void CalendarPrivate::slotSaveOnDisk()
     m_HasDelayedSave = false;
 }
 
+/// Refresh the snapshot if the events were saved since it was written
+void CalendarPrivate::slotSaveSnapshot()
+{
+    if (!m_IsLoaded)
+        return;
+
+    // The snapshot must match the file, so flush the pending events first
+    if (m_HasDelayedSave)
+        slotSaveOnDisk();
+
+    if (!CalendarSnapshot::isUpToDate(q_ptr))
+        CalendarSnapshot::write(q_ptr);
+}
+
 int Calendar::unsavedCount() const
 {
     return d_ptr->m_lUnsavedEvent.size();
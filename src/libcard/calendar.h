@@ -26,7 +26,7 @@ class QTimeZone;
 class Event;
 class Account;
 class Call;
-class EventPrivate;
+struct EventAttributes;
 
 class CalendarPrivate;
 
@@ -40,6 +40,8 @@ class LIB_EXPORT Calendar : public QObject, public CollectionInterface
 {
     Q_OBJECT
 
+    friend class ICSBuilder; // serialize the rows
+    friend class CalendarSnapshot; // serialize the rows
 public:
     explicit Calendar(CollectionMediator<Event>* mediator, Account* a);
     virtual ~Calendar();
@@ -52,6 +54,7 @@ public:
     virtual bool       isEnabled() const override;
     virtual QString    category () const override;
     virtual QByteArray id       () const override;
+    virtual int        size     () const override;
 
     Account* account() const;
 
@@ -62,7 +65,7 @@ public:
     /**
      * This version is designed for internal usage only.
      */
-    QSharedPointer<Event> addEvent(const EventPrivate& data);
+    QSharedPointer<Event> addEvent(const EventAttributes& data);
 
     /**
      * All timezone used by this calendar.
@@ -88,6 +91,9 @@ Q_SIGNALS:
     void loadingFinished();
 
 private:
+    /// The EventStore rows, most of them have no Event object
+    const QVector<quint32>& rows() const;
+
     CalendarPrivate* d_ptr;
     Q_DECLARE_PRIVATE(Calendar)
 };
@@ -33,13 +33,14 @@
 #include <eventmodel.h>
 #include <session.h>
 #include "libcard/private/event_p.h"
+#include "libcard/private/eventstore.h"
 #include "libcard/matrixutils.h"
 
 /**
  * Use a second "level" is private data alongside ::EventPrivate.
  *
- * EventPrivate is used internally for building events and managing some shared
- * internal metadata. It isn't the place to track the state.
+ * EventPrivate is used internally for managing some shared internal metadata.
+ * It isn't the place to track the state.
  */
 struct EventInternals
 {
@@ -90,34 +91,47 @@ const Matrix2D<Event::SyncState, EventInternals::EditActions, Event::SyncState>
 
 // Note that the nullptr parent is intentional. The events are managed using
 // shared pointers.
-Event::Event(const EventPrivate& attrs, Event::SyncState st) : ItemBase(Session::instance()->eventModel()),
+// Note that the objectName is no longer set from the UID. With large
+// histories, it was one of the largest allocation of each event.
+Event::Event(const EventAttributes& attrs, Event::SyncState st) : ItemBase(Session::instance()->eventModel()),
     d_ptr(new EventPrivate)
 {
-    (*d_ptr) = attrs;
+    d_ptr->m_Row = EventStore::instance().append(attrs);
     d_ptr->m_pStrongRef = QSharedPointer<Event>(this);
     d_ptr->m_pInternals = new EventInternals();
     d_ptr->m_pInternals->q_ptr = this;
     d_ptr->m_pInternals->m_SyncState = st;
-    d_ptr->m_lAttachedFiles = attrs.m_lAttachedFiles;
-
-    if (!d_ptr->m_UID.isEmpty())
-        setObjectName("Event: " + d_ptr->m_UID);
+    EventStore::instance().setObject(d_ptr->m_Row, this);
 //     Q_ASSERT(st != Event::SyncState::NEW); //TODO remove
 }
 
-void Event::rebuild(const EventPrivate& attrs, SyncState st)
+// The rows without objects are the events loaded from the calendars.
+Event::Event(quint32 row) : ItemBase(Session::instance()->eventModel()),
+    d_ptr(new EventPrivate)
+{
+    d_ptr->m_Row = row;
+    d_ptr->m_pStrongRef = QSharedPointer<Event>(this);
+    d_ptr->m_pInternals = new EventInternals();
+    d_ptr->m_pInternals->q_ptr = this;
+    d_ptr->m_pInternals->m_SyncState = Event::SyncState::SAVED;
+    EventStore::instance().setObject(row, this);
+
+    if (auto c = EventStore::instance().collection(row))
+        setCollection(c);
+}
+
+void Event::rebuild(const EventAttributes& attrs, SyncState st)
 {
     Q_UNUSED(st)
     Q_ASSERT(syncState() == Event::SyncState::PLACEHOLDER);
     Q_ASSERT(uid() == attrs.m_UID);
-    const auto i = d_ptr->m_pInternals;
-    (*d_ptr) = attrs;
-    d_ptr->m_pInternals = i;
+    EventStore::instance().assign(d_ptr->m_Row, attrs);
 }
 
 Event::~Event()
 {
     d_ptr->m_pStrongRef = nullptr;
+    EventStore::instance().release(d_ptr->m_Row);
     delete d_ptr;
 }
 
@@ -126,7 +140,7 @@ void EventInternals::updateRevisionTime()
 {
     time_t curTime;
     ::time(&curTime);
-    q_ptr->d_ptr->m_RevTimeStamp = curTime;
+    EventStore::instance().setRevTimeStamp(q_ptr->d_ptr->m_Row, curTime);
 }
 
 void Event::setStopTimeStamp(time_t t)
@@ -136,12 +150,12 @@ void Event::setStopTimeStamp(time_t t)
         Q_ASSERT(false);
     }
 
-    if (t == d_ptr->m_StopTimeStamp)
+    if (t == stopTimeStamp())
         return;
 
     d_ptr->m_pInternals->m_SyncState = Event::SyncState::RESCHEDULED;
 
-    d_ptr->m_StopTimeStamp = t;
+    EventStore::instance().setStopTimeStamp(d_ptr->m_Row, t);
 
     d_ptr->m_pInternals->updateRevisionTime();
 
@@ -150,17 +164,17 @@ void Event::setStopTimeStamp(time_t t)
 
 time_t Event::startTimeStamp() const
 {
-    return d_ptr->m_StartTimeStamp;
+    return EventStore::instance().startTimeStamp(d_ptr->m_Row);
 }
 
 time_t Event::stopTimeStamp() const
 {
-    return d_ptr->m_StopTimeStamp;
+    return EventStore::instance().stopTimeStamp(d_ptr->m_Row);
 }
 
 time_t Event::revTimeStamp() const
 {
-    return d_ptr->m_RevTimeStamp;
+    return EventStore::instance().revTimeStamp(d_ptr->m_Row);
 }
 
 QTimeZone* Event::timezone() const
@@ -171,7 +185,7 @@ QTimeZone* Event::timezone() const
 
 bool Event::isGroupHead() const
 {
-    return d_ptr->m_IsGroupHead;
+    return EventStore::instance().isGroupHead(d_ptr->m_Row);
 }
 
 Call* Event::toHistoryCall() const
@@ -181,7 +195,9 @@ Call* Event::toHistoryCall() const
 
 QByteArray Event::uid() const
 {
-    if (d_ptr->m_UID.isEmpty()) {
+    QByteArray ret = EventStore::instance().uid(d_ptr->m_Row);
+
+    if (ret.isEmpty()) {
         // The UID cannot be generated yet, so the event CANNOT exist
         Q_ASSERT(startTimeStamp());
 
@@ -189,16 +205,16 @@ QByteArray Event::uid() const
 
         const QString accId(account() ? account()->id() : "void");
 
-        d_ptr->m_UID = QString("%1-%2-%3@%4.ring.cx")
+        ret = QString("%1-%2-%3@%4.ring.cx")
             .arg(startTimeStamp())
             .arg(stopTimeStamp() - startTimeStamp())
             .arg(seed.left(std::min(seed.size(), 8)))
             .arg(accId).toLatin1();
 
-        const_cast<Event*>(this)->setObjectName("Event: " + d_ptr->m_UID);
+        EventStore::instance().setUid(d_ptr->m_Row, ret);
     }
 
-    return d_ptr->m_UID;
+    return ret;
 }
 
 QByteArray Event::categoryName(EventCategory cat)
@@ -359,62 +375,64 @@ QString Event::length() const
 
 QString Event::displayName() const
 {
-    return d_ptr->m_CN;
+    return EventStore::instance().displayName(d_ptr->m_Row);
 }
 
 void Event::setDisplayName(const QString& cn)
 {
-    d_ptr->m_CN = cn;
+    EventStore::instance().setDisplayName(d_ptr->m_Row, cn);
 }
 
 Event::EventCategory Event::eventCategory() const
 {
-    return d_ptr->m_EventCategory;
+    return EventStore::instance().eventCategory(d_ptr->m_Row);
 }
 
 Event::Type Event::type() const
 {
-    return d_ptr->m_Type;
+    return EventStore::instance().type(d_ptr->m_Row);
 }
 
 Event::Direction Event::direction() const
 {
-    return d_ptr->m_Direction;
+    return EventStore::instance().direction(d_ptr->m_Row);
 }
 
 Event::Status Event::status() const
 {
-    return d_ptr->m_Status;
+    return EventStore::instance().status(d_ptr->m_Row);
 }
 
 QList< QPair<ContactMethod*, QString> > Event::attendees() const
 {
-    return d_ptr->m_lAttendees;
+    return EventStore::instance().attendees(d_ptr->m_Row);
 }
 
 Account* Event::account() const
 {
-    return d_ptr->m_pAccount;
+    return EventStore::instance().account(d_ptr->m_Row);
 }
 
 QList<Media::Attachment*> Event::attachedFiles() const
 {
-    return d_ptr->m_lAttachedFiles;
+    return EventStore::instance().attachedFiles(d_ptr->m_Row);
 }
 
 void Event::attachFile(Media::Attachment* file)
 {
-    d_ptr->m_lAttachedFiles << file;
+    EventStore::instance().attachFile(d_ptr->m_Row, file);
 }
 
 void Event::detachFile(Media::Attachment* file)
 {
-    d_ptr->m_lAttachedFiles.removeAll(file);
+    EventStore::instance().detachFile(d_ptr->m_Row, file);
 }
 
 bool Event::hasAttachment(Media::Attachment::BuiltInTypes t) const
 {
-    for (auto a : qAsConst(d_ptr->m_lAttachedFiles)) {
+    const auto files = attachedFiles();
+
+    for (auto a : qAsConst(files)) {
         if (a->type() == t)
             return true;
     }
@@ -424,7 +442,9 @@ bool Event::hasAttachment(Media::Attachment::BuiltInTypes t) const
 
 Media::Attachment* Event::attachment(Media::Attachment::BuiltInTypes t) const
 {
-    for (auto a : qAsConst(d_ptr->m_lAttachedFiles)) {
+    const auto files = attachedFiles();
+
+    for (auto a : qAsConst(files)) {
         if (a->type() == t)
             return a;
     }
@@ -437,14 +457,14 @@ bool Event::isSibling(const QSharedPointer<Event>& other) const
     if (!other)
         return false;
 
-    return type() == other->type() &&
-        attendees().size() == other->attendees().size() &&
-        other->hasAttendees(attendees());
+    return EventStore::instance().isSibling(d_ptr->m_Row, other->d_ptr->m_Row);
 }
 
 bool Event::hasAttachment(const QUrl& path) const
 {
-    for (auto a : qAsConst(d_ptr->m_lAttachedFiles)) {
+    const auto files = attachedFiles();
+
+    for (auto a : qAsConst(files)) {
         if (a->path() == path)
             return true;
     }
@@ -454,7 +474,7 @@ bool Event::hasAttachment(const QUrl& path) const
 
 int Event::revisionCount() const
 {
-    return d_ptr->m_RevCounter;
+    return EventStore::instance().revisionCount(d_ptr->m_Row);
 }
 
 QVariant Event::roleData(int role) const
@@ -515,7 +535,10 @@ QVariant Event::roleData(int role) const
             );
         case Event::Roles::BEST_NAME:
             //FIXME That's wrong but multi party isn't implemented, so the other case never happen
-            return attendees().size() ? attendees().constFirst().first->bestName() : QString();
+            if (auto cm = EventStore::instance().attendee(d_ptr->m_Row, 0))
+                return cm->bestName();
+
+            return QString();
         case (int) Ring::Role::State:
         case (int) Ring::Role::FormattedState:
         case (int) Ring::Role::DropState:
@@ -532,10 +555,15 @@ Event::SyncState Event::syncState() const
 
 bool Event::hasAttendee(ContactMethod* cm) const
 {
-    const auto b(d_ptr->m_lAttendees.constBegin()), e(d_ptr->m_lAttendees.constEnd());
-    return std::find_if(b, e, [cm](const QPair<ContactMethod*, QString>& other) {
-        return cm->d() == other.first->d();
-    }) != e;
+    const auto& store = EventStore::instance();
+    const int count   = store.attendeeCount(d_ptr->m_Row);
+
+    for (int i = 0; i < count; i++) {
+        if (cm->d() == store.attendee(d_ptr->m_Row, i)->d())
+            return true;
+    }
+
+    return false;
 }
 
 bool Event::hasAttendees(const QList<ContactMethod*>& cms) const
@@ -545,7 +573,7 @@ bool Event::hasAttendees(const QList<ContactMethod*>& cms) const
             return false;
     }
 
-    return d_ptr->m_lAttendees.size() >= cms.size();
+    return EventStore::instance().attendeeCount(d_ptr->m_Row) >= cms.size();
 }
 
 bool Event::hasAttendees(const QList< QPair<ContactMethod*, QString> >& cms) const
@@ -555,15 +583,20 @@ bool Event::hasAttendees(const QList< QPair<ContactMethod*, QString> >& cms) con
             return false;
     }
 
-    return d_ptr->m_lAttendees.size() >= cms.size();
+    return EventStore::instance().attendeeCount(d_ptr->m_Row) >= cms.size();
 }
 
 bool Event::hasAttendee(Individual* ind) const
 {
-    const auto b(d_ptr->m_lAttendees.constBegin()), e(d_ptr->m_lAttendees.constEnd());
-    return std::find_if(b, e, [ind](const QPair<ContactMethod*, QString>& other) {
-        return ind == other.first->individual();
-    }) != e;
+    const auto& store = EventStore::instance();
+    const int count   = store.attendeeCount(d_ptr->m_Row);
+
+    for (int i = 0; i < count; i++) {
+        if (ind == store.attendee(d_ptr->m_Row, i)->individual())
+            return true;
+    }
+
+    return false;
 }
 
 QSharedPointer<Event> Event::ref() const
@@ -607,7 +640,7 @@ bool Event::edit()
 
 bool Event::remove()
 {
-    d_ptr->m_Status = Event::Status::CANCELLED;
+    EventStore::instance().setStatus(d_ptr->m_Row, Event::Status::CANCELLED);
 
     if (ItemBase::remove())
         return d_ptr->m_pInternals->performAction(EventInternals::EditActions::DELETE) !=
@@ -625,7 +658,7 @@ bool Event::addAttendee(ContactMethod* cm, const QString& name)
 
     const bool hasInd = hasAttendee(ind);
 
-    d_ptr->m_lAttendees << QPair<ContactMethod*, QString> {cm, name};
+    EventStore::instance().addAttendee(d_ptr->m_Row, cm, name);
 
     // Let it happen, someone calling her/himself to leave voicemails or
     // something like this isn't all that unusual.
@@ -27,6 +27,7 @@
 #include <itemdataroles.h>
 
 class EventPrivate;
+struct EventAttributes;
 class ContactMethod;
 class Call;
 class Account;
@@ -71,6 +72,9 @@ class LIB_EXPORT Event : public ItemBase
     friend class Serializable::Group; // update the timestamps on new messages
     friend class EventModel; // manager
     friend class EventModelPrivate; // manager
+    friend class EventStore; // lazy factory
+    friend class ICSBuilder; // serialization
+    friend class CalendarSnapshot; // serialization
     friend struct EventInternals; // itself
 
 public:
@@ -353,12 +357,17 @@ private:
      * immutable) properties. This class is intended to be managed/created by
      * the Calendars, so there is no point in making any of this public.
      */
-    explicit Event(const EventPrivate& attrs, SyncState st);
+    explicit Event(const EventAttributes& attrs, SyncState st);
+
+    /**
+     * Create the object for an already loaded EventStore row.
+     */
+    explicit Event(quint32 row);
 
     /**
      * Let the factory turn placeholders into "real" objects.
      */
-    void rebuild(const EventPrivate& attrs, SyncState st);
+    void rebuild(const EventAttributes& attrs, SyncState st);
 
     /**
      * To be used by the factory to turn placeholders into "active" events.
@@ -142,6 +142,7 @@ public Q_SLOTS:
     void slotAttendeeAdded(ContactMethod* cm);
     void slotEventChanged();
     void slotEventAdded(QSharedPointer<Event> e);
+    void slotEventsAdded(const QList<QSharedPointer<Event>>& events);
     void slotEventDetached(QSharedPointer<Event> e);
 };
 
@@ -239,6 +240,7 @@ QSharedPointer<EventAggregate> EventAggregate::build(ContactMethod* cm)
         e->setProperty("__singleAggregate", i++); //HACK it has to work-ish ASAP at any cost
 
     connect(cm, &ContactMethod::eventAdded, ret->d_ptr.data(), &EventAggregatePrivate::slotEventAdded);
+    connect(cm, &ContactMethod::eventsAdded, ret->d_ptr.data(), &EventAggregatePrivate::slotEventsAdded);
     connect(cm, &ContactMethod::eventDetached, ret->d_ptr.data(), &EventAggregatePrivate::slotEventDetached);
 
     return ret;
@@ -260,6 +262,7 @@ QSharedPointer<EventAggregate> EventAggregate::build(Individual* ind)
         e->setProperty("__singleAggregate", i++); //HACK it has to work-ish ASAP at any cost
 
     connect(ind, &Individual::eventAdded, ret->d_ptr.data(), &EventAggregatePrivate::slotEventAdded);
+    connect(ind, &Individual::eventsAdded, ret->d_ptr.data(), &EventAggregatePrivate::slotEventsAdded);
     connect(ind, &Individual::eventDetached, ret->d_ptr.data(), &EventAggregatePrivate::slotEventDetached);
 
     return ret;
@@ -309,6 +312,14 @@ void EventAggregatePrivate::slotEventAdded(QSharedPointer<Event> e)
     }*/
 }
 
+void EventAggregatePrivate::slotEventsAdded(const QList<QSharedPointer<Event>>& events)
+{
+    m_lAllEvents.reserve(m_lAllEvents.size() + events.size());
+
+    for (const auto& e : qAsConst(events))
+        slotEventAdded(e);
+}
+
 void EventAggregatePrivate::slotEventDetached(QSharedPointer<Event> e)
 {
     Q_UNUSED(e)
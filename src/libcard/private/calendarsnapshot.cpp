@@ -0,0 +1,320 @@
+/************************************************************************************
+ *   Copyright (C) 2018 by BlueSystems GmbH                                         *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                            *
+ *                                                                                  *
+ *   This library is free software; you can redistribute it and/or                  *
+ *   modify it under the terms of the GNU Lesser General Public                     *
+ *   License as published by the Free Software Foundation; either                   *
+ *   version 2.1 of the License, or (at your option) any later version.             *
+ *                                                                                  *
+ *   This library is distributed in the hope that it will be useful,                *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of                 *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU              *
+ *   Lesser General Public License for more details.                                *
+ *                                                                                  *
+ *   You should have received a copy of the GNU Lesser General Public               *
+ *   License along with this library; if not, write to the Free Software            *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA *
+ ***********************************************************************************/
+#include "calendarsnapshot.h"
+
+// Qt
+#include <QtCore/QDataStream>
+#include <QtCore/QDateTime>
+#include <QtCore/QDebug>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QSaveFile>
+#include <QtCore/QStandardPaths>
+#include <QtCore/QVector>
+
+// Ring
+#include <account.h>
+#include <contactmethod.h>
+#include <person.h>
+#include <uri.h>
+#include <libcard/event.h>
+#include <libcard/calendar.h>
+#include <media/attachment.h>
+#include "libcard/private/event_p.h"
+#include "libcard/private/eventstore.h"
+#include "private/tracer_p.h"
+
+class CalendarSnapshotPrivate final
+{
+public:
+    static constexpr quint32 MAGIC   = 0x5243534e; // "RCSN"
+    static constexpr quint32 VERSION = 2;
+
+    /// The smallest serialized record, attendee and recording, in bytes
+    static constexpr qint64 MIN_RECORD_SIZE    = 45;
+    static constexpr qint64 MIN_ATTENDEE_SIZE  = 16;
+    static constexpr qint64 MIN_RECORDING_SIZE = 4 ;
+
+    /// The ICS file state the snapshot was created from
+    struct Stamp {
+        qint64 m_Modified { 0};
+        qint64 m_Size     {-1};
+    };
+
+    /// The serialized events, kept as plain values until all of them are read
+    struct Record {
+        QByteArray                m_Uid           ;
+        qint64                    m_StartTimeStamp{0};
+        qint64                    m_StopTimeStamp {0};
+        qint64                    m_RevTimeStamp  {0};
+        QString                   m_CN            ;
+        quint16                   m_Category      {0};
+        quint8                    m_Direction     {0};
+        quint8                    m_Status        {0};
+        quint8                    m_Type          {0};
+        QVector<EventAttendeeRef> m_lAttendees    ;
+        QStringList               m_lRecordings   ;
+    };
+
+    static Stamp stamp(const QString& path);
+    static bool fits(const QDataStream& s, quint32 count, qint64 itemSize);
+};
+
+constexpr quint32 CalendarSnapshotPrivate::MAGIC;
+constexpr quint32 CalendarSnapshotPrivate::VERSION;
+constexpr qint64  CalendarSnapshotPrivate::MIN_RECORD_SIZE;
+constexpr qint64  CalendarSnapshotPrivate::MIN_ATTENDEE_SIZE;
+constexpr qint64  CalendarSnapshotPrivate::MIN_RECORDING_SIZE;
+
+CalendarSnapshotPrivate::Stamp CalendarSnapshotPrivate::stamp(const QString& path)
+{
+    const QFileInfo fi(path);
+
+    if (!fi.exists())
+        return {};
+
+    return {fi.lastModified().toMSecsSinceEpoch(), fi.size()};
+}
+
+/// The counts come from the file, they can't be larger than what is left of it
+bool CalendarSnapshotPrivate::fits(const QDataStream& s, quint32 count, qint64 itemSize)
+{
+    const qint64 left = s.device()->size() - s.device()->pos();
+
+    return s.status() == QDataStream::Ok && count <= left / itemSize;
+}
+
+QString CalendarSnapshot::path(const Calendar* cal)
+{
+    static const QString dir = QStandardPaths::writableLocation(QStandardPaths::DataLocation)
+        + QStringLiteral("/iCal/snapshots/");
+
+    return dir + cal->account()->id() + QStringLiteral(".bin");
+}
+
+bool CalendarSnapshot::isUpToDate(const Calendar* cal)
+{
+    QFile file(path(cal));
+
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream s(&file);
+    s.setVersion(QDataStream::Qt_5_6);
+
+    quint32 magic(0), version(0);
+    CalendarSnapshotPrivate::Stamp st;
+
+    s >> magic >> version >> st.m_Modified >> st.m_Size;
+
+    const auto current = CalendarSnapshotPrivate::stamp(cal->path());
+
+    return s.status() == QDataStream::Ok
+        && magic         == CalendarSnapshotPrivate::MAGIC
+        && version       == CalendarSnapshotPrivate::VERSION
+        && st.m_Modified == current.m_Modified
+        && st.m_Size     == current.m_Size;
+}
+
+bool CalendarSnapshot::read(Calendar* cal, const std::function<void(const EventAttributes&)>& cb)
+{
+    RING_TRACE_SPAN("calendar", "readSnapshot");
+
+    QFile file(path(cal));
+
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    // Map the file rather than reading it, the stream only ever walks
+    // forward and the pages are released once it is parsed
+    uchar* data = file.map(0, file.size());
+
+    if (!data)
+        return false;
+
+    const QByteArray raw = QByteArray::fromRawData(reinterpret_cast<const char*>(data), file.size());
+
+    QDataStream s(raw);
+    s.setVersion(QDataStream::Qt_5_6);
+
+    quint32 magic(0), version(0), count(0);
+    CalendarSnapshotPrivate::Stamp st;
+
+    s >> magic >> version >> st.m_Modified >> st.m_Size >> count;
+
+    const auto current = CalendarSnapshotPrivate::stamp(cal->path());
+
+    // The ICS file was modified since, it has to be parsed again
+    if (s.status() != QDataStream::Ok
+      || magic         != CalendarSnapshotPrivate::MAGIC
+      || version       != CalendarSnapshotPrivate::VERSION
+      || st.m_Modified != current.m_Modified
+      || st.m_Size     != current.m_Size) {
+        file.unmap(data);
+        return false;
+    }
+
+    QVector<CalendarSnapshotPrivate::Record> records;
+    bool valid = CalendarSnapshotPrivate::fits(s, count, CalendarSnapshotPrivate::MIN_RECORD_SIZE);
+
+    if (valid)
+        records.resize(count);
+
+    for (auto& r : records) {
+        quint32 attendees(0), recordings(0);
+
+        s >> r.m_Uid >> r.m_StartTimeStamp >> r.m_StopTimeStamp >> r.m_RevTimeStamp
+            >> r.m_CN >> r.m_Category >> r.m_Direction >> r.m_Status >> r.m_Type
+            >> attendees;
+
+        if (!(valid = CalendarSnapshotPrivate::fits(s, attendees, CalendarSnapshotPrivate::MIN_ATTENDEE_SIZE)))
+            break;
+
+        r.m_lAttendees.resize(attendees);
+
+        for (auto& a : r.m_lAttendees)
+            s >> a.m_Uri >> a.m_PersonUid >> a.m_Name >> a.m_AccountId;
+
+        // Same format as a QStringList, but QDataStream would reserve the
+        // count before reading anything
+        s >> recordings;
+
+        if (!(valid = CalendarSnapshotPrivate::fits(s, recordings, CalendarSnapshotPrivate::MIN_RECORDING_SIZE)))
+            break;
+
+        r.m_lRecordings.reserve(recordings);
+
+        for (quint32 i = 0; i < recordings; i++) {
+            QString rec;
+            s >> rec;
+            r.m_lRecordings << rec;
+        }
+    }
+
+    valid &= s.status() == QDataStream::Ok && s.atEnd();
+
+    file.unmap(data);
+
+    // Don't create half of the events, the ICS file is still there
+    if (!valid) {
+        qWarning() << "The calendar snapshot is corrupted" << file.fileName();
+        return false;
+    }
+
+    for (const auto& r : qAsConst(records)) {
+        EventAttributes attrs;
+        attrs.m_UID            = r.m_Uid;
+        attrs.m_StartTimeStamp = r.m_StartTimeStamp;
+        attrs.m_StopTimeStamp  = r.m_StopTimeStamp;
+        attrs.m_RevTimeStamp   = r.m_RevTimeStamp;
+        attrs.m_CN             = r.m_CN;
+        attrs.m_EventCategory  = static_cast<Event::EventCategory>(r.m_Category);
+        attrs.m_Direction      = static_cast<Event::Direction    >(r.m_Direction);
+        attrs.m_Status         = static_cast<Event::Status       >(r.m_Status);
+        attrs.m_Type           = static_cast<Event::Type         >(r.m_Type);
+
+        // Like the ICS loader, they are resolved by the main thread
+        attrs.m_lAttendeeRefs   = r.m_lAttendees;
+        attrs.m_lRecordingPaths = r.m_lRecordings;
+
+        cb(attrs);
+    }
+
+    return true;
+}
+
+bool CalendarSnapshot::write(Calendar* cal)
+{
+    RING_TRACE_SPAN("calendar", "writeSnapshot");
+
+    // The snapshot would contain events the ICS file doesn't
+    if (cal->unsavedCount())
+        return false;
+
+    const auto st = CalendarSnapshotPrivate::stamp(cal->path());
+
+    if (st.m_Size < 0)
+        return false;
+
+    QDir().mkpath(QFileInfo(path(cal)).absolutePath());
+
+    QSaveFile file(path(cal));
+
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Unable to save the calendar snapshot" << file.fileName();
+        return false;
+    }
+
+    // Same filter as ICSBuilder::rebuild, it uses the rows so the events
+    // without objects stay that way
+    const auto& store = EventStore::instance();
+    const auto  all   = cal->rows();
+
+    QVector<EventStore::Row> rows;
+    rows.reserve(all.size());
+
+    for (const auto row : qAsConst(all)) {
+        if (store.status(row) != Event::Status::CANCELLED)
+            rows << row;
+    }
+
+    QDataStream s(&file);
+    s.setVersion(QDataStream::Qt_5_6);
+
+    s << CalendarSnapshotPrivate::MAGIC << CalendarSnapshotPrivate::VERSION
+        << st.m_Modified << st.m_Size << quint32(rows.size());
+
+    for (const auto row : qAsConst(rows)) {
+        const auto attendees = store.attendees(row);
+
+        s << store.uid(row)
+            << qint64(store.startTimeStamp(row))
+            << qint64(store.stopTimeStamp (row))
+            << qint64(store.revTimeStamp  (row))
+            << store.displayName(row)
+            << quint16(store.eventCategory(row))
+            << quint8 (store.direction    (row))
+            << quint8 (store.status       (row))
+            << quint8 (store.type         (row))
+            << quint32(attendees.size     ());
+
+        for (const auto& pair : qAsConst(attendees)) {
+            const auto cm = pair.first;
+
+            s << cm->uri().format(URI::Section::SCHEME | URI::Section::USER_INFO | URI::Section::HOSTNAME)
+                << (cm->contact() ? cm->contact()->uid() : QByteArray())
+                << pair.second
+                << (cm->account() ? cm->account()->id()  : QByteArray());
+        }
+
+        // Only the recordings are imported by the ICS loader
+        QStringList recordings;
+        const auto files = store.attachedFiles(row);
+
+        for (const auto f : qAsConst(files)) {
+            if (f->type() == Media::Attachment::BuiltInTypes::AUDIO_RECORDING)
+                recordings << f->path().toString();
+        }
+
+        s << recordings;
+    }
+
+    return file.commit();
+}
@@ -0,0 +1,70 @@
+/************************************************************************************
+ *   Copyright (C) 2018 by BlueSystems GmbH                                         *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                            *
+ *                                                                                  *
+ *   This library is free software; you can redistribute it and/or                  *
+ *   modify it under the terms of the GNU Lesser General Public                     *
+ *   License as published by the Free Software Foundation; either                   *
+ *   version 2.1 of the License, or (at your option) any later version.             *
+ *                                                                                  *
+ *   This library is distributed in the hope that it will be useful,                *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of                 *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU              *
+ *   Lesser General Public License for more details.                                *
+ *                                                                                  *
+ *   You should have received a copy of the GNU Lesser General Public               *
+ *   License along with this library; if not, write to the Free Software            *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA *
+ ***********************************************************************************/
+#pragma once
+
+// Qt
+#include <QtCore/QString>
+
+// StdC++
+#include <functional>
+
+// Ring
+class Calendar;
+struct EventAttributes;
+
+/**
+ * A binary copy of the resolved calendar events for faster startup.
+ *
+ * Parsing the ICS files is the most expensive part of the startup. It is a
+ * text format with escaping, duplicated revisions of the same events and
+ * the attendees have to be resolved one property at a time. The snapshot
+ * stores the squashed events once they are loaded, in a format that can be
+ * read sequentially from a memory mapped file.
+ *
+ * It is only a cache. It is stamped with the modification time and size of
+ * the ICS file it was created from and discarded when they don't match.
+ * The ICS file always remains the reference.
+ *
+ * The snapshot is written after parsing the ICS file and on clean shutdown.
+ */
+class CalendarSnapshot final
+{
+public:
+    /// Where the snapshot of `cal` is stored
+    static QString path(const Calendar* cal);
+
+    /**
+     * Call `cb` for each event of the snapshot.
+     *
+     * Nothing is called unless the whole snapshot is valid and up to date.
+     *
+     * Like the ICS loader, it can run in a worker thread. The attendees and
+     * recordings are only set as EventAttributes::m_lAttendeeRefs and
+     * EventAttributes::m_lRecordingPaths.
+     *
+     * @return If the snapshot was used.
+     */
+    static bool read(Calendar* cal, const std::function<void(const EventAttributes&)>& cb);
+
+    /// Replace the snapshot with the current events of `cal`
+    static bool write(Calendar* cal);
+
+    /// If the snapshot matches the current ICS file
+    static bool isUpToDate(const Calendar* cal);
+};
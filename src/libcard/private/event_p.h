@@ -18,10 +18,11 @@
  ***********************************************************************************/
 #pragma once
 
-#include <libcard/event.h>
+// Qt
+#include <QtCore/QStringList>
+#include <QtCore/QVector>
 
-// Defined in EventModel and used to keep track of the attendees
-struct EventModelNode;
+#include <libcard/event.h>
 
 // "Really" private data too sensitive to be shared event in the private API
 struct EventInternals;
@@ -48,11 +49,27 @@ struct EventMetaNode
 };
 
 /**
- * The event private data
+ * An attendee as written in a file.
+ *
+ * The loaders can run in a CollectionLoader thread where the ContactMethod
+ * and Person can't be created, they are resolved later in the main thread.
  */
-class EventPrivate
+struct EventAttendeeRef
+{
+    QString    m_Uri      ;
+    QByteArray m_PersonUid;
+    QByteArray m_AccountId;
+    QString    m_Name     ;
+};
+
+/**
+ * The attributes used to build (or rebuild) an event.
+ *
+ * This is only used by the loaders and factories. Once the Event is created,
+ * the values are moved into the EventStore columns.
+ */
+struct EventAttributes
 {
-public:
     QByteArray m_UID;
     time_t m_StartTimeStamp {0};
     time_t m_StopTimeStamp  {0};
@@ -67,16 +84,29 @@ public:
     Event::Type m_Type {Event::Type::VJOURNAL};
     QList< QPair<ContactMethod*, QString> > m_lAttendees;
 
-    // Set by the event model
-    bool m_IsGroupHead {true};
+    /// Added to m_lAttendees and m_lAttachedFiles by the main thread
+    QVector<EventAttendeeRef> m_lAttendeeRefs;
+    QStringList               m_lRecordingPaths;
 
     /**
      * Either the call was from this session or it's an imported Call from the
      * old sflphone history.
      */
     bool m_HasImportedCall {false};
+};
 
-    EventModelNode* m_pTracker {nullptr};
+/**
+ * The event private data.
+ *
+ * The attributes themselves are in the EventStore, only the state specific to
+ * the object is kept here. Most events never get an object, see
+ * EventStore::event().
+ */
+class EventPrivate
+{
+public:
+    /// The EventStore columns index
+    quint32 m_Row {0};
 
     EventInternals* m_pInternals {nullptr};
 
@@ -28,18 +28,29 @@ class EventModelPrivate final : public QObject
 public:
     // Attributes
     QVector<EventModelNode*> m_lEvent;
-    QHash<const QByteArray, Event*> m_hUids;
+
+    /// The nodes indexed by EventStore row
+    QVector<EventModelNode*> m_lNodes;
 
     // Helpers
     void sort(ContactMethod* cm);
     void sort(Individual* ind);
     void mergeEvents(ContactMethod* dest, ContactMethod* src);
+    bool track(quint32 row);
+    EventModelNode* append(quint32 row);
+    void attach(ContactMethod* cm, EventModelNode* n);
+
+    /**
+     * Insert EventStore rows using a single row range.
+     *
+     * The Event objects are only created for the ContactMethods and
+     * Individuals with something connected to `eventsAdded`.
+     */
+    bool insertRows(const QVector<quint32>& rows);
 
     // Unoptimal internal API to get events, time not permitting anything better
-    const QVector< QSharedPointer<Event> >& events(const ContactMethod* cm) const;
+    QVector< QSharedPointer<Event> > events(const ContactMethod* cm) const;
+    int eventCount(const ContactMethod* cm) const;
 
     EventModel* q_ptr;
-
-public Q_SLOTS:
-    void slotFixCache();
 };
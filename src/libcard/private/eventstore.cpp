@@ -0,0 +1,653 @@
+/************************************************************************************
+ *   Copyright (C) 2018 by BlueSystems GmbH                                         *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                            *
+ *                                                                                  *
+ *   This library is free software; you can redistribute it and/or                  *
+ *   modify it under the terms of the GNU Lesser General Public                     *
+ *   License as published by the Free Software Foundation; either                   *
+ *   version 2.1 of the License, or (at your option) any later version.             *
+ *                                                                                  *
+ *   This library is distributed in the hope that it will be useful,                *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of                 *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU              *
+ *   Lesser General Public License for more details.                                *
+ *                                                                                  *
+ *   You should have received a copy of the GNU Lesser General Public               *
+ *   License along with this library; if not, write to the Free Software            *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA *
+ ***********************************************************************************/
+#include "eventstore.h"
+
+// Std
+#include <algorithm>
+
+// Qt
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDebug>
+#include <QtCore/QReadLocker>
+#include <QtCore/QThread>
+#include <QtCore/QWriteLocker>
+
+// Ring
+#include <contactmethod.h>
+#include "libcard/private/event_p.h"
+
+/// The main thread is the only writer, so it doesn't have to lock to read
+class EventStore::ReadLocker final
+{
+public:
+    explicit ReadLocker(const EventStore* s) :
+        m_pLock(s->isMainThread() ? nullptr : &s->m_Lock)
+    {
+        if (m_pLock)
+            m_pLock->lockForRead();
+    }
+
+    ~ReadLocker()
+    {
+        if (m_pLock)
+            m_pLock->unlock();
+    }
+
+private:
+    QReadWriteLock* m_pLock;
+};
+
+EventStore::EventStore()
+{
+    m_pMainThread = QCoreApplication::instance() ?
+        QCoreApplication::instance()->thread() : QThread::currentThread();
+
+    m_lStrings     << QString();
+    m_lAccounts    << nullptr;
+    m_lCollections << nullptr;
+}
+
+EventStore& EventStore::instance()
+{
+    static auto instance = new EventStore();
+    return *instance;
+}
+
+bool EventStore::isMainThread() const
+{
+    return QThread::currentThread() == m_pMainThread;
+}
+
+quint32 EventStore::intern(const QString& str)
+{
+    if (str.isEmpty())
+        return 0;
+
+    const auto it = m_hStrings.constFind(str);
+
+    if (it != m_hStrings.constEnd())
+        return *it;
+
+    const quint32 ret = m_lStrings.size();
+    m_lStrings << str;
+    m_hStrings[str] = ret;
+
+    return ret;
+}
+
+quint16 EventStore::accountIndex(Account* a)
+{
+    const int idx = m_lAccounts.indexOf(a);
+
+    if (idx != -1)
+        return idx;
+
+    m_lAccounts << a;
+
+    return m_lAccounts.size() - 1;
+}
+
+quint16 EventStore::collectionIndex(CollectionInterface* c)
+{
+    const int idx = m_lCollections.indexOf(c);
+
+    if (idx != -1)
+        return idx;
+
+    m_lCollections << c;
+
+    return m_lCollections.size() - 1;
+}
+
+QByteArray EventStore::rawUid(Row row) const
+{
+    return QByteArray::fromRawData(
+        m_UidPool.constData() + m_lUidOffset[row], m_lUidSize[row]
+    );
+}
+
+void EventStore::storeUid(Row row, const QByteArray& uid)
+{
+    dropUid(row);
+
+    if (uid.isEmpty())
+        return;
+
+    const int size = std::min(uid.size(), 0xFFFF);
+
+    m_lUidOffset[row] = m_UidPool.size();
+    m_lUidSize  [row] = size;
+    m_UidPool.append(uid.constData(), size);
+
+    const QByteArray raw = rawUid(row);
+    const uint       h   = qHash(raw);
+
+    for (auto it = m_hUids.constFind(h); it != m_hUids.constEnd() && it.key() == h; ++it) {
+        if (rawUid(*it) == raw) {
+            qWarning() << "An event with the same name was created twice, this is a bug" << raw;
+            break;
+        }
+    }
+
+    m_hUids.insert(h, row);
+}
+
+void EventStore::dropUid(Row row)
+{
+    if (!m_lUidSize[row])
+        return;
+
+    m_hUids.remove(qHash(rawUid(row)), row);
+
+    m_UidWaste += m_lUidSize[row];
+
+    m_lUidOffset[row] = 0;
+    m_lUidSize  [row] = 0;
+
+    if (m_UidWaste > 4096 && 2*m_UidWaste > m_UidPool.size())
+        compactUids();
+}
+
+void EventStore::compactUids()
+{
+    QByteArray pool;
+    pool.reserve(m_UidPool.size() - m_UidWaste);
+
+    for (int row = 0; row < m_lUidSize.size(); row++) {
+        if (!m_lUidSize[row])
+            continue;
+
+        const quint32 offset = pool.size();
+        pool.append(m_UidPool.constData() + m_lUidOffset[row], m_lUidSize[row]);
+        m_lUidOffset[row] = offset;
+    }
+
+    m_UidPool  = pool;
+    m_UidWaste = 0;
+}
+
+EventStore::Row EventStore::append(const EventAttributes& attrs)
+{
+    Q_ASSERT(isMainThread());
+
+    Row row;
+
+    {
+        QWriteLocker l(&m_Lock);
+
+        if (!m_lFreeRows.isEmpty()) {
+            row = m_lFreeRows.takeLast();
+        }
+        else {
+            row = m_lFlags.size();
+
+            m_lStartTimeStamp << 0;
+            m_lStopTimeStamp  << 0;
+            m_lRevTimeStamp   << 0;
+            m_lRevCounter     << 0;
+            m_lCategory       << 0;
+            m_lStatus         << 0;
+            m_lDirection      << 0;
+            m_lType           << 0;
+            m_lFlags          << 0;
+            m_lAccount        << 0;
+            m_lCollection     << 0;
+            m_lDisplayName    << 0;
+            m_lUidOffset      << 0;
+            m_lUidSize        << 0;
+            m_lObjects        << nullptr;
+            m_lAttendee       << nullptr;
+            m_lAttendeeName   << 0;
+        }
+
+        m_lFlags     [row] = LIVE | GROUP_HEAD;
+        m_lCollection[row] = 0;
+    }
+
+    assign(row, attrs);
+
+    return row;
+}
+
+void EventStore::assign(Row row, const EventAttributes& attrs)
+{
+    Q_ASSERT(isMainThread());
+
+    QWriteLocker l(&m_Lock);
+
+    m_lStartTimeStamp[row] = attrs.m_StartTimeStamp;
+    m_lStopTimeStamp [row] = attrs.m_StopTimeStamp;
+    m_lRevTimeStamp  [row] = attrs.m_RevTimeStamp;
+    m_lRevCounter    [row] = attrs.m_RevCounter;
+    m_lCategory      [row] = static_cast<quint16>(attrs.m_EventCategory);
+    m_lStatus        [row] = static_cast<quint8 >(attrs.m_Status       );
+    m_lDirection     [row] = static_cast<quint8 >(attrs.m_Direction    );
+    m_lType          [row] = static_cast<quint8 >(attrs.m_Type         );
+    m_lAccount       [row] = accountIndex(attrs.m_pAccount);
+    m_lDisplayName   [row] = intern(attrs.m_CN);
+    m_lAttendee      [row] = nullptr;
+    m_lAttendeeName  [row] = 0;
+
+    storeUid(row, attrs.m_UID);
+
+    m_hAttendees.remove(row);
+
+    for (const auto& pair : qAsConst(attrs.m_lAttendees)) {
+        if (!m_lAttendee[row]) {
+            m_lAttendee    [row] = pair.first;
+            m_lAttendeeName[row] = intern(pair.second);
+        }
+        else
+            m_hAttendees[row] << qMakePair(pair.first, intern(pair.second));
+    }
+
+    if (attrs.m_lAttachedFiles.isEmpty())
+        m_hAttachments.remove(row);
+    else
+        m_hAttachments[row] = attrs.m_lAttachedFiles;
+}
+
+void EventStore::release(Row row)
+{
+    Q_ASSERT(isMainThread());
+
+    QWriteLocker l(&m_Lock);
+
+    dropUid(row);
+
+    m_lAttendee    [row] = nullptr;
+    m_lAttendeeName[row] = 0;
+    m_lDisplayName [row] = 0;
+    m_lCollection  [row] = 0;
+    m_lFlags       [row] = 0;
+
+    if (m_lObjects[row]) {
+        m_lObjects[row] = nullptr;
+        m_ObjectCount--;
+    }
+
+    m_hAttendees.remove(row);
+    m_hAttachments.remove(row);
+
+    m_lFreeRows << row;
+}
+
+void EventStore::setObject(Row row, Event* e)
+{
+    Q_ASSERT(isMainThread());
+    Q_ASSERT(!m_lObjects[row]);
+
+    QWriteLocker l(&m_Lock);
+
+    m_lObjects[row] = e;
+    m_ObjectCount++;
+}
+
+QSharedPointer<Event> EventStore::event(Row row)
+{
+    Q_ASSERT(isMainThread());
+
+    if (!(m_lFlags[row] & LIVE))
+        return nullptr;
+
+    // The constructor registers the object
+    if (!m_lObjects[row])
+        new Event(row);
+
+    return m_lObjects[row]->ref();
+}
+
+Event* EventStore::object(Row row) const
+{
+    ReadLocker l(this);
+    return m_lObjects[row];
+}
+
+bool EventStore::find(const QByteArray& uid, Row* row) const
+{
+    if (uid.isEmpty())
+        return false;
+
+    ReadLocker l(this);
+
+    const uint h = qHash(uid);
+
+    for (auto it = m_hUids.constFind(h); it != m_hUids.constEnd() && it.key() == h; ++it) {
+        if (rawUid(*it) == uid) {
+            *row = *it;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+time_t EventStore::startTimeStamp(Row row) const
+{
+    ReadLocker l(this);
+    return m_lStartTimeStamp[row];
+}
+
+time_t EventStore::stopTimeStamp(Row row) const
+{
+    ReadLocker l(this);
+    return m_lStopTimeStamp[row];
+}
+
+time_t EventStore::revTimeStamp(Row row) const
+{
+    ReadLocker l(this);
+    return m_lRevTimeStamp[row];
+}
+
+uint EventStore::revisionCount(Row row) const
+{
+    ReadLocker l(this);
+    return m_lRevCounter[row];
+}
+
+Event::EventCategory EventStore::eventCategory(Row row) const
+{
+    ReadLocker l(this);
+    return static_cast<Event::EventCategory>(m_lCategory[row]);
+}
+
+Event::Direction EventStore::direction(Row row) const
+{
+    ReadLocker l(this);
+    return static_cast<Event::Direction>(m_lDirection[row]);
+}
+
+Event::Status EventStore::status(Row row) const
+{
+    ReadLocker l(this);
+    return static_cast<Event::Status>(m_lStatus[row]);
+}
+
+Event::Type EventStore::type(Row row) const
+{
+    ReadLocker l(this);
+    return static_cast<Event::Type>(m_lType[row]);
+}
+
+QByteArray EventStore::uid(Row row) const
+{
+    ReadLocker l(this);
+
+    // Deep copy, the pool can be compacted
+    return QByteArray(m_UidPool.constData() + m_lUidOffset[row], m_lUidSize[row]);
+}
+
+QString EventStore::displayName(Row row) const
+{
+    ReadLocker l(this);
+    return m_lStrings[m_lDisplayName[row]];
+}
+
+Account* EventStore::account(Row row) const
+{
+    ReadLocker l(this);
+    return m_lAccounts[m_lAccount[row]];
+}
+
+CollectionInterface* EventStore::collection(Row row) const
+{
+    ReadLocker l(this);
+    return m_lCollections[m_lCollection[row]];
+}
+
+bool EventStore::isGroupHead(Row row) const
+{
+    ReadLocker l(this);
+    return m_lFlags[row] & GROUP_HEAD;
+}
+
+int EventStore::attendeeCountUnlocked(Row row) const
+{
+    if (!m_lAttendee[row])
+        return 0;
+
+    const auto it = m_hAttendees.constFind(row);
+
+    return 1 + (it == m_hAttendees.constEnd() ? 0 : it->size());
+}
+
+ContactMethod* EventStore::attendeeUnlocked(Row row, int index) const
+{
+    if (!index)
+        return m_lAttendee[row];
+
+    const auto it = m_hAttendees.constFind(row);
+
+    if (it == m_hAttendees.constEnd() || index > it->size())
+        return nullptr;
+
+    return (*it)[index - 1].first;
+}
+
+int EventStore::attendeeCount(Row row) const
+{
+    ReadLocker l(this);
+    return attendeeCountUnlocked(row);
+}
+
+ContactMethod* EventStore::attendee(Row row, int index) const
+{
+    ReadLocker l(this);
+    return attendeeUnlocked(row, index);
+}
+
+QList< QPair<ContactMethod*, QString> > EventStore::attendees(Row row) const
+{
+    ReadLocker l(this);
+
+    QList< QPair<ContactMethod*, QString> > ret;
+
+    if (!m_lAttendee[row])
+        return ret;
+
+    ret << qMakePair(m_lAttendee[row], m_lStrings[m_lAttendeeName[row]]);
+
+    const auto it = m_hAttendees.constFind(row);
+
+    if (it != m_hAttendees.constEnd()) {
+        for (const auto& pair : qAsConst(*it))
+            ret << qMakePair(pair.first, m_lStrings[pair.second]);
+    }
+
+    return ret;
+}
+
+QList<Media::Attachment*> EventStore::attachedFiles(Row row) const
+{
+    ReadLocker l(this);
+    return m_hAttachments.value(row);
+}
+
+bool EventStore::isSibling(Row row, Row other) const
+{
+    ReadLocker l(this);
+
+    const int count = attendeeCountUnlocked(row);
+
+    if (m_lType[row] != m_lType[other] || count != attendeeCountUnlocked(other))
+        return false;
+
+    for (int i = 0; i < count; i++) {
+        const auto cm = attendeeUnlocked(row, i);
+
+        bool found = false;
+
+        for (int j = 0; j < count && !found; j++)
+            found = cm->d() == attendeeUnlocked(other, j)->d();
+
+        if (!found)
+            return false;
+    }
+
+    return true;
+}
+
+void EventStore::setStopTimeStamp(Row row, time_t t)
+{
+    Q_ASSERT(isMainThread());
+    QWriteLocker l(&m_Lock);
+    m_lStopTimeStamp[row] = t;
+}
+
+void EventStore::setRevTimeStamp(Row row, time_t t)
+{
+    Q_ASSERT(isMainThread());
+    QWriteLocker l(&m_Lock);
+    m_lRevTimeStamp[row] = t;
+}
+
+void EventStore::setStatus(Row row, Event::Status st)
+{
+    Q_ASSERT(isMainThread());
+    QWriteLocker l(&m_Lock);
+    m_lStatus[row] = static_cast<quint8>(st);
+}
+
+void EventStore::setUid(Row row, const QByteArray& uid)
+{
+    Q_ASSERT(isMainThread());
+    QWriteLocker l(&m_Lock);
+    storeUid(row, uid);
+}
+
+void EventStore::setDisplayName(Row row, const QString& cn)
+{
+    Q_ASSERT(isMainThread());
+    QWriteLocker l(&m_Lock);
+    m_lDisplayName[row] = intern(cn);
+}
+
+void EventStore::setAccount(Row row, Account* a)
+{
+    Q_ASSERT(isMainThread());
+    QWriteLocker l(&m_Lock);
+    m_lAccount[row] = accountIndex(a);
+}
+
+void EventStore::setCollection(Row row, CollectionInterface* c)
+{
+    Q_ASSERT(isMainThread());
+    QWriteLocker l(&m_Lock);
+    m_lCollection[row] = collectionIndex(c);
+}
+
+void EventStore::setGroupHead(Row row, bool value)
+{
+    Q_ASSERT(isMainThread());
+    QWriteLocker l(&m_Lock);
+
+    if (value)
+        m_lFlags[row] |= GROUP_HEAD;
+    else
+        m_lFlags[row] &= ~GROUP_HEAD;
+}
+
+void EventStore::addAttendee(Row row, ContactMethod* cm, const QString& name)
+{
+    Q_ASSERT(isMainThread());
+    QWriteLocker l(&m_Lock);
+
+    if (!m_lAttendee[row]) {
+        m_lAttendee    [row] = cm;
+        m_lAttendeeName[row] = intern(name);
+    }
+    else
+        m_hAttendees[row] << qMakePair(cm, intern(name));
+}
+
+void EventStore::clearAttendees(Row row)
+{
+    Q_ASSERT(isMainThread());
+    QWriteLocker l(&m_Lock);
+
+    m_lAttendee    [row] = nullptr;
+    m_lAttendeeName[row] = 0;
+
+    m_hAttendees.remove(row);
+}
+
+void EventStore::attachFile(Row row, Media::Attachment* file)
+{
+    Q_ASSERT(isMainThread());
+    QWriteLocker l(&m_Lock);
+    m_hAttachments[row] << file;
+}
+
+void EventStore::detachFile(Row row, Media::Attachment* file)
+{
+    Q_ASSERT(isMainThread());
+    QWriteLocker l(&m_Lock);
+
+    auto it = m_hAttachments.find(row);
+
+    if (it == m_hAttachments.end())
+        return;
+
+    it->removeAll(file);
+
+    if (it->isEmpty())
+        m_hAttachments.erase(it);
+}
+
+int EventStore::size() const
+{
+    ReadLocker l(this);
+    return m_lFlags.size() - m_lFreeRows.size();
+}
+
+int EventStore::objectCount() const
+{
+    ReadLocker l(this);
+    return m_ObjectCount;
+}
+
+qint64 EventStore::memoryUsage() const
+{
+    ReadLocker l(this);
+
+    // Per row: 3 timestamps, the revision, category, 3 enums, the flags,
+    // account, collection, name, the UID offset and size, the object, the
+    // first attendee and its name.
+    constexpr const qint64 rowSize = 3*sizeof(qint64) + sizeof(quint32)
+        + sizeof(quint16) + 3*sizeof(quint8) + sizeof(quint8)
+        + 2*sizeof(quint16) + sizeof(quint32) + sizeof(quint32)
+        + sizeof(quint16) + sizeof(Event*) + sizeof(ContactMethod*)
+        + sizeof(quint32);
+
+    qint64 ret = m_lFlags.capacity() * rowSize;
+
+    ret += m_UidPool.capacity();
+
+    // The hash nodes are (roughly) the key, the value and the next pointer
+    ret += m_hUids.size() * (sizeof(uint) + sizeof(Row) + sizeof(void*));
+
+    for (const auto& str : qAsConst(m_lStrings))
+        ret += str.capacity() * sizeof(QChar);
+
+    for (const auto& extra : qAsConst(m_hAttendees))
+        ret += extra.capacity() * sizeof(QPair<ContactMethod*, quint32>);
+
+    return ret;
+}
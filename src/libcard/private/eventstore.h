@@ -0,0 +1,204 @@
+/************************************************************************************
+ *   Copyright (C) 2018 by BlueSystems GmbH                                         *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                            *
+ *                                                                                  *
+ *   This library is free software; you can redistribute it and/or                  *
+ *   modify it under the terms of the GNU Lesser General Public                     *
+ *   License as published by the Free Software Foundation; either                   *
+ *   version 2.1 of the License, or (at your option) any later version.             *
+ *                                                                                  *
+ *   This library is distributed in the hope that it will be useful,                *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of                 *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU              *
+ *   Lesser General Public License for more details.                                *
+ *                                                                                  *
+ *   You should have received a copy of the GNU Lesser General Public               *
+ *   License along with this library; if not, write to the Free Software            *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA *
+ ***********************************************************************************/
+#pragma once
+
+// Qt
+#include <QtCore/QVector>
+#include <QtCore/QHash>
+#include <QtCore/QMultiHash>
+#include <QtCore/QReadWriteLock>
+#include <QtCore/QSharedPointer>
+class QThread;
+
+// Ring
+#include <libcard/event.h>
+struct EventAttributes;
+class CollectionInterface;
+
+/**
+ * Keep the attributes of all events in contiguous columns.
+ *
+ * A full history can have hundreds of thousands of events. Storing each of
+ * them with its own UID, display name and attendee list allocations costs
+ * several hundred bytes per event. Here, the scalar values are packed in
+ * arrays, the display and attendee names are interned (the same few peers
+ * account for most of the history) and the first attendee is stored inline
+ * since almost all events have exactly one. The UIDs are packed in a single
+ * buffer and indexed by hash.
+ *
+ * The rows are the events. The Event QObjects are only created when
+ * something asks for them (a view, a timeline, a text recording) using
+ * event(). The loaded events that are never displayed never get one.
+ * Released rows are recycled.
+ *
+ * All mutations happen in the main thread. The other threads have to take
+ * the read lock, which the main thread doesn't need to. The sorting code can
+ * use the unlocked getters directly.
+ */
+class EventStore final
+{
+    friend class Event; // register the objects
+public:
+    typedef quint32 Row;
+
+    static EventStore& instance();
+
+    // Mutators
+    Row  append (const EventAttributes& attrs);
+    void assign (Row row, const EventAttributes& attrs);
+    void release(Row row);
+
+    /// Get (or create) the Event object for `row`, main thread only
+    QSharedPointer<Event> event(Row row);
+
+    /// The Event object for `row` if it was already created
+    Event* object(Row row) const;
+
+    /// Find the live row with this UID
+    bool find(const QByteArray& uid, Row* row) const;
+
+    // Getters
+    time_t               startTimeStamp(Row row) const;
+    time_t               stopTimeStamp (Row row) const;
+    time_t               revTimeStamp  (Row row) const;
+    uint                 revisionCount (Row row) const;
+    Event::EventCategory eventCategory (Row row) const;
+    Event::Direction     direction     (Row row) const;
+    Event::Status        status        (Row row) const;
+    Event::Type          type          (Row row) const;
+    QByteArray           uid           (Row row) const;
+    QString              displayName   (Row row) const;
+    Account*             account       (Row row) const;
+    CollectionInterface* collection    (Row row) const;
+    bool                 isGroupHead   (Row row) const;
+
+    int            attendeeCount(Row row) const;
+    ContactMethod* attendee     (Row row, int index) const;
+    QList< QPair<ContactMethod*, QString> > attendees(Row row) const;
+    QList<Media::Attachment*> attachedFiles(Row row) const;
+
+    /// If both events have the same type and attendees
+    bool isSibling(Row row, Row other) const;
+
+    // Main thread only getters without locking, for the sort comparators
+    inline time_t unlockedStartTimeStamp(Row row) const;
+    inline time_t unlockedStopTimeStamp (Row row) const;
+
+    // Setters
+    void setStopTimeStamp(Row row, time_t t);
+    void setRevTimeStamp (Row row, time_t t);
+    void setStatus       (Row row, Event::Status st);
+    void setUid          (Row row, const QByteArray& uid);
+    void setDisplayName  (Row row, const QString& cn);
+    void setAccount      (Row row, Account* a);
+    void setCollection   (Row row, CollectionInterface* c);
+    void setGroupHead    (Row row, bool value);
+    void addAttendee     (Row row, ContactMethod* cm, const QString& name);
+    void clearAttendees  (Row row);
+    void attachFile      (Row row, Media::Attachment* file);
+    void detachFile      (Row row, Media::Attachment* file);
+
+    /// The number of live rows
+    int size() const;
+
+    /// The number of rows with an Event object
+    int objectCount() const;
+
+    /// An approximation of the memory used by the columns, in bytes
+    qint64 memoryUsage() const;
+
+private:
+    EventStore();
+
+    enum Flags : quint8 {
+        LIVE       = 0x1 << 0,
+        GROUP_HEAD = 0x1 << 1,
+    };
+
+    // All require the write lock
+    quint32 intern       (const QString& str);
+    quint16 accountIndex (Account* a);
+    quint16 collectionIndex(CollectionInterface* c);
+    void    storeUid     (Row row, const QByteArray& uid);
+    void    dropUid      (Row row);
+    void    compactUids  ();
+
+    // Require (at least) the read lock
+    QByteArray rawUid(Row row) const;
+    int            attendeeCountUnlocked(Row row) const;
+    ContactMethod* attendeeUnlocked     (Row row, int index) const;
+
+    bool isMainThread() const;
+    void setObject(Row row, Event* e);
+
+    class ReadLocker;
+
+    mutable QReadWriteLock m_Lock;
+    QThread* m_pMainThread {nullptr};
+
+    // Columns
+    QVector<qint64>     m_lStartTimeStamp;
+    QVector<qint64>     m_lStopTimeStamp ;
+    QVector<qint64>     m_lRevTimeStamp  ;
+    QVector<quint32>    m_lRevCounter    ;
+    QVector<quint16>    m_lCategory      ;
+    QVector<quint8>     m_lStatus        ;
+    QVector<quint8>     m_lDirection     ;
+    QVector<quint8>     m_lType          ;
+    QVector<quint8>     m_lFlags         ;
+    QVector<quint16>    m_lAccount       ;
+    QVector<quint16>    m_lCollection    ;
+    QVector<quint32>    m_lDisplayName   ;
+    QVector<quint32>    m_lUidOffset     ;
+    QVector<quint16>    m_lUidSize       ;
+    QVector<Event*>     m_lObjects       ;
+
+    // Almost all events have a single attendee, the others go in m_hAttendees
+    QVector<ContactMethod*> m_lAttendee    ;
+    QVector<quint32>        m_lAttendeeName;
+    QHash<Row, QVector< QPair<ContactMethod*, quint32> > > m_hAttendees;
+
+    // Few events have attachments
+    QHash<Row, QList<Media::Attachment*> > m_hAttachments;
+
+    QVector<Row> m_lFreeRows;
+    int m_ObjectCount {0};
+
+    // All UIDs are in the same buffer, the released ones are compacted
+    // once they are a large part of it.
+    QByteArray             m_UidPool ;
+    qint64                 m_UidWaste {0};
+    QMultiHash<uint, Row>  m_hUids   ;
+
+    // Interned values, the index 0 is always the null value
+    QVector<QString>              m_lStrings;
+    QHash<QString, quint32>       m_hStrings;
+    QVector<Account*>             m_lAccounts;
+    QVector<CollectionInterface*> m_lCollections;
+};
+
+time_t EventStore::unlockedStartTimeStamp(Row row) const
+{
+    return m_lStartTimeStamp[row];
+}
+
+time_t EventStore::unlockedStopTimeStamp(Row row) const
+{
+    return m_lStopTimeStamp[row];
+}
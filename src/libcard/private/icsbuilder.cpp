@@ -21,6 +21,7 @@
 // Qt
 #include <QtCore/QUrl>
 #include <QtCore/QMimeType>
+#include <QtCore/QTimeZone>
 
 // StdC++
 #include <fstream>
@@ -34,6 +35,8 @@
 #include <person.h>
 #include <media/attachment.h>
 #include <uri.h>
+#include "libcard/private/event_p.h"
+#include "libcard/private/eventstore.h"
 
 class ICSBuilderPrivate final
 {
@@ -120,45 +123,55 @@ bool ICSBuilder::toStream(Account* a, std::basic_iostream<char>* device)
 
 bool ICSBuilder::toStream(Event* e, std::basic_iostream<char>* device)
 {
+    return toStream(e->d_ptr->m_Row, device);
+}
+
+/// Serialize an EventStore row, it doesn't require an Event object
+bool ICSBuilder::toStream(quint32 row, std::basic_iostream<char>* device)
+{
+    const auto& store = EventStore::instance();
+
     // This is a current convention in libringqt to discard
-    if (e->status() == Event::Status::CANCELLED) {
+    if (store.status(row) == Event::Status::CANCELLED) {
         return false;
     }
 
-    (*device) << "BEGIN:" << Event::typeName(e->type()).toStdString() <<"\n";
+    const auto type = Event::typeName(store.type(row)).toStdString();
 
-    (*device) << "UID:" << e->uid().toStdString() << '\n';
-    (*device) << "CATEGORIES:" << Event::categoryName(e->eventCategory()).toStdString() << '\n';
+    (*device) << "BEGIN:" << type <<"\n";
 
-    const auto tzid = e->timezone()->id().toStdString();
+    (*device) << "UID:" << store.uid(row).toStdString() << '\n';
+    (*device) << "CATEGORIES:" << Event::categoryName(store.eventCategory(row)).toStdString() << '\n';
 
-    (*device) << "DTSTART;TZID=" << tzid << ':' << e->startTimeStamp() << '\n';
-    (*device) << "DTEND;TZID=" << tzid << ':' << e->stopTimeStamp() << '\n';
-    (*device) << "DTSTAMP;TZID=" << tzid << ':' << e->revTimeStamp() << '\n';
+    static const auto tzid = QTimeZone::systemTimeZone().id().toStdString();
+
+    (*device) << "DTSTART;TZID=" << tzid << ':' << store.startTimeStamp(row) << '\n';
+    (*device) << "DTEND;TZID=" << tzid << ':' << store.stopTimeStamp(row) << '\n';
+    (*device) << "DTSTAMP;TZID=" << tzid << ':' << store.revTimeStamp(row) << '\n';
 
     // A custom property as defined in rfc5545#section-3.8.4.1
     // In theory it can be reverse engineered from the ORGANIZER/ATTENDEE
     // properties, but that breaks when an account is deleted
     (*device) << "X_RING_DIRECTION;VALUE=STRING:" << (
-        e->direction() == Event::Direction::INCOMING ?
+        store.direction(row) == Event::Direction::INCOMING ?
             "INCOMING" : "OUTGOING"
     ) << '\n';
 
-    (*device) << "STATUS:" << Event::statusName(e->status()).toStdString() << '\n';
+    (*device) << "STATUS:" << Event::statusName(store.status(row)).toStdString() << '\n';
 
-    toStream(e->account(), device);
+    toStream(store.account(row), device);
 
-    const auto attendees = e->attendees();
+    const auto attendees = store.attendees(row);
 
     for (const auto pair : qAsConst(attendees))
         toStream(pair.first, pair.second, device);
 
-    const auto attachedFiles = e->attachedFiles();
+    const auto attachedFiles = store.attachedFiles(row);
 
     for (const auto file : qAsConst(attachedFiles))
         toStream(file, device);
 
-    (*device) << "END:" << Event::typeName(e->type()).toStdString() <<"\n";
+    (*device) << "END:" << type <<"\n";
 
     return true;
 }
@@ -365,11 +378,11 @@ bool ICSBuilder::rebuild(Calendar* cal, std::function<void(bool)> cb)
     // Move before the END:VCALENDAR
     fs.seekp(len, std::ios_base::end); //TODO actually check if it's right
 
-    for (int i = 0; i < cal->size(); i++) {
-        if (auto e = cal->eventAt(i)) {
-            toStream(e.data(), &fs);
-        }
-    }
+    // Use the rows, most events don't have an object
+    const auto rows = cal->rows();
+
+    for (const auto row : qAsConst(rows))
+        toStream(row, &fs);
 
     fs << "END:VCALENDAR\n";
 
@@ -58,6 +58,7 @@ public:
     };
 
     static bool toStream(Event* e, std::basic_iostream<char>* device);
+    static bool toStream(quint32 row, std::basic_iostream<char>* device);
     static bool toStream(const QTimeZone* tz, std::basic_iostream<char>* device);
     static bool toStream(Calendar* cal, std::basic_iostream<char>* device);
     static bool toStream(ContactMethod* cm, const QString& name, std::basic_iostream<char>* device);
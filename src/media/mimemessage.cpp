@@ -25,12 +25,12 @@
 #include <QtCore/QString>
 #include <QtCore/QRegExp>
 #include <QtCore/QUrl>
-#include <QtCore/QRegularExpression>
 
 // Ring
 #include "mime.h"
 #include "libcard/matrixutils.h"
 #include "account_const.h"
+#include "private/messageformatter_p.h"
 
 namespace Media {
 
@@ -38,9 +38,6 @@ class MimeMessagePrivate
 {
 public:
 
-    // Constants
-    static const QRegularExpression m_linkRegex;
-
     // Attributes
     time_t                       m_TimeStamp;
     QList<MimeMessage::Payload*> m_lPayloads;
@@ -54,8 +51,6 @@ public:
     //Cache the most common payload to avoid lookup
     QString     m_PlainText;
     QString     m_HTML;
-    QString     m_FormattedHtml;
-    QList<QUrl> m_LinkList;
     bool        m_HasText     {false};
     bool        m_HasSnapshot {false};
     bool        m_HasUri      {false};
@@ -273,6 +268,8 @@ MimeMessage* MimeMessage::buildExisting(const QJsonObject& json)
 
 MimeMessage::~MimeMessage()
 {
+    MessageFormatter::instance().forget(this);
+
     for (auto p : qAsConst(d_ptr->m_lPayloads))
         delete p;
 
@@ -345,36 +342,13 @@ void MimeMessage::write(QJsonObject &json) const
     json[QStringLiteral("deliveryStatus")] = static_cast<int>(d_ptr->m_Status);
 }
 
-const QRegularExpression MimeMessagePrivate::m_linkRegex = QRegularExpression(QStringLiteral("((?>(?>https|http|ftp|ring):|www\\.)(?>[^\\s,.);!>]|[,.);!>](?!\\s|$))+)"),
-                                                                                 QRegularExpression::CaseInsensitiveOption);
-
-const QString& MimeMessage::getFormattedHtml()
+/**
+ * The formatted messages are cached in MessageFormatter, the rarely displayed
+ * ones will be rendered again.
+ */
+QString MimeMessage::getFormattedHtml() const
 {
-    if (d_ptr->m_FormattedHtml.isEmpty()) {
-        QString re;
-        auto p = 0;
-        auto it = d_ptr->m_linkRegex.globalMatch(d_ptr->m_PlainText);
-        while (it.hasNext()) {
-            QRegularExpressionMatch match = it.next();
-            auto start = match.capturedStart();
-
-            auto url = QUrl::fromUserInput(match.capturedRef().toString());
-
-            if (start > p)
-                re.append(d_ptr->m_PlainText.mid(p, start - p).toHtmlEscaped().replace(QLatin1Char('\n'),
-                                                                                QStringLiteral("<br/>")));
-            re.append(QStringLiteral("<a href=\"%1\">%2</a>")
-                      .arg(QString::fromLatin1(url.toEncoded()).toHtmlEscaped(),
-                           match.capturedRef().toString().toHtmlEscaped()));
-            d_ptr->m_LinkList.append(url);
-            p = match.capturedEnd();
-        }
-        if (p < d_ptr->m_PlainText.size())
-            re.append(d_ptr->m_PlainText.mid(p, d_ptr->m_PlainText.size() - p).toHtmlEscaped());
-
-        d_ptr->m_FormattedHtml = QStringLiteral("<body>%1</body>").arg(re);
-    }
-    return d_ptr->m_FormattedHtml;
+    return MessageFormatter::instance().format(this).m_Html;
 }
 
 time_t MimeMessage::timestamp() const
@@ -394,7 +368,7 @@ QString MimeMessage::html() const
 
 QList<QUrl> MimeMessage::linkList() const
 {
-    return d_ptr->m_LinkList;
+    return MessageFormatter::instance().links(this);
 }
 
 Media::Direction MimeMessage::direction() const
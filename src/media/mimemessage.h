@@ -110,7 +110,7 @@ public:
 
     Payload* primaryPayload() const;
 
-    const QString& getFormattedHtml(); //FIXME remove
+    QString getFormattedHtml() const; //FIXME remove
 
     void bookmark(bool value, const QString& mimeType = {});
 
@@ -33,6 +33,7 @@
 #include "avrecording.h"
 #include "media.h"
 #include "session.h"
+#include "eventmodel.h"
 #include "mimemessage.h"
 #include "call.h"
 #include "collections/localtextrecordingcollection.h"
@@ -98,6 +99,9 @@ public:
 
     // Helpers
     void initCategories();
+    RecordingNode* parentFor(const Recording* item) const;
+    RecordingNode* createNode(const Recording* item, RecordingNode* parent);
+    void trackNode(RecordingNode* n);
     void forwardInsertion(TextRecording* r, ContactMethod* cm, Media::Direction direction);
     void updateUnreadCount(const int count);
     void emitChangedProxy();
@@ -168,7 +172,12 @@ d_ptr(new RecordingModelPrivate(this))
 {
     setObjectName(QStringLiteral("RecordingModel"));
 
-    d_ptr->m_pTextRecordingCollection = addCollection<LocalTextRecordingCollection>();
+    // The text recordings create events, the calendars have to be loaded first
+    CollectionLoader::instance().addDependency(this, Session::instance()->eventModel());
+
+    d_ptr->m_pTextRecordingCollection = addCollection<LocalTextRecordingCollection>(
+        LoadOptions::FORCE_ENABLED | LoadOptions::ASYNC
+    );
 
     d_ptr->m_pTextRecordingCollection->listId([](const QList<CollectionInterface::Element>& e) {
         //TODO
@@ -354,63 +363,122 @@ void Media::RecordingModelPrivate::initCategories()
     q_ptr->endInsertRows();
 }
 
-bool Media::RecordingModel::addItemCallback(const Recording* item)
+///Categorize by general media group
+RecordingNode* Media::RecordingModelPrivate::parentFor(const Recording* item) const
 {
-    Q_UNUSED(item)
-
-    d_ptr->initCategories();
-
-    //Categorize by general media group
-    RecordingNode* parent = nullptr;
-
     if (item->type() == Recording::Type::TEXT)
-        parent = d_ptr->m_pText;
+        return m_pText;
     else if (item->type() == Recording::Type::AUDIO_VIDEO)
-        parent = d_ptr->m_pAudioVideo;
+        return m_pAudioVideo;
 
-    if (!parent)
-        return false;
+    return nullptr;
+}
 
-    //Insert the item]
-    const int idx = parent->m_lChildren.size();
-    const_cast<Recording*>(item)->setParent(this);
-    beginInsertRows(index(parent->m_Index,0), idx, idx);
+///Create the node, the caller is responsible for the begin/endInsertRows
+RecordingNode* Media::RecordingModelPrivate::createNode(const Recording* item, RecordingNode* parent)
+{
+    const_cast<Recording*>(item)->setParent(q_ptr);
 
     RecordingNode* n = new RecordingNode       ( RecordingNode::Type::SESSION );
     n->m_pRec        = const_cast<Recording*>  ( item );
-    n->m_Index       = idx;
+    n->m_Index       = parent->m_lChildren.size();
     n->m_pParent     = parent;
     parent->m_lChildren.push_back(n);
-    d_ptr->m_hMapping[n->m_pRec] = n;
+    m_hMapping[n->m_pRec] = n;
 
-    endInsertRows();
+    return n;
+}
+
+void Media::RecordingModelPrivate::trackNode(RecordingNode* n)
+{
+    if (n->m_pRec->type() != Recording::Type::TEXT)
+        return;
+
+    auto parent = n->m_pParent;
+    auto r = static_cast<TextRecording*>(n->m_pRec);
+
+    connect(r, &TextRecording::unreadCountChange, this, &RecordingModelPrivate::updateUnreadCount);
+    connect(r, &TextRecording::mimeMessageInserted, q_ptr, [this, r](MimeMessage* message, ContactMethod* cm) {
+        emit q_ptr->mimeMessageInserted(message, r, cm);
+    });
+    connect(r, &TextRecording::messageInserted, q_ptr, [n, this, parent](
+        const QMap<QString,QString>&, ContactMethod* cm, Media::Media::Direction d
+    ){
+        const auto par = q_ptr->index(parent->m_Index, 0);
+
+        emit q_ptr->dataChanged(
+            q_ptr->index(n->m_Index, 0, par),
+            q_ptr->index(n->m_Index, 1, par)
+        );
 
-    if (item->type() == Recording::Type::TEXT) {
-        auto r = const_cast<TextRecording*>(static_cast<const TextRecording*>(item));
-        connect(r, &TextRecording::unreadCountChange, d_ptr, &RecordingModelPrivate::updateUnreadCount);
-        connect(r, &TextRecording::mimeMessageInserted, this, [this, r](MimeMessage* message, ContactMethod* cm) {
-            emit mimeMessageInserted(message, r, cm);
-        });
-        connect(r, &TextRecording::messageInserted, this, [n, this, parent](
-            const QMap<QString,QString>&, ContactMethod* cm, Media::Media::Direction d
-        ){
-            const auto par = index(parent->m_Index, 0);
-
-            emit dataChanged(
-                index(n->m_Index, 0, par),
-                index(n->m_Index, 1, par)
+        if (n->m_pRec->type() == Recording::Type::TEXT)
+            forwardInsertion(
+                static_cast<TextRecording*>(n->m_pRec), cm, d
             );
+    });
+}
 
-            if (n->m_pRec->type() == Recording::Type::TEXT)
-                d_ptr->forwardInsertion(
-                    static_cast<TextRecording*>(n->m_pRec), cm, d
-                );
-        });
-    }
+bool Media::RecordingModel::addItemCallback(const Recording* item)
+{
+    d_ptr->initCategories();
+
+    RecordingNode* parent = d_ptr->parentFor(item);
+
+    if (!parent)
+        return false;
+
+    //Insert the item
+    const int idx = parent->m_lChildren.size();
+    beginInsertRows(index(parent->m_Index,0), idx, idx);
+    RecordingNode* n = d_ptr->createNode(item, parent);
+    endInsertRows();
+
+    d_ptr->trackNode(n);
 
     return true;
 }
 
+///Insert the items using a single range per category
+bool Media::RecordingModel::addItemsCallback(const QList<Recording*>& items)
+{
+    d_ptr->initCategories();
+
+    bool ret = true;
+
+    for (RecordingNode* parent : d_ptr->m_lCategories) {
+        QVector<const Recording*> children;
+
+        for (const Recording* item : qAsConst(items)) {
+            if (d_ptr->parentFor(item) == parent)
+                children << item;
+        }
+
+        if (children.isEmpty())
+            continue;
+
+        const int first = parent->m_lChildren.size();
+        QVector<RecordingNode*> nodes;
+        nodes.reserve(children.size());
+
+        beginInsertRows(index(parent->m_Index,0), first, first + children.size() - 1);
+        parent->m_lChildren.reserve(first + children.size());
+
+        for (const Recording* item : qAsConst(children))
+            nodes << d_ptr->createNode(item, parent);
+
+        endInsertRows();
+
+        for (RecordingNode* n : qAsConst(nodes))
+            d_ptr->trackNode(n);
+    }
+
+    // Items without a category are ignored, as with addItemCallback()
+    for (const Recording* item : qAsConst(items))
+        ret &= d_ptr->parentFor(item) != nullptr;
+
+    return ret;
+}
+
 bool Media::RecordingModel::removeItemCallback(const Recording* item)
 {
     Q_UNUSED(item)
@@ -115,6 +115,7 @@ private:
     //Collection interface
     virtual void collectionAddedCallback(CollectionInterface* backend) override;
     virtual bool addItemCallback        (const Recording* item       ) override;
+    virtual bool addItemsCallback       (const QList<Recording*>& items) override;
     virtual bool removeItemCallback     (const Recording* item       ) override;
 };
 
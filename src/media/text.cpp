@@ -97,7 +97,7 @@ IMConversationManagerPrivate::IMConversationManagerPrivate(QObject* parent) : QO
    ConfigurationManagerInterface& configurationManager = ConfigurationManager::instance();
 
    connect(&configurationManager, &ConfigurationManagerInterface::incomingAccountMessage, this, &IMConversationManagerPrivate::newAccountMessage);
-   connect(&configurationManager, &ConfigurationManagerInterface::accountMessageStatusChanged  , this, &IMConversationManagerPrivate::accountMessageStatusChanged);
+   connect(&DaemonSignalBridge::instance(), &DaemonSignalBridge::messageStatusesChanged      , this, &IMConversationManagerPrivate::messageStatusesChanged);
    connect(&callManager         , &CallManagerInterface::incomingMessage                , this, &IMConversationManagerPrivate::newMessage       );
 }
 
@@ -208,6 +208,13 @@ void IMConversationManagerPrivate::accountMessageStatusChanged(const QString& ac
     }
 }
 
+///Coalesced per message, only the latest status is delivered
+void IMConversationManagerPrivate::messageStatusesChanged(const QVector<DaemonSignalBridge::MessageStatusEvent>& events)
+{
+    for (const auto& e : qAsConst(events))
+        accountMessageStatusChanged(e.accountId, e.id, e.to, e.status);
+}
+
 MediaTextPrivate::MediaTextPrivate(Media::Text* parent) : q_ptr(parent),m_pRecording(nullptr),m_HasChecked(false)
 {
 }
@@ -44,6 +44,7 @@
 #include "mime.h"
 #include "dbus/configurationmanager.h"
 #include "private/textrecordingmodel.h"
+#include "private/messageformatter_p.h"
 #include "collections/localtextrecordingcollection.h"
 
 //Std
@@ -781,6 +782,7 @@ QVariant TextMessageNode::roleData(int role) const
         case (int)Media::TextRecording::Role::DeliveryStatus       :
             return QVariant::fromValue(m_pMessage->status());
         case (int)Media::TextRecording::Role::FormattedHtml        :
+            prefetchNeighbors();
             return QVariant::fromValue(m_pMessage->getFormattedHtml());
         case (int)Media::TextRecording::Role::LinkList             :
             return QVariant::fromValue(m_pMessage->linkList());
@@ -795,6 +797,33 @@ QVariant TextMessageNode::roleData(int role) const
     return {};
 }
 
+/// Render the messages around a displayed one before they are scrolled to
+void TextMessageNode::prefetchNeighbors() const
+{
+    static constexpr int RANGE = 30;
+
+    if (!m_pRecording)
+        return;
+
+    const auto& nodes = m_pRecording->d_ptr->m_lNodes;
+
+    if (m_row < 0 || m_row >= nodes.size() || nodes[m_row] != this)
+        return;
+
+    const int first = std::max(0, m_row - RANGE);
+    const int last  = std::min(nodes.size() - 1, m_row + RANGE);
+
+    QVector<const Media::MimeMessage*> messages;
+    messages.reserve(last - first);
+
+    for (int i = first; i <= last; i++) {
+        if (i != m_row)
+            messages << nodes[i]->m_pMessage;
+    }
+
+    MessageFormatter::instance().prefetch(messages);
+}
+
 QVariant Media::TextRecording::roleData(int row, int role) const
 {
     if (row < -d_ptr->m_lNodes.size() || row >= d_ptr->m_lNodes.size())
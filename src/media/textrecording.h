@@ -32,6 +32,7 @@ class ContactMethod;
 class IndividualTimelineModel;
 class IndividualTimelineModelPrivate;
 class LocalHistoryCollection;
+struct TextMessageNode;
 class Calendar;
 
 namespace HistoryImporter {
@@ -61,6 +62,7 @@ class LIB_EXPORT TextRecording : public Recording
    friend class ::ContactMethod;
    friend class ::IndividualTimelineModel;
    friend class ::IndividualTimelineModelPrivate;
+   friend struct ::TextMessageNode;
    friend void ::HistoryImporter::importHistory(::LocalHistoryCollection* col);
 
 public:
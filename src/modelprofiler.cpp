@@ -0,0 +1,409 @@
+/************************************************************************************
+ *   Copyright (C) 2018 by BlueSystems GmbH                                         *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                            *
+ *                                                                                  *
+ *   This library is free software; you can redistribute it and/or                  *
+ *   modify it under the terms of the GNU Lesser General Public                     *
+ *   License as published by the Free Software Foundation; either                   *
+ *   version 2.1 of the License, or (at your option) any later version.             *
+ *                                                                                  *
+ *   This library is distributed in the hope that it will be useful,                *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of                 *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU              *
+ *   Lesser General Public License for more details.                                *
+ *                                                                                  *
+ *   You should have received a copy of the GNU Lesser General Public               *
+ *   License along with this library; if not, write to the Free Software            *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA *
+ ***********************************************************************************/
+#include "modelprofiler.h"
+
+// Qt
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDebug>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QHash>
+#include <QtCore/QIdentityProxyModel>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QPointer>
+#include <QtCore/QSaveFile>
+#include <QtCore/QTimer>
+#include <QtCore/QVector>
+
+struct RoleStatistics
+{
+    quint64 m_Calls   {0};
+    qint64  m_Nsecs   {0};
+    qint64  m_MaxNsecs{0};
+    quint64 m_Changes {0};
+};
+
+struct ModelStatistics
+{
+    QString                      m_Name          ;
+    QPointer<QAbstractItemModel> m_pModel        ;
+    QHash<int, QByteArray>       m_hRoleNames    ;
+    bool                         m_IsProfiled    {false};
+    quint64                      m_DataCalls     {  0  };
+    qint64                       m_DataNsecs     {  0  };
+    quint64                      m_Inserts       {  0  };
+    quint64                      m_Removes       {  0  };
+    quint64                      m_Moves         {  0  };
+    quint64                      m_Resets        {  0  };
+    quint64                      m_LayoutChanges {  0  };
+    quint64                      m_DataChanges   {  0  };
+    quint64                      m_FanOut        {  0  };
+    QHash<int, RoleStatistics>   m_hRoles        ;
+};
+
+/// Measure the source data() calls, everything else is forwarded as-is
+class ProfilingProxyModel final : public QIdentityProxyModel
+{
+    Q_OBJECT
+public:
+    explicit ProfilingProxyModel(ModelStatistics* stats, QAbstractItemModel* source) :
+        QIdentityProxyModel(source), m_pStats(stats)
+    {
+        setSourceModel(source);
+    }
+
+    virtual QVariant data(const QModelIndex& index, int role) const override;
+
+private:
+    ModelStatistics* m_pStats;
+};
+
+class ModelProfilerPrivate final
+{
+public:
+    /// Used for the dataChanged() without roles
+    static constexpr const int ALL_ROLES = -1;
+
+    QVector<ModelStatistics*>                       m_lModels    ;
+    QHash<QAbstractItemModel*, ModelStatistics*>    m_hByModel   ;
+    QTimer                                          m_Timer      ;
+    QString                                         m_OutputFile ;
+
+    // Helpers
+    static QVariantMap toMap(const ModelStatistics* s);
+    static QString roleName(const ModelStatistics* s, int role);
+    static QString hottestRole(const ModelStatistics* s);
+};
+
+QVariant ProfilingProxyModel::data(const QModelIndex& index, int role) const
+{
+    QElapsedTimer t;
+    t.start();
+
+    const QVariant ret = QIdentityProxyModel::data(index, role);
+
+    const qint64 elapsed = t.nsecsElapsed();
+
+    auto& r = m_pStats->m_hRoles[role];
+    r.m_Calls++;
+    r.m_Nsecs   += elapsed;
+    r.m_MaxNsecs = qMax(r.m_MaxNsecs, elapsed);
+
+    m_pStats->m_DataCalls++;
+    m_pStats->m_DataNsecs += elapsed;
+
+    return ret;
+}
+
+ModelProfiler::ModelProfiler() : QAbstractListModel(QCoreApplication::instance()),
+d_ptr(new ModelProfilerPrivate)
+{
+    d_ptr->m_Timer.setInterval(5000);
+
+    if (isRequested())
+        d_ptr->m_OutputFile = QString::fromLocal8Bit(qgetenv("RING_MODEL_PROFILE"));
+
+    connect(&d_ptr->m_Timer, &QTimer::timeout, this, [this]() {
+        if (!d_ptr->m_lModels.isEmpty())
+            emit dataChanged(index(0, 0), index(d_ptr->m_lModels.size() - 1, 0));
+
+        if (d_ptr->m_OutputFile.isEmpty())
+            return;
+
+        QSaveFile file(d_ptr->m_OutputFile);
+
+        if (file.open(QIODevice::WriteOnly)) {
+            file.write(toJson());
+            file.commit();
+        }
+        else
+            qWarning() << "Unable to write the model profile" << d_ptr->m_OutputFile;
+    });
+}
+
+ModelProfiler::~ModelProfiler()
+{
+    qDeleteAll(d_ptr->m_lModels);
+    delete d_ptr;
+}
+
+ModelProfiler& ModelProfiler::instance()
+{
+    static auto instance = new ModelProfiler();
+    return *instance;
+}
+
+bool ModelProfiler::isRequested()
+{
+    static const bool requested = !qgetenv("RING_MODEL_PROFILE").isEmpty();
+    return requested;
+}
+
+QHash<int,QByteArray> ModelProfiler::roleNames() const
+{
+    static QHash<int, QByteArray> roles = QAbstractItemModel::roleNames();
+    static bool initRoles = false;
+    if (!initRoles) {
+        initRoles = true;
+        roles.insert(static_cast<int>(Role::Name         ) , QByteArray("name"         ));
+        roles.insert(static_cast<int>(Role::IsProfiled   ) , QByteArray("isProfiled"   ));
+        roles.insert(static_cast<int>(Role::DataCalls    ) , QByteArray("dataCalls"    ));
+        roles.insert(static_cast<int>(Role::DataTime     ) , QByteArray("dataTime"     ));
+        roles.insert(static_cast<int>(Role::HottestRole  ) , QByteArray("hottestRole"  ));
+        roles.insert(static_cast<int>(Role::Inserts      ) , QByteArray("inserts"      ));
+        roles.insert(static_cast<int>(Role::Removes      ) , QByteArray("removes"      ));
+        roles.insert(static_cast<int>(Role::Moves        ) , QByteArray("moves"        ));
+        roles.insert(static_cast<int>(Role::Resets       ) , QByteArray("resets"       ));
+        roles.insert(static_cast<int>(Role::LayoutChanges) , QByteArray("layoutChanges"));
+        roles.insert(static_cast<int>(Role::DataChanges  ) , QByteArray("dataChanges"  ));
+        roles.insert(static_cast<int>(Role::FanOut       ) , QByteArray("fanOut"       ));
+        roles.insert(static_cast<int>(Role::Roles        ) , QByteArray("roles"        ));
+    }
+    return roles;
+}
+
+QVariant ModelProfiler::data(const QModelIndex& index, int role) const
+{
+    if ((!index.isValid()) || index.row() >= d_ptr->m_lModels.size())
+        return {};
+
+    const ModelStatistics* s = d_ptr->m_lModels[index.row()];
+
+    switch(role) {
+        case Qt::DisplayRole:
+        case static_cast<int>(Role::Name):
+            return s->m_Name;
+        case static_cast<int>(Role::IsProfiled):
+            return s->m_IsProfiled;
+        case static_cast<int>(Role::DataCalls):
+            return s->m_DataCalls;
+        case static_cast<int>(Role::DataTime):
+            return s->m_DataNsecs / 1000;
+        case static_cast<int>(Role::HottestRole):
+            return ModelProfilerPrivate::hottestRole(s);
+        case static_cast<int>(Role::Inserts):
+            return s->m_Inserts;
+        case static_cast<int>(Role::Removes):
+            return s->m_Removes;
+        case static_cast<int>(Role::Moves):
+            return s->m_Moves;
+        case static_cast<int>(Role::Resets):
+            return s->m_Resets;
+        case static_cast<int>(Role::LayoutChanges):
+            return s->m_LayoutChanges;
+        case static_cast<int>(Role::DataChanges):
+            return s->m_DataChanges;
+        case static_cast<int>(Role::FanOut):
+            return s->m_FanOut;
+        case static_cast<int>(Role::Roles):
+            return ModelProfilerPrivate::toMap(s)[QStringLiteral("roles")];
+    }
+
+    return {};
+}
+
+int ModelProfiler::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : d_ptr->m_lModels.size();
+}
+
+void ModelProfiler::watch(QAbstractItemModel* model, const QString& name)
+{
+    if ((!model) || d_ptr->m_hByModel.contains(model))
+        return;
+
+    auto s = new ModelStatistics;
+    s->m_Name       = name;
+    s->m_pModel     = model;
+    s->m_hRoleNames = model->roleNames();
+
+    connect(model, &QAbstractItemModel::rowsInserted, this, [s](const QModelIndex&, int first, int last) {
+        s->m_Inserts++;
+        s->m_FanOut += last - first + 1;
+    });
+
+    connect(model, &QAbstractItemModel::rowsRemoved, this, [s](const QModelIndex&, int first, int last) {
+        s->m_Removes++;
+        s->m_FanOut += last - first + 1;
+    });
+
+    connect(model, &QAbstractItemModel::rowsMoved, this, [s](const QModelIndex&, int first, int last) {
+        s->m_Moves++;
+        s->m_FanOut += last - first + 1;
+    });
+
+    // After a reset, the views have to fetch everything again
+    connect(model, &QAbstractItemModel::modelReset, this, [s, model]() {
+        s->m_Resets++;
+        s->m_FanOut += model->rowCount();
+    });
+
+    connect(model, &QAbstractItemModel::layoutChanged, this, [s]() {
+        s->m_LayoutChanges++;
+    });
+
+    connect(model, &QAbstractItemModel::dataChanged, this, [s](const QModelIndex& tl, const QModelIndex& br, const QVector<int>& roles) {
+        s->m_DataChanges++;
+        s->m_FanOut += (br.row() - tl.row() + 1) * (br.column() - tl.column() + 1);
+
+        if (roles.isEmpty())
+            s->m_hRoles[ModelProfilerPrivate::ALL_ROLES].m_Changes++;
+
+        for (const int r : qAsConst(roles))
+            s->m_hRoles[r].m_Changes++;
+    });
+
+    // Keep the numbers, they are still relevant
+    connect(model, &QObject::destroyed, this, [this, model]() {
+        d_ptr->m_hByModel.remove(model);
+    });
+
+    beginInsertRows({}, d_ptr->m_lModels.size(), d_ptr->m_lModels.size());
+    d_ptr->m_lModels << s;
+    d_ptr->m_hByModel[model] = s;
+    endInsertRows();
+
+    if (!d_ptr->m_Timer.isActive())
+        d_ptr->m_Timer.start();
+}
+
+QAbstractItemModel* ModelProfiler::profile(QAbstractItemModel* model, const QString& name)
+{
+    if (!model)
+        return nullptr;
+
+    watch(model, name);
+
+    auto s = d_ptr->m_hByModel[model];
+    s->m_IsProfiled = true;
+
+    return new ProfilingProxyModel(s, model);
+}
+
+int ModelProfiler::interval() const
+{
+    return d_ptr->m_Timer.interval();
+}
+
+void ModelProfiler::setInterval(int ms)
+{
+    if (ms == d_ptr->m_Timer.interval())
+        return;
+
+    d_ptr->m_Timer.setInterval(ms);
+
+    emit intervalChanged(ms);
+}
+
+QString ModelProfiler::outputFile() const
+{
+    return d_ptr->m_OutputFile;
+}
+
+void ModelProfiler::setOutputFile(const QString& path)
+{
+    d_ptr->m_OutputFile = path;
+}
+
+void ModelProfiler::reset()
+{
+    for (auto s : qAsConst(d_ptr->m_lModels)) {
+        const auto keep = *s;
+
+        *s = {};
+        s->m_Name       = keep.m_Name;
+        s->m_pModel     = keep.m_pModel;
+        s->m_hRoleNames = keep.m_hRoleNames;
+        s->m_IsProfiled = keep.m_IsProfiled;
+    }
+
+    if (!d_ptr->m_lModels.isEmpty())
+        emit dataChanged(index(0, 0), index(d_ptr->m_lModels.size() - 1, 0));
+}
+
+QString ModelProfilerPrivate::roleName(const ModelStatistics* s, int role)
+{
+    if (role == ALL_ROLES)
+        return QStringLiteral("(all)");
+
+    const QByteArray name = s->m_hRoleNames.value(role);
+
+    return name.isEmpty() ? QString::number(role) : QString::fromLatin1(name);
+}
+
+QString ModelProfilerPrivate::hottestRole(const ModelStatistics* s)
+{
+    int    hottest = ALL_ROLES;
+    qint64 max     = 0;
+
+    for (auto it = s->m_hRoles.constBegin(); it != s->m_hRoles.constEnd(); ++it) {
+        if (it->m_Nsecs > max) {
+            max     = it->m_Nsecs;
+            hottest = it.key();
+        }
+    }
+
+    return max ? roleName(s, hottest) : QString();
+}
+
+QVariantMap ModelProfilerPrivate::toMap(const ModelStatistics* s)
+{
+    QVariantList roles;
+
+    for (auto it = s->m_hRoles.constBegin(); it != s->m_hRoles.constEnd(); ++it) {
+        roles << QVariantMap {
+            { QStringLiteral("role"     ), it.key()                                               },
+            { QStringLiteral("name"     ), roleName(s, it.key())                                  },
+            { QStringLiteral("calls"    ), it->m_Calls                                            },
+            { QStringLiteral("timeUs"   ), it->m_Nsecs / 1000.0                                   },
+            { QStringLiteral("maxUs"    ), it->m_MaxNsecs / 1000.0                                },
+            { QStringLiteral("averageUs"), it->m_Calls ? it->m_Nsecs / 1000.0 / it->m_Calls : 0.0 },
+            { QStringLiteral("changes"  ), it->m_Changes                                          },
+        };
+    }
+
+    return {
+        { QStringLiteral("name"         ), s->m_Name                 },
+        { QStringLiteral("alive"        ), !s->m_pModel.isNull()     },
+        { QStringLiteral("profiled"     ), s->m_IsProfiled           },
+        { QStringLiteral("dataCalls"    ), s->m_DataCalls            },
+        { QStringLiteral("dataTimeUs"   ), s->m_DataNsecs / 1000.0   },
+        { QStringLiteral("hottestRole"  ), hottestRole(s)            },
+        { QStringLiteral("inserts"      ), s->m_Inserts              },
+        { QStringLiteral("removes"      ), s->m_Removes              },
+        { QStringLiteral("moves"        ), s->m_Moves                },
+        { QStringLiteral("resets"       ), s->m_Resets               },
+        { QStringLiteral("layoutChanges"), s->m_LayoutChanges        },
+        { QStringLiteral("dataChanges"  ), s->m_DataChanges          },
+        { QStringLiteral("fanOut"       ), s->m_FanOut               },
+        { QStringLiteral("roles"        ), roles                     },
+    };
+}
+
+QByteArray ModelProfiler::toJson() const
+{
+    QVariantList models;
+
+    for (const auto s : qAsConst(d_ptr->m_lModels))
+        models << ModelProfilerPrivate::toMap(s);
+
+    return QJsonDocument(QJsonArray::fromVariantList(models)).toJson();
+}
+
+#include <modelprofiler.moc>
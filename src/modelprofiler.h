@@ -0,0 +1,112 @@
+/************************************************************************************
+ *   Copyright (C) 2018 by BlueSystems GmbH                                         *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                            *
+ *                                                                                  *
+ *   This library is free software; you can redistribute it and/or                  *
+ *   modify it under the terms of the GNU Lesser General Public                     *
+ *   License as published by the Free Software Foundation; either                   *
+ *   version 2.1 of the License, or (at your option) any later version.             *
+ *                                                                                  *
+ *   This library is distributed in the hope that it will be useful,                *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of                 *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU              *
+ *   Lesser General Public License for more details.                                *
+ *                                                                                  *
+ *   You should have received a copy of the GNU Lesser General Public               *
+ *   License along with this library; if not, write to the Free Software            *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA *
+ ***********************************************************************************/
+#pragma once
+
+#include <QtCore/QAbstractListModel>
+
+#include <typedefs.h>
+#include <itemdataroles.h>
+
+class ModelProfilerPrivate;
+
+/**
+ * Count what the views ask from the models and what the models notify.
+ *
+ * It is opt-in and has two levels:
+ *
+ *  * watch() connects to the notifications of a model. It counts the
+ *    inserted, removed and moved rows, the resets, the layout changes and
+ *    the dataChanged() per role. The "fan-out" is the number of rows
+ *    (or cells for dataChanged) covered by the notifications, which is
+ *    what the views have to process.
+ *  * profile() also returns a proxy to put between the model and the view.
+ *    It measures each data() call per role.
+ *
+ * When the RING_MODEL_PROFILE environment variable is set, the models
+ * created by the Session are watched and the statistics are written to the
+ * JSON file it points to at each interval.
+ *
+ * The profiler itself is a model with one row per watched model, which is
+ * refreshed at each interval rather than at every call.
+ */
+class LIB_EXPORT ModelProfiler final : public QAbstractListModel
+{
+    Q_OBJECT
+public:
+    Q_PROPERTY(int interval READ interval WRITE setInterval NOTIFY intervalChanged)
+    Q_PROPERTY(QString outputFile READ outputFile WRITE setOutputFile)
+
+    enum class Role {
+        Name          = static_cast<int>(Ring::Role::UserRole) + 100,
+        IsProfiled    , /*!< If data() is measured (through a proxy)  */
+        DataCalls     ,
+        DataTime      , /*!< Total, in microseconds                   */
+        HottestRole   , /*!< The role name with the largest DataTime  */
+        Inserts       ,
+        Removes       ,
+        Moves         ,
+        Resets        ,
+        LayoutChanges ,
+        DataChanges   ,
+        FanOut        ,
+        Roles         , /*!< QVariantList of per role QVariantMap     */
+    };
+
+    static ModelProfiler& instance();
+
+    // Model
+    virtual QVariant data    ( const QModelIndex& index, int role = Qt::DisplayRole ) const override;
+    virtual int      rowCount( const QModelIndex& parent = {}                       ) const override;
+    virtual QHash<int,QByteArray> roleNames() const override;
+
+    /// Count the notifications of `model`
+    void watch(QAbstractItemModel* model, const QString& name);
+
+    /// Count the notifications and return a proxy measuring data()
+    QAbstractItemModel* profile(QAbstractItemModel* model, const QString& name);
+
+    /// If RING_MODEL_PROFILE is set
+    static bool isRequested();
+
+    // Getters
+    int interval() const;
+    QString outputFile() const;
+
+    /// All the statistics
+    Q_INVOKABLE QByteArray toJson() const;
+
+    // Setters
+    void setInterval(int ms);
+    void setOutputFile(const QString& path);
+
+    // Mutators
+    Q_INVOKABLE void reset();
+
+Q_SIGNALS:
+    void intervalChanged(int ms);
+
+private:
+    explicit ModelProfiler();
+    virtual ~ModelProfiler();
+
+    ModelProfilerPrivate* d_ptr;
+    Q_DECLARE_PRIVATE(ModelProfiler)
+};
+
+Q_DECLARE_METATYPE(ModelProfiler*)
@@ -76,7 +76,7 @@ QHash<int,QByteArray> NetworkInterfaceModel::roleNames() const
 ///Return the account local interface
 QString NetworkInterfaceModelPrivate::localInterface() const
 {
-   return m_pAccount->d_ptr->accountDetail(DRing::Account::ConfProperties::LOCAL_INTERFACE);
+   return m_pAccount->d_ptr->properties().toString(AccountProperties::Key::LOCAL_INTERFACE);
 }
 
 ///Set the local interface
@@ -30,6 +30,7 @@
 #include <session.h>
 #include <individualdirectory.h>
 #include <historytimecategorymodel.h>
+#include "private/tracer_p.h"
 
 #define NEVER static_cast<int>(HistoryTimeCategoryModel::HistoryConst::Never)
 class SummaryModel;
@@ -322,6 +323,8 @@ int PeersTimelineModelPrivate::init()
 
     m_IsInit = true;
 
+    RING_TRACE_SPAN("model", "PeersTimelineModel::reset");
+
     // Create a QList for the easy insertion, then convert it to a model
     QMultiMap<time_t, ITLNode*> map;
 
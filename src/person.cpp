@@ -32,6 +32,8 @@
 #include "account.h"
 #include "session.h"
 #include "private/vcardutils.h"
+#include "private/photoloader_p.h"
+#include "private/personfilterindex_p.h"
 #include "persondirectory.h"
 #include "historytimecategorymodel.h"
 #include "individualdirectory.h"
@@ -41,6 +43,7 @@
 #include "addressmodel.h"
 #include "globalinstances.h"
 #include "interfaces/pixmapmanipulatori.h"
+#include "thumbnailcache.h"
 #include "private/person_p.h"
 #include "private/contactmethod_p.h"
 #include "media/textrecording.h"
@@ -53,23 +56,40 @@
 
 QString PersonPrivate::filterString()
 {
-    if (m_CachedFilterString.size())
-        return m_CachedFilterString;
+    // Use the same normalization as PersonDirectory::match()
+    if (m_CachedFilterString.isEmpty())
+        m_CachedFilterString = PersonFilterIndex::key(q_ptr);
 
-    //Also filter by phone numbers, accents are negligible
-    q_ptr->individual()->forAllNumbers([this](ContactMethod* cm) {
-        m_CachedFilterString += cm->uri();
-        m_CachedFilterString += cm->registeredName();
-    }, false);
+    return m_CachedFilterString;
+}
 
-    //Strip non essential characters like accents from the filter string
-    foreach(const QChar& char2,(m_FormattedName+'\n'+m_Organization+'\n'+m_Group+'\n'+
-        m_Department+'\n'+m_PreferredEmail).toLower().normalized(QString::NormalizationForm_KD) ) {
-        if (!char2.combiningClass())
-            m_CachedFilterString += char2;
-    }
+void PersonPrivate::setEncodedPhoto(const QByteArray& data, const QByteArray& type)
+{
+    m_vPhoto.clear();
+    m_EncodedPhoto = data;
+    m_PhotoType    = type;
 
-    return m_CachedFilterString;
+    // Set once here so the thumbnails can be looked up from any thread
+    m_PhotoKey     = ThumbnailCache::key(data);
+    m_PhotoPending = false;
+    m_PhotoGeneration++;
+}
+
+void PersonPrivate::copyPhoto(const PersonPrivate* other)
+{
+    // Share the decoded photo if there is one, otherwise both are decoded
+    // independently, but the thumbnails will still be shared
+    m_vPhoto       = other->m_vPhoto      ;
+    m_EncodedPhoto = other->m_EncodedPhoto;
+    m_PhotoType    = other->m_PhotoType   ;
+    m_PhotoKey     = other->m_PhotoKey    ;
+    m_PhotoPending = false;
+    m_PhotoGeneration++;
+}
+
+bool PersonPrivate::hasPhoto() const
+{
+    return (!m_vPhoto.isNull()) || !m_EncodedPhoto.isEmpty();
 }
 
 void PersonPrivate::photoChanged()
@@ -110,11 +130,11 @@ void PersonPrivate::statusChanged  ( bool s )
         emit c->statusChanged(s);
 }
 
-// void PersonPrivate::phoneNumbersChanged()
-// {
-//     for (Person* c : qAsConst(m_lParents))
-//         emit c->phoneNumbersChanged();
-// }
+void PersonPrivate::phoneNumbersChanged()
+{
+    for (Person* c : qAsConst(m_lParents))
+        emit c->phoneNumbersChanged();
+}
 
 // void PersonPrivate::phoneNumbersAboutToChange()
 // {
@@ -183,7 +203,6 @@ Person::Person(const Person& other) noexcept : ItemBase(Session::instance()->per
    d_ptr->m_FirstName            = other.d_ptr->m_FirstName           ;
    d_ptr->m_SecondName           = other.d_ptr->m_SecondName          ;
    d_ptr->m_NickName             = other.d_ptr->m_NickName            ;
-   d_ptr->m_vPhoto               = other.d_ptr->m_vPhoto              ;
    d_ptr->m_FormattedName        = other.d_ptr->m_FormattedName       ;
    d_ptr->m_PreferredEmail       = other.d_ptr->m_PreferredEmail      ;
    d_ptr->m_Organization         = other.d_ptr->m_Organization        ;
@@ -195,6 +214,7 @@ Person::Person(const Person& other) noexcept : ItemBase(Session::instance()->per
    d_ptr->m_isPlaceHolder        = other.d_ptr->m_isPlaceHolder       ;
    d_ptr->m_lAddresses           = other.d_ptr->m_lAddresses          ;
    d_ptr->m_lCustomAttributes    = other.d_ptr->m_lCustomAttributes   ;
+   d_ptr->copyPhoto(other.d_ptr);
 }
 
 ///Updates an existing contact from vCard info
@@ -238,9 +258,17 @@ QString Person::secondName() const
    return d_ptr->m_SecondName;
 }
 
-///Get the photo
+/**
+ * Get the photo.
+ *
+ * The photos loaded from a vCard are decoded on the first call. Until then,
+ * an invalid QVariant is returned and photoChanged() is emitted once ready.
+ */
 QVariant Person::photo() const
 {
+   if (d_ptr->m_vPhoto.isNull() && !d_ptr->m_EncodedPhoto.isEmpty())
+      PhotoLoader::instance().request(d_ptr);
+
    return d_ptr->m_vPhoto;
 }
 
@@ -355,6 +383,11 @@ void Person::setFamilyName(const QString& name)
 ///Set the Photo/Avatar
 void Person::setPhoto(const QVariant& photo)
 {
+   d_ptr->m_EncodedPhoto.clear();
+   d_ptr->m_PhotoType.clear();
+   d_ptr->m_PhotoKey.clear();
+   d_ptr->m_PhotoPending = false;
+   d_ptr->m_PhotoGeneration++;
    d_ptr->m_vPhoto = photo;
    d_ptr->changed();
    d_ptr->photoChanged();
@@ -786,7 +819,15 @@ const QByteArray Person::toVCard(QList<Account*> accounts) const
         maker.addProperty(VCardUtils::Property::X_RINGACCOUNT, acc->id());
     }
 
-    maker.addPhoto(GlobalInstances::pixmapManipulator().toByteArray(photo()));
+    // Keep the original photo. It avoids decoding it only to encode it again
+    // and photo() is empty until the asynchronous decoding is done.
+    if (!d_ptr->m_EncodedPhoto.isEmpty())
+        maker.addPhoto(
+            QByteArray::fromBase64(d_ptr->m_EncodedPhoto),
+            d_ptr->m_PhotoType.isEmpty() ? QByteArray("PNG") : d_ptr->m_PhotoType.toUpper()
+        );
+    else
+        maker.addPhoto(GlobalInstances::pixmapManipulator().toByteArray(photo()));
     return maker.endVCard();
 }
 
@@ -50,6 +50,8 @@ class LIB_EXPORT Person : public ItemBase
    friend class ContactMethod;
    friend class Individual;
    friend class PeerProfileCollection2Private; //FIXME ugly memory leak, but not enough time to fix
+   friend class ThumbnailCache;
+   friend struct VCardMapper;
 
 public:
 
@@ -212,6 +214,8 @@ Q_SIGNALS:
    void photoChanged();
    ///When the formatted name changes
    void formattedNameChanged();
+   ///The individual phone numbers changed, doesn't create the individual
+   void phoneNumbersChanged();
 };
 
 class LIB_EXPORT PersonPlaceHolder : public Person {
@@ -34,6 +34,7 @@
 #include "individual.h"
 #include "collections/transitionalpersonbackend.h"
 #include "collections/peerprofilecollection2.h"
+#include "private/personfilterindex_p.h"
 
 //Qt
 #include <QtCore/QHash>
@@ -73,6 +74,7 @@ public:
    //Indexes
    QHash<QByteArray,Person*> m_hPersonsByUid;
    std::vector<std::unique_ptr<PersonItemNode>> m_lPersons;
+   PersonFilterIndex m_FilterIndex;
 
 private:
    PersonDirectory* q_ptr;
@@ -80,6 +82,7 @@ private:
 
 public Q_SLOTS:
    void slotLastUsedTimeChanged(time_t t) const;
+   void slotPersonChanged();
 };
 
 PersonItemNode::PersonItemNode(Person* p, const NodeType type) :
@@ -303,6 +306,12 @@ bool PersonDirectory::addItemCallback(const Person* c)
 
    connect(c, &Person::lastUsedTimeChanged, d_ptr.data(), &PersonDirectoryPrivate::slotLastUsedTimeChanged);
 
+   //Keep the filter index up to date
+   d_ptr->m_FilterIndex.append(c);
+   connect(c, &Person::changed, d_ptr.data(), &PersonDirectoryPrivate::slotPersonChanged);
+   connect(c, &Person::rebased, d_ptr.data(), &PersonDirectoryPrivate::slotPersonChanged);
+   connect(c, &Person::phoneNumbersChanged, d_ptr.data(), &PersonDirectoryPrivate::slotPersonChanged);
+
    if (c->lastUsedTime())
       emit lastUsedTimeChanged(const_cast<Person*>(c), c->lastUsedTime());
 
@@ -324,6 +333,7 @@ bool PersonDirectory::removeItemCallback(const Person* item)
           beginRemoveRows(QModelIndex(), nodeIdx, nodeIdx);
           d_ptr->m_lPersons[nodeIdx].release();
           d_ptr->m_lPersons.erase(d_ptr->m_lPersons.begin() + nodeIdx);
+          d_ptr->m_FilterIndex.remove(nodeIdx);
 
           // update indexes
           for (unsigned int i = 0; i < d_ptr->m_lPersons.size(); ++i) {
@@ -371,5 +381,20 @@ void PersonDirectoryPrivate::slotLastUsedTimeChanged(time_t t) const
    emit q_ptr->lastUsedTimeChanged(static_cast<Person*>(QObject::sender()), t);
 }
 
+void PersonDirectoryPrivate::slotPersonChanged()
+{
+   m_FilterIndex.invalidate(static_cast<Person*>(QObject::sender()));
+}
+
+QBitArray PersonDirectory::match(const QString& query) const
+{
+   return d_ptr->m_FilterIndex.match(query);
+}
+
+int PersonDirectory::indexOf(const Person* p) const
+{
+   return d_ptr->m_FilterIndex.row(p);
+}
+
 
 #include <persondirectory.moc>
@@ -22,6 +22,7 @@
 #include <QStringList>
 #include <QVariant>
 #include <QtCore/QAbstractItemModel>
+#include <QtCore/QBitArray>
 
 #include "typedefs.h"
 #include "person.h"
@@ -54,6 +55,17 @@ public:
    Person* getPersonByUid   ( const QByteArray& uid );
    Person* getPlaceHolder(const QByteArray& uid );
 
+   /**
+    * The rows of the persons containing all the words of `query`.
+    *
+    * The case and the accents are ignored. This is much faster than
+    * filtering the Person::Role::Filter role in a QSortFilterProxyModel.
+    */
+   QBitArray match(const QString& query) const;
+
+   ///The bit of `p` in match(), -1 if it isn't in the directory
+   int indexOf(const Person* p) const;
+
    //Model implementation
    virtual bool          setData     ( const QModelIndex& index, const QVariant &value, int role   ) override;
    virtual QVariant      data        ( const QModelIndex& index, int role = Qt::DisplayRole        ) const override;
@@ -65,6 +65,7 @@ public:
    virtual bool save(const T* item) =0;
    virtual bool batchSave(const QList<T*> contacts);
    virtual bool batchRemove(const QList<T*> contacts);
+   virtual bool batchAddExisting(const QList<T*> items);
    virtual bool remove(const T* item);
    virtual bool contains(const T* item) const;
 
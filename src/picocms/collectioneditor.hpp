@@ -66,6 +66,22 @@ template <class T> bool CollectionEditor<T>::batchRemove(const QList<T*> contact
    return ret;
 }
 
+/**
+ * Default batch insertion implementation.
+ *
+ * Collections loading many items at once should override this and forward
+ * the whole list to CollectionMediator::addItems() so the model can notify
+ * its views once instead of once per item.
+ */
+template <class T> bool CollectionEditor<T>::batchAddExisting(const QList<T*> items)
+{
+   bool ret = true;
+   for(const T* i : items) {
+      ret &= addExisting(i);
+   }
+   return ret;
+}
+
 template <class T>
 bool CollectionEditor<T>::remove(const T* item)
 {
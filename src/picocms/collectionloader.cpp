@@ -0,0 +1,352 @@
+/************************************************************************************
+ *   Copyright (C) 2018 by BlueSystems GmbH                                         *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                            *
+ *                                                                                  *
+ *   This library is free software; you can redistribute it and/or                  *
+ *   modify it under the terms of the GNU Lesser General Public                     *
+ *   License as published by the Free Software Foundation; either                   *
+ *   version 2.1 of the License, or (at your option) any later version.             *
+ *                                                                                  *
+ *   This library is distributed in the hope that it will be useful,                *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of                 *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU              *
+ *   Lesser General Public License for more details.                                *
+ *                                                                                  *
+ *   You should have received a copy of the GNU Lesser General Public               *
+ *   License along with this library; if not, write to the Free Software            *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA *
+ ***********************************************************************************/
+#include "collectionloader.h"
+
+//Qt
+#include <QtCore/QAtomicInt>
+#include <QtCore/QThread>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QMutex>
+#include <QtCore/QSemaphore>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QTimer>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDebug>
+
+//Libstdc++
+#include <algorithm>
+
+//Ring
+#include <picocms/collectioninterface.h>
+#include "private/taskpool_p.h"
+#include "private/tracer_p.h"
+
+struct CollectionLoaderJob final
+{
+   CollectionInterface*          m_pCollection {nullptr};
+   std::function<void(bool)>     m_fCallback   {       };
+   QVector<CollectionInterface*> m_lDeps       {       };
+   CollectionLoader::State       m_State       {CollectionLoader::State::PENDING};
+   qint64                        m_Elapsed     {   0   };
+   bool                          m_Success     { false };
+};
+
+/// Set once the loader is destroyed, the event loop can't be waited for anymore
+static QAtomicInt s_ShuttingDown {0};
+
+class CollectionLoaderPrivate final : public QObject
+{
+   Q_OBJECT
+public:
+   explicit CollectionLoaderPrivate(CollectionLoader* q) : q_ptr(q) {}
+
+   // Attributes
+   TaskPool::Token m_Token;
+   QVector<CollectionLoaderJob*> m_lJobs;
+   QHash<CollectionInterface*, CollectionLoaderJob*> m_hJobs;
+   QHash<QAbstractItemModel*, QVector<QAbstractItemModel*> > m_hModelDeps;
+   bool m_DispatchQueued {false};
+   int  m_Loaded {0};
+   int  m_Running {0};
+   int  m_MaxThreadCount {QThread::idealThreadCount()};
+
+   // Helpers
+   bool isReady(const CollectionLoaderJob* job) const;
+   bool isDone(const CollectionLoaderJob* job) const;
+   void queueDispatch();
+   void load(CollectionLoaderJob* job, int index);
+   void run(CollectionLoaderJob* job);
+   void finish(CollectionLoaderJob* job);
+
+   CollectionLoader* q_ptr;
+
+Q_SIGNALS:
+   /// Emitted from the worker threads, always used with a queued connection
+   void jobFinished(int index);
+
+public Q_SLOTS:
+   void slotDispatch();
+   void slotJobFinished(int index);
+};
+
+CollectionLoader::CollectionLoader() : QObject(QCoreApplication::instance()),
+d_ptr(new CollectionLoaderPrivate(this))
+{
+   connect(d_ptr, &CollectionLoaderPrivate::jobFinished,
+      d_ptr, &CollectionLoaderPrivate::slotJobFinished, Qt::QueuedConnection);
+}
+
+CollectionLoader::~CollectionLoader()
+{
+   s_ShuttingDown = 1;
+   d_ptr->m_Token.cancel();
+   TaskPool::instance().wait(d_ptr->m_Token);
+
+   for (auto job : qAsConst(d_ptr->m_lJobs))
+      delete job;
+
+   delete d_ptr;
+}
+
+CollectionLoader& CollectionLoader::instance()
+{
+   static auto l = new CollectionLoader();
+   return *l;
+}
+
+void CollectionLoader::schedule(CollectionInterface* collection, std::function<void(bool)> callback, const QVector<CollectionInterface*>& dependencies)
+{
+   Q_ASSERT(QThread::currentThread() == thread());
+
+   if (Q_UNLIKELY(d_ptr->m_hJobs.contains(collection))) {
+      qWarning() << "The collection" << collection->name() << "is already scheduled";
+      return;
+   }
+
+   auto job = new CollectionLoaderJob;
+   job->m_pCollection = collection;
+   job->m_fCallback   = callback;
+   job->m_lDeps       = dependencies;
+
+   d_ptr->m_lJobs << job;
+   d_ptr->m_hJobs[collection] = job;
+
+   d_ptr->queueDispatch();
+}
+
+bool CollectionLoader::runInMainThread(const std::function<bool()>& f)
+{
+   if (QThread::currentThread() == QCoreApplication::instance()->thread())
+      return f();
+
+   // Shared with the continuation, it may outlive this call during shutdown
+   struct Call {
+      QSemaphore m_Done  {       };
+      bool       m_Ret   { false };
+   };
+
+   const auto call = QSharedPointer<Call>::create();
+
+   TaskPool::instance().runInMainThread(QCoreApplication::instance(), [call, f]() {
+      call->m_Ret = f();
+      call->m_Done.release();
+   });
+
+   while (!call->m_Done.tryAcquire(1, 100)) {
+      if (s_ShuttingDown)
+         return false;
+   }
+
+   return call->m_Ret;
+}
+
+void CollectionLoader::addDependency(QAbstractItemModel* model, QAbstractItemModel* dependsOn)
+{
+   Q_ASSERT(model != dependsOn);
+
+   auto& deps = d_ptr->m_hModelDeps[model];
+
+   if (!deps.contains(dependsOn))
+      deps << dependsOn;
+}
+
+void CollectionLoader::setMaxThreadCount(int count)
+{
+   d_ptr->m_MaxThreadCount = qMax(1, count);
+   d_ptr->queueDispatch();
+}
+
+int CollectionLoader::maxThreadCount() const
+{
+   return d_ptr->m_MaxThreadCount;
+}
+
+CollectionLoader::State CollectionLoader::state(CollectionInterface* collection) const
+{
+   const auto job = d_ptr->m_hJobs.value(collection);
+
+   // Collections loaded synchronously are never scheduled
+   return job ? job->m_State : State::LOADED;
+}
+
+qint64 CollectionLoader::elapsed(CollectionInterface* collection) const
+{
+   const auto job = d_ptr->m_hJobs.value(collection);
+   return job && d_ptr->isDone(job) ? job->m_Elapsed : 0;
+}
+
+int CollectionLoader::pendingCount() const
+{
+   return d_ptr->m_lJobs.size() - d_ptr->m_Loaded;
+}
+
+int CollectionLoader::loadedCount() const
+{
+   return d_ptr->m_Loaded;
+}
+
+int CollectionLoader::totalCount() const
+{
+   return d_ptr->m_lJobs.size();
+}
+
+bool CollectionLoaderPrivate::isDone(const CollectionLoaderJob* job) const
+{
+   return job->m_State == CollectionLoader::State::LOADED
+       || job->m_State == CollectionLoader::State::FAILED;
+}
+
+/**
+ * A job is ready when all its explicit dependencies are done and when no job
+ * from the models it depends on is still pending or running.
+ *
+ * The dependencies are evaluated at dispatch time rather than when the
+ * collection is scheduled. This way the calendars created after the text
+ * recording collection are still waited for.
+ */
+bool CollectionLoaderPrivate::isReady(const CollectionLoaderJob* job) const
+{
+   for (auto dep : qAsConst(job->m_lDeps)) {
+      if (auto other = m_hJobs.value(dep)) {
+         if (!isDone(other))
+            return false;
+      }
+   }
+
+   const auto modelDeps = m_hModelDeps.value(job->m_pCollection->model());
+
+   if (modelDeps.isEmpty())
+      return true;
+
+   for (auto other : qAsConst(m_lJobs)) {
+      if ((!isDone(other)) && modelDeps.contains(other->m_pCollection->model()))
+         return false;
+   }
+
+   return true;
+}
+
+void CollectionLoaderPrivate::queueDispatch()
+{
+   if (m_DispatchQueued)
+      return;
+
+   m_DispatchQueued = true;
+   QTimer::singleShot(0, this, &CollectionLoaderPrivate::slotDispatch);
+}
+
+void CollectionLoaderPrivate::slotDispatch()
+{
+   m_DispatchQueued = false;
+
+   forever {
+      for (int i = 0; i < m_lJobs.size() && m_Running < m_MaxThreadCount; i++) {
+         auto job = m_lJobs[i];
+
+         if (job->m_State != CollectionLoader::State::PENDING || !isReady(job))
+            continue;
+
+         job->m_State = CollectionLoader::State::RUNNING;
+         m_Running++;
+         emit q_ptr->collectionStarted(job->m_pCollection);
+
+         TaskPool::instance().run(TaskPool::Lane::BACKGROUND, [this, job, i]() {
+            load(job, i);
+         }, m_Token);
+      }
+
+      if (m_Running || m_Loaded == m_lJobs.size())
+         return;
+
+      // Nothing runs but some jobs still wait, their dependencies are a cycle.
+      // Break it by loading the first of them here.
+      const auto it = std::find_if(m_lJobs.constBegin(), m_lJobs.constEnd(), [](CollectionLoaderJob* j) {
+         return j->m_State == CollectionLoader::State::PENDING;
+      });
+
+      Q_ASSERT(it != m_lJobs.constEnd());
+
+      auto job = *it;
+
+      qWarning() << "The dependencies of" << job->m_pCollection->name()
+         << "form a cycle, it is loaded synchronously";
+
+      job->m_State = CollectionLoader::State::RUNNING;
+      m_Running++;
+      emit q_ptr->collectionStarted(job->m_pCollection);
+
+      run(job);
+      finish(job);
+
+      if (m_Loaded == m_lJobs.size()) {
+         emit q_ptr->finished();
+         return;
+      }
+   }
+}
+
+/// Load the collection and measure how long it took, in any thread
+void CollectionLoaderPrivate::run(CollectionLoaderJob* job)
+{
+   RING_TRACE_SPAN_ARG("collection", "load", job->m_pCollection->id());
+
+   QElapsedTimer t;
+   t.start();
+
+   // The job is not touched by the main thread while it is RUNNING
+   job->m_Success = job->m_pCollection->load();
+   job->m_Elapsed = t.elapsed();
+}
+
+/// Called from the TaskPool
+void CollectionLoaderPrivate::load(CollectionLoaderJob* job, int index)
+{
+   run(job);
+
+   emit jobFinished(index);
+}
+
+/// Record the result of a job, in the main thread
+void CollectionLoaderPrivate::finish(CollectionLoaderJob* job)
+{
+   m_Running--;
+
+   job->m_State = job->m_Success ?
+      CollectionLoader::State::LOADED : CollectionLoader::State::FAILED;
+
+   m_Loaded++;
+
+   if (job->m_fCallback)
+      job->m_fCallback(job->m_Success);
+
+   emit q_ptr->collectionLoaded(job->m_pCollection, job->m_Success, job->m_Elapsed);
+   emit q_ptr->progress(m_Loaded, m_lJobs.size());
+}
+
+void CollectionLoaderPrivate::slotJobFinished(int index)
+{
+   finish(m_lJobs[index]);
+
+   if (m_Loaded == m_lJobs.size())
+      emit q_ptr->finished();
+   else
+      slotDispatch();
+}
+
+#include <collectionloader.moc>
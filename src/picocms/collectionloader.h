@@ -0,0 +1,126 @@
+/************************************************************************************
+ *   Copyright (C) 2018 by BlueSystems GmbH                                         *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                            *
+ *                                                                                  *
+ *   This library is free software; you can redistribute it and/or                  *
+ *   modify it under the terms of the GNU Lesser General Public                     *
+ *   License as published by the Free Software Foundation; either                   *
+ *   version 2.1 of the License, or (at your option) any later version.             *
+ *                                                                                  *
+ *   This library is distributed in the hope that it will be useful,                *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of                 *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU              *
+ *   Lesser General Public License for more details.                                *
+ *                                                                                  *
+ *   You should have received a copy of the GNU Lesser General Public               *
+ *   License along with this library; if not, write to the Free Software            *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA *
+ ***********************************************************************************/
+#pragma once
+
+#include <QtCore/QObject>
+#include <QtCore/QVector>
+
+#include <typedefs.h>
+
+//Libstdc++
+#include <functional>
+
+class QAbstractItemModel;
+
+class CollectionInterface;
+class CollectionLoaderPrivate;
+
+/**
+ * Load the collections concurrently on the background lane of the library
+ * worker threads.
+ *
+ * Collections added with `LoadOptions::FORCE_ENABLED | LoadOptions::ASYNC`
+ * are not loaded directly by addCollection(), they are queued here instead.
+ * The queue is dispatched on the next event loop iteration, so all the
+ * collections created while the session is initialized are known before
+ * the first one starts.
+ *
+ * A collection only starts loading once its dependencies are done. They can
+ * either be other collections or whole managers (models). For example, the
+ * text recordings have to be loaded after the calendars because they create
+ * events.
+ *
+ * Please note that load() is then called from a worker thread. The
+ * CollectionMediator forwards the insertions to the main thread, anything
+ * else touching the models or the UI has to use runInMainThread().
+ *
+ * If the dependencies form a cycle, the collections involved are loaded
+ * synchronously one after the other rather than never.
+ *
+ * All signals are emitted from the main thread.
+ */
+class LIB_EXPORT CollectionLoader final : public QObject
+{
+   Q_OBJECT
+   friend class CollectionLoaderPrivate;
+public:
+   enum class State {
+      PENDING, /*!< Waiting for its dependencies or a free worker */
+      RUNNING, /*!< load() is being executed                      */
+      LOADED , /*!< load() returned true                          */
+      FAILED , /*!< load() returned false                         */
+   };
+   Q_ENUM(State)
+
+   static CollectionLoader& instance();
+
+   /**
+    * Load a collection once all of its dependencies are loaded.
+    *
+    * @param collection The collection
+    * @param callback Called in the main thread with the load() return value
+    * @param dependencies Collections which need to be loaded first
+    */
+   void schedule(
+      CollectionInterface* collection,
+      std::function<void(bool)> callback = {},
+      const QVector<CollectionInterface*>& dependencies = {}
+   );
+
+   /**
+    * All collections of `model` will wait until the collections of
+    * `dependsOn` are loaded.
+    */
+   void addDependency(QAbstractItemModel* model, QAbstractItemModel* dependsOn);
+
+   /// Set the maximum number of collections being loaded at the same time
+   void setMaxThreadCount(int count);
+   int maxThreadCount() const;
+
+   /**
+    * Execute `f` in the main thread and wait for its return value.
+    *
+    * It is called directly when already in the main thread. It returns false
+    * without waiting if the application is shutting down.
+    */
+   static bool runInMainThread(const std::function<bool()>& f);
+
+   State  state  (CollectionInterface* collection) const;
+   qint64 elapsed(CollectionInterface* collection) const;
+   int    pendingCount() const;
+   int    loadedCount () const;
+   int    totalCount  () const;
+
+Q_SIGNALS:
+   /// When a collection starts loading
+   void collectionStarted(CollectionInterface* collection);
+   /// When a collection load() returns, the time is in milliseconds
+   void collectionLoaded(CollectionInterface* collection, bool success, qint64 elapsed);
+   /// Every time a collection is done loading
+   void progress(int loaded, int total);
+   /// When there is nothing left in the queue
+   void finished();
+
+private:
+   explicit CollectionLoader();
+   virtual ~CollectionLoader();
+
+   CollectionLoaderPrivate* d_ptr;
+   Q_DECLARE_PRIVATE(CollectionLoader)
+};
@@ -20,6 +20,7 @@
 //Ring
 #include <picocms/collectionmodel.h>
 #include "private/collectionmodel_p.h"
+#include "private/tracer_p.h"
 
 class CollectionManagerInterfaceBasePrivate
 {
@@ -46,3 +47,11 @@ void CollectionManagerInterfaceBase::setCollectionConfigurator(CollectionInterfa
 {
    col->setConfigurator(getter);
 }
+
+/// The synchronous loads, the others go through the CollectionLoader
+bool CollectionManagerInterfaceBase::loadCollection(CollectionInterface* col) const
+{
+   RING_TRACE_SPAN_ARG("collection", "load", col->id());
+
+   return col->load();
+}
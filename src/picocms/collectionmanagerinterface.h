@@ -30,6 +30,7 @@
 //Ring
 #include <picocms/collectioninterface.h>
 #include <picocms/collectionmediator.h>
+#include <picocms/collectionloader.h>
 
 class QAbstractItemModel;
 
@@ -37,8 +38,14 @@ enum LoadOptions {
    NONE           = 0x0     ,
    FORCE_ENABLED  = 0x1 << 0,
    FORCE_DISABLED = 0x1 << 1,
+   ASYNC          = 0x1 << 2, /*!< Load in the CollectionLoader thread pool */
 };
 
+constexpr inline LoadOptions operator|(const LoadOptions a, const LoadOptions b)
+{
+   return static_cast<LoadOptions>(static_cast<int>(a) | static_cast<int>(b));
+}
+
 class CollectionManagerInterfaceBasePrivate;
 class CollectionCreationInterface;
 class CollectionConfigurationInterface;
@@ -66,6 +73,7 @@ protected:
    void addCreatorToList(CollectionCreationInterface* creator);
    void addConfiguratorToList(CollectionConfigurationInterface* configurator);
    void setCollectionConfigurator(CollectionInterface* col, std::function<CollectionConfigurationInterface*()> getter);
+   bool loadCollection(CollectionInterface* col) const;
 
 private:
    CollectionManagerInterfaceBasePrivate* d_ptr;
@@ -124,6 +132,10 @@ public:
     *
     * The ownership of the collection is transferred to the manager.
     *
+    * When both LoadOptions::FORCE_ENABLED and LoadOptions::ASYNC are set, the
+    * collection is loaded later by the CollectionLoader and it will be part
+    * of the enabledCollections() once load() succeeds.
+    *
     * @return The newly created collection
     */
    template <class T2, typename ...Ts>
@@ -190,6 +202,16 @@ private:
     */
    virtual bool addItemCallback   (const T* item) = 0;
 
+   /**
+    * Add many items at once. This is used by the collections when they are
+    * loaded so the model can emit a single insertion range and a single
+    * notification per affected object.
+    *
+    * The default implementation calls addItemCallback() for each items. The
+    * same rules apply, the items may already be part of the model.
+    */
+   virtual bool addItemsCallback  (const QList<T*>& items);
+
    /**
     * Remove an item from the model. Subclasses must implement the logic
     * necessary to remove an item from the QAbstractCollection.
@@ -68,12 +68,16 @@ T2* CollectionManagerInterface<T>::addCollection(Ts... args, const LoadOptions o
       return registerConfigarator<T2>();
    });
 
-   if (options & LoadOptions::FORCE_ENABLED) { //TODO check is the collection is checked
+   if ((options & LoadOptions::FORCE_ENABLED) && (options & LoadOptions::ASYNC)) {
+      CollectionLoader::instance().schedule(collection, [this, collection](bool success) {
+         if (success)
+            d_ptr->m_lEnabledCollections << collection;
+      });
+   }
+   else if (options & LoadOptions::FORCE_ENABLED) { //TODO check is the collection is checked
 
       //Some collections can fail to load directly
-      //eventually it will necessary to add an async version of this
-      //to load the collection only when it is loaded
-      if (collection->load())
+      if (loadCollection(collection))
          d_ptr->m_lEnabledCollections << collection;
    }
 
@@ -201,6 +205,15 @@ void CollectionManagerInterface<T>::collectionAddedCallback(CollectionInterface*
    Q_UNUSED(collection)
 }
 
+template<class T>
+bool CollectionManagerInterface<T>::addItemsCallback(const QList<T*>& items)
+{
+   bool ret = true;
+   for (const T* item : items)
+      ret &= addItemCallback(item);
+   return ret;
+}
+
 template<class T>
 bool CollectionManagerInterface<T>::deleteItem(T* item)
 {
@@ -223,6 +236,17 @@ template<class T>
 bool CollectionManagerInterface<T>::enableCollection( CollectionInterface*  collection, bool enabled)
 {
    Q_UNUSED(enabled) //TODO implement it
-   collection->load();
+
+   // It will be enabled once the CollectionLoader is done with it
+   switch (CollectionLoader::instance().state(collection)) {
+      case CollectionLoader::State::PENDING:
+      case CollectionLoader::State::RUNNING:
+         return true;
+      case CollectionLoader::State::LOADED:
+      case CollectionLoader::State::FAILED:
+         break;
+   }
+
+   loadCollection(collection);
    return true;
 }
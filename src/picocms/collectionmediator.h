@@ -41,6 +41,7 @@ public:
    CollectionMediator(CollectionManagerInterface<T>* parentManager, QAbstractItemModel* m);
    virtual ~CollectionMediator();
    bool addItem   (const T* item);
+   bool addItems  (const QList<T*>& items);
    bool removeItem(const T* item);
 
    QAbstractItemModel* model() const;
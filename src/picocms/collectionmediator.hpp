@@ -43,15 +43,32 @@ CollectionMediator<T>::~CollectionMediator()
 template<typename T>
 bool CollectionMediator<T>::addItem(const T* item)
 {
-   QMutexLocker l(&d_ptr->m_pParent->m_InsertionMutex);
-   return d_ptr->m_pParent->addItemCallback(item);
+   // The models are only modified from the main thread
+   return CollectionLoader::runInMainThread([this, item]() {
+      QMutexLocker l(&d_ptr->m_pParent->m_InsertionMutex);
+      return d_ptr->m_pParent->addItemCallback(item);
+   });
+}
+
+template<typename T>
+bool CollectionMediator<T>::addItems(const QList<T*>& items)
+{
+   if (items.isEmpty())
+      return true;
+
+   return CollectionLoader::runInMainThread([this, items]() {
+      QMutexLocker l(&d_ptr->m_pParent->m_InsertionMutex);
+      return d_ptr->m_pParent->addItemsCallback(items);
+   });
 }
 
 template<typename T>
 bool CollectionMediator<T>::removeItem(const T* item)
 {
-   QMutexLocker l(&d_ptr->m_pParent->m_InsertionMutex);
-   return d_ptr->m_pParent->removeItemCallback(item);
+   return CollectionLoader::runInMainThread([this, item]() {
+      QMutexLocker l(&d_ptr->m_pParent->m_InsertionMutex);
+      return d_ptr->m_pParent->removeItemCallback(item);
+   });
 }
 
 template<typename T>
@@ -24,6 +24,7 @@
 //Ring
 #include <account.h>
 #include <libcard/matrixutils.h>
+#include "private/accountproperties_p.h"
 
 class AccountPrivate;
 class ContactMethod;
@@ -60,6 +61,8 @@ public:
     //Attributes
     QByteArray                 m_AccountId                ;
     QHash<QString,QString>     m_hAccountDetails          ;
+    MapStringString            m_hVolatileDetails         ;
+    AccountProperties          m_Properties               ;
     QString                    m_LastTransportMessage     ;
     QString                    m_LastSipRegistrationStatus;
     ContactMethod*             m_pAccountNumber           {nullptr};
@@ -92,6 +95,8 @@ public:
 
     //Getters
     QString accountDetail(const QString& param) const;
+    const MapStringString& volatileDetails();
+    inline const AccountProperties& properties() const { return m_Properties; }
 
     //Mutator
     bool merge(Account* account);
@@ -99,7 +104,8 @@ public:
     //Helpers
     inline void changeState(Account::EditState state);
     void regenSecurityValidation();
-    bool updateState();
+    void updateState();
+    bool updateState(const MapStringString& volatileDetails);
     QString buildUri();
 
     //State actions
@@ -27,6 +27,7 @@
 #include <mime.h>
 #include <accountmodel.h>
 #include "libcard/matrixutils.h"
+#include "private/daemonsignalbridge_p.h"
 class AccountModel;
 class ProtocolModel;
 class PendingContactRequestModel;
@@ -48,6 +49,7 @@ public:
     void insertAccount(Account* a, int idx);
     void removeAccount(Account* account);
     void connectAccount(Account* a);
+    bool applyVolatileDetails(const QString& accountId, const MapStringString& details);
 
     //Attributes
     QItemSelectionModel*              m_pSelectionModel          {nullptr};
@@ -83,6 +85,8 @@ public Q_SLOTS:
     void slotVoiceMailNotify( const QString& accountID , int count );
     void slotAccountPresenceEnabledChanged(bool state);
     void slotVolatileAccountDetailsChange(const QString& accountId, const MapStringString& details);
+    void slotRegistrationStatesChanged(const QVector<DaemonSignalBridge::RegistrationEvent>& events);
+    void slotVolatileDetailsChanged(const QVector<DaemonSignalBridge::VolatileDetailsEvent>& events);
     void slotMediaParametersChanged(const QString& accountId);
     void slotDeviceRevocationEnded(const QString& accountId, const QString& deviceId, int status);
     void slotKownDevicesChanged(const QString& accountId, const MapStringString& devices);
@@ -0,0 +1,226 @@
+/************************************************************************************
+ *   Copyright (C) 2018 by BlueSystems GmbH                                         *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                            *
+ *                                                                                  *
+ *   This library is free software; you can redistribute it and/or                  *
+ *   modify it under the terms of the GNU Lesser General Public                     *
+ *   License as published by the Free Software Foundation; either                   *
+ *   version 2.1 of the License, or (at your option) any later version.             *
+ *                                                                                  *
+ *   This library is distributed in the hope that it will be useful,                *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of                 *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU              *
+ *   Lesser General Public License for more details.                                *
+ *                                                                                  *
+ *   You should have received a copy of the GNU Lesser General Public               *
+ *   License along with this library; if not, write to the Free Software            *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA *
+ ***********************************************************************************/
+#include "accountproperties_p.h"
+
+//Ring daemon
+#include <account_const.h>
+
+const Matrix1D<AccountProperties::Key, const char*> AccountProperties::names = {{
+   /* ALIAS                          = */ DRing::Account::ConfProperties::ALIAS,
+   /* ENABLED                        = */ DRing::Account::ConfProperties::ENABLED,
+   /* TYPE                           = */ DRing::Account::ConfProperties::TYPE,
+   /* HOSTNAME                       = */ DRing::Account::ConfProperties::HOSTNAME,
+   /* USERNAME                       = */ DRing::Account::ConfProperties::USERNAME,
+   /* DISPLAYNAME                    = */ DRing::Account::ConfProperties::DISPLAYNAME,
+   /* MAILBOX                        = */ DRing::Account::ConfProperties::MAILBOX,
+   /* ROUTE                          = */ DRing::Account::ConfProperties::ROUTE,
+   /* USER_AGENT                     = */ DRing::Account::ConfProperties::USER_AGENT,
+   /* HAS_CUSTOM_USER_AGENT          = */ DRing::Account::ConfProperties::HAS_CUSTOM_USER_AGENT,
+   /* UPNP_ENABLED                   = */ DRing::Account::ConfProperties::UPNP_ENABLED,
+   /* DTMF_TYPE                      = */ DRing::Account::ConfProperties::DTMF_TYPE,
+   /* LOCAL_INTERFACE                = */ DRing::Account::ConfProperties::LOCAL_INTERFACE,
+   /* LOCAL_PORT                     = */ DRing::Account::ConfProperties::LOCAL_PORT,
+   /* PUBLISHED_SAMEAS_LOCAL         = */ DRing::Account::ConfProperties::PUBLISHED_SAMEAS_LOCAL,
+   /* PUBLISHED_ADDRESS              = */ DRing::Account::ConfProperties::PUBLISHED_ADDRESS,
+   /* PUBLISHED_PORT                 = */ DRing::Account::ConfProperties::PUBLISHED_PORT,
+   /* ACTIVE_CALL_LIMIT              = */ DRing::Account::ConfProperties::ACTIVE_CALL_LIMIT,
+   /* ARCHIVE_PASSWORD               = */ DRing::Account::ConfProperties::ARCHIVE_PASSWORD,
+   /* ARCHIVE_PIN                    = */ DRing::Account::ConfProperties::ARCHIVE_PIN,
+   /* RING_DEVICE_ID                 = */ DRing::Account::ConfProperties::RING_DEVICE_ID,
+   /* RING_DEVICE_NAME               = */ DRing::Account::ConfProperties::RING_DEVICE_NAME,
+   /* ALLOW_CERT_FROM_HISTORY        = */ DRing::Account::ConfProperties::ALLOW_CERT_FROM_HISTORY,
+   /* ALLOW_CERT_FROM_CONTACT        = */ DRing::Account::ConfProperties::ALLOW_CERT_FROM_CONTACT,
+   /* REGISTRATION_EXPIRE            = */ DRing::Account::ConfProperties::Registration::EXPIRE,
+   /* REGISTRATION_STATUS            = */ DRing::Account::ConfProperties::Registration::STATUS,
+   /* RINGNS_URI                     = */ DRing::Account::ConfProperties::RingNS::URI,
+   /* DHT_PORT                       = */ DRing::Account::ConfProperties::DHT::PORT,
+   /* DHT_PUBLIC_IN_CALLS            = */ DRing::Account::ConfProperties::DHT::PUBLIC_IN_CALLS,
+   /* SRTP_ENABLED                   = */ DRing::Account::ConfProperties::SRTP::ENABLED,
+   /* SRTP_KEY_EXCHANGE              = */ DRing::Account::ConfProperties::SRTP::KEY_EXCHANGE,
+   /* SRTP_RTP_FALLBACK              = */ DRing::Account::ConfProperties::SRTP::RTP_FALLBACK,
+   /* STUN_ENABLED                   = */ DRing::Account::ConfProperties::STUN::ENABLED,
+   /* STUN_SERVER                    = */ DRing::Account::ConfProperties::STUN::SERVER,
+   /* TURN_ENABLED                   = */ DRing::Account::ConfProperties::TURN::ENABLED,
+   /* TURN_SERVER                    = */ DRing::Account::ConfProperties::TURN::SERVER,
+   /* TURN_SERVER_UNAME              = */ DRing::Account::ConfProperties::TURN::SERVER_UNAME,
+   /* TURN_SERVER_PWD                = */ DRing::Account::ConfProperties::TURN::SERVER_PWD,
+   /* TURN_SERVER_REALM              = */ DRing::Account::ConfProperties::TURN::SERVER_REALM,
+   /* TLS_ENABLED                    = */ DRing::Account::ConfProperties::TLS::ENABLED,
+   /* TLS_LISTENER_PORT              = */ DRing::Account::ConfProperties::TLS::LISTENER_PORT,
+   /* TLS_CA_LIST_FILE               = */ DRing::Account::ConfProperties::TLS::CA_LIST_FILE,
+   /* TLS_CERTIFICATE_FILE           = */ DRing::Account::ConfProperties::TLS::CERTIFICATE_FILE,
+   /* TLS_PRIVATE_KEY_FILE           = */ DRing::Account::ConfProperties::TLS::PRIVATE_KEY_FILE,
+   /* TLS_PASSWORD                   = */ DRing::Account::ConfProperties::TLS::PASSWORD,
+   /* TLS_METHOD                     = */ DRing::Account::ConfProperties::TLS::METHOD,
+   /* TLS_CIPHERS                    = */ DRing::Account::ConfProperties::TLS::CIPHERS,
+   /* TLS_SERVER_NAME                = */ DRing::Account::ConfProperties::TLS::SERVER_NAME,
+   /* TLS_VERIFY_SERVER              = */ DRing::Account::ConfProperties::TLS::VERIFY_SERVER,
+   /* TLS_VERIFY_CLIENT              = */ DRing::Account::ConfProperties::TLS::VERIFY_CLIENT,
+   /* TLS_REQUIRE_CLIENT_CERTIFICATE = */ DRing::Account::ConfProperties::TLS::REQUIRE_CLIENT_CERTIFICATE,
+   /* TLS_NEGOTIATION_TIMEOUT_SEC    = */ DRing::Account::ConfProperties::TLS::NEGOTIATION_TIMEOUT_SEC,
+   /* PRESENCE_ENABLED               = */ DRing::Account::ConfProperties::Presence::ENABLED,
+   /* PRESENCE_SUPPORT_PUBLISH       = */ DRing::Account::ConfProperties::Presence::SUPPORT_PUBLISH,
+   /* PRESENCE_SUPPORT_SUBSCRIBE     = */ DRing::Account::ConfProperties::Presence::SUPPORT_SUBSCRIBE,
+   /* RINGTONE_ENABLED               = */ DRing::Account::ConfProperties::Ringtone::ENABLED,
+   /* RINGTONE_PATH                  = */ DRing::Account::ConfProperties::Ringtone::PATH,
+   /* VIDEO_ENABLED                  = */ DRing::Account::ConfProperties::Video::ENABLED,
+   /* VIDEO_PORT_MIN                 = */ DRing::Account::ConfProperties::Video::PORT_MIN,
+   /* VIDEO_PORT_MAX                 = */ DRing::Account::ConfProperties::Video::PORT_MAX,
+   /* AUDIO_PORT_MIN                 = */ DRing::Account::ConfProperties::Audio::PORT_MIN,
+   /* AUDIO_PORT_MAX                 = */ DRing::Account::ConfProperties::Audio::PORT_MAX,
+}};
+
+AccountProperties::Key AccountProperties::fromName(const QString& name)
+{
+   static const QHash<QString, Key> index = []() {
+      QHash<QString, Key> ret;
+
+      for (const Key k : EnumIterator<Key>())
+         ret[QString::fromLatin1(names[k])] = k;
+
+      return ret;
+   }();
+
+   return index.value(name, Key::COUNT__);
+}
+
+void AccountProperties::parse(Value& v, const QString& value)
+{
+   bool ok = false;
+
+   v.m_String = value;
+   v.m_Bool   = value == QLatin1String("true");
+   v.m_Int    = value.toInt(&ok);
+   v.m_IsSet  = true;
+
+   if (!ok)
+      v.m_Int = 0;
+}
+
+///Replace all values, this doesn't mark them as dirty
+void AccountProperties::load(const QHash<QString,QString>& details)
+{
+   clear();
+
+   for (auto i = details.constBegin(); i != details.constEnd(); ++i) {
+      const Key k = fromName(i.key());
+
+      if (k != Key::COUNT__)
+         parse(m_lValues[k], i.value());
+   }
+}
+
+///Return true if `name` is part of the table
+bool AccountProperties::set(const QString& name, const QString& value)
+{
+   const Key k = fromName(name);
+
+   // The value is only in the hash, but save() still has to send it
+   if (k == Key::COUNT__) {
+      m_HasUntypedChanges = true;
+      return false;
+   }
+
+   set(k, value);
+
+   return true;
+}
+
+void AccountProperties::set(Key key, const QString& value, bool markDirty)
+{
+   Value& v = m_lValues[key];
+
+   if (v.m_IsSet && v.m_String == value)
+      return;
+
+   parse(v, value);
+
+   if (markDirty && !v.m_Dirty) {
+      v.m_Dirty = true;
+      m_DirtyCount++;
+   }
+}
+
+void AccountProperties::clear()
+{
+   for (Value& v : m_lValues)
+      v = {};
+
+   m_DirtyCount        = 0;
+   m_HasUntypedChanges = false;
+}
+
+const QString& AccountProperties::toString(Key key) const
+{
+   return m_lValues[key].m_String;
+}
+
+bool AccountProperties::toBool(Key key) const
+{
+   return m_lValues[key].m_Bool;
+}
+
+int AccountProperties::toInt(Key key) const
+{
+   return m_lValues[key].m_Int;
+}
+
+uint AccountProperties::toUInt(Key key) const
+{
+   return static_cast<uint>(m_lValues[key].m_Int);
+}
+
+bool AccountProperties::isSet(Key key) const
+{
+   return m_lValues[key].m_IsSet;
+}
+
+bool AccountProperties::isDirty() const
+{
+   return m_DirtyCount || m_HasUntypedChanges;
+}
+
+bool AccountProperties::isDirty(Key key) const
+{
+   return m_lValues[key].m_Dirty;
+}
+
+QVector<AccountProperties::Key> AccountProperties::dirtyKeys() const
+{
+   QVector<Key> ret;
+
+   if (!m_DirtyCount)
+      return ret;
+
+   for (const Key k : EnumIterator<Key>()) {
+      if (m_lValues[k].m_Dirty)
+         ret << k;
+   }
+
+   return ret;
+}
+
+void AccountProperties::clearDirty()
+{
+   for (Value& v : m_lValues)
+      v.m_Dirty = false;
+
+   m_DirtyCount        = 0;
+   m_HasUntypedChanges = false;
+}
@@ -0,0 +1,148 @@
+/************************************************************************************
+ *   Copyright (C) 2018 by BlueSystems GmbH                                         *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                            *
+ *                                                                                  *
+ *   This library is free software; you can redistribute it and/or                  *
+ *   modify it under the terms of the GNU Lesser General Public                     *
+ *   License as published by the Free Software Foundation; either                   *
+ *   version 2.1 of the License, or (at your option) any later version.             *
+ *                                                                                  *
+ *   This library is distributed in the hope that it will be useful,                *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of                 *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU              *
+ *   Lesser General Public License for more details.                                *
+ *                                                                                  *
+ *   You should have received a copy of the GNU Lesser General Public               *
+ *   License along with this library; if not, write to the Free Software            *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA *
+ ***********************************************************************************/
+#pragma once
+
+//Qt
+#include <QtCore/QString>
+#include <QtCore/QHash>
+#include <QtCore/QVector>
+
+//Ring
+#include <libcard/matrixutils.h>
+
+/**
+ * Typed copy of the account details.
+ *
+ * The daemon sends the account configuration as a map of strings. Most
+ * Account getters used to look them up in that hash and parse the booleans
+ * and integers every time. This table is filled once when the details are
+ * loaded or changed and can then be accessed by index.
+ *
+ * Only the keys with a getter are part of the table, the others are only
+ * available from AccountPrivate::m_hAccountDetails.
+ */
+class AccountProperties final
+{
+public:
+   enum class Key {
+      ALIAS,
+      ENABLED,
+      TYPE,
+      HOSTNAME,
+      USERNAME,
+      DISPLAYNAME,
+      MAILBOX,
+      ROUTE,
+      USER_AGENT,
+      HAS_CUSTOM_USER_AGENT,
+      UPNP_ENABLED,
+      DTMF_TYPE,
+      LOCAL_INTERFACE,
+      LOCAL_PORT,
+      PUBLISHED_SAMEAS_LOCAL,
+      PUBLISHED_ADDRESS,
+      PUBLISHED_PORT,
+      ACTIVE_CALL_LIMIT,
+      ARCHIVE_PASSWORD,
+      ARCHIVE_PIN,
+      RING_DEVICE_ID,
+      RING_DEVICE_NAME,
+      ALLOW_CERT_FROM_HISTORY,
+      ALLOW_CERT_FROM_CONTACT,
+      REGISTRATION_EXPIRE,
+      REGISTRATION_STATUS,
+      RINGNS_URI,
+      DHT_PORT,
+      DHT_PUBLIC_IN_CALLS,
+      SRTP_ENABLED,
+      SRTP_KEY_EXCHANGE,
+      SRTP_RTP_FALLBACK,
+      STUN_ENABLED,
+      STUN_SERVER,
+      TURN_ENABLED,
+      TURN_SERVER,
+      TURN_SERVER_UNAME,
+      TURN_SERVER_PWD,
+      TURN_SERVER_REALM,
+      TLS_ENABLED,
+      TLS_LISTENER_PORT,
+      TLS_CA_LIST_FILE,
+      TLS_CERTIFICATE_FILE,
+      TLS_PRIVATE_KEY_FILE,
+      TLS_PASSWORD,
+      TLS_METHOD,
+      TLS_CIPHERS,
+      TLS_SERVER_NAME,
+      TLS_VERIFY_SERVER,
+      TLS_VERIFY_CLIENT,
+      TLS_REQUIRE_CLIENT_CERTIFICATE,
+      TLS_NEGOTIATION_TIMEOUT_SEC,
+      PRESENCE_ENABLED,
+      PRESENCE_SUPPORT_PUBLISH,
+      PRESENCE_SUPPORT_SUBSCRIBE,
+      RINGTONE_ENABLED,
+      RINGTONE_PATH,
+      VIDEO_ENABLED,
+      VIDEO_PORT_MIN,
+      VIDEO_PORT_MAX,
+      AUDIO_PORT_MIN,
+      AUDIO_PORT_MAX,
+      COUNT__
+   };
+
+   /// The DRing::Account::ConfProperties name of each key
+   static const Matrix1D<Key, const char*> names;
+
+   /// Return COUNT__ for the keys not in the table
+   static Key fromName(const QString& name);
+
+   // Mutators
+   void load(const QHash<QString,QString>& details);
+   bool set(const QString& name, const QString& value);
+   void set(Key key, const QString& value, bool markDirty = true);
+   void clear();
+
+   // Getters
+   const QString& toString(Key key) const;
+   bool           toBool  (Key key) const;
+   int            toInt   (Key key) const;
+   uint           toUInt  (Key key) const;
+   bool           isSet   (Key key) const;
+
+   // Dirty tracking
+   bool isDirty() const;
+   bool isDirty(Key key) const;
+   QVector<Key> dirtyKeys() const;
+   void clearDirty();
+
+private:
+   struct Value {
+      QString m_String {       };
+      int     m_Int    {   0   };
+      bool    m_Bool   { false };
+      bool    m_IsSet  { false };
+      bool    m_Dirty  { false };
+   };
+
+   TypedStateMachine<Value, Key> m_lValues {};
+   int  m_DirtyCount        {  0  };
+   bool m_HasUntypedChanges { false };
+
+   static void parse(Value& v, const QString& value);
+};
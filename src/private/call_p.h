@@ -23,7 +23,6 @@
 
 //Qt
 #include <QtCore/QObject>
-class QTimer;
 
 // Ring
 #include "call.h"
@@ -31,6 +30,7 @@ class QTimer;
 class Account;
 class ContactMethod;
 class UserActionModel;
+class CallQualityModel;
 class InstantMessagingModel;
 class Certificate;
 
@@ -99,8 +99,8 @@ public:
     Call::State               m_CurrentState       {Call::State::ERROR       };
     Call::Type                m_Type               {Call::Type::CALL         };
     bool                      m_History            {           false         };
-    QTimer*                   m_pTimer             {          nullptr        };
     UserActionModel*          m_pUserActionModel   {          nullptr        };
+    CallQualityModel*         m_pQualityModel      {          nullptr        };
     Certificate*              m_pCertificate       {          nullptr        };
     Call*                     m_pParentCall        {          nullptr        };
     QDateTime*                m_pDateTime          {          nullptr        };
@@ -252,14 +252,17 @@ public:
     void setStartTimeStamp(time_t stamp);
     void setStartTimeStamp(); // this version set stamp to current time
     void initTimer();
+    void tick();
     void registerRenderer(Video::Renderer* renderer);
     void removeRenderer(Video::Renderer* renderer);
     void setRecordingPath(const QString& path);
     static MapStringString getCallDetailsCommon(const QString& callId);
+    static void formatCallDetails(MapStringString& details);
     void peerHoldChanged(bool onPeerHold);
     template<typename T>
     T* mediaFactory(Media::Media::Direction dir);
     void updateOutgoingMedia(const MapStringString& details);
+    void updateCallDetails(const MapStringString& details);
 
     //Static getters
     static Call::State        startStateFromDaemonCallState ( const QString& daemonCallState, const QString& daemonCallType );
@@ -268,12 +271,14 @@ public:
     static Call* buildDialingCall  (const QString & peerName, Account* account = nullptr, Call* parent = nullptr );
     static Call* buildIncomingCall (const QString& callId                                );
     static Call* buildExistingCall (const QString& callId                                );
+    static Call* buildExistingCall (const QString& callId, const MapStringString& details, bool isRecording);
 
 private:
     Call* q_ptr;
 
     //Constructor helper
     static Call* buildCall(const QString& callId, Call::Direction callDirection, Call::State startState);
+    static Call* buildCall(const QString& callId, Call::Direction callDirection, Call::State startState, const MapStringString& details, bool isRecording);
 
     //Destructor helper (~Call is private, CallPrivate is a friend class)
     static void deleteCall(Call* call);
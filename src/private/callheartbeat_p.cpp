@@ -0,0 +1,104 @@
+/************************************************************************************
+ *   Copyright (C) 2018 by BlueSystems GmbH                                         *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                            *
+ *                                                                                  *
+ *   This library is free software; you can redistribute it and/or                  *
+ *   modify it under the terms of the GNU Lesser General Public                     *
+ *   License as published by the Free Software Foundation; either                   *
+ *   version 2.1 of the License, or (at your option) any later version.             *
+ *                                                                                  *
+ *   This library is distributed in the hope that it will be useful,                *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of                 *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU              *
+ *   Lesser General Public License for more details.                                *
+ *                                                                                  *
+ *   You should have received a copy of the GNU Lesser General Public               *
+ *   License along with this library; if not, write to the Free Software            *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA *
+ ***********************************************************************************/
+#include "callheartbeat_p.h"
+
+// Qt
+#include <QtCore/QTimer>
+#include <QtCore/QDateTime>
+
+// Ring
+#include "call.h"
+#include "private/call_p.h"
+
+class CallHeartbeatPrivate
+{
+public:
+   QTimer         m_Timer;
+   QVector<Call*> m_lCalls;
+
+   void schedule();
+};
+
+CallHeartbeat::CallHeartbeat() : QObject(nullptr), d_ptr(new CallHeartbeatPrivate)
+{
+   // Ticks are single shot, each of them is realigned on the next second
+   d_ptr->m_Timer.setSingleShot(true);
+   d_ptr->m_Timer.setTimerType(Qt::PreciseTimer);
+
+   connect(&d_ptr->m_Timer, &QTimer::timeout, this, [this]() {
+      // The calls can be removed while they are updated
+      const QVector<Call*> calls = d_ptr->m_lCalls;
+
+      for (Call* c : calls)
+         c->d_ptr->tick();
+
+      if (!d_ptr->m_lCalls.isEmpty())
+         d_ptr->schedule();
+
+      emit ticked(calls);
+   });
+}
+
+CallHeartbeat::~CallHeartbeat()
+{
+   delete d_ptr;
+}
+
+CallHeartbeat& CallHeartbeat::instance()
+{
+   static auto instance = new CallHeartbeat();
+   return *instance;
+}
+
+void CallHeartbeatPrivate::schedule()
+{
+   const qint64 now = QDateTime::currentMSecsSinceEpoch();
+
+   // A few ms after the boundary so the lengths already display the new value
+   m_Timer.start(1000 - static_cast<int>(now % 1000) + 5);
+}
+
+void CallHeartbeat::add(Call* call)
+{
+   if (d_ptr->m_lCalls.contains(call))
+      return;
+
+   d_ptr->m_lCalls << call;
+
+   if (!d_ptr->m_Timer.isActive())
+      d_ptr->schedule();
+}
+
+void CallHeartbeat::remove(Call* call)
+{
+   d_ptr->m_lCalls.removeOne(call);
+
+   if (d_ptr->m_lCalls.isEmpty())
+      d_ptr->m_Timer.stop();
+}
+
+bool CallHeartbeat::contains(Call* call) const
+{
+   return d_ptr->m_lCalls.contains(call);
+}
+
+const QVector<Call*>& CallHeartbeat::calls() const
+{
+   return d_ptr->m_lCalls;
+}
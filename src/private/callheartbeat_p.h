@@ -0,0 +1,61 @@
+/************************************************************************************
+ *   Copyright (C) 2018 by BlueSystems GmbH                                         *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                            *
+ *                                                                                  *
+ *   This library is free software; you can redistribute it and/or                  *
+ *   modify it under the terms of the GNU Lesser General Public                     *
+ *   License as published by the Free Software Foundation; either                   *
+ *   version 2.1 of the License, or (at your option) any later version.             *
+ *                                                                                  *
+ *   This library is distributed in the hope that it will be useful,                *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of                 *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU              *
+ *   Lesser General Public License for more details.                                *
+ *                                                                                  *
+ *   You should have received a copy of the GNU Lesser General Public               *
+ *   License along with this library; if not, write to the Free Software            *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA *
+ ***********************************************************************************/
+#pragma once
+
+#include <QtCore/QObject>
+#include <QtCore/QVector>
+
+class Call;
+class CallHeartbeatPrivate;
+
+/**
+ * A single process-wide 1Hz clock for the calls in progress.
+ *
+ * Each call used to own its own timer, so many parallel calls meant many
+ * independent wakeups and a dataChanged per call per second. The heartbeat
+ * ticks once per second for all of them, aligned on the wall clock seconds,
+ * so all the durations change at the same time.
+ *
+ * The timer only runs while at least one call is registered.
+ */
+class CallHeartbeat final : public QObject
+{
+   Q_OBJECT
+public:
+   static CallHeartbeat& instance();
+
+   void add   (Call* call);
+   void remove(Call* call);
+
+   bool contains(Call* call) const;
+
+   /// The calls which will be updated by the next tick
+   const QVector<Call*>& calls() const;
+
+Q_SIGNALS:
+   /// Emitted once per tick after all the calls have been updated
+   void ticked(const QVector<Call*>& calls);
+
+private:
+   explicit CallHeartbeat();
+   virtual ~CallHeartbeat();
+
+   CallHeartbeatPrivate* d_ptr;
+   Q_DECLARE_PRIVATE(CallHeartbeat)
+};
@@ -0,0 +1,106 @@
+/************************************************************************************
+ *   Copyright (C) 2018 by BlueSystems GmbH                                         *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                            *
+ *                                                                                  *
+ *   This library is free software; you can redistribute it and/or                  *
+ *   modify it under the terms of the GNU Lesser General Public                     *
+ *   License as published by the Free Software Foundation; either                   *
+ *   version 2.1 of the License, or (at your option) any later version.             *
+ *                                                                                  *
+ *   This library is distributed in the hope that it will be useful,                *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of                 *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU              *
+ *   Lesser General Public License for more details.                                *
+ *                                                                                  *
+ *   You should have received a copy of the GNU Lesser General Public               *
+ *   License along with this library; if not, write to the Free Software            *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA *
+ ***********************************************************************************/
+#pragma once
+
+// Qt
+#include <QtCore/QVector>
+
+// Ring
+#include <callqualitymodel.h>
+#include <typedefs.h>
+
+class Call;
+
+/**
+ * A multi resolution ring buffer of samples for a single metric.
+ *
+ * Each level holds CAPACITY buckets. Every FACTOR buckets pushed into a
+ * level are merged into a single bucket of the next (coarser) level. With the
+ * default 2 reports per second, the finest level holds ~1 minute of raw
+ * samples, the second ~17 minutes and the last ~4.5 hours.
+ */
+class QualitySeries final
+{
+public:
+    static constexpr const int CAPACITY = 128;
+    static constexpr const int FACTOR   = 16 ;
+    static constexpr const int LEVELS   = 3  ;
+
+    struct Bucket {
+        qint64  m_Time     {0}; /*!< The first sample, in msecs since epoch */
+        quint32 m_Duration {0}; /*!< The msecs between the first and last   */
+        quint32 m_Count    {0};
+        float   m_Min      {0};
+        float   m_Max      {0};
+        double  m_Sum      {0};
+
+        void   merge(const Bucket& other);
+        qint64 end    () const { return m_Time + m_Duration;          }
+        float  average() const { return m_Count ? m_Sum/m_Count : 0; }
+    };
+
+    void add(float value, qint64 time);
+
+    /**
+     * The non overlapping buckets ending after `since`, oldest first. The
+     * oldest ones come from the coarser levels.
+     */
+    QVector<Bucket> buckets(qint64 since) const;
+
+    float last() const { return m_Last; }
+
+private:
+    struct Level {
+        Bucket  m_lBuckets[CAPACITY];
+        int     m_Head        {0}; /*!< The next slot to be written         */
+        int     m_Size        {0};
+        Bucket  m_Pending     { }; /*!< The bucket built for the next level */
+        int     m_PendingSize {0};
+
+        void          push(const Bucket& b);
+        const Bucket& at  (int i) const; /*!< 0 is the oldest */
+    };
+
+    void push(int level, const Bucket& b);
+
+    Level m_lLevels[LEVELS];
+    float m_Last {0};
+};
+
+class CallQualityModelPrivate final
+{
+public:
+    explicit CallQualityModelPrivate(CallQualityModel* q) : q_ptr(q) {}
+    ~CallQualityModelPrivate();
+
+    QualitySeries* m_lSeries[static_cast<int>(CallQualityModel::Metric::COUNT__)] {};
+    int            m_Window { 30      };
+    Call*          m_pCall  { nullptr };
+
+    void add(CallQualityModel::Metric m, float value, qint64 time);
+    void commit();
+
+    /// Add the samples of a daemon RTCP report to the call series
+    static void addRtcpReport(Call* c, const MapStringInt& report);
+
+    /// Add the samples of a SmartInfo update to the series of its call
+    static void addSmartInfo(const MapStringString& info);
+
+    CallQualityModel* q_ptr;
+};
@@ -127,6 +127,9 @@ public:
    //Helpers
    void loadDetails(bool reload = false);
    void loadChecks (bool loadChecks = false);
+   void requestDetails();
+   void requestChecks ();
+   bool isCacheable   () const;
 
    static Matrix1D<Certificate::Checks ,QString> m_slChecksName;
    static Matrix1D<Certificate::Checks ,QString> m_slChecksDescription;
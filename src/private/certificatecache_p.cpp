@@ -0,0 +1,465 @@
+/************************************************************************************
+ *   Copyright (C) 2018 by BlueSystems GmbH                                         *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                            *
+ *                                                                                  *
+ *   This library is free software; you can redistribute it and/or                  *
+ *   modify it under the terms of the GNU Lesser General Public                     *
+ *   License as published by the Free Software Foundation; either                   *
+ *   version 2.1 of the License, or (at your option) any later version.             *
+ *                                                                                  *
+ *   This library is distributed in the hope that it will be useful,                *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of                 *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU              *
+ *   Lesser General Public License for more details.                                *
+ *                                                                                  *
+ *   You should have received a copy of the GNU Lesser General Public               *
+ *   License along with this library; if not, write to the Free Software            *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA *
+ ***********************************************************************************/
+#include "certificatecache_p.h"
+
+// Qt
+#include <QtCore/QCoreApplication>
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDateTime>
+#include <QtCore/QDir>
+#include <QtCore/QDirIterator>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QHash>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QMutex>
+#include <QtCore/QStandardPaths>
+#include <QtCore/QDebug>
+
+// Std
+#include <atomic>
+
+// Ring
+#include <security_const.h>
+#include "dbus/configurationmanager.h"
+
+struct CertificateCacheEntry final
+{
+   MapStringString m_Details   ;
+   MapStringString m_Checks    ;
+   QDateTime       m_ValidUntil;
+};
+
+/// The content hash of a file and the state of the file it was computed from
+struct CertificateCacheKey final
+{
+   qint64     m_Modified;
+   qint64     m_Size    ;
+   QByteArray m_Hash    ;
+};
+
+class CertificateCachePrivate final
+{
+public:
+   static const QLatin1String FILENAME;
+   static constexpr int VERSION  = 1;
+   static constexpr int MAX_DAYS = 7;
+
+   /// Held when accessing the attributes, never during a daemon call
+   QMutex m_Mutex;
+
+   QHash<QByteArray, CertificateCacheEntry> m_hEntries;
+
+   /// The content hash of each file, computed again when the file changes
+   QHash<QString, CertificateCacheKey> m_hKeys;
+
+   QByteArray m_Fingerprint;
+   bool       m_Loaded {false};
+   bool       m_Dirty  {false};
+
+   std::atomic<bool> m_SaveQueued {false};
+
+   CertificateCache* q_ptr;
+
+   // Helpers
+   void ensureLoaded();
+   QByteArray key(const QString& path, const QString& privateKey);
+   const CertificateCacheEntry* entry(const QByteArray& key) const;
+   void scheduleSave();
+
+   static QByteArray trustFingerprint();
+   static QDateTime validUntil(const MapStringString& details);
+   static QString filePath();
+};
+
+const QLatin1String CertificateCachePrivate::FILENAME("certificatecache.json");
+
+CertificateCache::CertificateCache() : QObject(nullptr), d_ptr(new CertificateCachePrivate)
+{
+   d_ptr->q_ptr = this;
+
+   // The first user can be a background loader thread, the queued saves
+   // need an event loop which stays around.
+   moveToThread(QCoreApplication::instance()->thread());
+
+   ConfigurationManagerInterface& configurationManager = ConfigurationManager::instance();
+
+   // Pinning a path isn't tracked, the folder collections pin theirs at
+   // every startup. It is covered by the fingerprint.
+   connect(&configurationManager, &ConfigurationManagerInterface::certificatePinned,
+      this, &CertificateCache::invalidate);
+   connect(&configurationManager, &ConfigurationManagerInterface::certificateExpired,
+      this, &CertificateCache::invalidate);
+}
+
+CertificateCache::~CertificateCache()
+{
+   delete d_ptr;
+}
+
+CertificateCache& CertificateCache::instance()
+{
+   static auto instance = new CertificateCache();
+   return *instance;
+}
+
+QString CertificateCachePrivate::filePath()
+{
+   return QStandardPaths::writableLocation(QStandardPaths::DataLocation)
+      + QLatin1Char('/')
+      + FILENAME;
+}
+
+/**
+ * A hash of everything outside of the certificate itself which can change
+ * the validation result.
+ */
+QByteArray CertificateCachePrivate::trustFingerprint()
+{
+   // The daemon keeps the pinned certificates and the revocation lists
+   // there. The path pins are not included, they are redone at every start.
+   static const QString base = QStandardPaths::writableLocation(
+      QStandardPaths::GenericDataLocation
+   ) + QStringLiteral("/ring/");
+
+   QStringList files;
+
+   for (const QString& dir : {QStringLiteral("certificates"), QStringLiteral("crls")}) {
+      QDirIterator it(base + dir, QDir::Files, QDirIterator::Subdirectories);
+
+      while (it.hasNext()) {
+         it.next();
+         files << QStringLiteral("%1 %2 %3")
+            .arg(it.filePath())
+            .arg(it.fileInfo().size())
+            .arg(it.fileInfo().lastModified().toMSecsSinceEpoch());
+      }
+   }
+
+   files.sort();
+
+   QCryptographicHash hash(QCryptographicHash::Sha256);
+
+   for (const QString& f : qAsConst(files)) {
+      hash.addData(f.toUtf8());
+      hash.addData("\n", 1);
+   }
+
+   return hash.result().toHex();
+}
+
+QDateTime CertificateCachePrivate::validUntil(const MapStringString& details)
+{
+   QDateTime ret = QDateTime::currentDateTime().addDays(MAX_DAYS);
+
+   static const QString keys[] = {
+      DRing::Certificate::DetailsNames::EXPIRATION_DATE,
+      DRing::Certificate::DetailsNames::NEXT_EXPECTED_UPDATE_DATE,
+   };
+
+   for (const QString& k : keys) {
+      const QString value = details[k];
+
+      QDateTime d = QDateTime::fromString(value, Qt::ISODate);
+
+      if (!d.isValid())
+         d = QDateTime::fromString(value, QStringLiteral("yyyy-MM-dd"));
+
+      if (d.isValid() && d < ret)
+         ret = d;
+   }
+
+   return ret;
+}
+
+/// Must be called with the mutex held
+void CertificateCachePrivate::ensureLoaded()
+{
+   if (m_Loaded)
+      return;
+
+   m_Loaded      = true;
+   m_Fingerprint = trustFingerprint();
+
+   QFile file(filePath());
+
+   if (!file.open(QIODevice::ReadOnly))
+      return;
+
+   const QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+
+   // Drop everything, it will be rewritten with the current fingerprint
+   if (root[QStringLiteral("version")].toInt() != VERSION
+     || root[QStringLiteral("fingerprint")].toString().toLatin1() != m_Fingerprint) {
+      m_Dirty = true;
+      return;
+   }
+
+   static const auto toMap = [](const QJsonObject& o) {
+      MapStringString ret;
+
+      for (auto i = o.constBegin(); i != o.constEnd(); ++i)
+         ret[i.key()] = i.value().toString();
+
+      return ret;
+   };
+
+   const QJsonArray entries = root[QStringLiteral("entries")].toArray();
+
+   for (const auto& v : entries) {
+      const QJsonObject o = v.toObject();
+
+      CertificateCacheEntry e;
+      e.m_Details    = toMap(o[QStringLiteral("details")].toObject());
+      e.m_Checks     = toMap(o[QStringLiteral("checks" )].toObject());
+      e.m_ValidUntil = QDateTime::fromMSecsSinceEpoch(o[QStringLiteral("validUntil")].toVariant().toLongLong());
+
+      m_hEntries[o[QStringLiteral("key")].toString().toLatin1()] = e;
+   }
+}
+
+/// Must be called without holding the mutex, it reads the file
+QByteArray CertificateCachePrivate::key(const QString& path, const QString& privateKey)
+{
+   const QString id = path + QLatin1Char('\n') + privateKey;
+
+   // Hashing is much more expensive than a stat()
+   const QFileInfo fi(path);
+   const qint64 modified = fi.lastModified().toMSecsSinceEpoch();
+   const qint64 size     = fi.size();
+
+   {
+      QMutexLocker l(&m_Mutex);
+      const auto it = m_hKeys.constFind(id);
+
+      if (it != m_hKeys.constEnd() && it->m_Modified == modified && it->m_Size == size)
+         return it->m_Hash;
+   }
+
+   QFile file(path);
+
+   if (!file.open(QIODevice::ReadOnly))
+      return {};
+
+   QCryptographicHash hash(QCryptographicHash::Sha256);
+   hash.addData(&file);
+   hash.addData(privateKey.toUtf8());
+
+   const QByteArray ret = hash.result().toHex();
+
+   QMutexLocker l(&m_Mutex);
+   m_hKeys[id] = {modified, size, ret};
+
+   return ret;
+}
+
+/// Must be called with the mutex held
+const CertificateCacheEntry* CertificateCachePrivate::entry(const QByteArray& key) const
+{
+   const auto it = m_hEntries.constFind(key);
+
+   if (it == m_hEntries.constEnd() || it->m_ValidUntil <= QDateTime::currentDateTime())
+      return nullptr;
+
+   return &(*it);
+}
+
+void CertificateCachePrivate::scheduleSave()
+{
+   if (!m_SaveQueued.exchange(true))
+      QMetaObject::invokeMethod(q_ptr, "save", Qt::QueuedConnection);
+}
+
+bool CertificateCache::details(const QString& path, const QString& privateKey, MapStringString& out)
+{
+   const QByteArray k = d_ptr->key(path, privateKey);
+
+   if (k.isEmpty())
+      return false;
+
+   QMutexLocker l(&d_ptr->m_Mutex);
+   d_ptr->ensureLoaded();
+
+   const auto e = d_ptr->entry(k);
+
+   if ((!e) || e->m_Details.isEmpty())
+      return false;
+
+   out = e->m_Details;
+
+   return true;
+}
+
+bool CertificateCache::checks(const QString& path, const QString& privateKey, MapStringString& out)
+{
+   const QByteArray k = d_ptr->key(path, privateKey);
+
+   if (k.isEmpty())
+      return false;
+
+   QMutexLocker l(&d_ptr->m_Mutex);
+   d_ptr->ensureLoaded();
+
+   const auto e = d_ptr->entry(k);
+
+   if ((!e) || e->m_Checks.isEmpty())
+      return false;
+
+   out = e->m_Checks;
+
+   return true;
+}
+
+void CertificateCache::insertDetails(const QString& path, const QString& privateKey, const MapStringString& details)
+{
+   const QByteArray k = d_ptr->key(path, privateKey);
+
+   if (k.isEmpty() || details.isEmpty())
+      return;
+
+   {
+      QMutexLocker l(&d_ptr->m_Mutex);
+      d_ptr->ensureLoaded();
+
+      auto& e = d_ptr->m_hEntries[k];
+      e.m_Details    = details;
+      e.m_ValidUntil = CertificateCachePrivate::validUntil(details);
+      d_ptr->m_Dirty = true;
+   }
+
+   d_ptr->scheduleSave();
+}
+
+void CertificateCache::insertChecks(const QString& path, const QString& privateKey, const MapStringString& checks)
+{
+   const QByteArray k = d_ptr->key(path, privateKey);
+
+   if (k.isEmpty() || checks.isEmpty())
+      return;
+
+   {
+      QMutexLocker l(&d_ptr->m_Mutex);
+      d_ptr->ensureLoaded();
+
+      auto& e = d_ptr->m_hEntries[k];
+      e.m_Checks = checks;
+
+      if (!e.m_ValidUntil.isValid())
+         e.m_ValidUntil = CertificateCachePrivate::validUntil(e.m_Details);
+
+      d_ptr->m_Dirty = true;
+   }
+
+   d_ptr->scheduleSave();
+}
+
+void CertificateCache::prefetch(const QList<QByteArray>& paths)
+{
+   ConfigurationManagerInterface& configurationManager = ConfigurationManager::instance();
+
+   for (const QByteArray& p : paths) {
+      const QString path = p;
+      const QByteArray k = d_ptr->key(path, {});
+
+      if (k.isEmpty())
+         continue;
+
+      {
+         QMutexLocker l(&d_ptr->m_Mutex);
+         d_ptr->ensureLoaded();
+
+         const auto e = d_ptr->entry(k);
+
+         if (e && !(e->m_Details.isEmpty() || e->m_Checks.isEmpty()))
+            continue;
+      }
+
+      const MapStringString details = configurationManager.getCertificateDetailsPath(path, {}, {});
+      const MapStringString checks  = configurationManager.validateCertificatePath({}, path, {}, {}, {});
+
+      insertDetails(path, {}, details);
+      insertChecks (path, {}, checks );
+   }
+}
+
+void CertificateCache::invalidate()
+{
+   // Outside of the lock, it walks the trust store
+   const QByteArray fingerprint = CertificateCachePrivate::trustFingerprint();
+
+   {
+      QMutexLocker l(&d_ptr->m_Mutex);
+      d_ptr->m_hEntries.clear();
+      d_ptr->m_Fingerprint = fingerprint;
+      d_ptr->m_Loaded      = true;
+      d_ptr->m_Dirty       = true;
+   }
+
+   d_ptr->scheduleSave();
+}
+
+void CertificateCache::save()
+{
+   d_ptr->m_SaveQueued = false;
+
+   QMutexLocker l(&d_ptr->m_Mutex);
+
+   if (!d_ptr->m_Dirty)
+      return;
+
+   static const auto toObject = [](const MapStringString& m) {
+      QJsonObject ret;
+
+      for (auto i = m.constBegin(); i != m.constEnd(); ++i)
+         ret[i.key()] = i.value();
+
+      return ret;
+   };
+
+   QJsonArray entries;
+
+   for (auto i = d_ptr->m_hEntries.constBegin(); i != d_ptr->m_hEntries.constEnd(); ++i) {
+      QJsonObject o;
+      o[QStringLiteral("key"       )] = QString::fromLatin1(i.key());
+      o[QStringLiteral("details"   )] = toObject(i->m_Details);
+      o[QStringLiteral("checks"    )] = toObject(i->m_Checks );
+      o[QStringLiteral("validUntil")] = QString::number(i->m_ValidUntil.toMSecsSinceEpoch());
+      entries.append(o);
+   }
+
+   QJsonObject root;
+   root[QStringLiteral("version"    )] = CertificateCachePrivate::VERSION;
+   root[QStringLiteral("fingerprint")] = QString::fromLatin1(d_ptr->m_Fingerprint);
+   root[QStringLiteral("entries"    )] = entries;
+
+   QDir().mkpath(QStandardPaths::writableLocation(QStandardPaths::DataLocation));
+
+   QFile file(CertificateCachePrivate::filePath());
+
+   if (!file.open(QIODevice::WriteOnly)) {
+      qWarning() << "Unable to save the certificate cache" << file.fileName();
+      return;
+   }
+
+   file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+
+   d_ptr->m_Dirty = false;
+}
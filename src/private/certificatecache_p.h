@@ -0,0 +1,75 @@
+/************************************************************************************
+ *   Copyright (C) 2018 by BlueSystems GmbH                                         *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                            *
+ *                                                                                  *
+ *   This library is free software; you can redistribute it and/or                  *
+ *   modify it under the terms of the GNU Lesser General Public                     *
+ *   License as published by the Free Software Foundation; either                   *
+ *   version 2.1 of the License, or (at your option) any later version.             *
+ *                                                                                  *
+ *   This library is distributed in the hope that it will be useful,                *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of                 *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU              *
+ *   Lesser General Public License for more details.                                *
+ *                                                                                  *
+ *   You should have received a copy of the GNU Lesser General Public               *
+ *   License along with this library; if not, write to the Free Software            *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA *
+ ***********************************************************************************/
+#pragma once
+
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QList>
+
+#include "typedefs.h"
+
+class CertificateCachePrivate;
+
+/**
+ * Persist the certificate file details and validation results across runs.
+ *
+ * The entries are keyed on the SHA-256 of the file content (and the private
+ * key path, if any), so a modified file is always validated again. They are
+ * also dropped when:
+ *
+ *  * The certificate expires or reaches its next expected update date
+ *  * They are older than a week (the daemon doesn't tell when its CRLs
+ *    are updated)
+ *  * The trust store fingerprint changes (pinned certificates and CRL files)
+ *  * A certificate is pinned or expires while running
+ *
+ * Certificates with a private key password are never cached.
+ *
+ * All methods are thread safe. Only prefetch() talks to the daemon, it is
+ * meant to be called from the background loaders.
+ */
+class CertificateCache final : public QObject
+{
+   Q_OBJECT
+public:
+   static CertificateCache& instance();
+
+   bool details(const QString& path, const QString& privateKey, MapStringString& out);
+   bool checks (const QString& path, const QString& privateKey, MapStringString& out);
+
+   void insertDetails(const QString& path, const QString& privateKey, const MapStringString& details);
+   void insertChecks (const QString& path, const QString& privateKey, const MapStringString& checks );
+
+   /// Validate all the files not already in the cache (blocking)
+   void prefetch(const QList<QByteArray>& paths);
+
+   /// Drop all entries, for example when the trust store changed
+   void invalidate();
+
+public Q_SLOTS:
+   /// Write the cache to disk if it changed
+   void save();
+
+private:
+   explicit CertificateCache();
+   virtual ~CertificateCache();
+
+   CertificateCachePrivate* d_ptr;
+   Q_DECLARE_PRIVATE(CertificateCache)
+};
@@ -19,6 +19,7 @@
 
 #include "libcard/matrixutils.h"
 #include "certificate.h"
+#include "private/daemonsignalbridge_p.h"
 
 #include <QtCore/QMutex>
 #include <QtCore/QObject>
@@ -80,4 +81,5 @@ private:
 
 private Q_SLOTS:
    void slotCertificateStateChanged(const QString& accountId, const QString& certId, const QString& state);
+   void slotCertificateStatesChanged(const QVector<DaemonSignalBridge::CertificateStateEvent>& events);
 };
@@ -0,0 +1,281 @@
+/************************************************************************************
+ *   Copyright (C) 2018 by BlueSystems GmbH                                         *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                            *
+ *                                                                                  *
+ *   This library is free software; you can redistribute it and/or                  *
+ *   modify it under the terms of the GNU Lesser General Public                     *
+ *   License as published by the Free Software Foundation; either                   *
+ *   version 2.1 of the License, or (at your option) any later version.             *
+ *                                                                                  *
+ *   This library is distributed in the hope that it will be useful,                *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of                 *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU              *
+ *   Lesser General Public License for more details.                                *
+ *                                                                                  *
+ *   You should have received a copy of the GNU Lesser General Public               *
+ *   License along with this library; if not, write to the Free Software            *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA *
+ ***********************************************************************************/
+#include "daemonhydrator_p.h"
+
+// Qt
+#include <QtCore/QThread>
+#include <QtCore/QCoreApplication>
+#ifdef ENABLE_LIBWRAP
+ #include <QtCore/QThreadPool>
+ #include <QtCore/QRunnable>
+#endif
+
+// Std
+#include <functional>
+
+// Ring
+#include "dbus/callmanager.h"
+#include "dbus/configurationmanager.h"
+#include "dbus/presencemanager.h"
+#include "tracer_p.h"
+
+#ifdef ENABLE_LIBWRAP
+/**
+ * The minimal QRunnable wrapper, Qt 5.9 has no QRunnable::create()
+ */
+class DaemonHydratorTask final : public QRunnable
+{
+public:
+   explicit DaemonHydratorTask(const std::function<void()>& f) : m_fTask(f) {}
+
+   virtual void run() override {
+      m_fTask();
+   }
+
+private:
+   std::function<void()> m_fTask;
+};
+
+/// Call f(0) to f(count-1) on a thread pool and wait for all of them
+static void parallelFor(int count, const std::function<void(int)>& f)
+{
+   QThreadPool pool;
+   pool.setMaxThreadCount(qBound(1, count, QThread::idealThreadCount()));
+
+   for (int i = 0; i < count; i++)
+      pool.start(new DaemonHydratorTask([&f, i]() { f(i); }));
+
+   pool.waitForDone();
+}
+#endif
+
+DaemonHydrator& DaemonHydrator::instance()
+{
+   static auto instance = new DaemonHydrator();
+   return *instance;
+}
+
+void DaemonHydrator::fetchAccounts()
+{
+   Q_ASSERT(QThread::currentThread() == QCoreApplication::instance()->thread());
+   RING_TRACE_SPAN("ipc", "DaemonHydrator::fetchAccounts");
+
+   ConfigurationManagerInterface& configurationManager = ConfigurationManager::instance();
+   PresenceManagerInterface&      presenceManager      = PresenceManager::instance();
+
+   const QStringList ids = configurationManager.getAccountList();
+
+   m_lAccounts.clear();
+   m_hAccounts.clear();
+   m_hTaken   .clear();
+   m_lAccounts.resize(ids.size());
+
+   for (int i = 0; i < ids.size(); i++) {
+      m_lAccounts[i].m_Id = ids[i];
+      m_hAccounts[ids[i]] = i;
+   }
+
+   // The trust requests and contacts only exist for Ring accounts, but the
+   // protocol isn't known until the details arrive. The daemon returns
+   // empty lists for the others.
+
+#ifdef ENABLE_LIBWRAP
+   parallelFor(ids.size(), [this, &configurationManager, &presenceManager](int i) {
+      AccountData& a = m_lAccounts[i];
+      a.m_Details         = configurationManager.getAccountDetails        (a.m_Id);
+      a.m_VolatileDetails = configurationManager.getVolatileAccountDetails(a.m_Id);
+      a.m_TrustRequests   = configurationManager.getTrustRequests         (a.m_Id);
+      a.m_Contacts        = configurationManager.getContacts              (a.m_Id);
+      a.m_Subscriptions   = presenceManager     .getSubscriptions         (a.m_Id);
+   });
+#else
+   QVector< QDBusPendingReply<MapStringString>       > details, volatileDetails;
+   QVector< QDBusPendingReply<VectorMapStringString> > trustRequests, contacts, subscriptions;
+
+   // Send everything first, then wait for the replies
+   for (const QString& id : ids) {
+      details         << configurationManager.getAccountDetails        (id);
+      volatileDetails << configurationManager.getVolatileAccountDetails(id);
+      trustRequests   << configurationManager.getTrustRequests         (id);
+      contacts        << configurationManager.getContacts              (id);
+      subscriptions   << presenceManager     .getSubscriptions         (id);
+   }
+
+   for (int i = 0; i < ids.size(); i++) {
+      AccountData& a = m_lAccounts[i];
+      a.m_Details         = details        [i];
+      a.m_VolatileDetails = volatileDetails[i];
+      a.m_TrustRequests   = trustRequests  [i];
+      a.m_Contacts        = contacts       [i];
+      a.m_Subscriptions   = subscriptions  [i];
+   }
+#endif
+}
+
+void DaemonHydrator::fetchCalls()
+{
+   Q_ASSERT(QThread::currentThread() == QCoreApplication::instance()->thread());
+   RING_TRACE_SPAN("ipc", "DaemonHydrator::fetchCalls");
+
+   CallManagerInterface& callManager = CallManager::instance();
+
+   m_lCalls.clear();
+
+#ifdef ENABLE_LIBWRAP
+   const QStringList ids = callManager.getCallList();
+   m_lConferences        = callManager.getConferenceList();
+
+   m_lCalls.resize(ids.size());
+
+   parallelFor(ids.size(), [this, &callManager, &ids](int i) {
+      CallData& c = m_lCalls[i];
+      c.m_Id          = ids[i];
+      c.m_Details     = callManager.getCallDetails(c.m_Id);
+      c.m_IsRecording = callManager.getIsRecording(c.m_Id);
+   });
+#else
+   QDBusPendingReply<QStringList> callList = callManager.getCallList      ();
+   QDBusPendingReply<QStringList> confList = callManager.getConferenceList();
+
+   const QStringList ids = callList;
+   m_lConferences        = confList;
+
+   m_lCalls.resize(ids.size());
+
+   QVector< QDBusPendingReply<MapStringString> > details;
+   QVector< QDBusPendingReply<bool>            > isRecording;
+
+   for (const QString& id : ids) {
+      details     << callManager.getCallDetails(id);
+      isRecording << callManager.getIsRecording(id);
+   }
+
+   for (int i = 0; i < ids.size(); i++) {
+      CallData& c = m_lCalls[i];
+      c.m_Id          = ids[i];
+      c.m_Details     = details    [i];
+      c.m_IsRecording = isRecording[i];
+   }
+#endif
+
+   m_HasCalls = true;
+}
+
+QStringList DaemonHydrator::accountIds() const
+{
+   QStringList ret;
+   ret.reserve(m_lAccounts.size());
+
+   for (const auto& a : qAsConst(m_lAccounts))
+      ret << a.m_Id;
+
+   return ret;
+}
+
+DaemonHydrator::AccountData* DaemonHydrator::account(const QString& id, Field f)
+{
+   const auto it = m_hAccounts.constFind(id);
+
+   if (it == m_hAccounts.constEnd())
+      return nullptr;
+
+   int& taken = m_hTaken[id];
+
+   if (taken & static_cast<int>(f))
+      return nullptr;
+
+   taken |= static_cast<int>(f);
+
+   return &m_lAccounts[*it];
+}
+
+bool DaemonHydrator::takeAccountDetails(const QString& id, MapStringString& out)
+{
+   if (auto a = account(id, Field::DETAILS)) {
+      out.swap(a->m_Details);
+      return true;
+   }
+
+   return false;
+}
+
+bool DaemonHydrator::takeVolatileAccountDetails(const QString& id, MapStringString& out)
+{
+   if (auto a = account(id, Field::VOLATILE_DETAILS)) {
+      out.swap(a->m_VolatileDetails);
+      return true;
+   }
+
+   return false;
+}
+
+bool DaemonHydrator::takeTrustRequests(const QString& id, VectorMapStringString& out)
+{
+   if (auto a = account(id, Field::TRUST_REQUESTS)) {
+      out.swap(a->m_TrustRequests);
+      return true;
+   }
+
+   return false;
+}
+
+bool DaemonHydrator::takeContacts(const QString& id, VectorMapStringString& out)
+{
+   if (auto a = account(id, Field::CONTACTS)) {
+      out.swap(a->m_Contacts);
+      return true;
+   }
+
+   return false;
+}
+
+bool DaemonHydrator::takeSubscriptions(const QString& id, VectorMapStringString& out)
+{
+   if (auto a = account(id, Field::SUBSCRIPTIONS)) {
+      out.swap(a->m_Subscriptions);
+      return true;
+   }
+
+   return false;
+}
+
+bool DaemonHydrator::takeCalls(QVector<CallData>& calls, QStringList& conferences)
+{
+   if (!m_HasCalls)
+      return false;
+
+   calls.swap(m_lCalls);
+   conferences.swap(m_lConferences);
+
+   m_lCalls      .clear();
+   m_lConferences.clear();
+   m_HasCalls = false;
+
+   return true;
+}
+
+void DaemonHydrator::clear()
+{
+   m_lAccounts   .clear();
+   m_hAccounts   .clear();
+   m_hTaken      .clear();
+   m_lCalls      .clear();
+   m_lConferences.clear();
+   m_HasCalls = false;
+}
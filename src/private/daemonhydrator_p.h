@@ -0,0 +1,102 @@
+/************************************************************************************
+ *   Copyright (C) 2018 by BlueSystems GmbH                                         *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                            *
+ *                                                                                  *
+ *   This library is free software; you can redistribute it and/or                  *
+ *   modify it under the terms of the GNU Lesser General Public                     *
+ *   License as published by the Free Software Foundation; either                   *
+ *   version 2.1 of the License, or (at your option) any later version.             *
+ *                                                                                  *
+ *   This library is distributed in the hope that it will be useful,                *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of                 *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU              *
+ *   Lesser General Public License for more details.                                *
+ *                                                                                  *
+ *   You should have received a copy of the GNU Lesser General Public               *
+ *   License along with this library; if not, write to the Free Software            *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA *
+ ***********************************************************************************/
+#pragma once
+
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QVector>
+#include <QtCore/QHash>
+
+#include "typedefs.h"
+
+/**
+ * Fetch the initial state of the daemon in one pass.
+ *
+ * Building the accounts and calls one by one costs a round-trip per getter
+ * and per item, all of them serialized. With 10+ accounts, this is most of
+ * the startup time. The hydrator sends all of them at once (pending replies
+ * with DBus, a thread pool with the library wrapper) and waits for the whole
+ * batch.
+ *
+ * The builders then take the data from here and fall back to the daemon
+ * when it isn't available. Each entry can be taken only once, so later
+ * reloads always get fresh values.
+ *
+ * This class must only be used from the main thread.
+ */
+class DaemonHydrator final
+{
+public:
+   struct AccountData {
+      QString               m_Id             ;
+      MapStringString       m_Details        ;
+      MapStringString       m_VolatileDetails;
+      VectorMapStringString m_TrustRequests  ;
+      VectorMapStringString m_Contacts       ;
+      VectorMapStringString m_Subscriptions  ;
+   };
+
+   struct CallData {
+      QString         m_Id         ;
+      MapStringString m_Details    ;
+      bool            m_IsRecording;
+   };
+
+   static DaemonHydrator& instance();
+
+   /// Fetch everything needed to build the accounts
+   void fetchAccounts();
+
+   /// Fetch the calls and conferences, the call details are not formatted
+   void fetchCalls();
+
+   // Accounts
+   QStringList accountIds() const;
+   bool takeAccountDetails        (const QString& id, MapStringString& out);
+   bool takeVolatileAccountDetails(const QString& id, MapStringString& out);
+   bool takeTrustRequests         (const QString& id, VectorMapStringString& out);
+   bool takeContacts              (const QString& id, VectorMapStringString& out);
+   bool takeSubscriptions         (const QString& id, VectorMapStringString& out);
+
+   // Calls
+   bool takeCalls(QVector<CallData>& calls, QStringList& conferences);
+
+   /// Drop whatever was not taken
+   void clear();
+
+private:
+   explicit DaemonHydrator() {}
+
+   enum class Field {
+      DETAILS          = 0x1 << 0,
+      VOLATILE_DETAILS = 0x1 << 1,
+      TRUST_REQUESTS   = 0x1 << 2,
+      CONTACTS         = 0x1 << 3,
+      SUBSCRIPTIONS    = 0x1 << 4,
+   };
+
+   AccountData* account(const QString& id, Field f);
+
+   QVector<AccountData> m_lAccounts     ;
+   QHash<QString, int>  m_hAccounts     ;
+   QHash<QString, int>  m_hTaken        ;
+   QVector<CallData>    m_lCalls        ;
+   QStringList          m_lConferences  ;
+   bool                 m_HasCalls {false};
+};
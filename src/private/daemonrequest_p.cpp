@@ -0,0 +1,293 @@
+/************************************************************************************
+ *   Copyright (C) 2018 by BlueSystems GmbH                                         *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                            *
+ *                                                                                  *
+ *   This library is free software; you can redistribute it and/or                  *
+ *   modify it under the terms of the GNU Lesser General Public                     *
+ *   License as published by the Free Software Foundation; either                   *
+ *   version 2.1 of the License, or (at your option) any later version.             *
+ *                                                                                  *
+ *   This library is distributed in the hope that it will be useful,                *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of                 *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU              *
+ *   Lesser General Public License for more details.                                *
+ *                                                                                  *
+ *   You should have received a copy of the GNU Lesser General Public               *
+ *   License along with this library; if not, write to the Free Software            *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA *
+ ***********************************************************************************/
+#include "daemonrequest_p.h"
+
+// Qt
+#include <QtCore/QHash>
+#include <QtCore/QPointer>
+#include <QtCore/QStringList>
+#include <QtCore/QDebug>
+#ifdef ENABLE_LIBWRAP
+ #include <QtCore/QThreadPool>
+ #include <QtCore/QRunnable>
+#else
+ #include <QtDBus/QDBusPendingCallWatcher>
+#endif
+
+// Std
+#include <atomic>
+
+// Ring
+#include "dbus/callmanager.h"
+#include "dbus/configurationmanager.h"
+#include "tracer_p.h"
+
+#ifdef ENABLE_LIBWRAP
+ typedef MapStringString DaemonReply;
+#else
+ typedef QDBusPendingReply<MapStringString> DaemonReply;
+#endif
+
+struct PendingContinuation final
+{
+   QPointer<QObject>           m_pContext  ;
+   bool                        m_HasContext;
+   DaemonRequest::Continuation m_fCallback ;
+};
+
+struct PendingRequest final
+{
+   int                          m_Id            {   0   };
+   const char*                  m_pMethod       {nullptr};
+   QString                      m_Key           {       };
+   QVector<PendingContinuation> m_lContinuations{       };
+   MapStringString              m_Result        {       };
+   qint64                       m_Sent          {   0   };
+
+   /// Set once m_Result is written (by the worker thread with libwrap)
+   std::atomic<bool>            m_Done          { false };
+};
+
+class DaemonRequestPrivate final : public QObject
+{
+   Q_OBJECT
+public:
+   /// The requests which can still be joined
+   QHash<QString, PendingRequest*> m_hInFlight;
+
+   /// All requests waiting to be delivered
+   QHash<int, PendingRequest*> m_hById;
+
+   int m_NextId  {0};
+   int m_Deduped {0};
+
+#ifdef ENABLE_LIBWRAP
+   QThreadPool m_Pool;
+#endif
+
+   // Helpers
+   void request(const char* method, const QStringList& args, QObject* context, const DaemonRequest::Continuation& f, const std::function<DaemonReply()>& issue);
+   void deliver(PendingRequest* r);
+
+   static QString makeKey(const char* method, const QStringList& args);
+
+Q_SIGNALS:
+   /// Emitted from the worker threads, always used with a queued connection
+   void requestFinished(int id);
+
+public Q_SLOTS:
+   void slotRequestFinished(int id);
+};
+
+#ifdef ENABLE_LIBWRAP
+/**
+ * The minimal QRunnable wrapper, Qt 5.9 has no QRunnable::create()
+ */
+class DaemonRequestTask final : public QRunnable
+{
+public:
+   DaemonRequestTask(DaemonRequestPrivate* d, PendingRequest* r, const std::function<DaemonReply()>& issue) :
+      m_pRequests(d), m_pRequest(r), m_fIssue(issue) {}
+
+   virtual void run() override {
+      // The result is not touched by the main thread until m_Done is set
+      m_pRequest->m_Result = m_fIssue();
+      m_pRequest->m_Done   = true;
+
+      emit m_pRequests->requestFinished(m_pRequest->m_Id);
+   }
+
+private:
+   DaemonRequestPrivate*        m_pRequests;
+   PendingRequest*              m_pRequest;
+   std::function<DaemonReply()> m_fIssue;
+};
+#endif
+
+DaemonRequest::DaemonRequest() : QObject(nullptr), d_ptr(new DaemonRequestPrivate)
+{
+#ifdef ENABLE_LIBWRAP
+   // The daemon serializes most of those calls internally, more threads
+   // wouldn't help.
+   d_ptr->m_Pool.setMaxThreadCount(2);
+#endif
+
+   connect(d_ptr, &DaemonRequestPrivate::requestFinished,
+      d_ptr, &DaemonRequestPrivate::slotRequestFinished, Qt::QueuedConnection);
+}
+
+DaemonRequest::~DaemonRequest()
+{
+#ifdef ENABLE_LIBWRAP
+   d_ptr->m_Pool.waitForDone();
+#endif
+
+   qDeleteAll(d_ptr->m_hById);
+
+   delete d_ptr;
+}
+
+DaemonRequest& DaemonRequest::instance()
+{
+   static auto instance = new DaemonRequest();
+   return *instance;
+}
+
+QString DaemonRequestPrivate::makeKey(const char* method, const QStringList& args)
+{
+   // The unit separator can't be part of an id or a path
+   return (QStringList {QString::fromLatin1(method)} + args).join(QChar(0x1F));
+}
+
+/// `method` must be a string literal, it is kept for the trace
+void DaemonRequestPrivate::request(const char* method, const QStringList& args, QObject* context, const DaemonRequest::Continuation& f, const std::function<DaemonReply()>& issue)
+{
+   const PendingContinuation c {context, context != nullptr, f};
+   const QString key = makeKey(method, args);
+
+   if (auto r = m_hInFlight.value(key)) {
+      // If the reply is already there, it may predate what the caller expects
+      if (!r->m_Done) {
+         r->m_lContinuations << c;
+         m_Deduped++;
+         return;
+      }
+   }
+
+   auto r = new PendingRequest;
+   r->m_Id      = ++m_NextId;
+   r->m_pMethod = method;
+   r->m_Key     = key;
+   r->m_Sent    = RING_TRACE_NOW();
+   r->m_lContinuations << c;
+
+   m_hInFlight[key] = r;
+   m_hById[r->m_Id] = r;
+
+#ifdef ENABLE_LIBWRAP
+   m_Pool.start(new DaemonRequestTask(this, r, issue));
+#else
+   auto watcher = new QDBusPendingCallWatcher(issue(), this);
+
+   connect(watcher, &QDBusPendingCallWatcher::finished, this, [this, r](QDBusPendingCallWatcher* w) {
+      const DaemonReply reply(*w);
+
+      if (reply.isError())
+         qWarning() << "Daemon request failed" << r->m_Key << reply.error().message();
+      else
+         r->m_Result = reply.value();
+
+      r->m_Done = true;
+
+      w->deleteLater();
+
+      deliver(r);
+   });
+#endif
+}
+
+void DaemonRequestPrivate::slotRequestFinished(int id)
+{
+   if (auto r = m_hById.value(id))
+      deliver(r);
+}
+
+void DaemonRequestPrivate::deliver(PendingRequest* r)
+{
+   // Remove it first, the continuations may issue the same request again
+   if (m_hInFlight.value(r->m_Key) == r)
+      m_hInFlight.remove(r->m_Key);
+
+   m_hById.remove(r->m_Id);
+
+   // From the request to the delivery, the queue time is part of the latency
+   RING_TRACE_COMPLETE("ipc", "DaemonRequest", r->m_pMethod, r->m_Sent);
+
+   for (const auto& c : qAsConst(r->m_lContinuations)) {
+      if ((!c.m_HasContext) || c.m_pContext)
+         c.m_fCallback(r->m_Result);
+   }
+
+   delete r;
+}
+
+void DaemonRequest::invalidate(const QString& id)
+{
+   for (auto i = d_ptr->m_hInFlight.begin(); i != d_ptr->m_hInFlight.end();) {
+      // They are still delivered to their own continuations
+      if (i.key().section(QChar(0x1F), 1, 1) == id)
+         i = d_ptr->m_hInFlight.erase(i);
+      else
+         ++i;
+   }
+}
+
+int DaemonRequest::pendingCount() const
+{
+   return d_ptr->m_hById.size();
+}
+
+int DaemonRequest::dedupedCount() const
+{
+   return d_ptr->m_Deduped;
+}
+
+void DaemonRequest::getCallDetails(const QString& callId, QObject* context, const Continuation& f)
+{
+   d_ptr->request("getCallDetails", {callId}, context, f, [callId]() -> DaemonReply {
+      return CallManager::instance().getCallDetails(callId);
+   });
+}
+
+void DaemonRequest::getVolatileAccountDetails(const QString& accountId, QObject* context, const Continuation& f)
+{
+   d_ptr->request("getVolatileAccountDetails", {accountId}, context, f, [accountId]() -> DaemonReply {
+      return ConfigurationManager::instance().getVolatileAccountDetails(accountId);
+   });
+}
+
+void DaemonRequest::getCertificateDetails(const QString& certId, QObject* context, const Continuation& f)
+{
+   d_ptr->request("getCertificateDetails", {certId}, context, f, [certId]() -> DaemonReply {
+      return ConfigurationManager::instance().getCertificateDetails(certId);
+   });
+}
+
+void DaemonRequest::getCertificateDetailsPath(const QString& path, const QString& privateKey, const QString& password, QObject* context, const Continuation& f)
+{
+   d_ptr->request("getCertificateDetailsPath", {path, privateKey, password}, context, f, [path, privateKey, password]() -> DaemonReply {
+      return ConfigurationManager::instance().getCertificateDetailsPath(path, privateKey, password);
+   });
+}
+
+void DaemonRequest::validateCertificate(const QString& accountId, const QString& certId, QObject* context, const Continuation& f)
+{
+   d_ptr->request("validateCertificate", {accountId, certId}, context, f, [accountId, certId]() -> DaemonReply {
+      return ConfigurationManager::instance().validateCertificate(accountId, certId);
+   });
+}
+
+void DaemonRequest::validateCertificatePath(const QString& accountId, const QString& path, const QString& privateKey, const QString& password, QObject* context, const Continuation& f)
+{
+   d_ptr->request("validateCertificatePath", {accountId, path, privateKey, password}, context, f, [accountId, path, privateKey, password]() -> DaemonReply {
+      return ConfigurationManager::instance().validateCertificatePath(accountId, path, privateKey, password, {});
+   });
+}
+
+#include <daemonrequest_p.moc>
@@ -0,0 +1,89 @@
+/************************************************************************************
+ *   Copyright (C) 2018 by BlueSystems GmbH                                         *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                            *
+ *                                                                                  *
+ *   This library is free software; you can redistribute it and/or                  *
+ *   modify it under the terms of the GNU Lesser General Public                     *
+ *   License as published by the Free Software Foundation; either                   *
+ *   version 2.1 of the License, or (at your option) any later version.             *
+ *                                                                                  *
+ *   This library is distributed in the hope that it will be useful,                *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of                 *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU              *
+ *   Lesser General Public License for more details.                                *
+ *                                                                                  *
+ *   You should have received a copy of the GNU Lesser General Public               *
+ *   License along with this library; if not, write to the Free Software            *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA *
+ ***********************************************************************************/
+#pragma once
+
+#include <QtCore/QObject>
+#include <QtCore/QString>
+
+// Std
+#include <functional>
+
+#include "typedefs.h"
+
+class DaemonRequestPrivate;
+
+/**
+ * Non blocking access to the daemon getters used in hot paths.
+ *
+ * Each of them used to be a synchronous round-trip blocking the main thread
+ * (every call state change, every registration change and every certificate
+ * lookup). Here, the requests are sent without waiting for the previous ones
+ * to return, so many of them can be in flight at once. When an identical
+ * request (same method and arguments) is already in flight, the new
+ * continuation is attached to it instead of issuing a second call.
+ *
+ * With DBus, this uses the pending replies. With the library wrapper
+ * (ENABLE_LIBWRAP), the calls are executed on a small thread pool.
+ *
+ * The continuations are always invoked in the main thread. They are dropped
+ * if their context object has been destroyed in the meantime. On error, they
+ * receive an empty map, like the synchronous getters would.
+ *
+ * This class must only be used from the main thread.
+ */
+class DaemonRequest final : public QObject
+{
+   Q_OBJECT
+public:
+   typedef std::function<void(const MapStringString&)> Continuation;
+
+   static DaemonRequest& instance();
+
+   // CallManager
+   void getCallDetails(const QString& callId, QObject* context, const Continuation& f);
+
+   // ConfigurationManager
+   void getVolatileAccountDetails(const QString& accountId, QObject* context, const Continuation& f);
+   void getCertificateDetails(const QString& certId, QObject* context, const Continuation& f);
+   void getCertificateDetailsPath(const QString& path, const QString& privateKey, const QString& password, QObject* context, const Continuation& f);
+   void validateCertificate(const QString& accountId, const QString& certId, QObject* context, const Continuation& f);
+   void validateCertificatePath(const QString& accountId, const QString& path, const QString& privateKey, const QString& password, QObject* context, const Continuation& f);
+
+   /**
+    * Stop merging the new requests about `id` (a call or an account) into
+    * those already in flight.
+    *
+    * Call it when the daemon reports a change, the replies on their way may
+    * predate it.
+    */
+   void invalidate(const QString& id);
+
+   /// The number of requests waiting for a reply
+   int pendingCount() const;
+
+   /// The number of requests merged into an identical in-flight one
+   int dedupedCount() const;
+
+private:
+   explicit DaemonRequest();
+   virtual ~DaemonRequest();
+
+   DaemonRequestPrivate* d_ptr;
+   Q_DECLARE_PRIVATE(DaemonRequest)
+};
@@ -0,0 +1,207 @@
+/************************************************************************************
+ *   Copyright (C) 2018 by BlueSystems GmbH                                         *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                            *
+ *                                                                                  *
+ *   This library is free software; you can redistribute it and/or                  *
+ *   modify it under the terms of the GNU Lesser General Public                     *
+ *   License as published by the Free Software Foundation; either                   *
+ *   version 2.1 of the License, or (at your option) any later version.             *
+ *                                                                                  *
+ *   This library is distributed in the hope that it will be useful,                *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of                 *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU              *
+ *   Lesser General Public License for more details.                                *
+ *                                                                                  *
+ *   You should have received a copy of the GNU Lesser General Public               *
+ *   License along with this library; if not, write to the Free Software            *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA *
+ ***********************************************************************************/
+#include "daemonsignalbridge_p.h"
+
+// Qt
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include <QtCore/QPair>
+
+// Std
+#include <atomic>
+
+// Ring
+#include "dbus/configurationmanager.h"
+#include "dbus/presencemanager.h"
+
+/**
+ * Keep the latest event for each key while preserving the order in which
+ * each key was first seen.
+ */
+template<typename K, typename E>
+struct CoalescedQueue
+{
+   QHash<K, int> m_hIndex;
+   QVector<E>    m_lEvents;
+
+   void push(const K& key, E&& e) {
+      const auto it = m_hIndex.constFind(key);
+
+      if (it != m_hIndex.constEnd()) {
+         m_lEvents[*it] = std::move(e);
+         return;
+      }
+
+      m_hIndex[key] = m_lEvents.size();
+      m_lEvents << std::move(e);
+   }
+
+   QVector<E> take() {
+      m_hIndex.clear();
+      QVector<E> ret;
+      ret.swap(m_lEvents);
+      return ret;
+   }
+};
+
+class DaemonSignalBridgePrivate
+{
+public:
+   CoalescedQueue<QString                 , DaemonSignalBridge::RegistrationEvent    > m_Registrations;
+   CoalescedQueue<QString                 , DaemonSignalBridge::VolatileDetailsEvent > m_VolatileDetails;
+   CoalescedQueue<QPair<QString, quint64> , DaemonSignalBridge::MessageStatusEvent   > m_MessageStatuses;
+   CoalescedQueue<QPair<QString, QString> , DaemonSignalBridge::PresenceEvent        > m_Presences;
+   CoalescedQueue<QPair<QString, QString> , DaemonSignalBridge::CertificateStateEvent> m_CertificateStates;
+
+   /// Held by the producers for the duration of a push and by flush() for a swap
+   mutable QMutex m_Mutex;
+
+   /// Set when a flush is already queued in the event loop
+   std::atomic<bool> m_FlushQueued {false};
+
+   DaemonSignalBridge* q_ptr;
+
+   void scheduleFlush();
+};
+
+DaemonSignalBridge::DaemonSignalBridge() : QObject(nullptr), d_ptr(new DaemonSignalBridgePrivate)
+{
+   d_ptr->q_ptr = this;
+
+   ConfigurationManagerInterface& configurationManager = ConfigurationManager::instance();
+   PresenceManagerInterface&      presenceManager      = PresenceManager::instance();
+
+   // Those are direct connections on purpose. With the library wrapper they
+   // are executed in the daemon threads and the only thing they do is to
+   // record the event. The thread hop happens once per batch in flush().
+
+   connect(&configurationManager, &ConfigurationManagerInterface::registrationStateChanged, this,
+      [this](const QString& accountId, const QString& state, unsigned code, const QString& detail) {
+         {
+            QMutexLocker l(&d_ptr->m_Mutex);
+            d_ptr->m_Registrations.push(accountId, {accountId, state, code, detail});
+         }
+         d_ptr->scheduleFlush();
+   }, Qt::DirectConnection);
+
+   connect(&configurationManager, &ConfigurationManagerInterface::volatileAccountDetailsChanged, this,
+      [this](const QString& accountId, const MapStringString& details) {
+         {
+            QMutexLocker l(&d_ptr->m_Mutex);
+            d_ptr->m_VolatileDetails.push(accountId, {accountId, details});
+         }
+         d_ptr->scheduleFlush();
+   }, Qt::DirectConnection);
+
+   connect(&configurationManager, &ConfigurationManagerInterface::accountMessageStatusChanged, this,
+      [this](const QString& accountId, uint64_t id, const QString& to, int status) {
+         {
+            QMutexLocker l(&d_ptr->m_Mutex);
+            d_ptr->m_MessageStatuses.push({accountId, id}, {accountId, id, to, status});
+         }
+         d_ptr->scheduleFlush();
+   }, Qt::DirectConnection);
+
+   connect(&configurationManager, &ConfigurationManagerInterface::certificateStateChanged, this,
+      [this](const QString& accountId, const QString& certId, const QString& state) {
+         {
+            QMutexLocker l(&d_ptr->m_Mutex);
+            d_ptr->m_CertificateStates.push({accountId, certId}, {accountId, certId, state});
+         }
+         d_ptr->scheduleFlush();
+   }, Qt::DirectConnection);
+
+   connect(&presenceManager, &PresenceManagerInterface::newBuddyNotification, this,
+      [this](const QString& accountId, const QString& uri, bool status, const QString& message) {
+         {
+            QMutexLocker l(&d_ptr->m_Mutex);
+            d_ptr->m_Presences.push({accountId, uri}, {accountId, uri, status, message});
+         }
+         d_ptr->scheduleFlush();
+   }, Qt::DirectConnection);
+}
+
+DaemonSignalBridge::~DaemonSignalBridge()
+{
+   delete d_ptr;
+}
+
+DaemonSignalBridge& DaemonSignalBridge::instance()
+{
+   static auto instance = new DaemonSignalBridge();
+   return *instance;
+}
+
+void DaemonSignalBridgePrivate::scheduleFlush()
+{
+   // Only the first event of a burst pays for the cross thread call
+   if (!m_FlushQueued.exchange(true))
+      QMetaObject::invokeMethod(q_ptr, "flush", Qt::QueuedConnection);
+}
+
+int DaemonSignalBridge::pendingCount() const
+{
+   QMutexLocker l(&d_ptr->m_Mutex);
+
+   return d_ptr->m_Registrations.m_lEvents.size()
+      + d_ptr->m_VolatileDetails.m_lEvents.size()
+      + d_ptr->m_MessageStatuses.m_lEvents.size()
+      + d_ptr->m_Presences.m_lEvents.size()
+      + d_ptr->m_CertificateStates.m_lEvents.size();
+}
+
+void DaemonSignalBridge::flush()
+{
+   QVector<RegistrationEvent    > registrations;
+   QVector<VolatileDetailsEvent > volatileDetails;
+   QVector<MessageStatusEvent   > messageStatuses;
+   QVector<PresenceEvent        > presences;
+   QVector<CertificateStateEvent> certificateStates;
+
+   {
+      QMutexLocker l(&d_ptr->m_Mutex);
+
+      // Reset before releasing the lock so events pushed while the batch is
+      // being delivered get their own flush.
+      d_ptr->m_FlushQueued = false;
+
+      registrations     = d_ptr->m_Registrations.take();
+      volatileDetails   = d_ptr->m_VolatileDetails.take();
+      messageStatuses   = d_ptr->m_MessageStatuses.take();
+      presences         = d_ptr->m_Presences.take();
+      certificateStates = d_ptr->m_CertificateStates.take();
+   }
+
+   // The registration state is delivered first as the volatile details
+   // handler uses it to compute the account state.
+   if (!registrations.isEmpty())
+      emit registrationStatesChanged(registrations);
+
+   if (!volatileDetails.isEmpty())
+      emit volatileDetailsChanged(volatileDetails);
+
+   if (!messageStatuses.isEmpty())
+      emit messageStatusesChanged(messageStatuses);
+
+   if (!presences.isEmpty())
+      emit presencesChanged(presences);
+
+   if (!certificateStates.isEmpty())
+      emit certificateStatesChanged(certificateStates);
+}
@@ -0,0 +1,108 @@
+/************************************************************************************
+ *   Copyright (C) 2018 by BlueSystems GmbH                                         *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                            *
+ *                                                                                  *
+ *   This library is free software; you can redistribute it and/or                  *
+ *   modify it under the terms of the GNU Lesser General Public                     *
+ *   License as published by the Free Software Foundation; either                   *
+ *   version 2.1 of the License, or (at your option) any later version.             *
+ *                                                                                  *
+ *   This library is distributed in the hope that it will be useful,                *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of                 *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU              *
+ *   Lesser General Public License for more details.                                *
+ *                                                                                  *
+ *   You should have received a copy of the GNU Lesser General Public               *
+ *   License along with this library; if not, write to the Free Software            *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA *
+ ***********************************************************************************/
+#pragma once
+
+#include <QtCore/QObject>
+#include <QtCore/QVector>
+#include <QtCore/QString>
+
+#include "typedefs.h"
+
+class DaemonSignalBridgePrivate;
+
+/**
+ * Sit between the daemon configuration and presence signals and the models.
+ *
+ * When the network comes back, the daemon emits a storm of registration,
+ * volatile details and presence updates for each account. Most of them are
+ * immediately superseded by the next one. Rather than having each of them
+ * become a queued call in the main event loop, they are accumulated here,
+ * only the latest value for each key is kept, and the result is delivered
+ * once per event loop iteration.
+ *
+ * The enqueue side is safe to call from the daemon threads when using the
+ * library wrapper (ENABLE_LIBWRAP). The batch signals are always emitted
+ * from the thread owning the bridge (the main thread).
+ *
+ * Events of a batch preserve the order in which their key was first seen.
+ */
+class DaemonSignalBridge final : public QObject
+{
+   Q_OBJECT
+public:
+   /// Coalesced per account
+   struct RegistrationEvent {
+      QString  accountId;
+      QString  state    ;
+      unsigned code     ;
+      QString  detail   ;
+   };
+
+   /// Coalesced per account
+   struct VolatileDetailsEvent {
+      QString         accountId;
+      MapStringString details  ;
+   };
+
+   /// Coalesced per account and message id
+   struct MessageStatusEvent {
+      QString  accountId;
+      uint64_t id       ;
+      QString  to       ;
+      int      status   ;
+   };
+
+   /// Coalesced per account and URI
+   struct PresenceEvent {
+      QString accountId;
+      QString uri      ;
+      bool    status   ;
+      QString message  ;
+   };
+
+   /// Coalesced per account and certificate
+   struct CertificateStateEvent {
+      QString accountId;
+      QString certId   ;
+      QString state    ;
+   };
+
+   static DaemonSignalBridge& instance();
+
+   /// The number of coalesced events waiting for the next flush
+   int pendingCount() const;
+
+public Q_SLOTS:
+   /// Deliver all pending events now (called automatically)
+   void flush();
+
+Q_SIGNALS:
+   void registrationStatesChanged(const QVector<DaemonSignalBridge::RegistrationEvent>& events);
+   void volatileDetailsChanged(const QVector<DaemonSignalBridge::VolatileDetailsEvent>& events);
+   void messageStatusesChanged(const QVector<DaemonSignalBridge::MessageStatusEvent>& events);
+   void presencesChanged(const QVector<DaemonSignalBridge::PresenceEvent>& events);
+   void certificateStatesChanged(const QVector<DaemonSignalBridge::CertificateStateEvent>& events);
+
+private:
+   explicit DaemonSignalBridge();
+   virtual ~DaemonSignalBridge();
+
+   DaemonSignalBridgePrivate* d_ptr;
+   Q_DECLARE_PRIVATE(DaemonSignalBridge)
+};
@@ -20,6 +20,8 @@
 #include <QtCore/QObject>
 #include <QtCore/QHash>
 
+#include "private/daemonsignalbridge_p.h"
+
 class Account;
 class Call;
 class ContactMethod;
@@ -42,4 +44,5 @@ private Q_SLOTS:
    void newMessage       (const QString& callId   , const QString& from, const QMap<QString,QString>& payloads);
    void newAccountMessage(const QString& accountId, const QString& from, const QMap<QString,QString>& payloads);
    void accountMessageStatusChanged(const QString& accountId, uint64_t id, const QString& to, int status);
+   void messageStatusesChanged(const QVector<DaemonSignalBridge::MessageStatusEvent>& events);
 };
@@ -25,6 +25,7 @@ class LocalNameServiceCache;
 #include "contactmethod.h"
 #include "account.h"
 #include "namedirectory.h"
+#include "private/daemonsignalbridge_p.h"
 
 //Internal data structures
 ///@struct NumberWrapper Wrap phone numbers to prevent collisions
@@ -118,5 +119,6 @@ private Q_SLOTS:
    void slotAccountStateChanged(Account* a, const Account::RegistrationState state);
 
    //From DBus
-   void slotNewBuddySubscription(const QString& uri, const QString& accountId, bool status, const QString& message);
+   void slotNewBuddySubscription(const QString& accountId, const QString& uri, bool status, const QString& message);
+   void slotPresencesChanged(const QVector<DaemonSignalBridge::PresenceEvent>& events);
 };
@@ -0,0 +1,297 @@
+/************************************************************************************
+ *   Copyright (C) 2018 by BlueSystems GmbH                                         *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                            *
+ *                                                                                  *
+ *   This library is free software; you can redistribute it and/or                  *
+ *   modify it under the terms of the GNU Lesser General Public                     *
+ *   License as published by the Free Software Foundation; either                   *
+ *   version 2.1 of the License, or (at your option) any later version.             *
+ *                                                                                  *
+ *   This library is distributed in the hope that it will be useful,                *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of                 *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU              *
+ *   Lesser General Public License for more details.                                *
+ *                                                                                  *
+ *   You should have received a copy of the GNU Lesser General Public               *
+ *   License along with this library; if not, write to the Free Software            *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA *
+ ***********************************************************************************/
+#include "messageformatter_p.h"
+
+// Qt
+#include <QtCore/QCache>
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include <QtCore/QPair>
+
+// Ring
+#include "media/mimemessage.h"
+#include "private/taskpool_p.h"
+
+class MessageFormatterPrivate final
+{
+public:
+    /// About 4MB of HTML
+    static constexpr int DEFAULT_CAPACITY = 2*1024*1024;
+
+    typedef QVector<QPair<const Media::MimeMessage*, QString>> Batch;
+
+    QMutex m_Mutex;
+    QCache<const Media::MimeMessage*, MessageFormatter::Result> m_Cache {DEFAULT_CAPACITY};
+
+    /// The messages waiting for the worker, with the text being rendered
+    QHash<const Media::MimeMessage*, QString> m_hPending;
+
+    TaskPool::Token m_Token;
+
+    // Helpers
+    void insert(const Media::MimeMessage* m, const MessageFormatter::Result& r);
+    void renderBatch(const Batch& batch);
+};
+
+MessageFormatter::MessageFormatter() : d_ptr(new MessageFormatterPrivate)
+{}
+
+MessageFormatter::~MessageFormatter()
+{
+    d_ptr->m_Token.cancel();
+    TaskPool::instance().wait(d_ptr->m_Token);
+    delete d_ptr;
+}
+
+MessageFormatter& MessageFormatter::instance()
+{
+    static auto instance = new MessageFormatter();
+    return *instance;
+}
+
+/// Must be called with the mutex held
+void MessageFormatterPrivate::insert(const Media::MimeMessage* m, const MessageFormatter::Result& r)
+{
+    m_hPending.remove(m);
+    m_Cache.insert(m, new MessageFormatter::Result(r), r.m_Html.size() + 1);
+}
+
+static inline bool isLinkEnd(const QChar c)
+{
+    switch(c.unicode()) {
+        case ',': case '.': case ')': case ';': case '!': case '>':
+            return true;
+    }
+
+    return false;
+}
+
+/// The length of the link scheme (or www.) starting at `p`, if any
+static inline int schemeLength(const QChar* p, const QChar* end)
+{
+    static const char* schemes[] = { "https:", "http:", "ftp:", "ring:", "www." };
+
+    // Fast path, most characters can't start a link
+    switch(p->unicode() | 0x20) {
+        case 'h': case 'f': case 'r': case 'w':
+            break;
+        default:
+            return 0;
+    }
+
+    for (const char* s : schemes) {
+        int i = 0;
+
+        while (s[i] && p + i < end && p[i].toLower() == QLatin1Char(s[i]))
+            i++;
+
+        if (!s[i])
+            return i;
+    }
+
+    return 0;
+}
+
+static void appendEscaped(QString& out, const QChar* begin, const QChar* end)
+{
+    for (const QChar* c = begin; c < end; c++) {
+        switch(c->unicode()) {
+            case '<':
+                out += QLatin1String("&lt;");
+                break;
+            case '>':
+                out += QLatin1String("&gt;");
+                break;
+            case '&':
+                out += QLatin1String("&amp;");
+                break;
+            case '"':
+                out += QLatin1String("&quot;");
+                break;
+            case '\n':
+                out += QLatin1String("<br/>");
+                break;
+            default:
+                out += *c;
+        }
+    }
+}
+
+/**
+ * Replace the old regular expression. A link is a scheme (or www.) followed
+ * by everything until the next space, minus a trailing punctuation mark.
+ */
+MessageFormatter::Result MessageFormatter::render(const QString& text, bool html)
+{
+    Result ret;
+    QString out;
+
+    const QChar* begin   = text.constData();
+    const QChar* end     = begin + text.size();
+    const QChar* segment = begin;
+
+    if (html) {
+        out.reserve(text.size() + 16);
+        out += QLatin1String("<body>");
+    }
+
+    for (const QChar* p = begin; p < end;) {
+        const int scheme = schemeLength(p, end);
+
+        if (!scheme) {
+            ++p;
+            continue;
+        }
+
+        const QChar* e = p + scheme;
+
+        while (e < end && !e->isSpace())
+            ++e;
+
+        if (isLinkEnd(e[-1]))
+            --e;
+
+        // A scheme alone isn't a link
+        if (e <= p + scheme) {
+            ++p;
+            continue;
+        }
+
+        const QString link(p, e - p);
+        const QUrl url = QUrl::fromUserInput(link);
+
+        ret.m_Links << url;
+
+        if (html) {
+            const QString href = QString::fromLatin1(url.toEncoded());
+
+            appendEscaped(out, segment, p);
+            out += QLatin1String("<a href=\"");
+            appendEscaped(out, href.constData(), href.constData() + href.size());
+            out += QLatin1String("\">");
+            appendEscaped(out, p, e);
+            out += QLatin1String("</a>");
+        }
+
+        segment = p = e;
+    }
+
+    if (html) {
+        appendEscaped(out, segment, end);
+        out += QLatin1String("</body>");
+        ret.m_Html = out;
+    }
+
+    return ret;
+}
+
+MessageFormatter::Result MessageFormatter::format(const Media::MimeMessage* m)
+{
+    {
+        QMutexLocker l(&d_ptr->m_Mutex);
+
+        if (auto r = d_ptr->m_Cache.object(m))
+            return *r;
+    }
+
+    const Result r = render(m->plainText());
+
+    QMutexLocker l(&d_ptr->m_Mutex);
+    d_ptr->insert(m, r);
+
+    return r;
+}
+
+QList<QUrl> MessageFormatter::links(const Media::MimeMessage* m)
+{
+    {
+        QMutexLocker l(&d_ptr->m_Mutex);
+
+        if (auto r = d_ptr->m_Cache.object(m))
+            return r->m_Links;
+    }
+
+    return render(m->plainText(), false).m_Links;
+}
+
+void MessageFormatter::prefetch(const QVector<const Media::MimeMessage*>& messages)
+{
+    MessageFormatterPrivate::Batch batch;
+
+    {
+        QMutexLocker l(&d_ptr->m_Mutex);
+
+        for (auto m : messages) {
+            if ((!m) || d_ptr->m_Cache.contains(m) || d_ptr->m_hPending.contains(m))
+                continue;
+
+            const QString text = m->plainText();
+
+            if (text.isEmpty())
+                continue;
+
+            d_ptr->m_hPending[m] = text;
+            batch << qMakePair(m, text);
+        }
+    }
+
+    // The messages are about to be scrolled into view
+    if (!batch.isEmpty())
+        TaskPool::instance().run(TaskPool::Lane::INTERACTIVE, [this, batch]() {
+            d_ptr->renderBatch(batch);
+        }, d_ptr->m_Token);
+}
+
+void MessageFormatterPrivate::renderBatch(const Batch& batch)
+{
+    for (const auto& entry : qAsConst(batch)) {
+        // Check if the message was deleted (or rendered) in the meantime
+        const auto isPending = [this, &entry]() -> bool {
+            const auto it = m_hPending.constFind(entry.first);
+            return it != m_hPending.constEnd() && *it == entry.second;
+        };
+
+        {
+            QMutexLocker l(&m_Mutex);
+
+            if (!isPending())
+                continue;
+        }
+
+        const auto r = MessageFormatter::render(entry.second);
+
+        QMutexLocker l(&m_Mutex);
+
+        if (isPending())
+            insert(entry.first, r);
+    }
+}
+
+void MessageFormatter::forget(const Media::MimeMessage* m)
+{
+    QMutexLocker l(&d_ptr->m_Mutex);
+    d_ptr->m_Cache.remove(m);
+    d_ptr->m_hPending.remove(m);
+}
+
+void MessageFormatter::setCapacity(int characters)
+{
+    QMutexLocker l(&d_ptr->m_Mutex);
+    d_ptr->m_Cache.setMaxCost(characters);
+}
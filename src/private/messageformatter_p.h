@@ -0,0 +1,76 @@
+/************************************************************************************
+ *   Copyright (C) 2018 by BlueSystems GmbH                                         *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                            *
+ *                                                                                  *
+ *   This library is free software; you can redistribute it and/or                  *
+ *   modify it under the terms of the GNU Lesser General Public                     *
+ *   License as published by the Free Software Foundation; either                   *
+ *   version 2.1 of the License, or (at your option) any later version.             *
+ *                                                                                  *
+ *   This library is distributed in the hope that it will be useful,                *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of                 *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU              *
+ *   Lesser General Public License for more details.                                *
+ *                                                                                  *
+ *   You should have received a copy of the GNU Lesser General Public               *
+ *   License along with this library; if not, write to the Free Software            *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA *
+ ***********************************************************************************/
+#pragma once
+
+#include <QtCore/QString>
+#include <QtCore/QList>
+#include <QtCore/QUrl>
+#include <QtCore/QVector>
+
+namespace Media {
+    class MimeMessage;
+}
+
+class MessageFormatterPrivate;
+
+/**
+ * Turn the text messages into HTML with clickable links.
+ *
+ * The results are kept in a cache bounded by the number of characters, so
+ * the rarely viewed messages eventually drop their formatted copy. The
+ * messages close to those being displayed can be rendered in advance on a
+ * worker thread with prefetch().
+ *
+ * All methods are thread safe.
+ */
+class MessageFormatter final
+{
+public:
+    struct Result {
+        QString     m_Html ;
+        QList<QUrl> m_Links;
+    };
+
+    static MessageFormatter& instance();
+
+    /// Get the cached result or render it now
+    Result format(const Media::MimeMessage* m);
+
+    /// Get the links, without rendering (or caching) anything on a miss
+    QList<QUrl> links(const Media::MimeMessage* m);
+
+    /// Render the messages in the background if they are not cached
+    void prefetch(const QVector<const Media::MimeMessage*>& messages);
+
+    /// Must be called before a message is deleted
+    void forget(const Media::MimeMessage* m);
+
+    /// Set the maximum number of cached HTML characters
+    void setCapacity(int characters);
+
+    /// Single pass link detection and HTML escaping
+    static Result render(const QString& text, bool html = true);
+
+private:
+    explicit MessageFormatter();
+    ~MessageFormatter();
+
+    MessageFormatterPrivate* d_ptr;
+    Q_DECLARE_PRIVATE(MessageFormatter)
+};
@@ -0,0 +1,519 @@
+/************************************************************************************
+ *   Copyright (C) 2018 by BlueSystems GmbH                                         *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                            *
+ *                                                                                  *
+ *   This library is free software; you can redistribute it and/or                  *
+ *   modify it under the terms of the GNU Lesser General Public                     *
+ *   License as published by the Free Software Foundation; either                   *
+ *   version 2.1 of the License, or (at your option) any later version.             *
+ *                                                                                  *
+ *   This library is distributed in the hope that it will be useful,                *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of                 *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU              *
+ *   Lesser General Public License for more details.                                *
+ *                                                                                  *
+ *   You should have received a copy of the GNU Lesser General Public               *
+ *   License along with this library; if not, write to the Free Software            *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA *
+ ***********************************************************************************/
+#include "messagesearchindex_p.h"
+
+// Std
+#include <algorithm>
+#include <limits>
+
+// Qt
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDataStream>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QHash>
+#include <QtCore/QMap>
+#include <QtCore/QSaveFile>
+#include <QtCore/QStandardPaths>
+#include <QtCore/QTimer>
+#include <QtCore/QDebug>
+
+// Ring
+#include "media/mimemessage.h"
+
+struct SearchPosting final
+{
+    quint32 m_Document;
+    quint16 m_Position;
+};
+Q_DECLARE_TYPEINFO(SearchPosting, Q_PRIMITIVE_TYPE);
+
+struct SearchDocument final
+{
+    quint64             m_Key     {0      };
+    Media::MimeMessage* m_pMessage{nullptr};
+    bool                m_Removed {false  }; /*!< Dropped on the next save */
+};
+Q_DECLARE_TYPEINFO(SearchDocument, Q_PRIMITIVE_TYPE);
+
+class MessageSearchIndexPrivate final
+{
+public:
+    static constexpr quint32 MAGIC   = 0x52494458; // "RIDX"
+    static constexpr quint32 VERSION = 1;
+
+    /// document -> start positions of the match
+    typedef QHash<quint32, QVector<quint16>> Matches;
+
+    // Attributes
+    QVector<SearchDocument>                   m_lDocuments;
+    QHash<quint64, quint32>                   m_hKeys     ;
+    QHash<const Media::MimeMessage*, quint32> m_hLive     ;
+
+    /// Sorted, so the prefix queries are a range
+    QMap<QString, QVector<SearchPosting>>     m_mTerms    ;
+
+    bool   m_Loaded  {false};
+    bool   m_Dirty   {false};
+    int    m_Removed {  0  };
+    QTimer m_SaveTimer     ;
+
+    // Helpers
+    void ensureLoaded();
+    void compact();
+    Matches matches(const QString& token, bool prefix) const;
+    Matches phrase(const QStringList& tokens, bool prefix) const;
+
+    static quint64 key(const Media::MimeMessage* m, const QString& text);
+    static QString filePath();
+};
+
+MessageSearchIndex::MessageSearchIndex() : QObject(QCoreApplication::instance()),
+    d_ptr(new MessageSearchIndexPrivate)
+{
+    // Adding the messages of a conversation is a burst, save once it's over
+    d_ptr->m_SaveTimer.setSingleShot(true);
+    d_ptr->m_SaveTimer.setInterval(5000);
+
+    connect(&d_ptr->m_SaveTimer, &QTimer::timeout, this, &MessageSearchIndex::save);
+    connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit,
+        this, &MessageSearchIndex::save);
+}
+
+MessageSearchIndex::~MessageSearchIndex()
+{
+    delete d_ptr;
+}
+
+MessageSearchIndex& MessageSearchIndex::instance()
+{
+    static auto instance = new MessageSearchIndex();
+    return *instance;
+}
+
+QString MessageSearchIndexPrivate::filePath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::DataLocation)
+        + QStringLiteral("/text/searchindex.bin");
+}
+
+/// FNV-1a, the messages have no persistent unique identifier
+quint64 MessageSearchIndexPrivate::key(const Media::MimeMessage* m, const QString& text)
+{
+    quint64 ret = 14695981039346656037ULL;
+
+    const auto add = [&ret](const char* data, int size) {
+        for (int i = 0; i < size; i++) {
+            ret ^= static_cast<uchar>(data[i]);
+            ret *= 1099511628211ULL;
+        }
+    };
+
+    const qint64 ts  = m->timestamp();
+    const char   dir = static_cast<char>(m->direction());
+
+    add(reinterpret_cast<const char*>(&ts), sizeof(ts));
+    add(&dir, 1);
+    add(reinterpret_cast<const char*>(text.utf16()), text.size() * 2);
+
+    return ret;
+}
+
+QStringList MessageSearchIndex::tokenize(const QString& text)
+{
+    QStringList ret;
+    QString current;
+
+    // Decompose the accents so "é" matches "e"
+    const QString normalized = text.normalized(QString::NormalizationForm_KD);
+
+    for (const QChar c : normalized) {
+        if (c.isLetterOrNumber())
+            current += c.toLower();
+        else if (c.category() == QChar::Mark_NonSpacing)
+            continue;
+        else if (!current.isEmpty()) {
+            ret << current;
+            current.clear();
+        }
+    }
+
+    if (!current.isEmpty())
+        ret << current;
+
+    return ret;
+}
+
+void MessageSearchIndexPrivate::ensureLoaded()
+{
+    if (m_Loaded)
+        return;
+
+    m_Loaded = true;
+
+    QFile file(filePath());
+
+    if (!file.open(QIODevice::ReadOnly))
+        return;
+
+    QDataStream s(&file);
+    s.setVersion(QDataStream::Qt_5_6);
+
+    quint32 magic(0), version(0), count(0);
+    s >> magic >> version;
+
+    if (magic != MAGIC || version != VERSION) {
+        qWarning() << "Ignoring the incompatible message search index" << file.fileName();
+        return;
+    }
+
+    // The counts are read from the file, check them against its size before
+    // allocating anything
+    const auto fits = [&file, &s](quint32 count, int itemSize) {
+        if (quint64(count) * itemSize <= quint64(file.bytesAvailable()))
+            return true;
+
+        s.setStatus(QDataStream::ReadCorruptData);
+        return false;
+    };
+
+    s >> count;
+
+    if (s.status() == QDataStream::Ok && fits(count, sizeof(quint64))) {
+        m_lDocuments.resize(count);
+
+        for (quint32 i = 0; i < count && s.status() == QDataStream::Ok; i++) {
+            s >> m_lDocuments[i].m_Key;
+            m_hKeys[m_lDocuments[i].m_Key] = i;
+        }
+    }
+
+    s >> count;
+
+    for (quint32 i = 0; i < count && s.status() == QDataStream::Ok; i++) {
+        QString term;
+        quint32 size(0);
+        s >> term >> size;
+
+        if (s.status() != QDataStream::Ok || !fits(size, sizeof(quint32) + sizeof(quint16)))
+            break;
+
+        auto& postings = m_mTerms[term];
+        postings.resize(size);
+
+        for (quint32 j = 0; j < size; j++) {
+            s >> postings[j].m_Document >> postings[j].m_Position;
+
+            if (postings[j].m_Document >= quint32(m_lDocuments.size()))
+                s.setStatus(QDataStream::ReadCorruptData);
+        }
+    }
+
+    // Start over rather than returning garbage
+    if (s.status() != QDataStream::Ok) {
+        qWarning() << "The message search index is corrupted" << file.fileName();
+        m_lDocuments.clear();
+        m_hKeys.clear();
+        m_mTerms.clear();
+        m_Dirty = true;
+    }
+}
+
+void MessageSearchIndex::add(Media::MimeMessage* m)
+{
+    if ((!m) || m->type() == Media::MimeMessage::Type::SNAPSHOT || d_ptr->m_hLive.contains(m))
+        return;
+
+    const QString text = m->plainText();
+
+    if (text.isEmpty())
+        return;
+
+    d_ptr->ensureLoaded();
+
+    const quint64 k = MessageSearchIndexPrivate::key(m, text);
+
+    // It was already indexed in a previous session
+    const auto it = d_ptr->m_hKeys.constFind(k);
+
+    if (it != d_ptr->m_hKeys.constEnd()) {
+        d_ptr->m_lDocuments[*it].m_pMessage = m;
+        d_ptr->m_hLive[m] = *it;
+        return;
+    }
+
+    const quint32 doc = d_ptr->m_lDocuments.size();
+
+    d_ptr->m_lDocuments << SearchDocument {k, m};
+    d_ptr->m_hKeys[k] = doc;
+    d_ptr->m_hLive[m] = doc;
+
+    const QStringList tokens = tokenize(text);
+    const int max = std::min(tokens.size(), int(std::numeric_limits<quint16>::max()));
+
+    for (int i = 0; i < max; i++)
+        d_ptr->m_mTerms[tokens[i]] << SearchPosting {doc, static_cast<quint16>(i)};
+
+    d_ptr->m_Dirty = true;
+    d_ptr->m_SaveTimer.start();
+}
+
+void MessageSearchIndex::remove(Media::MimeMessage* m)
+{
+    const auto it = d_ptr->m_hLive.find(m);
+
+    if (it == d_ptr->m_hLive.end())
+        return;
+
+    // Don't let the index only grow, the message will be tokenized again if
+    // it's ever loaded again
+    auto& doc = d_ptr->m_lDocuments[*it];
+
+    doc.m_pMessage = nullptr;
+    doc.m_Removed  = true;
+
+    d_ptr->m_hKeys.remove(doc.m_Key);
+    d_ptr->m_hLive.erase(it);
+
+    d_ptr->m_Removed++;
+    d_ptr->m_Dirty = true;
+    d_ptr->m_SaveTimer.start();
+}
+
+/// Remove the documents marked as removed and renumber the others
+void MessageSearchIndexPrivate::compact()
+{
+    static constexpr quint32 REMOVED = std::numeric_limits<quint32>::max();
+
+    QVector<quint32> remap(m_lDocuments.size(), REMOVED);
+    QVector<SearchDocument> documents;
+    documents.reserve(m_lDocuments.size() - m_Removed);
+
+    for (int i = 0; i < m_lDocuments.size(); i++) {
+        if (!m_lDocuments[i].m_Removed) {
+            remap[i] = documents.size();
+            documents << m_lDocuments[i];
+        }
+    }
+
+    for (auto it = m_mTerms.begin(); it != m_mTerms.end();) {
+        QVector<SearchPosting> kept;
+        kept.reserve(it->size());
+
+        for (const auto& p : qAsConst(*it)) {
+            if (remap[p.m_Document] != REMOVED)
+                kept << SearchPosting {remap[p.m_Document], p.m_Position};
+        }
+
+        if (kept.isEmpty())
+            it = m_mTerms.erase(it);
+        else {
+            *it = kept;
+            ++it;
+        }
+    }
+
+    m_lDocuments = documents;
+    m_Removed    = 0;
+
+    m_hKeys.clear();
+    m_hLive.clear();
+
+    for (int i = 0; i < m_lDocuments.size(); i++) {
+        m_hKeys[m_lDocuments[i].m_Key] = i;
+
+        if (auto m = m_lDocuments[i].m_pMessage)
+            m_hLive[m] = i;
+    }
+}
+
+int MessageSearchIndex::size() const
+{
+    return d_ptr->m_lDocuments.size();
+}
+
+MessageSearchIndexPrivate::Matches MessageSearchIndexPrivate::matches(const QString& token, bool prefix) const
+{
+    Matches ret;
+
+    const auto append = [&ret](const QVector<SearchPosting>& postings) {
+        for (const auto& p : postings)
+            ret[p.m_Document] << p.m_Position;
+    };
+
+    if (!prefix) {
+        const auto it = m_mTerms.constFind(token);
+
+        if (it != m_mTerms.constEnd())
+            append(*it);
+
+        return ret;
+    }
+
+    for (auto it = m_mTerms.lowerBound(token); it != m_mTerms.constEnd() && it.key().startsWith(token); ++it)
+        append(*it);
+
+    return ret;
+}
+
+/// Only keep the start positions followed by the rest of the phrase
+MessageSearchIndexPrivate::Matches MessageSearchIndexPrivate::phrase(const QStringList& tokens, bool prefix) const
+{
+    const int last = tokens.size() - 1;
+
+    Matches ret = matches(tokens.first(), prefix && !last);
+
+    for (int i = 1; i <= last && !ret.isEmpty(); i++) {
+        const Matches next = matches(tokens[i], prefix && i == last);
+
+        for (auto it = ret.begin(); it != ret.end();) {
+            const auto n = next.constFind(it.key());
+
+            if (n == next.constEnd()) {
+                it = ret.erase(it);
+                continue;
+            }
+
+            QVector<quint16> kept;
+
+            for (const quint16 start : qAsConst(*it)) {
+                if (n->contains(start + i))
+                    kept << start;
+            }
+
+            if (kept.isEmpty())
+                it = ret.erase(it);
+            else {
+                *it = kept;
+                ++it;
+            }
+        }
+    }
+
+    return ret;
+}
+
+QVector<Media::MimeMessage*> MessageSearchIndex::search(const QString& query)
+{
+    struct Clause {
+        QStringList m_lTokens;
+        bool        m_Prefix;
+    };
+
+    QList<Clause> clauses;
+    QString word;
+    bool quoted = false;
+
+    const auto flush = [&clauses, &word]() {
+        const bool prefix = word.endsWith(QLatin1Char('*'));
+        const QStringList tokens = tokenize(word);
+
+        if (!tokens.isEmpty())
+            clauses << Clause {tokens, prefix};
+
+        word.clear();
+    };
+
+    for (const QChar c : query) {
+        if (c == QLatin1Char('"')) {
+            flush();
+            quoted = !quoted;
+        }
+        else if (c.isSpace() && !quoted)
+            flush();
+        else
+            word += c;
+    }
+
+    flush();
+
+    if (clauses.isEmpty())
+        return {};
+
+    d_ptr->ensureLoaded();
+
+    auto result = d_ptr->phrase(clauses.first().m_lTokens, clauses.first().m_Prefix);
+
+    for (int i = 1; i < clauses.size() && !result.isEmpty(); i++) {
+        const auto m = d_ptr->phrase(clauses[i].m_lTokens, clauses[i].m_Prefix);
+
+        for (auto it = result.begin(); it != result.end();) {
+            if (m.contains(it.key()))
+                ++it;
+            else
+                it = result.erase(it);
+        }
+    }
+
+    QVector<Media::MimeMessage*> ret;
+    ret.reserve(result.size());
+
+    for (auto it = result.constBegin(); it != result.constEnd(); ++it) {
+        if (auto m = d_ptr->m_lDocuments[it.key()].m_pMessage)
+            ret << m;
+    }
+
+    std::stable_sort(ret.begin(), ret.end(), [](const Media::MimeMessage* a, const Media::MimeMessage* b) {
+        return a->timestamp() < b->timestamp();
+    });
+
+    return ret;
+}
+
+void MessageSearchIndex::save()
+{
+    if (!d_ptr->m_Dirty)
+        return;
+
+    d_ptr->m_SaveTimer.stop();
+
+    if (d_ptr->m_Removed)
+        d_ptr->compact();
+
+    QDir().mkpath(QStandardPaths::writableLocation(QStandardPaths::DataLocation) + QStringLiteral("/text"));
+
+    QSaveFile file(MessageSearchIndexPrivate::filePath());
+
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Unable to save the message search index" << file.fileName();
+        return;
+    }
+
+    QDataStream s(&file);
+    s.setVersion(QDataStream::Qt_5_6);
+
+    s << MessageSearchIndexPrivate::MAGIC << MessageSearchIndexPrivate::VERSION;
+
+    s << quint32(d_ptr->m_lDocuments.size());
+
+    for (const auto& d : qAsConst(d_ptr->m_lDocuments))
+        s << d.m_Key;
+
+    s << quint32(d_ptr->m_mTerms.size());
+
+    for (auto it = d_ptr->m_mTerms.constBegin(); it != d_ptr->m_mTerms.constEnd(); ++it) {
+        s << it.key() << quint32(it->size());
+
+        for (const auto& p : qAsConst(*it))
+            s << p.m_Document << p.m_Position;
+    }
+
+    if (file.commit())
+        d_ptr->m_Dirty = false;
+}
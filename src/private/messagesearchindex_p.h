@@ -0,0 +1,78 @@
+/************************************************************************************
+ *   Copyright (C) 2018 by BlueSystems GmbH                                         *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                            *
+ *                                                                                  *
+ *   This library is free software; you can redistribute it and/or                  *
+ *   modify it under the terms of the GNU Lesser General Public                     *
+ *   License as published by the Free Software Foundation; either                   *
+ *   version 2.1 of the License, or (at your option) any later version.             *
+ *                                                                                  *
+ *   This library is distributed in the hope that it will be useful,                *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of                 *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU              *
+ *   Lesser General Public License for more details.                                *
+ *                                                                                  *
+ *   You should have received a copy of the GNU Lesser General Public               *
+ *   License along with this library; if not, write to the Free Software            *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA *
+ ***********************************************************************************/
+#pragma once
+
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QVector>
+
+namespace Media {
+    class MimeMessage;
+}
+
+class MessageSearchIndexPrivate;
+
+/**
+ * An inverted index of the text messages words.
+ *
+ * The messages are added as the text recordings are loaded (or received), so
+ * the index grows incrementally and searching never needs to scan the
+ * messages. It is saved next to the text recordings and only the new messages
+ * are tokenized when they are loaded again.
+ *
+ * The query syntax is a list of words which all have to match:
+ *
+ *  * `word`     : An exact word (case and accent insensitive)
+ *  * `wor*`     : Any word starting with "wor"
+ *  * `"a b c"`  : The words in that order (the last one can be a prefix)
+ *
+ * This class is not thread safe, it is used from the main thread.
+ */
+class MessageSearchIndex final : public QObject
+{
+    Q_OBJECT
+public:
+    static MessageSearchIndex& instance();
+
+    /// Index a message (or bind it to its saved entry)
+    void add(Media::MimeMessage* m);
+
+    /// Call before a message is deleted
+    void remove(Media::MimeMessage* m);
+
+    /// The loaded messages matching the query, oldest first
+    QVector<Media::MimeMessage*> search(const QString& query);
+
+    /// The number of indexed messages (including those not loaded)
+    int size() const;
+
+    /// Split a text into normalized words
+    static QStringList tokenize(const QString& text);
+
+public Q_SLOTS:
+    /// Write the index to disk if it changed
+    void save();
+
+private:
+    explicit MessageSearchIndex();
+    virtual ~MessageSearchIndex();
+
+    MessageSearchIndexPrivate* d_ptr;
+    Q_DECLARE_PRIVATE(MessageSearchIndex)
+};
@@ -57,6 +57,13 @@ public:
 
     QWeakPointer<QAbstractItemModel> m_pAddressModel;
 
+    // The photo as found in the vCard, decoded on demand by the PhotoLoader
+    QByteArray m_EncodedPhoto     ;
+    QByteArray m_PhotoType        ;
+    QByteArray m_PhotoKey         ;
+    uint       m_PhotoGeneration {0};
+    bool       m_PhotoPending    {false};
+
     Person* q_ptr;
 
     /*
@@ -72,6 +79,11 @@ public:
 
     QString filterString();
 
+    // Photo helpers
+    void setEncodedPhoto(const QByteArray& data, const QByteArray& type);
+    void copyPhoto(const PersonPrivate* other);
+    bool hasPhoto() const;
+
     //Helper code to help handle multiple parents
     QList<Person*> m_lParents;
 
@@ -83,6 +95,7 @@ public:
     void changed                  (                );
     void photoChanged             (                );
     void formattedNameChanged     (                );
+    void phoneNumbersChanged      (                );
 public Q_SLOTS:
     void slotTrackedChanged();
     void slotPresenceChanged();
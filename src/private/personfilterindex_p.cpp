@@ -0,0 +1,205 @@
+/************************************************************************************
+ *   Copyright (C) 2018 by BlueSystems GmbH                                         *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                            *
+ *                                                                                  *
+ *   This library is free software; you can redistribute it and/or                  *
+ *   modify it under the terms of the GNU Lesser General Public                     *
+ *   License as published by the Free Software Foundation; either                   *
+ *   version 2.1 of the License, or (at your option) any later version.             *
+ *                                                                                  *
+ *   This library is distributed in the hope that it will be useful,                *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of                 *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU              *
+ *   Lesser General Public License for more details.                                *
+ *                                                                                  *
+ *   You should have received a copy of the GNU Lesser General Public               *
+ *   License along with this library; if not, write to the Free Software            *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA *
+ ***********************************************************************************/
+#include "personfilterindex_p.h"
+
+// Std
+#include <algorithm>
+#include <cstring>
+
+// Ring
+#include "person.h"
+#include "individual.h"
+#include "contactmethod.h"
+
+QString PersonFilterIndex::normalize(const QString& s)
+{
+   QString ret;
+   ret.reserve(s.size());
+
+   const QChar* c   = s.constData();
+   const QChar* end = c + s.size();
+
+   // Most names and URIs are ASCII, they don't need to be decomposed
+   for (; c < end && c->unicode() < 0x80; c++) {
+      const ushort u = c->unicode();
+      ret += QChar((u >= 'A' && u <= 'Z') ? (u | 0x20) : u);
+   }
+
+   if (c == end)
+      return ret;
+
+   // Strip non essential characters like accents
+   const QString rest = QString(c, end - c).toLower().normalized(QString::NormalizationForm_KD);
+
+   for (const QChar& c2 : rest) {
+      if (!c2.combiningClass())
+         ret += c2;
+   }
+
+   return ret;
+}
+
+QString PersonFilterIndex::key(const Person* p)
+{
+   QString ret;
+
+   p->individual()->forAllNumbers([&ret](ContactMethod* cm) {
+      ret += cm->uri();
+      ret += QLatin1Char('\n');
+      ret += cm->registeredName();
+      ret += QLatin1Char('\n');
+   }, false);
+
+   ret += p->formattedName() + QLatin1Char('\n') + p->organization()   + QLatin1Char('\n')
+        + p->group()         + QLatin1Char('\n') + p->department()     + QLatin1Char('\n')
+        + p->preferredEmail();
+
+   return normalize(ret);
+}
+
+void PersonFilterIndex::append(const Person* p)
+{
+   // The key is built on the first query, the person is usually still
+   // being loaded at this point
+   m_hRows[p] = m_lPersons.size();
+   m_lPersons.push_back(p);
+   m_lOffsets.push_back(m_Buffer.size());
+   m_lLengths.push_back(0);
+
+   m_lDirty.insert(p);
+}
+
+void PersonFilterIndex::remove(int row)
+{
+   if (row < 0 || static_cast<size_t>(row) >= m_lPersons.size())
+      return;
+
+   m_Garbage += m_lLengths[row];
+   m_lDirty.remove(m_lPersons[row]);
+
+   m_lPersons.erase(m_lPersons.begin() + row);
+   m_lOffsets.erase(m_lOffsets.begin() + row);
+   m_lLengths.erase(m_lLengths.begin() + row);
+
+   m_hRows.clear();
+   for (size_t i = 0; i < m_lPersons.size(); i++)
+      m_hRows[m_lPersons[i]] = i;
+}
+
+int PersonFilterIndex::row(const Person* p) const
+{
+   return m_hRows.value(p, -1);
+}
+
+void PersonFilterIndex::invalidate(const Person* p)
+{
+   m_lDirty.insert(p);
+}
+
+void PersonFilterIndex::update()
+{
+   if (m_lDirty.isEmpty())
+      return;
+
+   for (size_t row = 0; row < m_lPersons.size(); row++) {
+      if (!m_lDirty.contains(m_lPersons[row]))
+         continue;
+
+      const QString k = key(m_lPersons[row]);
+
+      m_Garbage += m_lLengths[row];
+
+      m_lOffsets[row] = m_Buffer.size();
+      m_lLengths[row] = k.size();
+      m_Buffer += k;
+   }
+
+   // Also drops the persons removed before their key was built
+   m_lDirty.clear();
+
+   if (m_Garbage > m_Buffer.size() / 2)
+      compact();
+}
+
+void PersonFilterIndex::compact()
+{
+   QString buffer;
+   buffer.reserve(m_Buffer.size() - m_Garbage);
+
+   for (size_t row = 0; row < m_lPersons.size(); row++) {
+      const int offset = buffer.size();
+      buffer += m_Buffer.midRef(m_lOffsets[row], m_lLengths[row]);
+      m_lOffsets[row] = offset;
+   }
+
+   m_Buffer  = buffer;
+   m_Garbage = 0;
+}
+
+static inline bool contains(const ushort* begin, const ushort* end, const QString& word)
+{
+   const int     size = word.size();
+   const ushort* w    = word.utf16();
+
+   if (end - begin < size)
+      return false;
+
+   const ushort* last = end - size + 1;
+
+   // std::find on a contiguous array of ushort is easily vectorized, the
+   // full comparison only happens when the first character matches
+   for (auto c = std::find(begin, last, w[0]); c != last; c = std::find(c + 1, last, w[0])) {
+      if (!memcmp(c + 1, w + 1, (size - 1) * sizeof(ushort)))
+         return true;
+   }
+
+   return false;
+}
+
+QBitArray PersonFilterIndex::match(const QString& query)
+{
+   update();
+
+   const int count = static_cast<int>(m_lPersons.size());
+
+   const QStringList words = normalize(query.simplified()).split(
+      QLatin1Char(' '), QString::SkipEmptyParts
+   );
+
+   if (words.isEmpty())
+      return QBitArray(count, true);
+
+   QBitArray ret(count);
+
+   const ushort* data = m_Buffer.utf16();
+
+   for (int row = 0; row < count; row++) {
+      const ushort* begin = data + m_lOffsets[row];
+      const ushort* end   = begin + m_lLengths[row];
+
+      const bool found = std::all_of(words.constBegin(), words.constEnd(), [begin, end](const QString& w) {
+         return contains(begin, end, w);
+      });
+
+      if (found)
+         ret.setBit(row);
+   }
+
+   return ret;
+}
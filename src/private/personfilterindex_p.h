@@ -0,0 +1,82 @@
+/************************************************************************************
+ *   Copyright (C) 2018 by BlueSystems GmbH                                         *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                            *
+ *                                                                                  *
+ *   This library is free software; you can redistribute it and/or                  *
+ *   modify it under the terms of the GNU Lesser General Public                     *
+ *   License as published by the Free Software Foundation; either                   *
+ *   version 2.1 of the License, or (at your option) any later version.             *
+ *                                                                                  *
+ *   This library is distributed in the hope that it will be useful,                *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of                 *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU              *
+ *   Lesser General Public License for more details.                                *
+ *                                                                                  *
+ *   You should have received a copy of the GNU Lesser General Public               *
+ *   License along with this library; if not, write to the Free Software            *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA *
+ ***********************************************************************************/
+#pragma once
+
+// Qt
+#include <QtCore/QBitArray>
+#include <QtCore/QHash>
+#include <QtCore/QSet>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+
+// Std
+#include <vector>
+
+class Person;
+
+/**
+ * The search keys of all persons, for PersonDirectory::match().
+ *
+ * The keys are lower case, accent folded and stored back to back in a single
+ * buffer, in the same order as the PersonDirectory rows. A query is then a
+ * linear scan over contiguous memory instead of calling data() and
+ * normalizing each row in a QSortFilterProxyModel.
+ *
+ * The modified persons are only marked as dirty and their key is rebuilt
+ * on the next query. The old key is left in the buffer until more than half
+ * of it is garbage.
+ */
+class PersonFilterIndex final
+{
+public:
+   /// Lower case, decomposed and without the combining characters
+   static QString normalize(const QString& s);
+
+   /// The normalized content of all the searchable fields of `p`
+   static QString key(const Person* p);
+
+   void append(const Person* p);
+   void remove(int row);
+
+   /// Rebuild the key of `p` before the next query
+   void invalidate(const Person* p);
+
+   /// The rows containing all the words of `query`
+   QBitArray match(const QString& query);
+
+   /// The row of `p`, -1 if it isn't indexed
+   int row(const Person* p) const;
+
+private:
+   QString m_Buffer;
+
+   // One entry per row
+   std::vector<const Person*> m_lPersons;
+   std::vector<int>           m_lOffsets;
+   std::vector<int>           m_lLengths;
+
+   QHash<const Person*, int> m_hRows;
+
+   QSet<const Person*> m_lDirty;
+   int m_Garbage {0};
+
+   // Helpers
+   void update();
+   void compact();
+};
@@ -0,0 +1,134 @@
+/************************************************************************************
+ *   Copyright (C) 2018 by BlueSystems GmbH                                         *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                            *
+ *                                                                                  *
+ *   This library is free software; you can redistribute it and/or                  *
+ *   modify it under the terms of the GNU Lesser General Public                     *
+ *   License as published by the Free Software Foundation; either                   *
+ *   version 2.1 of the License, or (at your option) any later version.             *
+ *                                                                                  *
+ *   This library is distributed in the hope that it will be useful,                *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of                 *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU              *
+ *   Lesser General Public License for more details.                                *
+ *                                                                                  *
+ *   You should have received a copy of the GNU Lesser General Public               *
+ *   License along with this library; if not, write to the Free Software            *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA *
+ ***********************************************************************************/
+#include "photoloader_p.h"
+
+// Qt
+#include <QtCore/QCoreApplication>
+#include <QtCore/QMutex>
+#include <QtCore/QPointer>
+#include <QtCore/QThread>
+#include <QtCore/QVector>
+
+// Ring
+#include "globalinstances.h"
+#include "interfaces/pixmapmanipulatori.h"
+#include "private/person_p.h"
+#include "private/taskpool_p.h"
+
+struct PhotoLoaderResult
+{
+   QPointer<PersonPrivate> m_pPerson     ;
+   uint                    m_Generation  ;
+   QByteArray              m_Data        ;
+   QByteArray              m_Type        ;
+   QVariant                m_Photo       ;
+   bool                    m_IsThreadSafe;
+};
+
+class PhotoLoaderPrivate final
+{
+public:
+   QMutex                     m_Mutex      ;
+   QVector<PhotoLoaderResult> m_lDone      ;
+   bool                       m_FlushQueued {false};
+   TaskPool::Token            m_Token      ;
+
+   // Helpers
+   void decode(PhotoLoader* q, PhotoLoaderResult r);
+};
+
+PhotoLoader::PhotoLoader() : QObject(nullptr), d_ptr(new PhotoLoaderPrivate)
+{}
+
+PhotoLoader::~PhotoLoader()
+{
+   d_ptr->m_Token.cancel();
+   TaskPool::instance().wait(d_ptr->m_Token);
+   delete d_ptr;
+}
+
+PhotoLoader& PhotoLoader::instance()
+{
+   static auto instance = new PhotoLoader();
+   return *instance;
+}
+
+void PhotoLoader::request(PersonPrivate* p)
+{
+   Q_ASSERT(QThread::currentThread() == QCoreApplication::instance()->thread());
+
+   if (p->m_PhotoPending || p->m_EncodedPhoto.isEmpty())
+      return;
+
+   p->m_PhotoPending = true;
+
+   // Read it here, the task must not touch the GlobalInstances setters
+   const bool threadSafe = GlobalInstances::pixmapManipulator().isPhotoDecodingThreadSafe();
+
+   const PhotoLoaderResult r {
+      p, p->m_PhotoGeneration, p->m_EncodedPhoto, p->m_PhotoType, {}, threadSafe
+   };
+
+   // Someone is looking at the person
+   TaskPool::instance().run(TaskPool::Lane::INTERACTIVE, [this, r]() {
+      d_ptr->decode(this, r);
+   }, d_ptr->m_Token);
+}
+
+void PhotoLoaderPrivate::decode(PhotoLoader* q, PhotoLoaderResult r)
+{
+   if (r.m_IsThreadSafe)
+      r.m_Photo = GlobalInstances::pixmapManipulator().personPhoto(r.m_Data, r.m_Type);
+
+   QMutexLocker l(&m_Mutex);
+
+   m_lDone << r;
+
+   if (!m_FlushQueued) {
+      m_FlushQueued = true;
+      QMetaObject::invokeMethod(q, "flush", Qt::QueuedConnection);
+   }
+}
+
+void PhotoLoader::flush()
+{
+   QVector<PhotoLoaderResult> done;
+
+   {
+      QMutexLocker l(&d_ptr->m_Mutex);
+      done.swap(d_ptr->m_lDone);
+      d_ptr->m_FlushQueued = false;
+   }
+
+   for (const auto& r : qAsConst(done)) {
+      PersonPrivate* p = r.m_pPerson.data();
+
+      // The person was deleted or its photo replaced in the meantime
+      if ((!p) || p->m_PhotoGeneration != r.m_Generation)
+         continue;
+
+      p->m_PhotoPending = false;
+      p->m_vPhoto       = r.m_IsThreadSafe ? r.m_Photo :
+         GlobalInstances::pixmapManipulator().personPhoto(r.m_Data, r.m_Type);
+
+      // The models only refresh the rows on changed()
+      p->photoChanged();
+      p->changed();
+   }
+}
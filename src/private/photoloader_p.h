@@ -0,0 +1,56 @@
+/************************************************************************************
+ *   Copyright (C) 2018 by BlueSystems GmbH                                         *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                            *
+ *                                                                                  *
+ *   This library is free software; you can redistribute it and/or                  *
+ *   modify it under the terms of the GNU Lesser General Public                     *
+ *   License as published by the Free Software Foundation; either                   *
+ *   version 2.1 of the License, or (at your option) any later version.             *
+ *                                                                                  *
+ *   This library is distributed in the hope that it will be useful,                *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of                 *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU              *
+ *   Lesser General Public License for more details.                                *
+ *                                                                                  *
+ *   You should have received a copy of the GNU Lesser General Public               *
+ *   License along with this library; if not, write to the Free Software            *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA *
+ ***********************************************************************************/
+#pragma once
+
+// Qt
+#include <QtCore/QObject>
+
+class PersonPrivate;
+class PhotoLoaderPrivate;
+
+/**
+ * Decode the vCard photos when they are first needed rather than while the
+ * vCards are being parsed.
+ *
+ * Most contacts are never displayed, or only long after the collections are
+ * loaded. The encoded bytes are cheap to keep around and decoding them all
+ * at startup used to dominate the loading time of large address books.
+ *
+ * The image is only decoded in the background if the PixmapManipulatorI
+ * implementation allows it, QPixmap can only be created in the main thread.
+ */
+class PhotoLoader final : public QObject
+{
+   Q_OBJECT
+public:
+   static PhotoLoader& instance();
+
+   /// Decode the photo, PersonPrivate::photoChanged() is called once done
+   void request(PersonPrivate* p);
+
+private Q_SLOTS:
+   void flush();
+
+private:
+   explicit PhotoLoader();
+   virtual ~PhotoLoader();
+
+   PhotoLoaderPrivate* d_ptr;
+   Q_DECLARE_PRIVATE(PhotoLoader)
+};
@@ -0,0 +1,155 @@
+/************************************************************************************
+ *   Copyright (C) 2018 by BlueSystems GmbH                                         *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                            *
+ *                                                                                  *
+ *   This library is free software; you can redistribute it and/or                  *
+ *   modify it under the terms of the GNU Lesser General Public                     *
+ *   License as published by the Free Software Foundation; either                   *
+ *   version 2.1 of the License, or (at your option) any later version.             *
+ *                                                                                  *
+ *   This library is distributed in the hope that it will be useful,                *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of                 *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU              *
+ *   Lesser General Public License for more details.                                *
+ *                                                                                  *
+ *   You should have received a copy of the GNU Lesser General Public               *
+ *   License along with this library; if not, write to the Free Software            *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA *
+ ***********************************************************************************/
+#include "presencesubscriptions_p.h"
+
+// Qt
+#include <QtCore/QHash>
+#include <QtCore/QSet>
+#include <QtCore/QTimer>
+
+// Ring
+#include "dbus/presencemanager.h"
+#include "contactmethod.h"
+#include "account.h"
+#include "accountmodel.h"
+#include "session.h"
+#include "uri.h"
+
+class PresenceSubscriptionsPrivate
+{
+public:
+   struct AccountSubscriptions {
+      QSet<QString>        m_lActive ; /*!< What the daemon currently has   */
+      QHash<QString, bool> m_hPending; /*!< Only what differs from m_lActive */
+   };
+
+   QHash<QByteArray, AccountSubscriptions> m_hAccounts;
+
+   QTimer* m_pTimer {nullptr};
+
+   /// The URI format used by the daemon for the subscriptions
+   static QString key(const ContactMethod* cm);
+};
+
+PresenceSubscriptions::PresenceSubscriptions() : QObject(nullptr),
+   d_ptr(new PresenceSubscriptionsPrivate)
+{
+   d_ptr->m_pTimer = new QTimer(this);
+   d_ptr->m_pTimer->setInterval(INTERVAL);
+   connect(d_ptr->m_pTimer, &QTimer::timeout, this, &PresenceSubscriptions::flush);
+}
+
+PresenceSubscriptions::~PresenceSubscriptions()
+{
+   delete d_ptr;
+}
+
+PresenceSubscriptions& PresenceSubscriptions::instance()
+{
+   static auto instance = new PresenceSubscriptions();
+   return *instance;
+}
+
+QString PresenceSubscriptionsPrivate::key(const ContactMethod* cm)
+{
+   return cm->uri().format(
+      URI::Section::CHEVRONS  |
+      URI::Section::SCHEME    |
+      URI::Section::USER_INFO |
+      URI::Section::HOSTNAME
+   );
+}
+
+void PresenceSubscriptions::setTracked(ContactMethod* cm, bool track)
+{
+   if ((!cm) || !cm->account())
+      return;
+
+   const QString k = PresenceSubscriptionsPrivate::key(cm);
+   auto& s = d_ptr->m_hAccounts[cm->account()->id()];
+
+   // Cancel a change that didn't reach the daemon yet
+   if (s.m_lActive.contains(k) == track)
+      s.m_hPending.remove(k);
+   else
+      s.m_hPending[k] = track;
+
+   if ((!s.m_hPending.isEmpty()) && !d_ptr->m_pTimer->isActive())
+      d_ptr->m_pTimer->start();
+}
+
+void PresenceSubscriptions::setActive(ContactMethod* cm)
+{
+   if ((!cm) || !cm->account())
+      return;
+
+   const QString k = PresenceSubscriptionsPrivate::key(cm);
+   auto& s = d_ptr->m_hAccounts[cm->account()->id()];
+
+   s.m_lActive.insert(k);
+
+   // An unsubscription could still be pending
+   if (s.m_hPending.value(k, false))
+      s.m_hPending.remove(k);
+}
+
+int PresenceSubscriptions::pendingCount() const
+{
+   int ret = 0;
+
+   for (const auto& s : qAsConst(d_ptr->m_hAccounts))
+      ret += s.m_hPending.size();
+
+   return ret;
+}
+
+void PresenceSubscriptions::flush()
+{
+   int remaining = 0;
+
+   for (auto it = d_ptr->m_hAccounts.begin(); it != d_ptr->m_hAccounts.end();) {
+      // The daemon dropped the subscriptions along with the account
+      if (!Session::instance()->accountModel()->getById(it.key())) {
+         it = d_ptr->m_hAccounts.erase(it);
+         continue;
+      }
+
+      auto& s = it.value();
+      const QString accountId = QString::fromLatin1(it.key());
+
+      int sent = 0;
+
+      for (auto p = s.m_hPending.begin(); p != s.m_hPending.end() && sent < BATCH_SIZE; sent++) {
+         PresenceManager::instance().subscribeBuddy(accountId, p.key(), p.value());
+
+         if (p.value())
+            s.m_lActive.insert(p.key());
+         else
+            s.m_lActive.remove(p.key());
+
+         p = s.m_hPending.erase(p);
+      }
+
+      remaining += s.m_hPending.size();
+      ++it;
+   }
+
+   if (!remaining)
+      d_ptr->m_pTimer->stop();
+}
@@ -0,0 +1,69 @@
+/************************************************************************************
+ *   Copyright (C) 2018 by BlueSystems GmbH                                         *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                            *
+ *                                                                                  *
+ *   This library is free software; you can redistribute it and/or                  *
+ *   modify it under the terms of the GNU Lesser General Public                     *
+ *   License as published by the Free Software Foundation; either                   *
+ *   version 2.1 of the License, or (at your option) any later version.             *
+ *                                                                                  *
+ *   This library is distributed in the hope that it will be useful,                *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of                 *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU              *
+ *   Lesser General Public License for more details.                                *
+ *                                                                                  *
+ *   You should have received a copy of the GNU Lesser General Public               *
+ *   License along with this library; if not, write to the Free Software            *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA *
+ ***********************************************************************************/
+#pragma once
+
+// Qt
+#include <QtCore/QObject>
+
+class ContactMethod;
+class PresenceSubscriptionsPrivate;
+
+/**
+ * Keep the daemon presence subscriptions in sync with the tracked contact
+ * methods.
+ *
+ * ContactMethod::setTracked() only records the desired state. The difference
+ * with the subscriptions the daemon already has is sent later by a timer, at
+ * most BATCH_SIZE calls per account for each tick. Tracking (or untracking)
+ * thousands of contacts at once then neither floods the daemon nor blocks the
+ * event loop, and toggling a contact back and forth before the next tick
+ * costs nothing.
+ */
+class PresenceSubscriptions final : public QObject
+{
+   Q_OBJECT
+public:
+   /// The maximum number of subscribeBuddy() for each account and tick
+   static constexpr const int BATCH_SIZE = 32;
+
+   /// The delay between two batches, in milliseconds
+   static constexpr const int INTERVAL = 50;
+
+   static PresenceSubscriptions& instance();
+
+   /// Record the desired state, the daemon is updated later
+   void setTracked(ContactMethod* cm, bool track);
+
+   /// The daemon already has this subscription (account loading, Ring contacts)
+   void setActive(ContactMethod* cm);
+
+   /// The number of subscription changes not yet sent to the daemon
+   int pendingCount() const;
+
+public Q_SLOTS:
+   /// Send the next batch for each account
+   void flush();
+
+private:
+   explicit PresenceSubscriptions();
+   virtual ~PresenceSubscriptions();
+
+   PresenceSubscriptionsPrivate* d_ptr;
+   Q_DECLARE_PRIVATE(PresenceSubscriptions)
+};
@@ -22,12 +22,14 @@
 
 //Qt
 #include <QtCore/QAbstractListModel>
+#include <QtCore/QBitArray>
 #include <QtCore/QItemSelectionModel>
 #include <QtCore/QSortFilterProxyModel>
 
 //Ring
 #include "libcard/matrixutils.h"
 #include <contactmodel.h>
+#include <persondirectory.h>
 #include <callhistorymodel.h>
 #include <globalinstances.h>
 #include <session.h>
@@ -75,6 +77,30 @@ protected:
    virtual bool filterAcceptsRow ( int source_row, const QModelIndex & source_parent ) const override;
 };
 
+/**
+ * Use PersonDirectory::match() instead of normalizing the filter role of
+ * every person each time the filter changes.
+ *
+ * The matches are computed on the first row after the filter or the
+ * contacts changed, then each row only tests its bit.
+ */
+class ContactFilterProxy final : public RemoveDisabledProxy
+{
+   Q_OBJECT
+public:
+   explicit ContactFilterProxy(QObject* parent) : RemoveDisabledProxy(parent) {}
+
+   virtual void setSourceModel(QAbstractItemModel* source) override;
+protected:
+   virtual bool filterAcceptsRow ( int source_row, const QModelIndex & source_parent ) const override;
+private:
+   mutable QBitArray m_Matches;
+   mutable QString   m_Query;
+   mutable bool      m_IsValid {false};
+
+   void slotInvalidateMatches() { m_IsValid = false; }
+};
+
 class ContactSortingCategoryModel : public QAbstractListModel
 {
    Q_OBJECT
@@ -110,6 +136,55 @@ bool RemoveDisabledProxy::filterAcceptsRow ( int source_row, const QModelIndex &
    return QSortFilterProxyModel::filterAcceptsRow(source_row, source_parent);
 }
 
+void ContactFilterProxy::setSourceModel(QAbstractItemModel* source)
+{
+   if (sourceModel())
+      disconnect(sourceModel(), nullptr, this, nullptr);
+
+   // Connected before QSortFilterProxyModel so the rows are never tested
+   // against the stale matches
+   if (source) {
+      connect(source, &QAbstractItemModel::rowsInserted , this, &ContactFilterProxy::slotInvalidateMatches);
+      connect(source, &QAbstractItemModel::rowsRemoved  , this, &ContactFilterProxy::slotInvalidateMatches);
+      connect(source, &QAbstractItemModel::dataChanged  , this, &ContactFilterProxy::slotInvalidateMatches);
+      connect(source, &QAbstractItemModel::modelReset   , this, &ContactFilterProxy::slotInvalidateMatches);
+      connect(source, &QAbstractItemModel::layoutChanged, this, &ContactFilterProxy::slotInvalidateMatches);
+   }
+
+   RemoveDisabledProxy::setSourceModel(source);
+}
+
+bool ContactFilterProxy::filterAcceptsRow( int source_row, const QModelIndex & source_parent ) const
+{
+   const QRegExp& rx = filterRegExp();
+
+   // Only the plain text filters can use the index
+   if (rx.patternSyntax() != QRegExp::FixedString)
+      return RemoveDisabledProxy::filterAcceptsRow(source_row, source_parent);
+
+   const QModelIndex idx = sourceModel()->index(source_row, 0, source_parent);
+
+   if (!(idx.flags() & Qt::ItemIsEnabled))
+      return false;
+   else if (!source_parent.isValid() || source_parent.parent().isValid() || rx.isEmpty())
+      return true;
+
+   const auto p   = qvariant_cast<Person*>(idx.data(static_cast<int>(Ring::Role::Object)));
+   const auto dir = Session::instance()->personDirectory();
+   const int  row = p ? dir->indexOf(p) : -1;
+
+   if (row == -1)
+      return RemoveDisabledProxy::filterAcceptsRow(source_row, source_parent);
+
+   if ((!m_IsValid) || m_Query != rx.pattern() || row >= m_Matches.size()) {
+      m_Query   = rx.pattern();
+      m_Matches = dir->match(m_Query);
+      m_IsValid = true;
+   }
+
+   return row < m_Matches.size() && m_Matches.testBit(row);
+}
+
 ContactSortingCategoryModel::ContactSortingCategoryModel(QObject* parent) : QAbstractListModel(parent)
 {
 
@@ -255,14 +330,14 @@ bool HistorySortingCategoryModel::setData( const QModelIndex& index, const QVari
    return CategoryModelCommon::setData(index,value,role);
 }
 
-template<typename T>
+template<typename T, typename P = RemoveDisabledProxy>
 SortingCategory::ModelTuple* createModels(QAbstractItemModel* src, int filterRole, int sortRole, std::function<void(QSortFilterProxyModel*,const QModelIndex&)> callback)
 {
    SortingCategory::ModelTuple* ret = new SortingCategory::ModelTuple;
 
    ret->categories = new T(src);
 
-   QSortFilterProxyModel* proxy = new RemoveDisabledProxy(src);
+   QSortFilterProxyModel* proxy = new P(src);
    proxy->setSortRole              ( sortRole                  );
    proxy->setSortLocaleAware       ( true                      );
    proxy->setFilterRole            ( filterRole                );
@@ -281,7 +356,7 @@ SortingCategory::ModelTuple* createModels(QAbstractItemModel* src, int filterRol
 
 SortingCategory::ModelTuple* SortingCategory::getContactProxy()
 {
-   return createModels<ContactSortingCategoryModel>(Session::instance()->contactModel(),(int)Person::Role::Filter, Qt::DisplayRole, [](QSortFilterProxyModel* proxy,const QModelIndex& idx) {
+   return createModels<ContactSortingCategoryModel, ContactFilterProxy>(Session::instance()->contactModel(),(int)Person::Role::Filter, Qt::DisplayRole, [](QSortFilterProxyModel* proxy,const QModelIndex& idx) {
       if (idx.isValid()) {
          qDebug() << "Selection changed" << idx.row();
          sortContact(proxy,idx.row());
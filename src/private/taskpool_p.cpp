@@ -0,0 +1,301 @@
+/************************************************************************************
+ *   Copyright (C) 2018 by BlueSystems GmbH                                         *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                            *
+ *                                                                                  *
+ *   This library is free software; you can redistribute it and/or                  *
+ *   modify it under the terms of the GNU Lesser General Public                     *
+ *   License as published by the Free Software Foundation; either                   *
+ *   version 2.1 of the License, or (at your option) any later version.             *
+ *                                                                                  *
+ *   This library is distributed in the hope that it will be useful,                *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of                 *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU              *
+ *   Lesser General Public License for more details.                                *
+ *                                                                                  *
+ *   You should have received a copy of the GNU Lesser General Public               *
+ *   License along with this library; if not, write to the Free Software            *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA *
+ ***********************************************************************************/
+#include "taskpool_p.h"
+
+// Qt
+#include <QtCore/QCoreApplication>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QMutex>
+#include <QtCore/QPointer>
+#include <QtCore/QQueue>
+#include <QtCore/QThread>
+#include <QtCore/QVector>
+#include <QtCore/QWaitCondition>
+
+// Ring
+#include "tracer_p.h"
+
+struct TaskPoolTask
+{
+   std::function<void()> m_fTask ;
+   TaskPool::Token       m_Token ;
+   qint64                m_Queued;
+};
+
+struct TaskPoolContinuation
+{
+   QPointer<QObject>     m_pContext;
+   std::function<void()> m_fTask   ;
+};
+
+class TaskPoolWorker final : public QThread
+{
+public:
+   explicit TaskPoolWorker(TaskPoolPrivate* d) : m_pPool(d) {}
+
+   virtual void run() override;
+
+private:
+   TaskPoolPrivate* m_pPool;
+};
+
+class TaskPoolPrivate final : public QObject
+{
+   Q_OBJECT
+public:
+   static constexpr const int LANES = static_cast<int>(TaskPool::Lane::COUNT__);
+
+   mutable QMutex m_Mutex;
+   QWaitCondition m_Wake ;
+   QWaitCondition m_Idle ;
+   QElapsedTimer  m_Clock;
+
+   QQueue<TaskPoolTask>     m_lQueues   [LANES];
+   int                      m_Running   [LANES] {};
+   quint64                  m_Completed [LANES] {};
+   qint64                   m_Latency   [LANES] {};
+   QVector<QThread*>        m_lWorkers  ;
+   int                      m_BackgroundLimit {1};
+   bool                     m_Quit {false};
+
+   QVector<TaskPoolContinuation> m_lContinuations;
+   bool                          m_FlushQueued {false};
+
+   // Helpers
+   bool take(TaskPoolTask& task, int& lane);
+   void work();
+
+public Q_SLOTS:
+   void flush();
+};
+
+TaskPool::Token::Token() : m_pState(new State)
+{}
+
+void TaskPool::Token::cancel()
+{
+   m_pState->m_Cancelled.storeRelease(1);
+}
+
+bool TaskPool::Token::isCancelled() const
+{
+   return m_pState->m_Cancelled.loadAcquire();
+}
+
+int TaskPool::Token::pendingCount() const
+{
+   return m_pState->m_Pending.loadAcquire();
+}
+
+TaskPool::TaskPool() : QObject(nullptr), d_ptr(new TaskPoolPrivate)
+{
+   moveToThread(QCoreApplication::instance()->thread());
+   d_ptr->moveToThread(QCoreApplication::instance()->thread());
+
+   d_ptr->m_Clock.start();
+
+   const int count = qMax(2, QThread::idealThreadCount());
+
+   // Keep one worker for the interactive lane
+   d_ptr->m_BackgroundLimit = count - 1;
+
+   for (int i = 0; i < count; i++) {
+      auto w = new TaskPoolWorker(d_ptr);
+      w->setObjectName(QStringLiteral("TaskPool %1").arg(i));
+      d_ptr->m_lWorkers << w;
+      w->start();
+   }
+}
+
+TaskPool::~TaskPool()
+{
+   {
+      QMutexLocker l(&d_ptr->m_Mutex);
+      d_ptr->m_Quit = true;
+      d_ptr->m_Wake.wakeAll();
+   }
+
+   for (auto w : qAsConst(d_ptr->m_lWorkers)) {
+      w->wait();
+      delete w;
+   }
+
+   delete d_ptr;
+}
+
+TaskPool& TaskPool::instance()
+{
+   static auto instance = new TaskPool();
+   return *instance;
+}
+
+void TaskPoolWorker::run()
+{
+   RING_TRACE_THREAD_NAME("TaskPool worker");
+
+   m_pPool->work();
+}
+
+/// Must be called with the mutex held
+bool TaskPoolPrivate::take(TaskPoolTask& task, int& lane)
+{
+   static const int interactive = static_cast<int>(TaskPool::Lane::INTERACTIVE);
+   static const int background  = static_cast<int>(TaskPool::Lane::BACKGROUND );
+
+   if (!m_lQueues[interactive].isEmpty())
+      lane = interactive;
+   else if ((!m_lQueues[background].isEmpty()) && m_Running[background] < m_BackgroundLimit)
+      lane = background;
+   else
+      return false;
+
+   task = m_lQueues[lane].dequeue();
+
+   return true;
+}
+
+void TaskPoolPrivate::work()
+{
+   QMutexLocker l(&m_Mutex);
+
+   forever {
+      TaskPoolTask task;
+      int lane;
+
+      while ((!m_Quit) && !take(task, lane))
+         m_Wake.wait(&m_Mutex);
+
+      if (m_Quit)
+         return;
+
+      m_Running[lane]++;
+
+      // Exponential moving average, the last 8 tasks or so
+      m_Latency[lane] += ((m_Clock.elapsed() - task.m_Queued) - m_Latency[lane]) / 8;
+
+      l.unlock();
+
+      if (!task.m_Token.isCancelled())
+         task.m_fTask();
+
+      l.relock();
+
+      m_Running[lane]--;
+      m_Completed[lane]++;
+      task.m_Token.m_pState->m_Pending.deref();
+
+      // A background slot may be free again for another worker
+      m_Wake.wakeOne();
+      m_Idle.wakeAll();
+   }
+}
+
+void TaskPool::run(Lane lane, const std::function<void()>& task, const Token& token)
+{
+   QMutexLocker l(&d_ptr->m_Mutex);
+
+   token.m_pState->m_Pending.ref();
+
+   d_ptr->m_lQueues[static_cast<int>(lane)].enqueue({task, token, d_ptr->m_Clock.elapsed()});
+   d_ptr->m_Wake.wakeOne();
+}
+
+void TaskPool::run(Lane lane, const std::function<void()>& task, QObject* context,
+                   const std::function<void()>& then, const Token& token)
+{
+   const QPointer<QObject> ctx(context);
+
+   run(lane, [this, task, ctx, then, token]() {
+      task();
+
+      if (!token.isCancelled())
+         runInMainThread(ctx.data(), then);
+   }, token);
+}
+
+void TaskPool::runInMainThread(QObject* context, const std::function<void()>& f)
+{
+   QMutexLocker l(&d_ptr->m_Mutex);
+
+   d_ptr->m_lContinuations << TaskPoolContinuation {context, f};
+
+   if (!d_ptr->m_FlushQueued) {
+      d_ptr->m_FlushQueued = true;
+      QMetaObject::invokeMethod(d_ptr, "flush", Qt::QueuedConnection);
+   }
+}
+
+void TaskPoolPrivate::flush()
+{
+   QVector<TaskPoolContinuation> continuations;
+
+   {
+      QMutexLocker l(&m_Mutex);
+      continuations.swap(m_lContinuations);
+      m_FlushQueued = false;
+   }
+
+   for (const auto& c : qAsConst(continuations)) {
+      // The context was deleted in the meantime
+      if (c.m_pContext)
+         c.m_fTask();
+   }
+}
+
+void TaskPool::wait(const Token& token)
+{
+   // It would deadlock once all workers are waiting
+   Q_ASSERT(!d_ptr->m_lWorkers.contains(QThread::currentThread()));
+
+   QMutexLocker l(&d_ptr->m_Mutex);
+
+   while (token.pendingCount())
+      d_ptr->m_Idle.wait(&d_ptr->m_Mutex);
+}
+
+int TaskPool::workerCount() const
+{
+   return d_ptr->m_lWorkers.size();
+}
+
+int TaskPool::queueDepth(Lane lane) const
+{
+   QMutexLocker l(&d_ptr->m_Mutex);
+   return d_ptr->m_lQueues[static_cast<int>(lane)].size();
+}
+
+int TaskPool::activeCount(Lane lane) const
+{
+   QMutexLocker l(&d_ptr->m_Mutex);
+   return d_ptr->m_Running[static_cast<int>(lane)];
+}
+
+quint64 TaskPool::completedCount(Lane lane) const
+{
+   QMutexLocker l(&d_ptr->m_Mutex);
+   return d_ptr->m_Completed[static_cast<int>(lane)];
+}
+
+qint64 TaskPool::averageLatency(Lane lane) const
+{
+   QMutexLocker l(&d_ptr->m_Mutex);
+   return d_ptr->m_Latency[static_cast<int>(lane)];
+}
+
+#include "taskpool_p.moc"
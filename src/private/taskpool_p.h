@@ -0,0 +1,116 @@
+/************************************************************************************
+ *   Copyright (C) 2018 by BlueSystems GmbH                                         *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                            *
+ *                                                                                  *
+ *   This library is free software; you can redistribute it and/or                  *
+ *   modify it under the terms of the GNU Lesser General Public                     *
+ *   License as published by the Free Software Foundation; either                   *
+ *   version 2.1 of the License, or (at your option) any later version.             *
+ *                                                                                  *
+ *   This library is distributed in the hope that it will be useful,                *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of                 *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU              *
+ *   Lesser General Public License for more details.                                *
+ *                                                                                  *
+ *   You should have received a copy of the GNU Lesser General Public               *
+ *   License along with this library; if not, write to the Free Software            *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA *
+ ***********************************************************************************/
+#pragma once
+
+// Qt
+#include <QtCore/QObject>
+#include <QtCore/QSharedPointer>
+
+// Std
+#include <functional>
+
+class TaskPoolPrivate;
+
+/**
+ * The worker threads shared by the whole library.
+ *
+ * The collections, the importers and the caches used to create their own
+ * threads or QThreadPool. Each of them was reasonable on its own, but
+ * together they could start dozens of threads during startup. This pool
+ * has a fixed number of workers and two lanes:
+ *
+ *  * INTERACTIVE: something is waiting for the result (a photo being
+ *    displayed, a message being formatted). Always dequeued first.
+ *  * BACKGROUND: loading, scanning and other I/O. It can use all the
+ *    workers but one, so there is always a thread left for the
+ *    interactive tasks.
+ *
+ * A task can be given a Token. Cancelling it skips the tasks of this token
+ * which did not start yet and the running ones can poll isCancelled() to
+ * stop early. wait() blocks until all tasks of a token are done, it is
+ * meant for destructors.
+ *
+ * The continuations passed to run() are called in the main thread, but
+ * only if their context object still exists and the token wasn't
+ * cancelled.
+ */
+class TaskPool final : public QObject
+{
+   Q_OBJECT
+public:
+   enum class Lane {
+      INTERACTIVE,
+      BACKGROUND ,
+      COUNT__
+   };
+
+   class Token final
+   {
+   public:
+      Token();
+
+      void cancel();
+      bool isCancelled() const;
+
+      /// The number of tasks not finished yet
+      int pendingCount() const;
+
+   private:
+      friend class TaskPool;
+      friend class TaskPoolPrivate;
+
+      struct State {
+         QAtomicInt m_Cancelled;
+         QAtomicInt m_Pending  ;
+      };
+
+      QSharedPointer<State> m_pState;
+   };
+
+   static TaskPool& instance();
+
+   /// Run `task` on a worker
+   void run(Lane lane, const std::function<void()>& task, const Token& token = {});
+
+   /// Run `task` on a worker, then `then` in the main thread
+   void run(Lane lane, const std::function<void()>& task, QObject* context,
+            const std::function<void()>& then, const Token& token = {});
+
+   /// Call `f` in the main thread if `context` still exists by then
+   void runInMainThread(QObject* context, const std::function<void()>& f);
+
+   /// Block until all the tasks of `token` are done
+   void wait(const Token& token);
+
+   // Counters
+   int     workerCount   (         ) const;
+   int     queueDepth    (Lane lane) const;
+   int     activeCount   (Lane lane) const;
+   quint64 completedCount(Lane lane) const;
+
+   /// The moving average of the time spent in the queue, in milliseconds
+   qint64 averageLatency(Lane lane) const;
+
+private:
+   explicit TaskPool();
+   virtual ~TaskPool();
+
+   TaskPoolPrivate* d_ptr;
+   Q_DECLARE_PRIVATE(TaskPool)
+};
@@ -120,4 +120,5 @@ struct TextMessageNode
     QVariant roleData(int role) const;
     QVariant snapshotRoleData(int role) const;
     bool setRoleData(int role, const QVariant& value);
+    void prefetchNeighbors() const;
 };
@@ -31,11 +31,13 @@
 #include "accountmodel.h"
 #include "eventmodel.h"
 #include "libcard/private/event_p.h"
+#include "libcard/private/eventstore.h"
 #include "libcard/calendar.h"
 #include "media/file.h"
 #include "availableaccountmodel.h"
 #include <collections/localtextrecordingcollection.h>
 #include "individualdirectory.h"
+#include "private/messagesearchindex_p.h"
 
 QHash<QByteArray, QWeakPointer<Serializable::Peers>> SerializableEntityManager::m_hPeers;
 
@@ -168,8 +170,10 @@ Serializable::Group::Group(Account* a, const QString& path) : m_pAccount(a), m_P
 
 Serializable::Group::~Group()
 {
-    for (auto m : qAsConst(messages))
+    for (auto m : qAsConst(messages)) {
+        MessageSearchIndex::instance().remove(m.first);
         delete m.first;
+    }
 }
 
 const QList< QPair<Media::MimeMessage*, ContactMethod*> >& Serializable::Group::messagesRef() const
@@ -212,18 +216,17 @@ void Serializable::Group::addMessage(Media::MimeMessage* m, ContactMethod* peer)
     addPeer(peer);
 
     messages.append({m, peer});
+
+    MessageSearchIndex::instance().add(m);
 }
 
 void Serializable::Group::reloadAttendees() const
 {
     if (m_pParent && m_pEvent) {
-        m_pEvent->d_ptr->m_lAttendees.clear();
+        EventStore::instance().clearAttendees(m_pEvent->d_ptr->m_Row);
 
-        for (auto peer : qAsConst(m_pParent->peers)) {
-             m_pEvent->d_ptr->m_lAttendees << QPair<ContactMethod*, QString> {
-                 peer, ""
-             };
-        }
+        for (auto peer : qAsConst(m_pParent->peers))
+            EventStore::instance().addAttendee(m_pEvent->d_ptr->m_Row, peer, {});
     }
 }
 
@@ -513,7 +516,7 @@ QSharedPointer<Event> Serializable::Group::event(bool allowPlaceholders) const
     }
 
     // Build an event;
-    EventPrivate ev;
+    EventAttributes ev;
 
     Q_ASSERT(!m_Path.isEmpty());
 
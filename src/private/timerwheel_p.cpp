@@ -0,0 +1,346 @@
+/************************************************************************************
+ *   Copyright (C) 2018 by BlueSystems GmbH                                         *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                            *
+ *                                                                                  *
+ *   This library is free software; you can redistribute it and/or                  *
+ *   modify it under the terms of the GNU Lesser General Public                     *
+ *   License as published by the Free Software Foundation; either                   *
+ *   version 2.1 of the License, or (at your option) any later version.             *
+ *                                                                                  *
+ *   This library is distributed in the hope that it will be useful,                *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of                 *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU              *
+ *   Lesser General Public License for more details.                                *
+ *                                                                                  *
+ *   You should have received a copy of the GNU Lesser General Public               *
+ *   License along with this library; if not, write to the Free Software            *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA *
+ ***********************************************************************************/
+#include "timerwheel_p.h"
+
+// Qt
+#include <QtCore/QTimer>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/qalgorithms.h>
+
+static constexpr int     LEVELS     = 3 ;
+static constexpr int     SLOT_BITS  = 6 ;
+static constexpr int     SLOTS      = 1 << SLOT_BITS;
+static constexpr quint64 SLOT_MASK  = SLOTS - 1;
+
+/// The furthest tick each level can hold relative to the current one
+static constexpr qint64 LEVEL_SPAN[LEVELS] = {
+   qint64(1) << (1*SLOT_BITS),
+   qint64(1) << (2*SLOT_BITS),
+   qint64(1) << (3*SLOT_BITS),
+};
+
+struct TimerWheel::Entry final
+{
+   Entry*                m_pPrev    {nullptr};
+   Entry*                m_pNext    {nullptr};
+   qint64                m_Expiry   {   0   };
+   int                   m_Level    {  -1   }; /*!< -1 when not armed */
+   int                   m_Slot     {  -1   };
+   std::function<void()> m_fCallback{       };
+};
+
+class TimerWheelPrivate final
+{
+public:
+   typedef TimerWheel::Entry Entry;
+
+   Entry*  m_lSlots   [LEVELS][SLOTS] {};
+   quint64 m_Occupied [LEVELS]        {}; /*!< One bit per non empty slot */
+
+   QTimer        m_Timer;
+   QElapsedTimer m_Clock;
+   qint64        m_CurrentTick {0};
+   qint64        m_NextWake    {-1};
+   int           m_Resolution;
+   int           m_Count       {0};
+   bool          m_Advancing   {false};
+
+   TimerWheel::Statistics m_Stats;
+
+   // Helpers
+   void insert(Entry* e);
+   void unlink(Entry* e);
+   void cascade(int level);
+   void advance(qint64 tick);
+   qint64 nextWakeTick() const;
+   void reschedule();
+   qint64 now() const;
+
+   static void _test_cascade();
+
+   TimerWheel* q_ptr;
+};
+
+TimerWheel::TimerWheel(int resolution, QObject* parent) : QObject(parent),
+d_ptr(new TimerWheelPrivate)
+{
+   d_ptr->q_ptr        = this;
+   d_ptr->m_Resolution = qMax(1, resolution);
+   d_ptr->m_Timer.setSingleShot(true);
+   d_ptr->m_Clock.start();
+
+#ifdef ENABLE_TEST_ASSERTS
+   static bool tested = (TimerWheelPrivate::_test_cascade(), true);
+   Q_UNUSED(tested)
+#endif
+
+   connect(&d_ptr->m_Timer, &QTimer::timeout, this, [this]() {
+      d_ptr->m_NextWake = -1;
+      d_ptr->m_Stats.wakeups++;
+      d_ptr->advance(d_ptr->now());
+      d_ptr->reschedule();
+   });
+}
+
+TimerWheel::~TimerWheel()
+{
+   delete d_ptr;
+}
+
+TimerWheel& TimerWheel::instance()
+{
+   // Never deleted. The holders may be destroyed after the QCoreApplication
+   // (statics, late QML engines) and still need to destroy() their entries.
+   static auto w = new TimerWheel(250);
+   return *w;
+}
+
+qint64 TimerWheelPrivate::now() const
+{
+   return m_Clock.elapsed() / m_Resolution;
+}
+
+void TimerWheelPrivate::insert(Entry* e)
+{
+   const qint64 delta = e->m_Expiry - m_CurrentTick;
+
+   int level = 0;
+
+   while (level < LEVELS - 1 && delta >= LEVEL_SPAN[level])
+      level++;
+
+   // Beyond the last level, park it in the furthest slot. It will be
+   // cascaded again until it fits.
+   const qint64 at = delta >= LEVEL_SPAN[LEVELS - 1] ?
+      m_CurrentTick + LEVEL_SPAN[LEVELS - 1] - 1 : e->m_Expiry;
+
+   const int slot = (at >> (level * SLOT_BITS)) & SLOT_MASK;
+
+   e->m_Level = level;
+   e->m_Slot  = slot;
+   e->m_pPrev = nullptr;
+   e->m_pNext = m_lSlots[level][slot];
+
+   if (e->m_pNext)
+      e->m_pNext->m_pPrev = e;
+
+   m_lSlots[level][slot] = e;
+   m_Occupied[level] |= quint64(1) << slot;
+}
+
+void TimerWheelPrivate::unlink(Entry* e)
+{
+   if (e->m_Level == -1)
+      return;
+
+   if (e->m_pPrev)
+      e->m_pPrev->m_pNext = e->m_pNext;
+   else
+      m_lSlots[e->m_Level][e->m_Slot] = e->m_pNext;
+
+   if (e->m_pNext)
+      e->m_pNext->m_pPrev = e->m_pPrev;
+
+   if (!m_lSlots[e->m_Level][e->m_Slot])
+      m_Occupied[e->m_Level] &= ~(quint64(1) << e->m_Slot);
+
+   e->m_pPrev = e->m_pNext = nullptr;
+   e->m_Level = e->m_Slot  = -1;
+}
+
+/// Move the entries of the current slot of `level` into the lower levels
+void TimerWheelPrivate::cascade(int level)
+{
+   const int slot = (m_CurrentTick >> (level * SLOT_BITS)) & SLOT_MASK;
+
+   while (Entry* e = m_lSlots[level][slot]) {
+      unlink(e);
+      insert(e);
+   }
+}
+
+void TimerWheelPrivate::advance(qint64 tick)
+{
+   // When a callback arms an entry, it doesn't need to catch up
+   if (m_Advancing)
+      return;
+
+   m_Advancing = true;
+
+   while (m_CurrentTick < tick) {
+      m_CurrentTick++;
+
+      // The highest level first so its entries can land in level 0
+      for (int l = LEVELS - 1; l > 0; l--) {
+         if (!(m_CurrentTick & (LEVEL_SPAN[l-1] - 1)))
+            cascade(l);
+      }
+
+      const int slot = m_CurrentTick & SLOT_MASK;
+
+      // The callbacks can arm and cancel, including entries of this slot
+      while (Entry* e = m_lSlots[0][slot]) {
+         unlink(e);
+         m_Count--;
+
+         m_Stats.fired++;
+         m_Stats.maxLateness = qMax(
+            m_Stats.maxLateness, m_Clock.elapsed() - e->m_Expiry * m_Resolution
+         );
+
+         e->m_fCallback();
+      }
+   }
+
+   m_Advancing = false;
+}
+
+/// The tick at which the wheel has something to do
+qint64 TimerWheelPrivate::nextWakeTick() const
+{
+   // The next cascade of level 1 (which is also when level 2 cascades)
+   const qint64 cascade = (m_CurrentTick | (LEVEL_SPAN[0] - 1)) + 1;
+
+   if (!m_Occupied[0])
+      return cascade;
+
+   // Rotate so bit 0 is the slot after the current one
+   const int     s = (m_CurrentTick + 1) & SLOT_MASK;
+   const quint64 r = (m_Occupied[0] >> s) | (m_Occupied[0] << ((SLOTS - s) & SLOT_MASK));
+   const qint64  next = m_CurrentTick + 1 + qCountTrailingZeroBits(r);
+
+   // The cascaded entries can be due before the next level 0 slot
+   return (m_Occupied[1] || m_Occupied[2]) ? qMin(next, cascade) : next;
+}
+
+/// Extra code for the integration tests, a cascade must not be skipped
+void TimerWheelPrivate::_test_cascade()
+{
+#ifdef ENABLE_TEST_ASSERTS
+   TimerWheelPrivate w;
+   w.m_Resolution = 1;
+   w.m_Clock.start();
+
+   qint64 wake(0), fired[2] = {-1, -1};
+
+   Entry e1, e2;
+   e1.m_fCallback = [&wake, &fired]() { fired[0] = wake; };
+   e2.m_fCallback = [&wake, &fired]() { fired[1] = wake; };
+
+   // Arm 64 ticks at tick 0, then 62 ticks at tick 5
+   e1.m_Expiry = 64;
+   w.insert(&e1);
+   w.advance(5);
+   e2.m_Expiry = w.m_CurrentTick + 62;
+   w.insert(&e2);
+
+   // Do what the QTimer would
+   while (w.m_Occupied[0] || w.m_Occupied[1] || w.m_Occupied[2])
+      w.advance(wake = w.nextWakeTick());
+
+   Q_ASSERT(fired[0] == 64);
+   Q_ASSERT(fired[1] == 67);
+#endif
+}
+
+void TimerWheelPrivate::reschedule()
+{
+   if (!m_Count) {
+      m_Timer.stop();
+      m_NextWake = -1;
+      return;
+   }
+
+   const qint64 next = nextWakeTick();
+
+   if (m_Timer.isActive() && m_NextWake != -1 && m_NextWake <= next)
+      return;
+
+   m_NextWake = next;
+   m_Timer.start(qMax<qint64>(0, next * m_Resolution - m_Clock.elapsed()));
+}
+
+TimerWheel::Entry* TimerWheel::create(const std::function<void()>& callback)
+{
+   auto e = new Entry;
+   e->m_fCallback = callback;
+   return e;
+}
+
+void TimerWheel::destroy(Entry* e)
+{
+   cancel(e);
+   delete e;
+}
+
+void TimerWheel::arm(Entry* e, int msec)
+{
+   // Catch up first, otherwise the entry would be placed relative to a
+   // stale current tick.
+   d_ptr->advance(d_ptr->now());
+
+   if (e->m_Level != -1) {
+      d_ptr->unlink(e);
+      d_ptr->m_Count--;
+   }
+
+   // Round up, never expire early
+   const qint64 ticks = qMax<qint64>(1, (msec + d_ptr->m_Resolution - 1) / d_ptr->m_Resolution);
+
+   e->m_Expiry = d_ptr->m_CurrentTick + ticks;
+
+   d_ptr->insert(e);
+   d_ptr->m_Count++;
+   d_ptr->m_Stats.armed++;
+
+   d_ptr->reschedule();
+}
+
+void TimerWheel::cancel(Entry* e)
+{
+   if (e->m_Level == -1)
+      return;
+
+   d_ptr->unlink(e);
+   d_ptr->m_Count--;
+
+   // Let the timer fire once for nothing rather than recomputing
+   if (!d_ptr->m_Count)
+      d_ptr->reschedule();
+}
+
+bool TimerWheel::isArmed(Entry* e) const
+{
+   return e->m_Level != -1;
+}
+
+int TimerWheel::armedCount() const
+{
+   return d_ptr->m_Count;
+}
+
+int TimerWheel::resolution() const
+{
+   return d_ptr->m_Resolution;
+}
+
+TimerWheel::Statistics TimerWheel::statistics() const
+{
+   return d_ptr->m_Stats;
+}
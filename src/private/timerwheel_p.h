@@ -0,0 +1,77 @@
+/************************************************************************************
+ *   Copyright (C) 2018 by BlueSystems GmbH                                         *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                            *
+ *                                                                                  *
+ *   This library is free software; you can redistribute it and/or                  *
+ *   modify it under the terms of the GNU Lesser General Public                     *
+ *   License as published by the Free Software Foundation; either                   *
+ *   version 2.1 of the License, or (at your option) any later version.             *
+ *                                                                                  *
+ *   This library is distributed in the hope that it will be useful,                *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of                 *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU              *
+ *   Lesser General Public License for more details.                                *
+ *                                                                                  *
+ *   You should have received a copy of the GNU Lesser General Public               *
+ *   License along with this library; if not, write to the Free Software            *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA *
+ ***********************************************************************************/
+#pragma once
+
+#include <QtCore/QObject>
+
+// Std
+#include <functional>
+
+class TimerWheelPrivate;
+
+/**
+ * A hierarchical timer wheel for many low precision timeouts.
+ *
+ * The timeouts are rounded up to the wheel resolution and sorted into three
+ * levels of 64 slots. Arming and canceling are O(1) and a single QTimer is
+ * used for all of them. It only wakes up when a slot is due (or when a higher
+ * level needs to be cascaded), so idle wheels cost nothing.
+ *
+ * The entries are owned by the caller. They must be destroyed with
+ * destroy(), which also cancels them.
+ *
+ * This class must only be used from the thread owning it.
+ */
+class TimerWheel final : public QObject
+{
+   Q_OBJECT
+public:
+   struct Entry;
+
+   struct Statistics {
+      quint64 armed      {0}; /*!< Number of arm() calls                   */
+      quint64 fired      {0}; /*!< Number of expired entries               */
+      quint64 wakeups    {0}; /*!< Number of times the wheel was advanced  */
+      qint64  maxLateness{0}; /*!< Worst delay past a deadline, in ms      */
+   };
+
+   explicit TimerWheel(int resolution = 250, QObject* parent = nullptr);
+   virtual ~TimerWheel();
+
+   /// A wheel shared by the components without timing requirements, it
+   /// outlives the QCoreApplication
+   static TimerWheel& instance();
+
+   Entry* create (const std::function<void()>& callback);
+   void   destroy(Entry* e);
+
+   /// (Re)start the entry, it will expire in `msec` milliseconds or later
+   void arm(Entry* e, int msec);
+   void cancel(Entry* e);
+
+   bool isArmed(Entry* e) const;
+   int armedCount() const;
+   int resolution() const;
+
+   Statistics statistics() const;
+
+private:
+   TimerWheelPrivate* d_ptr;
+   Q_DECLARE_PRIVATE(TimerWheel)
+};
@@ -0,0 +1,297 @@
+/************************************************************************************
+ *   Copyright (C) 2018 by BlueSystems GmbH                                         *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                            *
+ *                                                                                  *
+ *   This library is free software; you can redistribute it and/or                  *
+ *   modify it under the terms of the GNU Lesser General Public                     *
+ *   License as published by the Free Software Foundation; either                   *
+ *   version 2.1 of the License, or (at your option) any later version.             *
+ *                                                                                  *
+ *   This library is distributed in the hope that it will be useful,                *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of                 *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU              *
+ *   Lesser General Public License for more details.                                *
+ *                                                                                  *
+ *   You should have received a copy of the GNU Lesser General Public               *
+ *   License along with this library; if not, write to the Free Software            *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA *
+ ***********************************************************************************/
+#include "tracer_p.h"
+
+#ifdef ENABLE_TRACING
+
+// Qt
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDebug>
+#include <QtCore/QMutex>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QSaveFile>
+#include <QtCore/QSet>
+
+// Std
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+struct TraceEvent final
+{
+   const char* m_pCategory;
+   const char* m_pName    ;
+   const char* m_pDetail  ;
+   qint64      m_Begin    ;
+   qint64      m_End      ;
+};
+
+/**
+ * The spans of a single thread.
+ *
+ * Only the owner thread writes. The chunks are never moved nor freed, so
+ * the exporter can read everything up to the published count of each
+ * chunk while the owner keeps appending.
+ */
+struct TraceBuffer final
+{
+   static constexpr const int CHUNK_SIZE = 4096;
+
+   /// About 10MB per thread, enough for the startup and then some
+   static constexpr const int MAX_CHUNKS = 64;
+
+   struct Chunk final {
+      TraceEvent          m_lEvents[CHUNK_SIZE];
+      std::atomic<int>    m_Count {  0    };
+      std::atomic<Chunk*> m_pNext {nullptr};
+   };
+
+   Chunk*                   m_pFirst    {new Chunk};
+   Chunk*                   m_pLast     {m_pFirst };
+   int                      m_Chunks    {   1     };
+   int                      m_Tid       {   0     };
+   std::atomic<const char*> m_pThreadName{nullptr};
+};
+
+class TracerPrivate final
+{
+public:
+   static QMutex                    m_Mutex        ;
+   static QMutex                    m_StringsMutex ;
+   static std::vector<TraceBuffer*> m_lBuffers     ;
+   static QSet<QByteArray>          m_lStrings     ;
+   static std::atomic<quint64>      m_Dropped      ;
+
+   static thread_local TraceBuffer* t_pBuffer;
+
+   static TraceBuffer* buffer();
+   static void escape(QByteArray& out, const char* str);
+};
+
+QMutex                    TracerPrivate::m_Mutex        ;
+QMutex                    TracerPrivate::m_StringsMutex ;
+std::vector<TraceBuffer*> TracerPrivate::m_lBuffers     ;
+QSet<QByteArray>          TracerPrivate::m_lStrings     ;
+std::atomic<quint64>      TracerPrivate::m_Dropped      {0};
+
+thread_local TraceBuffer* TracerPrivate::t_pBuffer {nullptr};
+
+// Taken when the library is loaded, so the timeline starts before main()
+static const auto s_Epoch = std::chrono::steady_clock::now();
+
+/// The buffers outlive their thread, the spans of finished threads are kept
+TraceBuffer* TracerPrivate::buffer()
+{
+   if (Q_LIKELY(t_pBuffer))
+      return t_pBuffer;
+
+   t_pBuffer = new TraceBuffer;
+
+   QMutexLocker l(&m_Mutex);
+   m_lBuffers.push_back(t_pBuffer);
+   t_pBuffer->m_Tid = static_cast<int>(m_lBuffers.size());
+
+   return t_pBuffer;
+}
+
+qint64 Tracer::now()
+{
+   return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - s_Epoch
+   ).count();
+}
+
+void Tracer::record(const char* category, const char* name, const char* detail, qint64 begin, qint64 end)
+{
+   auto b     = TracerPrivate::buffer();
+   auto chunk = b->m_pLast;
+   int  count = chunk->m_Count.load(std::memory_order_relaxed);
+
+   if (Q_UNLIKELY(count == TraceBuffer::CHUNK_SIZE)) {
+      if (b->m_Chunks == TraceBuffer::MAX_CHUNKS) {
+         TracerPrivate::m_Dropped.fetch_add(1, std::memory_order_relaxed);
+         return;
+      }
+
+      auto next = new TraceBuffer::Chunk;
+      chunk->m_pNext.store(next, std::memory_order_release);
+      b->m_pLast = chunk = next;
+      b->m_Chunks++;
+      count = 0;
+   }
+
+   chunk->m_lEvents[count] = {category, name, detail, begin, end};
+
+   // Publish the event to the exporter
+   chunk->m_Count.store(count + 1, std::memory_order_release);
+}
+
+const char* Tracer::intern(const QByteArray& str)
+{
+   if (str.isEmpty())
+      return nullptr;
+
+   // Not the buffers mutex, the exporter holds it for a while
+   QMutexLocker l(&TracerPrivate::m_StringsMutex);
+
+   auto it = TracerPrivate::m_lStrings.constFind(str);
+
+   if (it == TracerPrivate::m_lStrings.constEnd()) {
+      // Something is interning unbounded values (like ids), keep the memory
+      // bounded
+      if (TracerPrivate::m_lStrings.size() >= MAX_STRINGS)
+         return "(too many strings)";
+
+      it = TracerPrivate::m_lStrings.insert(str);
+   }
+
+   // The QSet moves the QByteArray, not their data
+   return it->constData();
+}
+
+const char* Tracer::intern(const QString& str)
+{
+   return intern(str.toUtf8());
+}
+
+void Tracer::setThreadName(const char* name)
+{
+   TracerPrivate::buffer()->m_pThreadName.store(name, std::memory_order_release);
+}
+
+quint64 Tracer::droppedCount()
+{
+   return TracerPrivate::m_Dropped.load(std::memory_order_relaxed);
+}
+
+void TracerPrivate::escape(QByteArray& out, const char* str)
+{
+   out += '"';
+
+   for (const char* c = str; c && *c; c++) {
+      switch(*c) {
+         case '"' : out += "\\\""; break;
+         case '\\': out += "\\\\"; break;
+         case '\n': out += "\\n" ; break;
+         case '\t': out += "\\t" ; break;
+         default:
+            if (static_cast<unsigned char>(*c) < 0x20)
+               out += QByteArray("\\u00") + QByteArray::number(*c, 16).rightJustified(2, '0');
+            else
+               out += *c;
+      }
+   }
+
+   out += '"';
+}
+
+/**
+ * Use the "complete" (X) events, the spans are recorded once they end so
+ * there is no begin/end pairing to do.
+ *
+ * @see https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU
+ */
+bool Tracer::exportTrace(const QString& path)
+{
+   QSaveFile file(path);
+
+   if (!file.open(QIODevice::WriteOnly)) {
+      qWarning() << "Unable to write the trace" << path;
+      return false;
+   }
+
+   const QByteArray pid = QByteArray::number(QCoreApplication::applicationPid());
+
+   QMutexLocker l(&TracerPrivate::m_Mutex);
+
+   file.write("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+   bool first = true;
+   QByteArray line;
+
+   const auto append = [&file, &first, &line]() {
+      if (!first)
+         file.write(",\n");
+
+      file.write(line);
+      first = false;
+      line.clear();
+   };
+
+   for (const auto b : TracerPrivate::m_lBuffers) {
+      const QByteArray tid = QByteArray::number(b->m_Tid);
+
+      if (auto name = b->m_pThreadName.load(std::memory_order_acquire)) {
+         line += "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":" + pid + ",\"tid\":" + tid + ",\"args\":{\"name\":";
+         TracerPrivate::escape(line, name);
+         line += "}}";
+         append();
+      }
+
+      for (auto chunk = b->m_pFirst; chunk; chunk = chunk->m_pNext.load(std::memory_order_acquire)) {
+         const int count = chunk->m_Count.load(std::memory_order_acquire);
+
+         for (int i = 0; i < count; i++) {
+            const auto& e = chunk->m_lEvents[i];
+
+            line += "{\"ph\":\"X\",\"cat\":";
+            TracerPrivate::escape(line, e.m_pCategory);
+            line += ",\"name\":";
+            TracerPrivate::escape(line, e.m_pName);
+            line += ",\"pid\":" + pid + ",\"tid\":" + tid;
+            line += ",\"ts\":"  + QByteArray::number(e.m_Begin / 1000.0, 'f', 3);
+            line += ",\"dur\":" + QByteArray::number((e.m_End - e.m_Begin) / 1000.0, 'f', 3);
+
+            if (e.m_pDetail) {
+               line += ",\"args\":{\"detail\":";
+               TracerPrivate::escape(line, e.m_pDetail);
+               line += '}';
+            }
+
+            line += '}';
+            append();
+         }
+      }
+   }
+
+   file.write("\n]}\n");
+
+   if (const auto dropped = droppedCount())
+      qWarning() << "The trace is incomplete," << dropped << "spans were dropped";
+
+   return file.commit();
+}
+
+void Tracer::exportOnExit()
+{
+   static bool installed = false;
+
+   const QString path = QString::fromLocal8Bit(qgetenv("RING_TRACE_FILE"));
+
+   if (installed || path.isEmpty() || !QCoreApplication::instance())
+      return;
+
+   installed = true;
+
+   QObject::connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, [path]() {
+      Tracer::exportTrace(path);
+   });
+}
+
+#endif
@@ -0,0 +1,142 @@
+/************************************************************************************
+ *   Copyright (C) 2018 by BlueSystems GmbH                                         *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                            *
+ *                                                                                  *
+ *   This library is free software; you can redistribute it and/or                  *
+ *   modify it under the terms of the GNU Lesser General Public                     *
+ *   License as published by the Free Software Foundation; either                   *
+ *   version 2.1 of the License, or (at your option) any later version.             *
+ *                                                                                  *
+ *   This library is distributed in the hope that it will be useful,                *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of                 *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU              *
+ *   Lesser General Public License for more details.                                *
+ *                                                                                  *
+ *   You should have received a copy of the GNU Lesser General Public               *
+ *   License along with this library; if not, write to the Free Software            *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA *
+ ***********************************************************************************/
+#pragma once
+
+/**
+ * Timing spans for the startup and the hot paths.
+ *
+ * The tracer only exists when the library is built with ENABLE_TRACING.
+ * Otherwise all the macros below expand to nothing, including their
+ * arguments, so the instrumentation can stay in place.
+ *
+ * Each thread records into its own append-only buffer. Recording a span is
+ * two clock reads and a store, there is no lock and no allocation beside a
+ * new chunk every few thousand spans. The names must be string literals
+ * (or Tracer::intern()ed strings), they are stored as pointers.
+ *
+ * The details can also be a QString or a QByteArray. Those are interned,
+ * which takes a lock, and only the first MAX_STRINGS of them are kept. Use
+ * them for things like loading a collection, the hot paths should pass a
+ * string literal.
+ *
+ * When the RING_TRACE_FILE environment variable is set, the spans are
+ * written to that file when the application quits. The format is the Chrome
+ * trace event JSON, it can be opened in chrome://tracing or
+ * https://ui.perfetto.dev
+ *
+ * Usage:
+ *
+ *    RING_TRACE_SPAN("collection", "load");
+ *    RING_TRACE_SPAN_ARG("calendar", "load", account->id());
+ *
+ *    // When the end happens in another scope (like a reply)
+ *    const qint64 begin = RING_TRACE_NOW();
+ *    ...
+ *    RING_TRACE_COMPLETE("ipc", "getCallDetails", callId, begin);
+ */
+
+// Qt
+#include <QtCore/QtGlobal>
+
+#ifdef ENABLE_TRACING
+
+// Qt
+#include <QtCore/QString>
+#include <QtCore/QByteArray>
+
+class Tracer final
+{
+public:
+   /// Record the time between its construction and destruction
+   class Span final
+   {
+   public:
+      explicit Span(const char* category, const char* name, const char* detail = nullptr) :
+         m_pCategory(category), m_pName(name), m_pDetail(detail), m_Begin(Tracer::now()) {}
+
+      ~Span() {
+         Tracer::record(m_pCategory, m_pName, m_pDetail, m_Begin, Tracer::now());
+      }
+
+   private:
+      Q_DISABLE_COPY(Span)
+
+      const char* m_pCategory;
+      const char* m_pName    ;
+      const char* m_pDetail  ;
+      qint64      m_Begin    ;
+   };
+
+   /// Nanoseconds since the library was loaded
+   static qint64 now();
+
+   /// Add a span to the current thread buffer
+   static void record(const char* category, const char* name, const char* detail, qint64 begin, qint64 end);
+
+   /// The number of distinct interned strings, the others are replaced
+   static constexpr const int MAX_STRINGS = 1024;
+
+   /// Keep a copy of `str` for the lifetime of the process
+   static const char* intern(const QByteArray& str);
+   static const char* intern(const QString& str);
+
+   /// A string literal, it is used as-is
+   static const char* intern(const char* str) { return str; }
+
+   /// Name the current thread in the exported timeline
+   static void setThreadName(const char* name);
+
+   /// Write all the spans recorded so far as Chrome trace event JSON
+   static bool exportTrace(const QString& path);
+
+   /// Export to RING_TRACE_FILE when the application quits, if it is set
+   static void exportOnExit();
+
+   /// The number of spans lost because a thread buffer was full
+   static quint64 droppedCount();
+};
+
+#define RING_TRACE_CAT_(a, b) a ## b
+#define RING_TRACE_CAT(a, b) RING_TRACE_CAT_(a, b)
+
+#define RING_TRACE_SPAN(category, name) \
+   Tracer::Span RING_TRACE_CAT(ringTraceSpan, __LINE__) (category, name)
+
+#define RING_TRACE_SPAN_ARG(category, name, detail) \
+   Tracer::Span RING_TRACE_CAT(ringTraceSpan, __LINE__) (category, name, Tracer::intern(detail))
+
+#define RING_TRACE_NOW() Tracer::now()
+
+#define RING_TRACE_COMPLETE(category, name, detail, begin) \
+   Tracer::record(category, name, Tracer::intern(detail), begin, Tracer::now())
+
+#define RING_TRACE_THREAD_NAME(name) Tracer::setThreadName(name)
+
+#define RING_TRACE_INIT() Tracer::exportOnExit()
+
+#else
+
+#define RING_TRACE_SPAN(category, name)
+#define RING_TRACE_SPAN_ARG(category, name, detail)
+#define RING_TRACE_NOW() qint64(0)
+#define RING_TRACE_COMPLETE(category, name, detail, begin) Q_UNUSED(begin)
+#define RING_TRACE_THREAD_NAME(name)
+#define RING_TRACE_INIT()
+
+#endif
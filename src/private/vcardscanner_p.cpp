@@ -0,0 +1,657 @@
+/************************************************************************************
+ *   Copyright (C) 2018 by BlueSystems GmbH                                         *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                            *
+ *                                                                                  *
+ *   This library is free software; you can redistribute it and/or                  *
+ *   modify it under the terms of the GNU Lesser General Public                     *
+ *   License as published by the Free Software Foundation; either                   *
+ *   version 2.1 of the License, or (at your option) any later version.             *
+ *                                                                                  *
+ *   This library is distributed in the hope that it will be useful,                *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of                 *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU              *
+ *   Lesser General Public License for more details.                                *
+ *                                                                                  *
+ *   You should have received a copy of the GNU Lesser General Public               *
+ *   License along with this library; if not, write to the Free Software            *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA *
+ ***********************************************************************************/
+#include "vcardscanner_p.h"
+
+// Qt
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDataStream>
+#include <QtCore/QDateTime>
+#include <QtCore/QDebug>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QFileSystemWatcher>
+#include <QtCore/QMutex>
+#include <QtCore/QSaveFile>
+#include <QtCore/QSet>
+#include <QtCore/QStandardPaths>
+#include <QtCore/QThread>
+#include <QtCore/QTimer>
+#include <QtCore/QVector>
+
+// Std
+#include <functional>
+
+// Ring
+#include "person.h"
+#include "private/taskpool_p.h"
+#include "private/vcardutils.h"
+
+typedef QList<QPair<QByteArray, QByteArray>> VCardFields;
+
+struct VCardScanResult
+{
+   enum class Type {
+      ADDED   , /*!< A new file, m_pPerson is set            */
+      MODIFIED, /*!< A known file changed, m_Content is set  */
+      REMOVED , /*!< A known file is gone                    */
+      TOUCHED , /*!< Only the time changed, update the entry */
+   };
+
+   Type                m_Type    ;
+   QString             m_Name    ;
+   VCardScanner::Entry m_Entry   ;
+   Person*             m_pPerson {nullptr};
+   QByteArray          m_Content ;
+   QByteArray          m_Fields  ; /*!< The packed fields, when parsed */
+};
+
+/// A file to read, or to create from the fields of the last session
+struct VCardScanJob
+{
+   QString             m_Name  ;
+   VCardScanner::Entry m_Entry ;
+   QByteArray          m_Fields;
+};
+
+class VCardScannerPrivate final : public QObject
+{
+   Q_OBJECT
+public:
+   explicit VCardScannerPrivate(VCardScanner* q) : QObject(q), q_ptr(q) {}
+
+   static constexpr quint32 MAGIC   = 0x5256434d; // "RVCM"
+   static constexpr quint32 VERSION = 2;
+
+   typedef QHash<QString, VCardScanner::Entry> Manifest;
+   typedef QVector<VCardScanJob> Batch;
+
+   // Main thread only
+   QString             m_Path              ;
+   Manifest            m_hManifest         ;
+   QFileSystemWatcher* m_pWatcher {nullptr};
+   QTimer*             m_pTimer   {nullptr};
+   bool                m_Running  {false  };
+   bool                m_Rescan   {false  };
+   bool                m_Seeded   {false  };
+
+   // Shared with the tasks
+   QMutex                   m_Mutex              ;
+   QVector<VCardScanResult> m_lResults           ;
+   int                      m_Pending     {0    };
+   bool                     m_FlushQueued {false};
+   TaskPool::Token          m_Token              ;
+
+   // Shared with the save tasks, protected by m_SaveMutex
+   QMutex                     m_SaveMutex         ;
+   QMutex                     m_WriteMutex        ;
+   Manifest                   m_hUnsaved          ;
+   QHash<QString, QByteArray> m_hFields           ;
+   bool                       m_HasUnsaved {false};
+   TaskPool::Token            m_SaveToken         ;
+
+   VCardScanner* q_ptr;
+
+   // Helpers
+   static QString manifestPath(const QString& path);
+   static QByteArray pack(const VCardFields& fields);
+   static bool unpack(const QByteArray& packed, VCardFields* fields);
+   static bool readManifest(const QString& path, Manifest* entries, QHash<QString, QByteArray>* fields);
+   void saveManifest();
+   void writeManifest();
+   void watchFiles();
+   void start(const std::function<void()>& f);
+   void list(Manifest known, bool seed);
+   void parse(const Batch& batch);
+   void push(const QVector<VCardScanResult>& results);
+
+public Q_SLOTS:
+   void flush();
+};
+
+constexpr quint32 VCardScannerPrivate::MAGIC;
+constexpr quint32 VCardScannerPrivate::VERSION;
+
+VCardScanner::VCardScanner(const QString& path, QObject* parent) : QObject(parent),
+d_ptr(new VCardScannerPrivate(this))
+{
+   d_ptr->m_Path = path;
+}
+
+VCardScanner::~VCardScanner()
+{
+   d_ptr->m_Token.cancel();
+   TaskPool::instance().wait(d_ptr->m_Token);
+
+   // Let the last manifest be written, it's cheap compared to a full parse
+   TaskPool::instance().wait(d_ptr->m_SaveToken);
+
+   // Never delivered
+   for (const auto& r : qAsConst(d_ptr->m_lResults))
+      delete r.m_pPerson;
+}
+
+QString VCardScannerPrivate::manifestPath(const QString& path)
+{
+   const QByteArray name = QCryptographicHash::hash(
+      QDir(path).absolutePath().toUtf8(), QCryptographicHash::Sha1
+   ).toHex();
+
+   return QStandardPaths::writableLocation(QStandardPaths::DataLocation)
+      + QStringLiteral("/vcardmanifest/")
+      + QString::fromLatin1(name)
+      + QStringLiteral(".bin");
+}
+
+QByteArray VCardScannerPrivate::pack(const VCardFields& fields)
+{
+   QByteArray ret;
+
+   QDataStream s(&ret, QIODevice::WriteOnly);
+   s.setVersion(QDataStream::Qt_5_6);
+
+   s << quint32(fields.size());
+
+   for (const auto& pair : qAsConst(fields))
+      s << pair.first << pair.second;
+
+   return ret;
+}
+
+bool VCardScannerPrivate::unpack(const QByteArray& packed, VCardFields* fields)
+{
+   QDataStream s(packed);
+   s.setVersion(QDataStream::Qt_5_6);
+
+   quint32 count(0);
+   s >> count;
+
+   // Append as they are read, the count can't be trusted for an allocation
+   for (quint32 i = 0; i < count && s.status() == QDataStream::Ok; i++) {
+      QByteArray key, value;
+      s >> key >> value;
+      fields->append({key, value});
+   }
+
+   return s.status() == QDataStream::Ok && s.atEnd();
+}
+
+/// Read the manifest of the last session, in the pool
+bool VCardScannerPrivate::readManifest(const QString& path, Manifest* entries, QHash<QString, QByteArray>* fields)
+{
+   QFile file(manifestPath(path));
+
+   if (!file.open(QIODevice::ReadOnly))
+      return false;
+
+   QDataStream s(&file);
+   s.setVersion(QDataStream::Qt_5_6);
+
+   quint32 magic(0), version(0), count(0);
+   s >> magic >> version >> count;
+
+   if (s.status() != QDataStream::Ok || magic != MAGIC || version != VERSION)
+      return false;
+
+   Manifest                   ret;
+   QHash<QString, QByteArray> retFields;
+
+   for (quint32 i = 0; i < count && s.status() == QDataStream::Ok; i++) {
+      QString             name;
+      VCardScanner::Entry e;
+      QByteArray          packed;
+
+      s >> name >> e.m_Modified >> e.m_Size >> e.m_Hash >> packed;
+
+      ret[name] = e;
+
+      if (fields && !packed.isEmpty())
+         retFields[name] = packed;
+   }
+
+   if (s.status() != QDataStream::Ok || !s.atEnd()) {
+      qWarning() << "The vCard manifest is corrupted" << file.fileName();
+      return false;
+   }
+
+   *entries = ret;
+
+   if (fields)
+      *fields = retFields;
+
+   return true;
+}
+
+/// Write the manifest in the pool, the fields of the files which were not
+/// parsed in this session are copied from the previous manifest
+void VCardScannerPrivate::saveManifest()
+{
+   {
+      QMutexLocker l(&m_SaveMutex);
+      m_hUnsaved   = m_hManifest;
+      m_HasUnsaved = true;
+   }
+
+   TaskPool::instance().run(TaskPool::Lane::BACKGROUND, [this]() {
+      writeManifest();
+   }, m_SaveToken);
+}
+
+void VCardScannerPrivate::writeManifest()
+{
+   // Held for the whole write so the saves can't be reordered
+   QMutexLocker w(&m_WriteMutex);
+
+   Manifest                   manifest;
+   QHash<QString, QByteArray> fresh;
+
+   {
+      QMutexLocker l(&m_SaveMutex);
+
+      // A later task already wrote the latest state
+      if (!m_HasUnsaved)
+         return;
+
+      manifest     = m_hUnsaved;
+      fresh        = m_hFields;
+      m_HasUnsaved = false;
+   }
+
+   Manifest                   old;
+   QHash<QString, QByteArray> oldFields;
+   readManifest(m_Path, &old, &oldFields);
+
+   const QString path = manifestPath(m_Path);
+
+   QDir().mkpath(QFileInfo(path).absolutePath());
+
+   QSaveFile file(path);
+
+   if (!file.open(QIODevice::WriteOnly)) {
+      qWarning() << "Unable to save the vCard manifest" << file.fileName();
+      return;
+   }
+
+   QDataStream s(&file);
+   s.setVersion(QDataStream::Qt_5_6);
+
+   s << MAGIC << VERSION << quint32(manifest.size());
+
+   for (auto i = manifest.constBegin(); i != manifest.constEnd(); ++i) {
+      QByteArray packed = fresh.value(i.key());
+
+      // Only if it is the same file, otherwise it will be parsed next time
+      if (packed.isEmpty() && old.contains(i.key()) && old[i.key()].m_Hash == i->m_Hash)
+         packed = oldFields.value(i.key());
+
+      s << i.key() << i->m_Modified << i->m_Size << i->m_Hash << packed;
+   }
+
+   if (!file.commit()) {
+      qWarning() << "Unable to save the vCard manifest" << file.fileName();
+      return;
+   }
+
+   // They are now in the file, unless they changed again in the meantime
+   QMutexLocker l(&m_SaveMutex);
+
+   for (auto i = fresh.constBegin(); i != fresh.constEnd(); ++i) {
+      if (m_hFields.value(i.key()) == i.value())
+         m_hFields.remove(i.key());
+   }
+}
+
+/// Must be called with the mutex held
+void VCardScannerPrivate::start(const std::function<void()>& f)
+{
+   m_Pending++;
+
+   TaskPool::instance().run(TaskPool::Lane::BACKGROUND, [this, f]() {
+      f();
+
+      QMutexLocker l(&m_Mutex);
+
+      m_Pending--;
+
+      if (!m_FlushQueued) {
+         m_FlushQueued = true;
+         QMetaObject::invokeMethod(this, "flush", Qt::QueuedConnection);
+      }
+   }, m_Token);
+}
+
+void VCardScanner::scan()
+{
+   if (QThread::currentThread() != thread()) {
+      QMetaObject::invokeMethod(this, "scan", Qt::QueuedConnection);
+      return;
+   }
+
+   // Wait for the current scan to be delivered, otherwise the same files
+   // would be reported twice
+   if (d_ptr->m_Running) {
+      d_ptr->m_Rescan = true;
+      return;
+   }
+
+   d_ptr->m_Running = true;
+
+   // The first scan starts from the manifest of the last session
+   const bool seed = !d_ptr->m_Seeded;
+   d_ptr->m_Seeded = true;
+
+   const auto known = d_ptr->m_hManifest;
+
+   QMutexLocker l(&d_ptr->m_Mutex);
+   d_ptr->start([this, known, seed]() { d_ptr->list(known, seed); });
+}
+
+/// Compare the directory with the manifest, in the pool
+void VCardScannerPrivate::list(Manifest known, bool seed)
+{
+   QVector<VCardScanResult> results;
+   Batch batch;
+
+   // The files not delivered yet in this session but unchanged since the
+   // last one are created from their saved fields
+   Manifest                   saved;
+   QHash<QString, QByteArray> savedFields;
+
+   if (seed)
+      readManifest(m_Path, &saved, &savedFields);
+
+   const QFileInfoList files = QDir(m_Path).entryInfoList({QStringLiteral("*.vcf")}, QDir::Files);
+
+   for (const QFileInfo& fi : files) {
+      VCardScanner::Entry e {fi.lastModified().toMSecsSinceEpoch(), fi.size(), {}};
+
+      const auto it = known.find(fi.fileName());
+
+      if (it != known.end()) {
+         const bool unchanged = it->m_Modified == e.m_Modified && it->m_Size == e.m_Size;
+
+         // Keep the hash to detect the files which were only touched
+         e.m_Hash = it->m_Hash;
+         known.erase(it);
+
+         if (unchanged)
+            continue;
+      }
+      else if (saved.contains(fi.fileName())) {
+         const auto& old = saved[fi.fileName()];
+
+         if (old.m_Modified == e.m_Modified && old.m_Size == e.m_Size && savedFields.contains(fi.fileName())) {
+            batch << VCardScanJob {fi.fileName(), old, savedFields[fi.fileName()]};
+            continue;
+         }
+      }
+
+      batch << VCardScanJob {fi.fileName(), e, {}};
+   }
+
+   for (auto i = known.constBegin(); i != known.constEnd(); ++i)
+      results << VCardScanResult {VCardScanResult::Type::REMOVED, i.key(), {}, nullptr, {}, {}};
+
+   if (m_Token.isCancelled())
+      return;
+
+   QMutexLocker l(&m_Mutex);
+
+   for (int i = 0; i < batch.size(); i += VCardScanner::CHUNK_SIZE) {
+      const Batch chunk = batch.mid(i, VCardScanner::CHUNK_SIZE);
+      start([this, chunk]() { parse(chunk); });
+   }
+
+   l.unlock();
+
+   push(results);
+}
+
+/// Read and parse the changed files, in the pool
+void VCardScannerPrivate::parse(const Batch& batch)
+{
+   QVector<VCardScanResult> results;
+   results.reserve(batch.size());
+
+   const QDir dir(m_Path);
+
+   for (const auto& job : batch) {
+      if (m_Token.isCancelled())
+         break;
+
+      VCardScanResult r {VCardScanResult::Type::ADDED, job.m_Name, job.m_Entry, nullptr, {}, {}};
+
+      // Unchanged since the last session
+      if (!job.m_Fields.isEmpty()) {
+         VCardFields fields;
+
+         if (unpack(job.m_Fields, &fields)) {
+            r.m_pPerson = new Person();
+            VCardUtils::mapToPerson(r.m_pPerson, fields);
+            results << r;
+            continue;
+         }
+
+         // Read the file instead
+         r.m_Entry.m_Hash.clear();
+      }
+
+      QFile file(dir.absoluteFilePath(job.m_Name));
+
+      // It may have been deleted since, the next scan will notice
+      if (!file.open(QIODevice::ReadOnly))
+         continue;
+
+      r.m_Content = file.readAll();
+
+      const QByteArray oldHash = r.m_Entry.m_Hash;
+      r.m_Entry.m_Hash = QCryptographicHash::hash(r.m_Content, QCryptographicHash::Sha1).toHex();
+
+      if (oldHash.isEmpty()) {
+         const VCardFields fields = VCardUtils::parseFields(r.m_Content);
+         r.m_pPerson = new Person();
+         VCardUtils::mapToPerson(r.m_pPerson, fields);
+         r.m_Fields = pack(fields);
+         r.m_Content.clear();
+      }
+      else if (oldHash == r.m_Entry.m_Hash) {
+         r.m_Type = VCardScanResult::Type::TOUCHED;
+         r.m_Content.clear();
+      }
+      else {
+         r.m_Type   = VCardScanResult::Type::MODIFIED;
+         r.m_Fields = pack(VCardUtils::parseFields(r.m_Content));
+      }
+
+      results << r;
+   }
+
+   push(results);
+}
+
+void VCardScannerPrivate::push(const QVector<VCardScanResult>& results)
+{
+   if (results.isEmpty())
+      return;
+
+   QMutexLocker l(&m_Mutex);
+   m_lResults << results;
+}
+
+/// Deliver the results, in the main thread
+void VCardScannerPrivate::flush()
+{
+   QVector<VCardScanResult> results;
+   bool done;
+
+   {
+      QMutexLocker l(&m_Mutex);
+      results.swap(m_lResults);
+      m_FlushQueued = false;
+      done = !m_Pending;
+   }
+
+   {
+      QMutexLocker l(&m_SaveMutex);
+
+      for (const auto& r : qAsConst(results)) {
+         if (!r.m_Fields.isEmpty())
+            m_hFields[r.m_Name] = r.m_Fields;
+         else if (r.m_Type == VCardScanResult::Type::REMOVED)
+            m_hFields.remove(r.m_Name);
+      }
+   }
+
+   for (const auto& r : qAsConst(results)) {
+      const QString path = QDir(m_Path).absoluteFilePath(r.m_Name);
+
+      switch(r.m_Type) {
+         case VCardScanResult::Type::ADDED:
+            m_hManifest[r.m_Name] = r.m_Entry;
+            emit q_ptr->added(path, r.m_pPerson);
+            break;
+         case VCardScanResult::Type::MODIFIED:
+            m_hManifest[r.m_Name] = r.m_Entry;
+            emit q_ptr->modified(path, r.m_Content);
+            break;
+         case VCardScanResult::Type::REMOVED:
+            m_hManifest.remove(r.m_Name);
+            emit q_ptr->removed(path);
+            break;
+         case VCardScanResult::Type::TOUCHED:
+            m_hManifest[r.m_Name] = r.m_Entry;
+            break;
+      }
+   }
+
+   if (!done)
+      return;
+
+   m_Running = false;
+   saveManifest();
+   watchFiles();
+
+   if (m_Rescan) {
+      m_Rescan = false;
+      q_ptr->scan();
+   }
+}
+
+/// Watch the files of the manifest, the directory doesn't change when a
+/// file is modified in place
+void VCardScannerPrivate::watchFiles()
+{
+   if (!m_pWatcher)
+      return;
+
+   const QDir dir(m_Path);
+
+   QSet<QString> wanted;
+   wanted.reserve(m_hManifest.size());
+
+   for (auto i = m_hManifest.constBegin(); i != m_hManifest.constEnd(); ++i)
+      wanted << dir.absoluteFilePath(i.key());
+
+   QSet<QString> watched = m_pWatcher->files().toSet();
+
+   const QStringList stale = (watched - wanted).toList();
+   const QStringList added = (wanted - watched).toList();
+
+   if (!stale.isEmpty())
+      m_pWatcher->removePaths(stale);
+
+   if (!added.isEmpty())
+      m_pWatcher->addPaths(added);
+}
+
+void VCardScanner::commit(const QString& path, const QByteArray& content)
+{
+   const QFileInfo fi(path);
+
+   if (fi.absolutePath() != QDir(d_ptr->m_Path).absolutePath())
+      return;
+
+   d_ptr->m_hManifest[fi.fileName()] = {
+      fi.lastModified().toMSecsSinceEpoch(),
+      fi.size(),
+      QCryptographicHash::hash(content, QCryptographicHash::Sha1).toHex()
+   };
+
+   {
+      QMutexLocker l(&d_ptr->m_SaveMutex);
+      d_ptr->m_hFields[fi.fileName()] = VCardScannerPrivate::pack(VCardUtils::parseFields(content));
+   }
+
+   if (d_ptr->m_pWatcher && !d_ptr->m_pWatcher->files().contains(fi.absoluteFilePath()))
+      d_ptr->m_pWatcher->addPath(fi.absoluteFilePath());
+}
+
+void VCardScanner::forget(const QString& path)
+{
+   const QFileInfo fi(path);
+
+   d_ptr->m_hManifest.remove(fi.fileName());
+
+   {
+      QMutexLocker l(&d_ptr->m_SaveMutex);
+      d_ptr->m_hFields.remove(fi.fileName());
+   }
+
+   if (d_ptr->m_pWatcher)
+      d_ptr->m_pWatcher->removePath(fi.absoluteFilePath());
+}
+
+void VCardScanner::setWatched(bool watched)
+{
+   if (QThread::currentThread() != thread()) {
+      QMetaObject::invokeMethod(this, "setWatched", Qt::QueuedConnection, Q_ARG(bool, watched));
+      return;
+   }
+
+   if (watched == !!d_ptr->m_pWatcher)
+      return;
+
+   if (!watched) {
+      delete d_ptr->m_pWatcher;
+      delete d_ptr->m_pTimer;
+      d_ptr->m_pWatcher = nullptr;
+      d_ptr->m_pTimer   = nullptr;
+      return;
+   }
+
+   // Editors often write many files in a row, wait for them to settle
+   d_ptr->m_pTimer = new QTimer(d_ptr);
+   d_ptr->m_pTimer->setSingleShot(true);
+   d_ptr->m_pTimer->setInterval(WATCH_DELAY);
+   connect(d_ptr->m_pTimer, &QTimer::timeout, this, &VCardScanner::scan);
+
+   d_ptr->m_pWatcher = new QFileSystemWatcher({d_ptr->m_Path}, d_ptr);
+   connect(d_ptr->m_pWatcher, &QFileSystemWatcher::directoryChanged,
+      d_ptr->m_pTimer, static_cast<void(QTimer::*)()>(&QTimer::start));
+
+   // The scan compares the size and the time, so it also finds the files
+   // edited in place
+   connect(d_ptr->m_pWatcher, &QFileSystemWatcher::fileChanged,
+      d_ptr->m_pTimer, static_cast<void(QTimer::*)()>(&QTimer::start));
+
+   if (!d_ptr->m_Running)
+      d_ptr->watchFiles();
+}
+
+#include "vcardscanner_p.moc"
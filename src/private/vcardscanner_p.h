@@ -0,0 +1,92 @@
+/************************************************************************************
+ *   Copyright (C) 2018 by BlueSystems GmbH                                         *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                            *
+ *                                                                                  *
+ *   This library is free software; you can redistribute it and/or                  *
+ *   modify it under the terms of the GNU Lesser General Public                     *
+ *   License as published by the Free Software Foundation; either                   *
+ *   version 2.1 of the License, or (at your option) any later version.             *
+ *                                                                                  *
+ *   This library is distributed in the hope that it will be useful,                *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of                 *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU              *
+ *   Lesser General Public License for more details.                                *
+ *                                                                                  *
+ *   You should have received a copy of the GNU Lesser General Public               *
+ *   License along with this library; if not, write to the Free Software            *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA *
+ ***********************************************************************************/
+#pragma once
+
+// Qt
+#include <QtCore/QObject>
+#include <QtCore/QHash>
+
+class Person;
+class VCardScannerPrivate;
+
+/**
+ * Keep the content of a vCard directory in sync with a collection.
+ *
+ * A manifest of the files already loaded (modification time, size and
+ * content hash) is kept. A scan only reads the files whose size or time
+ * changed and only parses those whose content really did. The work is
+ * split in chunks of CHUNK_SIZE files and runs on the background lane of
+ * the TaskPool, so a large tree of directories no longer means a thread
+ * for each of them.
+ *
+ * When watched, the directory and the files are watched. The directory is
+ * scanned again after either changes and only the difference is reported.
+ *
+ * scan() and setWatched() can be called from any thread (like from
+ * CollectionInterface::load()), they are forwarded to the scanner thread.
+ *
+ * The manifest is saved after each scan along with the parsed fields of
+ * each file. The first scan starts from it, the files whose size and time
+ * didn't change since the last session are created from their saved fields
+ * instead of being read and parsed again.
+ */
+class VCardScanner final : public QObject
+{
+   Q_OBJECT
+public:
+   /// The number of files parsed by a single task
+   static constexpr const int CHUNK_SIZE = 64;
+
+   /// The delay between a directory change and the scan, in milliseconds
+   static constexpr const int WATCH_DELAY = 500;
+
+   struct Entry {
+      qint64     m_Modified;
+      qint64     m_Size    ;
+      QByteArray m_Hash    ;
+   };
+
+   explicit VCardScanner(const QString& path, QObject* parent = nullptr);
+   virtual ~VCardScanner();
+
+   /// Record a file written by the collection itself, so it isn't reloaded
+   void commit(const QString& path, const QByteArray& content);
+
+   /// Record a file deleted by the collection itself
+   void forget(const QString& path);
+
+public Q_SLOTS:
+   /// Look for changes, the signals are emitted as the files are parsed
+   void scan();
+
+   /// Scan again each time the directory changes
+   void setWatched(bool watched);
+
+Q_SIGNALS:
+   /// A new file, `p` is owned by the receiver
+   void added(const QString& path, Person* p);
+   /// The content of a file already reported by added() changed
+   void modified(const QString& path, const QByteArray& content);
+   /// A file reported by added() was deleted
+   void removed(const QString& path);
+
+private:
+   VCardScannerPrivate* d_ptr;
+   Q_DECLARE_PRIVATE(VCardScanner)
+};
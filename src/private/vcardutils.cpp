@@ -31,10 +31,9 @@
 #include "contactmethod.h"
 #include "address.h"
 #include "accountmodel.h"
-#include "globalinstances.h"
 #include "individual.h"
-#include "interfaces/pixmapmanipulatori.h"
 #include "persondirectory.h"
+#include "private/person_p.h"
 #include "session.h"
 
 /* https://www.ietf.org/rfc/rfc2045.txt
@@ -150,8 +149,11 @@ struct VCardMapper final {
          break;
       }
 
-      QVariant photo = GlobalInstances::pixmapManipulator().personPhoto(fn,type);
-      c->setPhoto(photo);
+      // Decoding is slow and most photos are never displayed, keep the bytes
+      // until Person::photo() is called
+      c->d_ptr->setEncodedPhoto(fn, type);
+      c->d_ptr->changed();
+      c->d_ptr->photoChanged();
    }
 
    void addContactMethod(Person* c, const QString& key, const QByteArray& fn) {
@@ -298,14 +300,14 @@ void VCardUtils::addContactMethod(const QString& type, const QString& num)
    addProperty(prop.toLatin1(), num);
 }
 
-void VCardUtils::addPhoto(const QByteArray img)
+void VCardUtils::addPhoto(const QByteArray img, const QByteArray& type)
 {
     const auto base64 = img.toBase64().trimmed();
-    static auto header = QString::fromUtf8(Property::PHOTO) +
+    const auto header = QString::fromUtf8(Property::PHOTO) +
                 QString::fromUtf8(Delimiter::SEPARATOR_TOKEN) +
                 "ENCODING=BASE64" +
                 QString::fromUtf8(Delimiter::SEPARATOR_TOKEN) +
-                "TYPE=PNG:";
+                "TYPE=" + QString::fromLatin1(type) + ':';
 
     const int offset = 76 - header.size();
 
@@ -392,8 +394,12 @@ parseFields(const QByteArray& all)
 //TODO use QStringRef
 bool VCardUtils::mapToPerson(Person* p, const QByteArray& all, QList<Account*>* accounts)
 {
-    const auto fields = parseFields(all);
+    return mapToPerson(p, parseFields(all), accounts);
+}
 
+///Map fields already split by parseFields()
+bool VCardUtils::mapToPerson(Person* p, const QList<QPair<QByteArray, QByteArray> >& fields, QList<Account*>* accounts)
+{
     for (const auto& pair : qAsConst(fields)) {
         if (pair.first.size())
             vc_mapper->metacall(p, pair.first, pair.second);
@@ -74,7 +74,7 @@ public:
    void addEmail(const QString& type, const QString& num);
    void addAddress(Address* addr);
    void addContactMethod(const QString& type, const QString& num);
-   void addPhoto(const QByteArray img);
+   void addPhoto(const QByteArray img, const QByteArray& type = "PNG");
    const QByteArray endVCard();
 
    //Loading
@@ -83,6 +83,7 @@ public:
    //Mapping
    static bool mapToPerson(Person* p, const QUrl& url, QList<Account*>* accounts = nullptr);
    static bool mapToPerson(Person* p, const QByteArray& content, QList<Account*>* accounts = nullptr);
+   static bool mapToPerson(Person* p, const QList<QPair<QByteArray, QByteArray> >& fields, QList<Account*>* accounts = nullptr);
    static Person* mapToPerson(const QHash<QByteArray, QByteArray>& vCard, QList<Account*>* accounts = nullptr);
    static Person* mapToPersonFromReceivedProfile(ContactMethod *contactMethod, const QByteArray& payload);
    static Person* mapToPerson(const QByteArray& payload, bool purgeUntrusted = false);
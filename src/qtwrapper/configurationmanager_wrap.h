@@ -87,14 +87,14 @@ public:
                 [this] (const std::string &accountID, const std::string& registration_state,
                         unsigned detail_code,
                         const std::string& detail_str) {
-                    Q_EMIT this->registrationStateChanged(QString(accountID.c_str()),
-                                                          QString(registration_state.c_str()),
+                    Q_EMIT this->registrationStateChanged(QString::fromStdString(accountID),
+                                                          QString::fromStdString(registration_state),
                                                           detail_code,
-                                                          QString(detail_str.c_str()));
+                                                          QString::fromStdString(detail_str));
                 }),
             exportable_callback<ConfigurationSignal::VolatileDetailsChanged>(
                 [this] (const std::string &accountID, const std::map<std::string, std::string>& details) {
-                    Q_EMIT this->volatileAccountDetailsChanged(QString(accountID.c_str()), convertMap(details));
+                    Q_EMIT this->volatileAccountDetailsChanged(QString::fromStdString(accountID), convertMap(details));
                 }),
             exportable_callback<ConfigurationSignal::Error>(
                 [this] (int code) {
@@ -114,14 +114,12 @@ public:
                 }),
             exportable_callback<ConfigurationSignal::CertificateStateChanged>(
                 [this] (const std::string &accountID, const std::string &certId, const std::string &state) {
-                    QTimer::singleShot(
-                        0, [this, accountID, certId, state] {
-                            Q_EMIT this->certificateStateChanged(QString(accountID.c_str()), QString(certId.c_str()), QString(state.c_str()));
-                        });
+                    // Moved to the main thread by DaemonSignalBridge
+                    Q_EMIT this->certificateStateChanged(QString::fromStdString(accountID), QString::fromStdString(certId), QString::fromStdString(state));
                 }),
             exportable_callback<DRing::ConfigurationSignal::AccountMessageStatusChanged>(
                 [this] (const std::string& accountID, uint64_t id, const std::string& to, int status) {
-                    Q_EMIT this->accountMessageStatusChanged(QString(accountID.c_str()), id, QString(to.c_str()), status);
+                    Q_EMIT this->accountMessageStatusChanged(QString::fromStdString(accountID), id, QString::fromStdString(to), status);
                 }),
             exportable_callback<ConfigurationSignal::IncomingTrustRequest>(
                 [this] (const std::string &accountId, const std::string &certId, const std::vector<uint8_t> &payload, time_t timestamp) {
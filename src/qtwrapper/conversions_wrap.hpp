@@ -42,7 +42,7 @@
 inline MapStringString convertMap(const std::map<std::string, std::string>& m) {
    MapStringString temp;
    for (const auto& x : m) {
-      temp[QString(x.first.c_str())] = QString(x.second.c_str());
+      temp[QString::fromStdString(x.first)] = QString::fromStdString(x.second);
    }
    return temp;
 }
@@ -59,7 +59,7 @@ public:
                 }),
             exportable_callback<PresenceSignal::NewBuddyNotification>(
                 [this] (const std::string &accountID, const std::string &buddyUri, bool status, const std::string &lineStatus) {
-                    Q_EMIT this->newBuddyNotification(QString(accountID.c_str()), QString(buddyUri.c_str()), status, QString(lineStatus.c_str()));
+                    Q_EMIT this->newBuddyNotification(QString::fromStdString(accountID), QString::fromStdString(buddyUri), status, QString::fromStdString(lineStatus));
                 }),
             exportable_callback<PresenceSignal::SubscriptionStateChanged>(
                 [this] (const std::string &accountID, const std::string &buddyUri, bool state) {
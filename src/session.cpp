@@ -40,7 +40,10 @@
 #include "infotemplatemanager.h"
 #include "numbercompletionmodel.h"
 #include "recentfilemodel.h"
+#include "datatransfermodel.h"
 #include "video/devicemodel.h"
+#include "modelprofiler.h"
+#include "private/tracer_p.h"
 
 class SessionPrivate {
 public:
@@ -64,9 +67,20 @@ public:
     InfoTemplateManager*   m_pInfoTemplateManager   {nullptr};
     NumberCompletionModel* m_pNumberCompletionModel {nullptr};
     RecentFileModel*       m_pRecentFileModel       {nullptr};
+    DataTransferModel*     m_pDataTransferModel     {nullptr};
     Video::DeviceModel*    m_pDeviceModel           {nullptr};
 };
 
+/// Count the notifications of the models when RING_MODEL_PROFILE is set
+static void watchModel(QObject* o, const char* name)
+{
+    if (!ModelProfiler::isRequested())
+        return;
+
+    if (auto m = qobject_cast<QAbstractItemModel*>(o))
+        ModelProfiler::instance().watch(m, QString::fromLatin1(name));
+}
+
 // The code was too repetitive, changing one detail meant copy/pasting the
 // same change too many time.
 #define ACCESS(type, prop, name, parent) \
@@ -77,12 +91,18 @@ public:
     \
     static std::atomic_flag test_recurse = ATOMIC_FLAG_INIT; \
     Q_ASSERT(!test_recurse.test_and_set()); \
+    RING_TRACE_SPAN("session", #prop); \
     d_ptr->name = new type();\
     d_ptr->name->setParent((QObject*) Session:: parent ());\
+    watchModel(d_ptr->name, #prop);\
     return d_ptr->name;}
 
 Session::Session(QObject* parent) : QObject(parent), d_ptr(new SessionPrivate())
 {
+    RING_TRACE_THREAD_NAME("main");
+    RING_TRACE_INIT();
+    RING_TRACE_SPAN("session", "registerCommTypes");
+
     registerCommTypes();
 }
 
@@ -119,6 +139,7 @@ ACCESS(Video::PreviewManager, previewManager       , m_pPreviewManager       , i
 ACCESS(InfoTemplateManager  , infoTemplateManager  , m_pInfoTemplateManager  , instance           )
 ACCESS(NumberCompletionModel, numberCompletionModel, m_pNumberCompletionModel, individualDirectory)
 ACCESS(RecentFileModel      , recentFileModel      , m_pRecentFileModel      , instance           )
+ACCESS(DataTransferModel    , dataTransferModel    , m_pDataTransferModel    , instance           )
 ACCESS(Video::DeviceModel   , deviceModel          , m_pDeviceModel          , instance           )
 
 QAbstractItemModel* Session::sortedContactModel() const
@@ -44,6 +44,7 @@ class PersonDirectory;
 class InfoTemplateManager;
 class NumberCompletionModel;
 class RecentFileModel;
+class DataTransferModel;
 
 namespace Media {
 class RecordingModel;
@@ -82,6 +83,7 @@ public:
     Q_PROPERTY(InfoTemplateManager* infoTemplateManager READ infoTemplateManager CONSTANT)
     Q_PROPERTY(NumberCompletionModel* numberCompletionModel READ numberCompletionModel CONSTANT)
     Q_PROPERTY(RecentFileModel* recentFileModel READ recentFileModel CONSTANT)
+    Q_PROPERTY(DataTransferModel* dataTransferModel READ dataTransferModel CONSTANT)
     Q_PROPERTY(Video::DeviceModel* deviceModel READ deviceModel CONSTANT)
 
     Q_PROPERTY(QAbstractItemModel* contactCategoryModel READ contactCategoryModel CONSTANT)
@@ -108,6 +110,7 @@ public:
     InfoTemplateManager* infoTemplateManager() const;
     NumberCompletionModel* numberCompletionModel() const;
     RecentFileModel* recentFileModel() const;
+    DataTransferModel* dataTransferModel() const;
     Video::DeviceModel* deviceModel() const;
 
     QAbstractItemModel* contactCategoryModel() const;
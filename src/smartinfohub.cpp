@@ -18,6 +18,7 @@
 
 #include "smartinfohub.h"
 #include "private/smartInfoHub_p.h"
+#include "private/callqualitymodel_p.h"
 #include "callmodel.h"
 #include "typedefs.h"
 
@@ -63,6 +64,9 @@ void SmartInfoHubPrivate::slotSmartInfo(const MapStringString& map)
         SmartInfoHubPrivate::m_information[map.keys().at(i)]=map[map.keys().at(i)];
     }
 
+    // Keep the history too, the hub itself only knows the latest values
+    CallQualityModelPrivate::addSmartInfo(map);
+
     emit SmartInfoHub::instance().changed();
 }
 //Getter
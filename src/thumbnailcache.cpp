@@ -0,0 +1,277 @@
+/************************************************************************************
+ *   Copyright (C) 2018 by BlueSystems GmbH                                         *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                            *
+ *                                                                                  *
+ *   This library is free software; you can redistribute it and/or                  *
+ *   modify it under the terms of the GNU Lesser General Public                     *
+ *   License as published by the Free Software Foundation; either                   *
+ *   version 2.1 of the License, or (at your option) any later version.             *
+ *                                                                                  *
+ *   This library is distributed in the hope that it will be useful,                *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of                 *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU              *
+ *   Lesser General Public License for more details.                                *
+ *                                                                                  *
+ *   You should have received a copy of the GNU Lesser General Public               *
+ *   License along with this library; if not, write to the Free Software            *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA *
+ ***********************************************************************************/
+#include "thumbnailcache.h"
+
+// Qt
+#include <QtCore/QCache>
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDebug>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include <QtCore/QPair>
+#include <QtCore/QSaveFile>
+#include <QtCore/QSize>
+#include <QtCore/QStandardPaths>
+#include <QtCore/QVector>
+#include <algorithm>
+
+// Ring
+#include "person.h"
+#include "private/person_p.h"
+
+class ThumbnailCachePrivate final
+{
+public:
+    /// About 8MB of 32 bits pixels
+    static constexpr int DEFAULT_CAPACITY = 8*1024*1024;
+
+    /// The default size of the files on disk
+    static constexpr qint64 DEFAULT_DISK_CAPACITY = 64*1024*1024;
+
+    /// Prune down to this percentage of the capacity so it doesn't happen
+    /// on every store()
+    static constexpr qint64 DISK_PRUNE_TARGET = 75;
+
+    struct DiskEntry {
+        qint64  m_Size   ;
+        quint64 m_LastUse;
+    };
+
+    mutable QMutex m_Mutex;
+    QCache<QByteArray, QVariant> m_Cache {DEFAULT_CAPACITY};
+
+    // The disk LRU, it is only read from the directory on the first store()
+    mutable QMutex                 m_DiskMutex   ;
+    QHash<QByteArray, DiskEntry>   m_hDisk       ;
+    qint64                         m_DiskSize    {0    };
+    qint64                         m_DiskCapacity{DEFAULT_DISK_CAPACITY};
+    quint64                        m_DiskClock   {0    };
+    bool                           m_DiskScanned {false};
+
+    // Helpers
+    static QByteArray entryName(const QByteArray& key, const QSize& size);
+    static QString directory();
+    void scanDisk();
+    void pruneDisk();
+};
+
+ThumbnailCache::ThumbnailCache() : d_ptr(new ThumbnailCachePrivate)
+{}
+
+ThumbnailCache::~ThumbnailCache()
+{
+    delete d_ptr;
+}
+
+ThumbnailCache& ThumbnailCache::instance()
+{
+    static auto instance = new ThumbnailCache();
+    return *instance;
+}
+
+QByteArray ThumbnailCachePrivate::entryName(const QByteArray& key, const QSize& size)
+{
+    return key + '-' + QByteArray::number(size.width())
+        + 'x' + QByteArray::number(size.height());
+}
+
+QString ThumbnailCachePrivate::directory()
+{
+    static const QString dir = QStandardPaths::writableLocation(QStandardPaths::DataLocation)
+        + QStringLiteral("/thumbnails/");
+
+    return dir;
+}
+
+/// Must be called with m_DiskMutex locked
+void ThumbnailCachePrivate::scanDisk()
+{
+    if (m_DiskScanned)
+        return;
+
+    m_DiskScanned = true;
+
+    // Oldest first, the last write time is the best guess after a restart
+    const auto files = QDir(directory()).entryInfoList(
+        QDir::Files, QDir::Time | QDir::Reversed
+    );
+
+    for (const QFileInfo& fi : qAsConst(files)) {
+        const QByteArray name = QFile::encodeName(fi.fileName());
+
+        // Entries written since the startup are already known
+        if (m_hDisk.contains(name))
+            continue;
+
+        m_hDisk[name] = { fi.size(), m_DiskClock++ };
+        m_DiskSize   += fi.size();
+    }
+}
+
+/// Must be called with m_DiskMutex locked
+void ThumbnailCachePrivate::pruneDisk()
+{
+    if (m_DiskSize <= m_DiskCapacity)
+        return;
+
+    QVector<QPair<quint64, QByteArray>> byUse;
+    byUse.reserve(m_hDisk.size());
+
+    for (auto i = m_hDisk.constBegin(); i != m_hDisk.constEnd(); ++i)
+        byUse << qMakePair(i->m_LastUse, i.key());
+
+    std::sort(byUse.begin(), byUse.end());
+
+    const qint64 target = (m_DiskCapacity / 100) * DISK_PRUNE_TARGET;
+
+    for (const auto& e : qAsConst(byUse)) {
+        if (m_DiskSize <= target)
+            break;
+
+        m_DiskSize -= m_hDisk.take(e.second).m_Size;
+        QFile::remove(directory() + QFile::decodeName(e.second));
+    }
+}
+
+QByteArray ThumbnailCache::key(const QByteArray& data)
+{
+    if (data.isEmpty())
+        return {};
+
+    return QCryptographicHash::hash(data, QCryptographicHash::Sha1).toHex();
+}
+
+QByteArray ThumbnailCache::key(const Person* p)
+{
+    // Computed in the main thread when the encoded photo is set, so it is
+    // only read here
+    return p ? p->d_ptr->m_PhotoKey : QByteArray();
+}
+
+QVariant ThumbnailCache::find(const QByteArray& key, const QSize& size) const
+{
+    if (key.isEmpty())
+        return {};
+
+    QMutexLocker l(&d_ptr->m_Mutex);
+
+    // QCache::object() also bumps the entry to the front of the LRU
+    if (auto v = d_ptr->m_Cache.object(ThumbnailCachePrivate::entryName(key, size)))
+        return *v;
+
+    return {};
+}
+
+void ThumbnailCache::insert(const QByteArray& key, const QSize& size, const QVariant& thumbnail, int cost)
+{
+    if (key.isEmpty() || !thumbnail.isValid())
+        return;
+
+    QMutexLocker l(&d_ptr->m_Mutex);
+
+    d_ptr->m_Cache.insert(
+        ThumbnailCachePrivate::entryName(key, size), new QVariant(thumbnail), qMax(1, cost)
+    );
+}
+
+QByteArray ThumbnailCache::load(const QByteArray& key, const QSize& size) const
+{
+    if (key.isEmpty())
+        return {};
+
+    const QByteArray name = ThumbnailCachePrivate::entryName(key, size);
+
+    QFile f(ThumbnailCachePrivate::directory() + QFile::decodeName(name));
+
+    if (!f.open(QIODevice::ReadOnly))
+        return {};
+
+    const QByteArray data = f.readAll();
+
+    QMutexLocker l(&d_ptr->m_DiskMutex);
+
+    // Move it to the back of the LRU, unknown entries are set by scanDisk()
+    auto i = d_ptr->m_hDisk.find(name);
+
+    if (i != d_ptr->m_hDisk.end())
+        i->m_LastUse = d_ptr->m_DiskClock++;
+
+    return data;
+}
+
+void ThumbnailCache::store(const QByteArray& key, const QSize& size, const QByteArray& data)
+{
+    if (key.isEmpty() || data.isEmpty())
+        return;
+
+    static bool init = QDir().mkpath(ThumbnailCachePrivate::directory());
+    Q_UNUSED(init)
+
+    const QByteArray name = ThumbnailCachePrivate::entryName(key, size);
+
+    // Avoid leaving truncated images behind if the process is killed
+    QSaveFile f(ThumbnailCachePrivate::directory() + QFile::decodeName(name));
+
+    if (!f.open(QIODevice::WriteOnly)) {
+        qWarning() << "Failed to save the thumbnail" << f.fileName();
+        return;
+    }
+
+    f.write(data);
+
+    if (!f.commit())
+        return;
+
+    QMutexLocker l(&d_ptr->m_DiskMutex);
+
+    d_ptr->scanDisk();
+
+    // It may replace an existing entry
+    d_ptr->m_DiskSize -= d_ptr->m_hDisk.value(name).m_Size;
+    d_ptr->m_hDisk[name] = { data.size(), d_ptr->m_DiskClock++ };
+    d_ptr->m_DiskSize += data.size();
+
+    d_ptr->pruneDisk();
+}
+
+void ThumbnailCache::setCapacity(int cost)
+{
+    QMutexLocker l(&d_ptr->m_Mutex);
+    d_ptr->m_Cache.setMaxCost(cost);
+}
+
+void ThumbnailCache::setDiskCapacity(qint64 bytes)
+{
+    QMutexLocker l(&d_ptr->m_DiskMutex);
+    d_ptr->m_DiskCapacity = bytes;
+
+    // Only prune if the entries are already known, it will happen on the
+    // next store() otherwise
+    if (d_ptr->m_DiskScanned)
+        d_ptr->pruneDisk();
+}
+
+void ThumbnailCache::clear()
+{
+    QMutexLocker l(&d_ptr->m_Mutex);
+    d_ptr->m_Cache.clear();
+}
@@ -0,0 +1,87 @@
+/************************************************************************************
+ *   Copyright (C) 2018 by BlueSystems GmbH                                         *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                            *
+ *                                                                                  *
+ *   This library is free software; you can redistribute it and/or                  *
+ *   modify it under the terms of the GNU Lesser General Public                     *
+ *   License as published by the Free Software Foundation; either                   *
+ *   version 2.1 of the License, or (at your option) any later version.             *
+ *                                                                                  *
+ *   This library is distributed in the hope that it will be useful,                *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of                 *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU              *
+ *   Lesser General Public License for more details.                                *
+ *                                                                                  *
+ *   You should have received a copy of the GNU Lesser General Public               *
+ *   License along with this library; if not, write to the Free Software            *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA *
+ ***********************************************************************************/
+#pragma once
+
+#include <typedefs.h>
+
+// Qt
+#include <QtCore/QByteArray>
+#include <QtCore/QVariant>
+class QSize;
+
+class Person;
+
+class ThumbnailCachePrivate;
+
+/**
+ * A cache for the scaled down photos shared by all PixmapManipulatorI
+ * implementations.
+ *
+ * The entries are identified by the content hash of the photo and the
+ * thumbnail size, so the same picture used by many persons (or by the same
+ * person in many collections) is only scaled once.
+ *
+ * There is two layers. The first is an in memory LRU holding the objects
+ * produced by the client (usually a QPixmap, this library doesn't link
+ * with QtGui), bounded by their cost. The second holds the encoded images
+ * on disk so they survive a restart. It is also an LRU, bounded by the size
+ * of the files and pruned when a thumbnail is stored.
+ *
+ * The disk layer is thread safe. The memory layer is too, but the objects
+ * it holds may not be.
+ */
+class LIB_EXPORT ThumbnailCache final
+{
+public:
+    static ThumbnailCache& instance();
+
+    /// The content hash of `p` photo, empty unless it was loaded from an encoded image
+    static QByteArray key(const Person* p);
+
+    /// The content hash of an encoded image
+    static QByteArray key(const QByteArray& data);
+
+    /// Get the in memory thumbnail or an invalid QVariant
+    QVariant find(const QByteArray& key, const QSize& size) const;
+
+    /// Add a thumbnail to the in memory LRU, `cost` is usually its size in bytes
+    void insert(const QByteArray& key, const QSize& size, const QVariant& thumbnail, int cost);
+
+    /// Get the encoded thumbnail saved on disk, or an empty array
+    QByteArray load(const QByteArray& key, const QSize& size) const;
+
+    /// Save the encoded thumbnail to disk
+    void store(const QByteArray& key, const QSize& size, const QByteArray& data);
+
+    /// Set the maximum total cost of the in memory thumbnails
+    void setCapacity(int cost);
+
+    /// Set the maximum total size of the thumbnails on disk, in bytes
+    void setDiskCapacity(qint64 bytes);
+
+    /// Drop the in memory thumbnails, the disk entries are kept
+    void clear();
+
+private:
+    explicit ThumbnailCache();
+    ~ThumbnailCache();
+
+    ThumbnailCachePrivate* d_ptr;
+    Q_DECLARE_PRIVATE(ThumbnailCache)
+};
@@ -148,7 +148,7 @@ QItemSelectionModel* TlsMethodModel::selectionModel() const
 {
    if (!d_ptr->m_pSelectionModel) {
       d_ptr->m_pSelectionModel = new QItemSelectionModel(const_cast<TlsMethodModel*>(this));
-      const QString value    = d_ptr->m_pAccount->d_ptr->accountDetail(DRing::Account::ConfProperties::TLS::METHOD);
+      const QString value    = d_ptr->m_pAccount->d_ptr->properties().toString(AccountProperties::Key::TLS_METHOD);
       const auto idx = toIndex(TlsMethodModelPrivate::fromDaemonName(value));
       d_ptr->m_pSelectionModel->setCurrentIndex(idx,QItemSelectionModel::ClearAndSelect);
 
@@ -165,7 +165,7 @@ void TlsMethodModelPrivate::slotSelectionChanged(const QModelIndex& idx)
       return;
 
    const char* value = toDaemonName(static_cast<TlsMethodModel::Type>(idx.row()));
-   if (value != m_pAccount->d_ptr->accountDetail(DRing::Account::ConfProperties::TLS::METHOD))
+   if (value != m_pAccount->d_ptr->properties().toString(AccountProperties::Key::TLS_METHOD))
       m_pAccount->d_ptr->setAccountProperty(DRing::Account::ConfProperties::TLS::METHOD , value);
 }
 
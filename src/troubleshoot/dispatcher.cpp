@@ -20,14 +20,17 @@
 
 // Qt
 #include <QtCore/QTimer>
+#include <QtCore/QElapsedTimer>
 
 // Ring
 #include <call.h>
+#include "private/timerwheel_p.h"
 
 // Troubleshoot
 #include "absent.h"
 #include "handshake.h"
 #include "videostuck.h"
+#include "poorquality.h"
 #include "generic.h"
 #include "crequest.h"
 #include "unhold.h"
@@ -43,11 +46,12 @@ public:
 
     struct Holder {
         std::function<bool(Call*, time_t t)> m_fProbe;
-        Base*   m_pInstance {nullptr};
-        QTimer* m_pTimer    {nullptr};
-        Holder* m_pNext     {nullptr};
-        time_t  m_Timeout   {   0   };
-        int     m_Index     {  -1   };
+        Base*              m_pInstance {nullptr};
+        TimerWheel::Entry* m_pEntry    {nullptr};
+        Holder*            m_pNext     {nullptr};
+        time_t             m_Timeout   {   0   };
+        int                m_Index     {  -1   };
+        int                m_StatIndex {  -1   };
     };
 
     Holder* m_pFirstHolder   {nullptr};
@@ -58,21 +62,29 @@ public:
 
     QTimer* m_pAutoDismiss {new QTimer(this)};
 
+    /// Set when the probes are already going to be evaluated
+    bool m_EvaluationQueued {false};
+
     Dispatcher* q_ptr;
 
     template<class T> void registerAdapter();
 
     static int m_Count;
+    static QVector<Dispatcher::ProbeStatistics> m_lStatistics;
 
     // Helpers
     void setCurrentHolder(Holder* h);
+    void armAll();
+    void cancelAll();
+    bool runProbe(Holder* h, time_t elapsed);
+    void timeout(Holder* holder);
 
 public Q_SLOTS:
     void slotStateChanged();
-    void slotTimeout();
 };
 
 int DispatcherPrivate::m_Count = 0;
+QVector<Dispatcher::ProbeStatistics> DispatcherPrivate::m_lStatistics;
 
 }
 
@@ -84,17 +96,28 @@ Troubleshoot::Dispatcher::Dispatcher(QObject* parent) : QIdentityProxyModel(pare
     connect(d_ptr->m_pAutoDismiss, &QTimer::timeout, this, &Dispatcher::dismiss);
 
     // The order *is* important. The first has the highest priority
-    d_ptr->registerAdapter<Troubleshoot::Unhold>    ();
-    d_ptr->registerAdapter<Troubleshoot::VideoStuck>();
-    d_ptr->registerAdapter<Troubleshoot::Handshake> ();
-    d_ptr->registerAdapter<Troubleshoot::Absent>    ();
-    d_ptr->registerAdapter<Troubleshoot::CallState> ();
-    d_ptr->registerAdapter<Troubleshoot::CRequest>  ();
-    d_ptr->registerAdapter<Troubleshoot::Generic>   ();
+    d_ptr->registerAdapter<Troubleshoot::Unhold>     ();
+    d_ptr->registerAdapter<Troubleshoot::VideoStuck> ();
+    d_ptr->registerAdapter<Troubleshoot::PoorQuality>();
+    d_ptr->registerAdapter<Troubleshoot::Handshake>  ();
+    d_ptr->registerAdapter<Troubleshoot::Absent>     ();
+    d_ptr->registerAdapter<Troubleshoot::CallState>  ();
+    d_ptr->registerAdapter<Troubleshoot::CRequest>   ();
+    d_ptr->registerAdapter<Troubleshoot::Generic>    ();
 }
 
 Troubleshoot::Dispatcher::~Dispatcher()
 {
+    for (auto h = d_ptr->m_pFirstHolder; h;) {
+        auto next = h->m_pNext;
+
+        if (h->m_pEntry)
+            TimerWheel::instance().destroy(h->m_pEntry);
+
+        delete h;
+        h = next;
+    }
+
     delete d_ptr;
 }
 
@@ -182,60 +205,87 @@ void Troubleshoot::Dispatcher::setCall(Call* call)
         connect(d_ptr->m_pCall, &Call::liveMediaIssuesChanaged,
             d_ptr, &DispatcherPrivate::slotStateChanged);
 
-        for (auto h = d_ptr->m_pFirstHolder; h; h = h->m_pNext)
-            h->m_pTimer->start();
+        d_ptr->armAll();
     }
-    else for (auto h = d_ptr->m_pFirstHolder; h; h = h->m_pNext)
-        h->m_pTimer->stop();
+    else
+        d_ptr->cancelAll();
 
     d_ptr->setCurrentHolder(nullptr);
 }
 
+void Troubleshoot::DispatcherPrivate::armAll()
+{
+    for (auto h = m_pFirstHolder; h; h = h->m_pNext) {
+        if (h->m_pEntry)
+            TimerWheel::instance().arm(h->m_pEntry, h->m_Timeout * 1000);
+    }
+}
+
+void Troubleshoot::DispatcherPrivate::cancelAll()
+{
+    for (auto h = m_pFirstHolder; h; h = h->m_pNext) {
+        if (h->m_pEntry)
+            TimerWheel::instance().cancel(h->m_pEntry);
+    }
+}
+
+bool Troubleshoot::DispatcherPrivate::runProbe(Holder* h, time_t elapsed)
+{
+    QElapsedTimer t;
+    t.start();
+
+    const bool ret = h->m_fProbe(m_pCall, elapsed);
+
+    const qint64 ns = t.nsecsElapsed();
+
+    auto& stats = m_lStatistics[h->m_StatIndex];
+    stats.executions++;
+    stats.totalNs += ns;
+    stats.maxNs    = qMax(stats.maxNs, ns);
+
+    return ret;
+}
+
 void Troubleshoot::DispatcherPrivate::slotStateChanged()
 {
     if (!m_pCall)
         return;
 
+    // Many changes can happen in the same event loop iteration, they are all
+    // handled by the same evaluation.
+    if (m_EvaluationQueued)
+        return;
+
+    m_EvaluationQueued = true;
+
     //HACK The signal is sent quite early and many pieces of code are either
     // connected to the signal or executed later in the Call internal state
     // machine. These changes affect many error handling corner cases so they
     // have to be executed first rather than at a random point after this
     // class changes them.
-    QTimer::singleShot(0, [this]() {
+    QTimer::singleShot(0, this, [this]() {
+        m_EvaluationQueued = false;
+
         if (!m_pCall)
             return;
 
         Holder* affected = nullptr;
 
-        for (auto h = m_pFirstHolder; h; h = h->m_pNext) {
-            h->m_pTimer->stop();
-            h->m_pTimer->start();
-            affected = affected ? affected : h->m_fProbe(m_pCall, 0) ? h : nullptr;
-        }
+        armAll();
+
+        for (auto h = m_pFirstHolder; h && !affected; h = h->m_pNext)
+            affected = runProbe(h, 0) ? h : nullptr;
 
         setCurrentHolder(affected);
     });
 }
 
-void Troubleshoot::DispatcherPrivate::slotTimeout()
+void Troubleshoot::DispatcherPrivate::timeout(Holder* holder)
 {
-    auto t = qobject_cast<QTimer*>(sender());
-    Holder* holder = nullptr;
-
-    for (auto h = m_pFirstHolder; h; h = h->m_pNext) {
-        if (h->m_pTimer == t) {
-            holder = h;
-            break;
-        }
-    }
-
-    Q_ASSERT(holder);
-    t->stop();
-
     if (m_pCurrentHolder && holder->m_Index <= m_pCurrentHolder->m_Index)
         return;
 
-    if (!holder->m_fProbe(m_pCall, holder->m_Timeout))
+    if (!runProbe(holder, holder->m_Timeout))
         return;
 
     setCurrentHolder(holder);
@@ -249,14 +299,25 @@ void Troubleshoot::DispatcherPrivate::registerAdapter()
     auto h = new Holder();
     h->m_fProbe    = [i](Call* c, time_t t) -> bool { return T::isAffected(c, t, i); };
     h->m_pInstance = i;
-    h->m_pTimer    = new QTimer( q_ptr );
     h->m_pNext     = nullptr            ;
     h->m_Timeout   = T::timeout(       );
     h->m_Index     = m_Count++;
 
-    if (auto t = T::timeout()) {
-        connect(h->m_pTimer, &QTimer::timeout, this, &DispatcherPrivate::slotTimeout);
-        h->m_pTimer->setInterval(t * 1000);
+    // The probes without timeout are only evaluated when the call changes
+    if (h->m_Timeout)
+        h->m_pEntry = TimerWheel::instance().create([this, h]() { timeout(h); });
+
+    // The statistics are per troubleshooter, not per dispatcher
+    const QByteArray name = i->metaObject()->className();
+
+    for (int idx = 0; idx < m_lStatistics.size() && h->m_StatIndex == -1; idx++) {
+        if (m_lStatistics[idx].name == name)
+            h->m_StatIndex = idx;
+    }
+
+    if (h->m_StatIndex == -1) {
+        h->m_StatIndex = m_lStatistics.size();
+        m_lStatistics << Dispatcher::ProbeStatistics { name, 0, 0, 0 };
     }
 
     m_pFirstHolder = m_pFirstHolder ? m_pFirstHolder : h;
@@ -285,6 +346,11 @@ void Troubleshoot::Dispatcher::dismiss()
     d_ptr->setCurrentHolder(nullptr);
 }
 
+QVector<Troubleshoot::Dispatcher::ProbeStatistics> Troubleshoot::Dispatcher::probeStatistics()
+{
+    return DispatcherPrivate::m_lStatistics;
+}
+
 QString Troubleshoot::Dispatcher::currentIssue() const
 {
     if (!d_ptr->m_pCurrentHolder)
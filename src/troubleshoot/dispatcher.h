@@ -19,6 +19,7 @@
 #pragma once
 
 #include <QtCore/QIdentityProxyModel>
+#include <QtCore/QVector>
 #include <typedefs.h>
 
 #include <troubleshoot/base.h>
@@ -40,6 +41,14 @@ public:
     Q_PROPERTY(int severity   READ severity   NOTIFY textChanged  )
     Q_PROPERTY(QString currentIssue READ currentIssue NOTIFY activeChanged)
 
+    /// Execution statistics of a probe, shared by all dispatchers
+    struct ProbeStatistics {
+        QByteArray name      ; /*!< The troubleshooter class name          */
+        quint64    executions; /*!< How many times the probe was evaluated */
+        qint64     totalNs   ; /*!< The cumulative evaluation time         */
+        qint64     maxNs     ; /*!< The slowest evaluation                 */
+    };
+
     Q_INVOKABLE explicit Dispatcher(QObject* parent = nullptr);
     virtual ~Dispatcher();
 
@@ -56,6 +65,8 @@ public:
 
     Base* currentModule() const;
 
+    static QVector<ProbeStatistics> probeStatistics();
+
     Q_INVOKABLE bool setSelection(const QModelIndex& idx);
     Q_INVOKABLE bool setSelection(int idx);
 
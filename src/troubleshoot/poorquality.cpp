@@ -0,0 +1,152 @@
+/************************************************************************************
+ *   Copyright (C) 2018 by BlueSystems GmbH                                         *
+ *   Author : Emmanuel Lepage Vallee <elv1313@gmail.com>                            *
+ *                                                                                  *
+ *   This library is free software; you can redistribute it and/or                  *
+ *   modify it under the terms of the GNU Lesser General Public                     *
+ *   License as published by the Free Software Foundation; either                   *
+ *   version 2.1 of the License, or (at your option) any later version.             *
+ *                                                                                  *
+ *   This library is distributed in the hope that it will be useful,                *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of                 *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU              *
+ *   Lesser General Public License for more details.                                *
+ *                                                                                  *
+ *   You should have received a copy of the GNU Lesser General Public               *
+ *   License along with this library; if not, write to the Free Software            *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA *
+ ***********************************************************************************/
+#include "poorquality.h"
+
+// Qt
+#include <QtCore/QTimer>
+
+// Ring
+#include <call.h>
+#include <session.h>
+#include <callmodel.h>
+#include <callqualitymodel.h>
+#include <media/video.h>
+
+namespace Troubleshoot {
+
+class PoorQualityPrivate
+{
+public:
+    enum class Mitigations {
+        MUTE_VIDEO,
+        HOLD_UNHOLD,
+        CALL_AGAIN
+    };
+
+    /// The period used to compute the statistics, in seconds
+    static constexpr const int WINDOW = 30;
+
+    // The thresholds above which a call is considered degraded
+    static constexpr const float MAX_PACKET_LOSS = 10.f ; // percent
+    static constexpr const float MAX_JITTER      = 100.f; // ms
+    static constexpr const float MAX_RTT         = 800.f; // ms
+
+    /// Do not trigger on the first few reports
+    static constexpr const int MIN_SAMPLES = 5;
+
+    static bool exceeds(const CallQualityModel* m, CallQualityModel::Metric metric, float threshold);
+};
+
+}
+
+Troubleshoot::PoorQuality::PoorQuality(Dispatcher* parent) :
+    Troubleshoot::Base(parent), d_ptr(new PoorQualityPrivate())
+{}
+
+Troubleshoot::PoorQuality::~PoorQuality()
+{
+    delete d_ptr;
+}
+
+QString Troubleshoot::PoorQuality::headerText() const
+{
+    static QString message = tr("The network connection is unstable and the call quality is degraded. The following options may help:");
+
+    return message;
+}
+
+Troubleshoot::Base::Severity Troubleshoot::PoorQuality::severity() const
+{
+    return Base::Severity::WARNING;
+}
+
+bool Troubleshoot::PoorQuality::setSelection(const QModelIndex& idx, Call* c)
+{
+    if ((!c) || !idx.isValid())
+        return false;
+
+    auto cm = c->peerContactMethod();
+
+    switch((PoorQualityPrivate::Mitigations) idx.row()) {
+        case PoorQualityPrivate::Mitigations::MUTE_VIDEO:
+            // Free the bandwidth for the audio
+            if (auto videoOut = c->firstMedia<Media::Video>(Media::Media::Direction::OUT))
+                videoOut->mute();
+            break;
+        case PoorQualityPrivate::Mitigations::HOLD_UNHOLD:
+            c << Call::Action::HOLD;
+            QTimer::singleShot(1000, [c]() {
+                if (c->state() == Call::State::HOLD)
+                    c << Call::Action::HOLD;
+            });
+            break;
+        case PoorQualityPrivate::Mitigations::CALL_AGAIN:
+            c << Call::Action::REFUSE;
+            c = Session::instance()->callModel()->dialingCall(cm);
+            c << Call::Action::ACCEPT;
+            break;
+    }
+
+    return true;
+}
+
+bool Troubleshoot::PoorQualityPrivate::exceeds(const CallQualityModel* m, CallQualityModel::Metric metric, float threshold)
+{
+    const auto s = m->statistics(metric, WINDOW);
+
+    return s.count >= MIN_SAMPLES && s.p95 > threshold;
+}
+
+bool Troubleshoot::PoorQuality::isAffected(Call* c, time_t elapsedTime, Troubleshoot::Base* self)
+{
+    Q_UNUSED(elapsedTime)
+    Q_UNUSED(self)
+
+    if (c->state() != Call::State::CURRENT)
+        return false;
+
+    const auto m = c->qualityModel();
+
+    return PoorQualityPrivate::exceeds(m, CallQualityModel::Metric::PACKET_LOSS    , PoorQualityPrivate::MAX_PACKET_LOSS)
+        || PoorQualityPrivate::exceeds(m, CallQualityModel::Metric::JITTER         , PoorQualityPrivate::MAX_JITTER     )
+        || PoorQualityPrivate::exceeds(m, CallQualityModel::Metric::ROUND_TRIP_TIME, PoorQualityPrivate::MAX_RTT        );
+}
+
+int Troubleshoot::PoorQuality::timeout()
+{
+    return 10;
+}
+
+void Troubleshoot::PoorQuality::activate()
+{
+    static QStringList options {
+        tr( "Stop sending video"          ),
+        tr( "Hold and resume the call"    ),
+        tr( "Hang up and call again"      ),
+    };
+
+    setStringList(options);
+
+    emit textChanged();
+}
+
+void Troubleshoot::PoorQuality::deactivate()
+{
+    setStringList({});
+}
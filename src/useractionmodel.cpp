@@ -18,8 +18,13 @@
 #include "useractionmodel.h"
 
 //Qt
+#include <QtCore/QHash>
 #include <QtCore/QItemSelection>
 #include <QtCore/QSortFilterProxyModel>
+#include <QtCore/QTimer>
+
+//Std
+#include <cstdint>
 
 //Ring
 #include "call.h"
@@ -66,6 +71,26 @@ public:
       GENERIC , /*!< Model that react on a model selection       */
    };
 
+   /**
+    * The actions available for a single object, one bit per action.
+    *
+    * They only depend on the object (and its account), the selection
+    * specific parts are applied once the masks are aggregated.
+    */
+   struct Capabilities {
+      uint32_t m_Available {0    }; /*!< Actions usable on this object      */
+      uint32_t m_Checked   {0    }; /*!< Stateful actions currently checked */
+      uint32_t m_Unchecked {0    }; /*!< Stateful actions not checked       */
+      bool     m_IsCall    {false};
+   };
+
+   static_assert(enum_class_size<UserActionModel::Action>() <= 32,
+      "The capability masks need one bit per action");
+
+   static constexpr uint32_t bit(UserActionModel::Action action) {
+      return 1u << static_cast<int>(action);
+   }
+
    //Availability matrices
    UserActionModelPrivate(UserActionModel* parent, const FlagPack<UAM::Context>& c);
    static const Matrix1D< UAM::Action                            , bool  > heterogenous_call_options ;
@@ -85,10 +110,17 @@ public:
    //Helpers
    bool updateAction         (UAM::Action action                          );
    bool updateByCall         (UAM::Action action, const Call* c           );
+   bool updateByCallState    (UAM::Action action, const Call* c           );
    bool updateByContactMethod(UAM::Action action, const ContactMethod* cm );
    bool updateByAccount      (UAM::Action action, const Account* a        );
    bool updateByPerson       (UAM::Action action, const Person* p         );
    void updateCheckMask      (int& ret, UAM::Action action, const Call* c );
+   void updateLabels         (const Call* c                               );
+   void updateSelection      (                                            );
+   bool capabilities         (const QModelIndex& idx, Capabilities& out, const Call*& call);
+   Capabilities computeCapabilities(Ring::ObjectType type, QObject* o     );
+   void watch                (QObject* owner, QObject* dependency         );
+   void invalidate           (QObject* o                                  );
 
    //Attributes
    Call*                                  m_pCall              ;
@@ -102,6 +134,14 @@ public:
    QItemSelectionModel*                   m_pSelectionModel {nullptr};
    QAbstractItemModel*                    m_pSourceModel    {nullptr};
 
+   //Selection (GENERIC mode)
+   QHash<const QObject*, Capabilities>    m_hCapabilities      ;
+   QMultiHash<const QObject*, QObject*>   m_hDependents        ;
+   uint32_t                               m_SelectionAvailable {0};
+   uint32_t                               m_SelectionChecked   {0};
+   uint32_t                               m_SelectionUnchecked {0};
+   bool                                   m_UpdateQueued {false};
+
 private:
    UserActionModel* q_ptr;
 
@@ -111,6 +151,10 @@ public Q_SLOTS:
 
    //CallModel mode
    void updateActions();
+   void slotInvalidate();
+   void slotInvalidateAll();
+   void slotDestroyed(QObject* o);
+   void slotCallChanged(Call* c);
 };
 
 
@@ -613,13 +657,14 @@ UserActionModel::UserActionModel(QAbstractItemModel* parent, const FlagPack<User
    d_ptr->m_SelectionState = UserActionModelPrivate::SelectionState::UNIQUE;
    d_ptr->m_pSourceModel = parent;
 
-   connect(Session::instance()->accountModel(), &AccountModel::accountStateChanged      , d_ptr.data(), &UserActionModelPrivate::updateActions);
+   connect(Session::instance()->accountModel(), &AccountModel::accountStateChanged      , d_ptr.data(), &UserActionModelPrivate::slotInvalidateAll);
+   connect(Session::instance()->availableAccountModel(), &AvailableAccountModel::currentDefaultAccountChanged, d_ptr.data(), &UserActionModelPrivate::slotInvalidateAll);
 
    if (auto callmodel = qobject_cast<CallModel*>(parent)) {
       setSelectionModel(callmodel->selectionModel());
-      connect(callmodel, &CallModel::callStateChanged , d_ptr.data(), &UserActionModelPrivate::updateActions);
-      connect(callmodel, &CallModel::mediaStateChanged, d_ptr.data(), &UserActionModelPrivate::updateActions);
-      connect(callmodel, &CallModel::dialNumberChanged, d_ptr.data(), &UserActionModelPrivate::updateActions);
+      connect(callmodel, &CallModel::callStateChanged , d_ptr.data(), &UserActionModelPrivate::slotCallChanged);
+      connect(callmodel, &CallModel::mediaStateChanged, d_ptr.data(), &UserActionModelPrivate::slotCallChanged);
+      connect(callmodel, &CallModel::dialNumberChanged, d_ptr.data(), &UserActionModelPrivate::slotCallChanged);
    }
    //TODO add other relevant models here Categorized*, RecentModel, etc
 
@@ -767,78 +812,63 @@ void UserActionModelPrivate::updateCheckMask(int& ret, UserActionModel::Action a
       case UserActionModel::Action::COUNT__:
          break;
    };
+}
 
+void UserActionModelPrivate::updateLabels(const Call* c)
+{
    //Avoid the noise
    #pragma GCC diagnostic push
    #pragma GCC diagnostic ignored "-Wswitch-enum"
-   //Update the labels
-   switch (action) {
-      case UserActionModel::Action::ACCEPT          :
-         switch(c->state()) {
-            case Call::State::DIALING        :
-               m_ActionNames.setAt(UserActionModel::Action::ACCEPT, QObject::tr("Call"));
-               break;
-            default:
-               m_ActionNames.setAt(UserActionModel::Action::ACCEPT,  QObject::tr("Accept"));
-               break;
-         }
+   switch(c->state()) {
+      case Call::State::DIALING        :
+         m_ActionNames.setAt(UserActionModel::Action::ACCEPT, QObject::tr("Call"));
          break;
-      case UserActionModel::Action::HOLD            :
-         switch(c->state()) {
-            case Call::State::HOLD           :
-            case Call::State::CONFERENCE_HOLD:
-            case Call::State::TRANSF_HOLD    :
-               m_ActionNames.setAt(UserActionModel::Action::HOLD, QObject::tr("Unhold"));
-               break;
-            default:
-               m_ActionNames.setAt(UserActionModel::Action::HOLD, QObject::tr("Hold"));
-               break;
-         }
+      default:
+         m_ActionNames.setAt(UserActionModel::Action::ACCEPT,  QObject::tr("Accept"));
          break;
-      case UserActionModel::Action::HANGUP          :
-         switch(c->state()) {
-            case Call::State::DIALING        :
-            case Call::State::NEW            :
-               m_ActionNames.setAt(UserActionModel::Action::HANGUP, QObject::tr("Cancel"));
-               break;
-            case Call::State::FAILURE        :
-            case Call::State::ERROR          :
-            case Call::State::COUNT__        :
-            case Call::State::INITIALIZATION :
-            case Call::State::BUSY           :
-               m_ActionNames.setAt(UserActionModel::Action::HANGUP, QObject::tr("Remove"));
-               break;
-            default:
-               m_ActionNames.setAt(UserActionModel::Action::HANGUP, QObject::tr("Hangup"));
-               break;
-         }
+   }
+
+   switch(c->state()) {
+      case Call::State::HOLD           :
+      case Call::State::CONFERENCE_HOLD:
+      case Call::State::TRANSF_HOLD    :
+         m_ActionNames.setAt(UserActionModel::Action::HOLD, QObject::tr("Unhold"));
          break;
-      case UserActionModel::Action::JOIN            :
-      case UserActionModel::Action::ADD_NEW         :
-      case UserActionModel::Action::COUNT__         :
-      case UserActionModel::Action::MUTE_AUDIO      :
-      case UserActionModel::Action::MUTE_VIDEO      :
-      case UserActionModel::Action::SERVER_TRANSFER :
-      case UserActionModel::Action::RECORD          :
-      case UserActionModel::Action::TOGGLE_VIDEO      :
-      case UserActionModel::Action::ADD_CONTACT       :
-      case UserActionModel::Action::ADD_TO_CONTACT    :
-      case UserActionModel::Action::DELETE_CONTACT    :
-      case UserActionModel::Action::EMAIL_CONTACT     :
-      case UserActionModel::Action::COPY_CONTACT      :
-      case UserActionModel::Action::BOOKMARK          :
-      case UserActionModel::Action::VIEW_CHAT_HISTORY :
-      case UserActionModel::Action::ADD_CONTACT_METHOD:
-      case UserActionModel::Action::CALL_CONTACT      :
-      case UserActionModel::Action::EDIT_CONTACT      :
-      case UserActionModel::Action::REMOVE_HISTORY    :
-      case UserActionModel::Action::MARK_AS_CONSUMED  :
+      default:
+         m_ActionNames.setAt(UserActionModel::Action::HOLD, QObject::tr("Hold"));
+         break;
+   }
+
+   switch(c->state()) {
+      case Call::State::DIALING        :
+      case Call::State::NEW            :
+         m_ActionNames.setAt(UserActionModel::Action::HANGUP, QObject::tr("Cancel"));
+         break;
+      case Call::State::FAILURE        :
+      case Call::State::ERROR          :
+      case Call::State::COUNT__        :
+      case Call::State::INITIALIZATION :
+      case Call::State::BUSY           :
+         m_ActionNames.setAt(UserActionModel::Action::HANGUP, QObject::tr("Remove"));
+         break;
+      default:
+         m_ActionNames.setAt(UserActionModel::Action::HANGUP, QObject::tr("Hangup"));
          break;
    }
    #pragma GCC diagnostic pop
 }
 
 bool UserActionModelPrivate::updateByCall(UserActionModel::Action action, const Call* c)
+{
+   return (
+      multi_call_options        [action] [m_SelectionState       ] &&
+      actionContext             [action] & m_fContext              &&
+      updateByCallState(action, c)
+   );
+}
+
+///The part of updateByCall() which doesn't depend on the selection
+bool UserActionModelPrivate::updateByCallState(UserActionModel::Action action, const Call* c)
 {
    if (!c)
       return false;
@@ -846,8 +876,6 @@ bool UserActionModelPrivate::updateByCall(UserActionModel::Action action, const
 
    return (
       availableActionMap        [action] [c->state()             ] &&
-      multi_call_options        [action] [m_SelectionState       ] &&
-      actionContext             [action] & m_fContext              &&
       updateByAccount(action, a)                                   &&
       ((!cmActionAvailability[action]) ||
          cmActionAvailability[action](c->peerContactMethod()))
@@ -883,126 +911,342 @@ bool UserActionModelPrivate::updateByPerson(UserActionModel::Action action, cons
    return (!personActionAvailability[action]) || personActionAvailability[action](p);
 }
 
-bool UserActionModelPrivate::updateAction(UserActionModel::Action action)
+/**
+ * Compute the actions of a single object.
+ *
+ * Only the dialing calls are evaluated every time, the URI (and the matching
+ * contact method) change with every keystroke.
+ */
+UserActionModelPrivate::Capabilities UserActionModelPrivate::computeCapabilities(Ring::ObjectType type, QObject* o)
 {
-   int state = 0;
-   switch(m_Mode) {
-      case UserActionModelMode::CALL:
-         updateCheckMask(state,action,m_pCall);
-         m_CurrentActionsState.setAt(action,  state / 100 ? Qt::Checked : Qt::Unchecked);
+   Capabilities ret;
+   ret.m_IsCall = type == Ring::ObjectType::Call;
 
-         return updateByCall(action, m_pCall);
-      case UserActionModelMode::GENERIC: {
-         bool ret = true;
+   const Call*          dialing  = nullptr;
+   const ContactMethod* existing = nullptr;
 
-         m_SelectionState = m_pSelectionModel ? (
-            m_pSelectionModel->selectedRows().size() > 1 ?
-               SelectionState::MULTI :
-               SelectionState::UNIQUE
-         ) : SelectionState::NONE ;
+   if (ret.m_IsCall && o && static_cast<Call*>(o)->state() == Call::State::DIALING) {
+      dialing = static_cast<Call*>(o);
+      existing  = Session::instance()->individualDirectory()->getExistingNumberIf(
+         dialing->peerContactMethod()->uri(),
+         [](const ContactMethod* cm) -> bool { return cm->account();}
+      );
+   }
 
-         //Aggregate and reduce the action state for each selected calls
-         if (m_pSelectionModel && (m_pSelectionModel->selectedRows().size() || m_pSelectionModel->currentIndex().isValid())) {
+   for (UserActionModel::Action action : EnumIterator<UserActionModel::Action>()) {
+      if (!availableObjectActions[action][type])
+         continue;
 
-            auto selected = m_pSelectionModel->selectedRows();
+      bool available = true;
 
-            if (selected.isEmpty() && m_pSelectionModel->currentIndex().isValid())
-               selected << m_pSelectionModel->currentIndex();
+      switch(type) {
+         case Ring::ObjectType::Person         :
+            available = o && updateByPerson(action, static_cast<Person*>(o));
+            break;
+         case Ring::ObjectType::ContactMethod  :
+            available = o && updateByContactMethod(action, static_cast<ContactMethod*>(o));
+            break;
+         case Ring::ObjectType::Call           : {
+            const auto c = static_cast<Call*>(o);
 
-            foreach (const QModelIndex& idx, selected) {
+            available = updateByCallState(action, c);
 
-               const QVariant objTv = idx.data(static_cast<int>(Ring::Role::ObjectType));
+            // Dialing (search field) calls have a new URI with every
+            // keystroke. Check is such URI match an existing one. This
+            // changes the availability of some actions. For example,
+            // the offline chat only works for Ring CM *or* SIP CM with
+            // an existing chat history.
+            if (dialing)
+               available &= updateByContactMethod(action, existing);
 
-               Ring::ObjectType objT = {};
+            int state = 0;
+            updateCheckMask(state, action, c);
 
-               //Be sure the model support the UAM abstraction
-               if (!objTv.canConvert<Ring::ObjectType>()) {
-                  qWarning() << "Cannot determine object type, fallback to the call";
-                  objT = Ring::ObjectType::Call;
-                  continue;
-               }
-               else
-                  objT = qvariant_cast<Ring::ObjectType>(objTv);
+            if (state >= 100)
+               ret.m_Checked |= bit(action);
+            else if (state)
+               ret.m_Unchecked |= bit(action);
 
-               ret &= availableObjectActions[action][objT];
+            break;
+         }
+         case Ring::ObjectType::Media          : //TODO
+         case Ring::ObjectType::Certificate    : //TODO
+         case Ring::ObjectType::ContactRequest : //TODO
+         case Ring::ObjectType::Event          : //TODO
+         case Ring::ObjectType::Individual     : //TODO
+         case Ring::ObjectType::COUNT__        :
+            break;
+      }
 
-               //There is no point in doing further checks
-               if (!ret) {
-                  continue;
-               }
+      if (available)
+         ret.m_Available |= bit(action);
+   }
 
-               switch(objT) {
-                  case Ring::ObjectType::Person         : {
+   return ret;
+}
 
-                     const auto p = qvariant_cast<Person*>(idx.data(static_cast<int>(Ring::Role::Object)));
+/**
+ * Get the (cached) capabilities of a selected index.
+ *
+ * @return false if the index isn't an object supported by the UAM
+ */
+bool UserActionModelPrivate::capabilities(const QModelIndex& idx, Capabilities& out, const Call*& call)
+{
+   const QVariant objTv = idx.data(static_cast<int>(Ring::Role::ObjectType));
 
-                     ret &= updateByPerson( action, p );
+   //Be sure the model support the UAM abstraction
+   if (!objTv.canConvert<Ring::ObjectType>()) {
+      qWarning() << "Cannot determine object type, fallback to the call";
+      return false;
+   }
 
-                     break;
-                  }
-                  case Ring::ObjectType::ContactMethod  : {
+   const auto objT = qvariant_cast<Ring::ObjectType>(objTv);
+   const QVariant objV = idx.data(static_cast<int>(Ring::Role::Object));
 
-                     const auto cm = qvariant_cast<ContactMethod*>(idx.data(static_cast<int>(Ring::Role::Object)));
+   QObject* o = nullptr;
 
-                     ret &= cm ? updateByContactMethod( action, cm ) : false;
+   switch(objT) {
+      case Ring::ObjectType::Person         :
+         o = qvariant_cast<Person*>(objV);
+         break;
+      case Ring::ObjectType::ContactMethod  :
+         o = qvariant_cast<ContactMethod*>(objV);
+         break;
+      case Ring::ObjectType::Call           : {
+         auto c = qvariant_cast<Call*>(objV);
 
-                     break;
-                  }
-                  case Ring::ObjectType::Call           : {
+         // Fallback to the active call to prevent not being able to hang up
+         // due to some race conditions.
+         if (!c) {
+            const CallList calls = Session::instance()->callModel()->getActiveCalls();
 
-                     auto c = qvariant_cast<Call*>(idx.data(static_cast<int>(Ring::Role::Object)));
+            if (!calls.isEmpty())
+               c = calls.first();
+         }
 
-                     // Fallback to the active call to prevent not being able to hang up
-                     // due to some race conditions.
-                     if (!c) {
-                        const CallList calls = Session::instance()->callModel()->getActiveCalls();
+         if (!c)
+            return false;
 
-                        if (!calls.isEmpty())
-                           c = calls.first();
-                     }
+         call = c;
 
-                     if (!c)
-                        break;
+         if (c->state() == Call::State::DIALING) {
+            out = computeCapabilities(objT, c);
+            return true;
+         }
 
-                     ret &= updateByCall( action, c );
+         o = c;
+         break;
+      }
+      case Ring::ObjectType::Media          :
+      case Ring::ObjectType::Certificate    :
+      case Ring::ObjectType::ContactRequest :
+      case Ring::ObjectType::Event          :
+      case Ring::ObjectType::Individual     :
+      case Ring::ObjectType::COUNT__        :
+         break;
+   }
 
-                     // Dialing (search field) calls have a new URI with every
-                     // keystroke. Check is such URI match an existing one. This
-                     // changes the availability of some actions. For example,
-                     // the offline chat only works for Ring CM *or* SIP CM with
-                     // an existing chat history.
-                     if (c->state() == Call::State::DIALING) {
-                        ret &= updateByContactMethod(
-                          action, Session::instance()->individualDirectory()->getExistingNumberIf(
-                             c->peerContactMethod()->uri(),
-                             [](const ContactMethod* cm) -> bool { return cm->account();}
-                          )
-                        );
-                     }
+   if (!o) {
+      out = computeCapabilities(objT, nullptr);
+      return true;
+   }
 
-                     updateCheckMask( state ,action, c ); //TODO abstract this out
+   const auto it = m_hCapabilities.constFind(o);
 
-                     break;
-                  }
-                  case Ring::ObjectType::Media          : //TODO
-                  case Ring::ObjectType::Certificate    : //TODO
-                  case Ring::ObjectType::ContactRequest   : //TODO
-                  case Ring::ObjectType::Event          : //TODO
-                  case Ring::ObjectType::Individual     : //TODO
-                  case Ring::ObjectType::COUNT__        :
-                     break;
-               }
-            }
-         }
-         else {
-            Account* a =  Session::instance()->availableAccountModel()->currentDefaultAccount();
-            ret = multi_call_options[action][UserActionModelPrivate::SelectionState::NONE]
-               && (a?availableAccountActionMap[action][a->registrationState()]:false);
-         }
+   if (it != m_hCapabilities.constEnd()) {
+      out = *it;
+      return true;
+   }
+
+   out = computeCapabilities(objT, o);
+   m_hCapabilities[o] = out;
+
+   // Track everything the masks were computed from
+   watch(o, o);
+
+   if (auto c = qobject_cast<Call*>(o)) {
+      watch(c, c->peerContactMethod());
+
+      if (c->peerContactMethod())
+         watch(c, c->peerContactMethod()->contact());
+   }
+   else if (auto cm = qobject_cast<ContactMethod*>(o)) {
+      watch(cm, cm->contact());
+      watch(cm, cm->textRecording());
+   }
+
+   return true;
+}
+
+/**
+ * Drop the cached capabilities of `owner` when `dependency` changes.
+ */
+void UserActionModelPrivate::watch(QObject* owner, QObject* dependency)
+{
+   if ((!dependency) || m_hDependents.contains(dependency, owner))
+      return;
+
+   m_hDependents.insert(dependency, owner);
+
+   static constexpr const auto u = Qt::UniqueConnection;
+
+   if (auto c = qobject_cast<Call*>(dependency)) {
+      connect(c, &Call::changed          , this, &UserActionModelPrivate::slotInvalidate, u);
+      connect(c, &Call::stateChanged     , this, &UserActionModelPrivate::slotInvalidate, u);
+      connect(c, &Call::mediaAdded       , this, &UserActionModelPrivate::slotInvalidate, u);
+      connect(c, &Call::mediaStateChanged, this, &UserActionModelPrivate::slotInvalidate, u);
+   }
+   else if (auto cm = qobject_cast<ContactMethod*>(dependency)) {
+      connect(cm, &ContactMethod::changed       , this, &UserActionModelPrivate::slotInvalidate, u);
+      connect(cm, &ContactMethod::contactChanged, this, &UserActionModelPrivate::slotInvalidate, u);
+      connect(cm, &ContactMethod::callAdded     , this, &UserActionModelPrivate::slotInvalidate, u);
+      connect(cm, &ContactMethod::presentChanged, this, &UserActionModelPrivate::slotInvalidate, u);
+      connect(cm, &ContactMethod::rebased       , this, &UserActionModelPrivate::slotInvalidate, u);
+   }
+   else if (auto p = qobject_cast<Person*>(dependency)) {
+      connect(p, &Person::changed  , this, &UserActionModelPrivate::slotInvalidate, u);
+      connect(p, &Person::callAdded, this, &UserActionModelPrivate::slotInvalidate, u);
+      connect(p, &Person::rebased  , this, &UserActionModelPrivate::slotInvalidate, u);
+   }
+   else if (auto t = qobject_cast<Media::TextRecording*>(dependency)) {
+      connect(t, &Media::TextRecording::unreadCountChange, this, &UserActionModelPrivate::slotInvalidate, u);
+   }
+
+   connect(dependency, &QObject::destroyed, this, &UserActionModelPrivate::slotDestroyed, u);
+}
+
+void UserActionModelPrivate::invalidate(QObject* o)
+{
+   m_hCapabilities.remove(o);
+
+   const auto owners = m_hDependents.values(o);
+
+   for (QObject* owner : owners)
+      m_hCapabilities.remove(owner);
+}
+
+void UserActionModelPrivate::slotInvalidate()
+{
+   invalidate(sender());
+
+   // A single change often emits many signals
+   if (m_UpdateQueued)
+      return;
+
+   m_UpdateQueued = true;
+
+   QTimer::singleShot(0, this, [this]() {
+      m_UpdateQueued = false;
+      updateActions();
+   });
+}
+
+///The account states are part of every masks
+void UserActionModelPrivate::slotInvalidateAll()
+{
+   m_hCapabilities.clear();
+   updateActions();
+}
+
+void UserActionModelPrivate::slotDestroyed(QObject* o)
+{
+   m_hCapabilities.remove(o);
+   m_hDependents.remove(o);
+}
+
+void UserActionModelPrivate::slotCallChanged(Call* c)
+{
+   invalidate(c);
+   updateActions();
+}
+
+/**
+ * Aggregate the capabilities of all selected objects.
+ *
+ * This is a AND of the available masks and a OR of the check states, so
+ * a large selection costs one lookup per row rather than running every
+ * availability check for every action.
+ */
+void UserActionModelPrivate::updateSelection()
+{
+   QModelIndexList selected;
+
+   if (m_pSelectionModel) {
+      selected = m_pSelectionModel->selectedRows();
+
+      if (selected.isEmpty() && m_pSelectionModel->currentIndex().isValid())
+         selected << m_pSelectionModel->currentIndex();
+   }
+
+   m_SelectionState = m_pSelectionModel ? (
+      selected.size() > 1 ?
+         SelectionState::MULTI :
+         SelectionState::UNIQUE
+   ) : SelectionState::NONE ;
+
+   m_SelectionAvailable = 0;
+   m_SelectionChecked   = 0;
+   m_SelectionUnchecked = 0;
+
+   if (selected.isEmpty()) {
+      Account* a =  Session::instance()->availableAccountModel()->currentDefaultAccount();
+
+      for (UserActionModel::Action action : EnumIterator<UserActionModel::Action>()) {
+         if (multi_call_options[action][UserActionModelPrivate::SelectionState::NONE]
+           && (a?availableAccountActionMap[action][a->registrationState()]:false))
+            m_SelectionAvailable |= bit(action);
+      }
+
+      return;
+   }
+
+   uint32_t available = ~0u;
+   bool     hasCall   = false;
+
+   const Call* lastCall = nullptr;
+
+   for (const QModelIndex& idx : qAsConst(selected)) {
+      Capabilities c;
+
+      if (!capabilities(idx, c, lastCall))
+         continue;
+
+      available            &= c.m_Available;
+      m_SelectionChecked   |= c.m_Checked  ;
+      m_SelectionUnchecked |= c.m_Unchecked;
+      hasCall              |= c.m_IsCall   ;
+   }
+
+   // Apply the selection specific parts of updateByCall()
+   if (hasCall) {
+      for (UserActionModel::Action action : EnumIterator<UserActionModel::Action>()) {
+         if (!(multi_call_options[action][m_SelectionState] && actionContext[action] & m_fContext))
+            available &= ~bit(action);
+      }
+   }
+
+   m_SelectionAvailable = available;
+
+   if (lastCall)
+      updateLabels(lastCall);
+}
+
+bool UserActionModelPrivate::updateAction(UserActionModel::Action action)
+{
+   int state = 0;
+   switch(m_Mode) {
+      case UserActionModelMode::CALL:
+         updateCheckMask(state,action,m_pCall);
+         m_CurrentActionsState.setAt(action,  state / 100 ? Qt::Checked : Qt::Unchecked);
+
+         return updateByCall(action, m_pCall);
+      case UserActionModelMode::GENERIC: {
+         const bool checked   = m_SelectionChecked   & bit(action);
+         const bool unchecked = m_SelectionUnchecked & bit(action);
 
          //Detect if the multiple selection has mismatching item states, disable it if necessary
-         m_CurrentActionsState.setAt(action, (state % 100 && state / 100) ? Qt::PartiallyChecked : (state / 100 ? Qt::Checked : Qt::Unchecked));
-         return ret && (m_CurrentActionsState[action] != Qt::PartiallyChecked || heterogenous_call_options[action]);
+         m_CurrentActionsState.setAt(action, (checked && unchecked) ? Qt::PartiallyChecked : (checked ? Qt::Checked : Qt::Unchecked));
+         return (m_SelectionAvailable & bit(action)) && (m_CurrentActionsState[action] != Qt::PartiallyChecked || heterogenous_call_options[action]);
       }
    };
    return false;
@@ -1010,6 +1254,16 @@ bool UserActionModelPrivate::updateAction(UserActionModel::Action action)
 
 void UserActionModelPrivate::updateActions()
 {
+   switch(m_Mode) {
+      case UserActionModelMode::CALL:
+         if (m_pCall)
+            updateLabels(m_pCall);
+         break;
+      case UserActionModelMode::GENERIC:
+         updateSelection();
+         break;
+   }
+
    for (UserActionModel::Action action : EnumIterator<UserActionModel::Action>())
       m_CurrentActions[action] = updateAction(action);
    emit q_ptr->dataChanged(q_ptr->index(0,0),q_ptr->index(enum_class_size<UserActionModel::Action>()-1,0));